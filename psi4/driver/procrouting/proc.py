@@ -2205,10 +2205,10 @@ def run_scf_hessian(name, **kwargs):
     if ref_wfn is None:
         ref_wfn = run_scf(name, **kwargs)
 
-    badref = core.get_option('SCF', 'REFERENCE') in ['UHF', 'ROHF', 'CUHF', 'RKS', 'UKS']
-    badint = core.get_global_option('SCF_TYPE') in [ 'CD', 'OUT_OF_CORE']
+    badref = core.get_option('SCF', 'REFERENCE') in ['UHF', 'ROHF', 'CUHF', 'UKS']
+    badint = core.get_global_option('SCF_TYPE') in [ 'CD', 'OUT_OF_CORE', 'COSX']
     if badref or badint:
-        raise ValidationError("Only RHF Hessians are currently implemented. SCF_TYPE either CD or OUT_OF_CORE not supported")
+        raise ValidationError("Only RHF/RKS Hessians are currently implemented. SCF_TYPE CD, OUT_OF_CORE, or COSX not supported")
 
     if hasattr(ref_wfn, "_disp_functor"):
         disp_hess = ref_wfn._disp_functor.compute_hessian(ref_wfn.molecule())
@@ -2352,8 +2352,9 @@ def run_ccenergy(name, **kwargs):
                                             "RIFIT", core.get_global_option("BASIS"))
         ref_wfn.set_basisset("DF_BASIS_CC", aux_basis)
 
-    # Ensure IWL files have been written
-    proc_util.check_iwl_file_from_scf_type(core.get_global_option('SCF_TYPE'), ref_wfn)
+    # Ensure IWL files have been written, unless cctransort computes the SO integrals directly
+    if not proc_util.cctransort_direct_tei():
+        proc_util.check_iwl_file_from_scf_type(core.get_global_option('SCF_TYPE'), ref_wfn)
 
     # Obtain semicanonical orbitals
     if (core.get_option('SCF', 'REFERENCE') == 'ROHF') and \
@@ -2458,8 +2459,9 @@ def run_bccd(name, **kwargs):
     if (core.get_option('SCF', 'REFERENCE') == 'ROHF'):
         ref_wfn.semicanonicalize()
 
-    # Ensure IWL files have been written
-    proc_util.check_iwl_file_from_scf_type(core.get_global_option('SCF_TYPE'), ref_wfn)
+    # Ensure IWL files have been written, unless cctransort computes the SO integrals directly
+    if not proc_util.cctransort_direct_tei():
+        proc_util.check_iwl_file_from_scf_type(core.get_global_option('SCF_TYPE'), ref_wfn)
 
     core.set_local_option('CCTRANSORT', 'DELETE_TEI', 'false')
 
@@ -217,7 +217,7 @@ for key in functionals:
         procedures['gradient'][key] = proc.run_scf_gradient
 
     # Hessians
-    if not ssuper.needs_xc():
+    if not (ssuper.is_meta() or ssuper.is_c_hybrid() or ssuper.is_x_lrc() or ssuper.needs_vv10()):
         procedures['hessian'][key] = proc.run_scf_hessian
 
 # Integrate CFOUR with driver routines
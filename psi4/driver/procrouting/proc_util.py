@@ -96,7 +96,7 @@ def check_iwl_file_from_scf_type(scf_type, wfn):
     """
 
 
-    if scf_type in ['DF', 'DISK_DF', 'MEM_DF', 'CD', 'PK', 'DIRECT']:
+    if scf_type in ['DF', 'DISK_DF', 'MEM_DF', 'CD', 'PK', 'DIRECT', 'COSX']:
         mints = core.MintsHelper(wfn.basisset())
         if core.get_global_option("RELATIVISTIC") in ["X2C", "DKH"]:
             rel_bas = core.BasisSet.build(wfn.molecule(), "BASIS_RELATIVISTIC",
@@ -108,12 +108,20 @@ def check_iwl_file_from_scf_type(scf_type, wfn):
         mints.set_print(1)
         mints.integrals()
 
+def cctransort_direct_tei():
+    """
+    Whether cctransort will compute the SO integrals directly, so that no IWL file is needed.
+    """
+
+    return (core.get_global_option('RUN_CCTRANSORT') and core.get_option('CCTRANSORT', 'DIRECT_TEI')
+            and core.get_option('CCTRANSORT', 'AO_BASIS') != 'DISK')
+
 def check_non_symmetric_jk_density(name):
     """
     Ensure non-symmetric density matrices are supported for the selected JK routine.
     """
     scf_type = core.get_global_option('SCF_TYPE')
-    supp_jk_type = ['DF', 'DISK_DF', 'MEM_DF', 'CD', 'PK', 'DIRECT', 'OUT_OF_CORE']
+    supp_jk_type = ['DF', 'DISK_DF', 'MEM_DF', 'CD', 'PK', 'DIRECT', 'OUT_OF_CORE', 'COSX']
     supp_string = ', '.join(supp_jk_type[:-1]) + ', or ' + supp_jk_type[-1] + '.'
 
     if scf_type not in supp_jk_type:
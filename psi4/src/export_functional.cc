@@ -55,7 +55,10 @@ void export_functional(py::module &m) {
         .def_static("XC_build", &SuperFunctional::XC_build, "Builds a SuperFunctional from a XC string.")
         .def("allocate", &SuperFunctional::allocate,
              "Allocates the vectors, should be called after ansatz or npoint changes.")
-        .def("compute_functional", &SuperFunctional::compute_functional, "Computes the SuperFunctional.")
+        .def("compute_functional",
+             static_cast<std::map<std::string, SharedVector>& (SuperFunctional::*)(
+                 const std::map<std::string, SharedVector>&, int)>(&SuperFunctional::compute_functional),
+             "Computes the SuperFunctional.")
         .def("x_functional", &SuperFunctional::x_functional, "Returns the desired X Functional.")
         .def("c_functional", &SuperFunctional::c_functional, "Returns the desired C Functional.")
         .def("x_functionals", &SuperFunctional::x_functionals, "Returns all X Functionals.")
@@ -119,7 +122,11 @@ void export_functional(py::module &m) {
 
     py::class_<Functional, std::shared_ptr<Functional>>(m, "Functional", "docstring")
         .def_static("build_base", &Functional::build_base, "alias"_a, "docstring")
-        .def("compute_functional", &Functional::compute_functional, "docstring")
+        .def("compute_functional",
+             static_cast<void (Functional::*)(const std::map<std::string, SharedVector>&,
+                                              const std::map<std::string, SharedVector>&, int, int)>(
+                 &Functional::compute_functional),
+             "docstring")
         .def("name", &Functional::name, "docstring")
         .def("description", &Functional::description, "docstring")
         .def("citation", &Functional::citation, "docstring")
@@ -266,7 +273,10 @@ void export_functional(py::module &m) {
         .def_static("build", [](std::shared_ptr<Molecule> &mol, std::shared_ptr<BasisSet> &basis,
                                 std::map<std::string, int> int_opts, std::map<std::string, std::string> string_opts) {
             return std::make_shared<DFTGrid>(mol, basis, int_opts, string_opts, Process::environment.options);
-        });
+        })
+        .def_static("clear_cache", &DFTGrid::clear_cache, "Drops the cached atomic and molecular grids.")
+        .def_static("cache_hits", &DFTGrid::cache_hits,
+                    "Number of grids served from the molecular grid cache since the last clear_cache.");
 
     py::class_<Dispersion, std::shared_ptr<Dispersion>>(m, "Dispersion", "docstring")
         .def_static("build", &Dispersion::build, "type"_a, "s6"_a = 0.0, "alpha6"_a = 0.0, "sr6"_a = 0.0,
@@ -912,7 +912,7 @@ void export_mints(py::module& m) {
     typedef SharedMatrix (MintsHelper::*normal_eri)();
     typedef SharedMatrix (MintsHelper::*normal_eri_factory)(std::shared_ptr<IntegralFactory>);
     typedef SharedMatrix (MintsHelper::*normal_eri2)(std::shared_ptr<BasisSet>, std::shared_ptr<BasisSet>,
-                                                     std::shared_ptr<BasisSet>, std::shared_ptr<BasisSet>);
+                                                     std::shared_ptr<BasisSet>, std::shared_ptr<BasisSet>, bool);
     typedef SharedMatrix (MintsHelper::*normal_3c)(std::shared_ptr<BasisSet>, std::shared_ptr<BasisSet>,
                                                    std::shared_ptr<BasisSet>);
 
@@ -989,7 +989,8 @@ void export_mints(py::module& m) {
 
         // Two-electron AO
         .def("ao_eri", normal_eri_factory(&MintsHelper::ao_eri), "AO ERI integrals", "factory"_a = nullptr)
-        .def("ao_eri", normal_eri2(&MintsHelper::ao_eri), "AO ERI integrals", "bs1"_a, "bs2"_a, "bs3"_a, "bs4"_a)
+        .def("ao_eri", normal_eri2(&MintsHelper::ao_eri), "AO ERI integrals", "bs1"_a, "bs2"_a, "bs3"_a, "bs4"_a,
+             "use_shell_pairs"_a = true)
         .def("ao_eri_shell", &MintsHelper::ao_eri_shell, "AO ERI Shell", "M"_a, "N"_a, "P"_a, "Q"_a)
         .def("ao_erf_eri", &MintsHelper::ao_erf_eri, "AO ERF integrals", "omega"_a, "factory"_a = nullptr)
         .def("ao_f12", normal_f12(&MintsHelper::ao_f12), "AO F12 integrals", "corr"_a)
@@ -1046,6 +1047,16 @@ void export_mints(py::module& m) {
              "factory"_a = nullptr)
         .def("ao_tei_deriv2", &MintsHelper::ao_tei_deriv2,
              "Hessian  of AO basis TEI integrals: returns (3 * natoms)^2 matrices")
+        .def("ao_oei_deriv1_all", &MintsHelper::ao_oei_deriv1_all,
+             "Gradient of AO basis OEI integrals for every atom in one pass: returns (3 * natoms) matrices",
+             "oei_type"_a)
+        .def("ao_tei_deriv1_all", &MintsHelper::ao_tei_deriv1_all,
+             "Gradient of AO basis TEI integrals for every atom in one pass: returns (3 * natoms) matrices",
+             "omega"_a = 0.0, "factory"_a = nullptr)
+        .def("ao_jk_deriv1", &MintsHelper::ao_jk_deriv1,
+             "Gradient of AO basis TEI integrals contracted with a density into J and K for every atom in one "
+             "pass: returns two lists of (3 * natoms) matrices",
+             "D"_a, "omega"_a = 0.0)
         .def("mo_oei_deriv1", &MintsHelper::mo_oei_deriv1,
              "Gradient of MO basis OEI integrals: returns (3 * natoms) matrices")
         .def("mo_oei_deriv2", &MintsHelper::mo_oei_deriv2,
@@ -1474,6 +1485,10 @@ void export_mints(py::module& m) {
         .def("addBasis", &ExternalPotential::addBasis, "Add a basis of S auxiliary functions iwth Df coefficients",
              "basis"_a, "coefs"_a)
         .def("clear", &ExternalPotential::clear, "Reset the field to zero (eliminates all entries)")
+        .def("setFarFieldTheta", &ExternalPotential::setFarFieldTheta,
+             "Treat distant point charges through a multipole tree with the given opening angle (0.0 is exact)",
+             "theta"_a)
+        .def("farFieldTheta", &ExternalPotential::farFieldTheta, "Opening angle of the far-field charge tree")
         .def("computePotentialMatrix", &ExternalPotential::computePotentialMatrix,
              "Compute the external potential matrix in the given basis set", "basis"_a)
         .def("print_out", &ExternalPotential::py_print, "Print python print helper to the outfile");
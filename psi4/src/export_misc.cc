@@ -37,6 +37,14 @@ namespace py = pybind11;
 void export_misc(py::module &m) {
     m.def("timer_on", timer_on, "Start timer with argument as label");
     m.def("timer_off", timer_off, "Stop timer of label argument");
+    m.def("trace_timers_enable", trace_timers_enable, "Switch per-thread trace timer recording on or off",
+          py::arg("enable"), py::arg("capacity") = 1L << 18);
+    m.def("trace_timers_enabled", trace_timers_enabled, "Whether trace timers are being recorded");
+    m.def("trace_timers_clear", trace_timers_clear, "Drop all recorded trace timer events");
+    m.def("trace_timers_write_chrome", trace_timers_write_chrome,
+          "Write the trace timer timeline in Chrome trace-event format to the given file");
+    m.def("trace_timers_write_json", trace_timers_write_json,
+          "Write per-key trace timer totals as JSON to the given file");
     m.def("tstart", tstart, "docstring");
     m.def("tstop", tstop, "docstring");
 }
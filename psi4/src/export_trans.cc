@@ -156,6 +156,8 @@ void export_trans(py::module& m) {
         .def("get_keep_dpd_so_ints", &IntegralTransform::get_keep_dpd_so_ints)
         .def("set_keep_iwl_so_ints", &IntegralTransform::set_keep_iwl_so_ints)
         .def("get_keep_iwl_so_ints", &IntegralTransform::get_keep_iwl_so_ints)
+        .def("set_direct_tei", &IntegralTransform::set_direct_tei)
+        .def("get_direct_tei", &IntegralTransform::get_direct_tei)
         .def("set_tpdm_already_presorted", &IntegralTransform::set_tpdm_already_presorted)
         .def("get_tei_already_presorted", &IntegralTransform::get_tei_already_presorted)
         .def("set_tei_already_presorted", &IntegralTransform::set_tei_already_presorted)
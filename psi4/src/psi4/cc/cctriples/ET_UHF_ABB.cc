@@ -33,6 +33,11 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cmath>
+#include <array>
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 #include "psi4/libdpd/dpd.h"
 #include "psi4/libqt/qt.h"
 #include "MOInfo.h"
@@ -43,37 +48,24 @@
 namespace psi {
 namespace cctriples {
 
+int threadprep(long int thread_mem_estimate);
+void threaddone();
+
 double ET_UHF_ABB() {
     int cnt;
     int h, nirreps;
-    int Gi, Gj, Gk, Ga, Gb, Gc, Gd, Gl;
+    int Gi, Gj, Gk;
     int Gji, Gij, Gjk, Gkj, Gik, Gki, Gijk;
-    int Gab, Gbc, Gac, Gca, Gba;
-    int Gid, Gjd, Gkd;
-    int Gil, Gjl, Gkl;
-    int I, J, K, A, B, C;
-    int i, j, k, a, b, c;
-    int ij, ji, ik, ki, jk, kj;
-    int ab, ba, ac, ca, bc, cb;
-    int cd, bd, ad, db, dc;
-    int lc, lb, la;
-    int id, jd, kd;
-    int il, jl, kl;
+    int ba, ca, cb;
     int *aoccpi, *avirtpi, *aocc_off, *avir_off;
     int *boccpi, *bvirtpi, *bocc_off, *bvir_off;
-    double value_c, value_d, dijk, denom, ET_ABB;
-    int nrows, ncols, nlinks;
-    double t_ia, t_jb, t_jc, t_kb, t_kc;
-    double f_ia, f_jb, f_jc, f_kb, f_kc;
-    double D_jkbc, D_ikac, D_ikab, D_ijac, D_ijab;
-    double t_jkbc, t_ikac, t_ikab, t_ijac, t_ijab;
+    double value_c, value_d, ET_ABB;
     dpdbuf4 T2AB, T2BB, T2BA;
-    dpdbuf4 FBBints, FABints, FBAints;
     dpdbuf4 EBBints, EABints, EBAints;
     dpdbuf4 DBBints, DABints;
     dpdfile2 T1A, T1B, fIJ, fij, fAB, fab, fIA, fia;
-    double ***WAbc, ***VAbc, ***WAcb, ***WbAc, ***WcAb, ***WbcA;
-    int nijk, mijk;
+    int nijk;
+    int nthreads;
 
     nirreps = moinfo.nirreps;
     aoccpi = moinfo.aoccpi;
@@ -85,6 +77,14 @@ double ET_UHF_ABB() {
     bocc_off = moinfo.bocc_off;
     bvir_off = moinfo.bvir_off;
 
+    /* Each thread holds its own 6 W/V blocks plus one block of F integrals */
+    long int max_v = 0;
+    for (h = 0; h < nirreps; h++) {
+        if (avirtpi[h] > max_v) max_v = avirtpi[h];
+        if (bvirtpi[h] > max_v) max_v = bvirtpi[h];
+    }
+    nthreads = threadprep(7 * max_v * max_v * max_v);
+
     global_dpd_->file2_init(&fIJ, PSIF_CC_OEI, 0, 0, 0, "fIJ");
     global_dpd_->file2_init(&fij, PSIF_CC_OEI, 0, 2, 2, "fij");
     global_dpd_->file2_init(&fAB, PSIF_CC_OEI, 0, 1, 1, "fAB");
@@ -115,9 +115,15 @@ double ET_UHF_ABB() {
     global_dpd_->buf4_init(&T2AB, PSIF_CC_TAMPS, 0, 22, 28, 22, 28, 0, "tIjAb");
     global_dpd_->buf4_init(&T2BA, PSIF_CC_TAMPS, 0, 23, 29, 23, 29, 0, "tiJaB");
 
-    global_dpd_->buf4_init(&FBBints, PSIF_CC_FINTS, 0, 30, 15, 30, 15, 1, "F <ia|bc>");
-    global_dpd_->buf4_init(&FABints, PSIF_CC_FINTS, 0, 24, 28, 24, 28, 0, "F <Ia|Bc>");
-    global_dpd_->buf4_init(&FBAints, PSIF_CC_FINTS, 0, 27, 29, 27, 29, 0, "F <iA|bC>");
+    std::vector<dpdbuf4> FBBints_array(nthreads);
+    for (int thread = 0; thread < nthreads; ++thread)
+        global_dpd_->buf4_init(&FBBints_array[thread], PSIF_CC_FINTS, 0, 30, 15, 30, 15, 1, "F <ia|bc>");
+    std::vector<dpdbuf4> FABints_array(nthreads);
+    for (int thread = 0; thread < nthreads; ++thread)
+        global_dpd_->buf4_init(&FABints_array[thread], PSIF_CC_FINTS, 0, 24, 28, 24, 28, 0, "F <Ia|Bc>");
+    std::vector<dpdbuf4> FBAints_array(nthreads);
+    for (int thread = 0; thread < nthreads; ++thread)
+        global_dpd_->buf4_init(&FBAints_array[thread], PSIF_CC_FINTS, 0, 27, 29, 27, 29, 0, "F <iA|bC>");
 
     global_dpd_->buf4_init(&EBBints, PSIF_CC_EINTS, 0, 10, 30, 12, 30, 0, "E <ij||ka> (i>j,ka)");
     global_dpd_->buf4_init(&EABints, PSIF_CC_EINTS, 0, 22, 24, 22, 24, 0, "E <Ij|Ka>");
@@ -157,12 +163,12 @@ double ET_UHF_ABB() {
     for (Gi = 0; Gi < nirreps; Gi++)
         for (Gj = 0; Gj < nirreps; Gj++)
             for (Gk = 0; Gk < nirreps; Gk++)
-                for (i = 0; i < aoccpi[Gi]; i++) {
-                    I = aocc_off[Gi] + i;
-                    for (j = 0; j < boccpi[Gj]; j++) {
-                        J = bocc_off[Gj] + j;
-                        for (k = 0; k < boccpi[Gk]; k++) {
-                            K = bocc_off[Gk] + k;
+                for (int i = 0; i < aoccpi[Gi]; i++) {
+                    int I = aocc_off[Gi] + i;
+                    for (int j = 0; j < boccpi[Gj]; j++) {
+                        int J = bocc_off[Gj] + j;
+                        for (int k = 0; k < boccpi[Gk]; k++) {
+                            int K = bocc_off[Gk] + k;
 
                             if (J > K) nijk++;
                         }
@@ -173,18 +179,9 @@ double ET_UHF_ABB() {
     // ffile(&ijkfile,"ijk.dat",0);
     printer->Printf("Spin Case: ABB\n");
     printer->Printf("Number of IJK combintions: %d\n", nijk);
-    printer->Printf("\nCurrent IJK Combination:\n");
 
-    mijk = 0;
     ET_ABB = 0.0;
 
-    WAbc = (double ***)malloc(nirreps * sizeof(double **));
-    VAbc = (double ***)malloc(nirreps * sizeof(double **));
-    WAcb = (double ***)malloc(nirreps * sizeof(double **));
-    WbcA = (double ***)malloc(nirreps * sizeof(double **));
-    WcAb = (double ***)malloc(nirreps * sizeof(double **));
-    WbAc = (double ***)malloc(nirreps * sizeof(double **));
-
     for (Gi = 0; Gi < nirreps; Gi++) {
         for (Gj = 0; Gj < nirreps; Gj++) {
             for (Gk = 0; Gk < nirreps; Gk++) {
@@ -194,566 +191,597 @@ double ET_UHF_ABB() {
 
                 Gijk = Gi ^ Gj ^ Gk;
 
-                for (i = 0; i < aoccpi[Gi]; i++) {
-                    I = aocc_off[Gi] + i;
-                    for (j = 0; j < boccpi[Gj]; j++) {
-                        J = bocc_off[Gj] + j;
-                        for (k = 0; k < boccpi[Gk]; k++) {
-                            K = bocc_off[Gk] + k;
-
-                            if (J > K) {
-                                mijk++;
-                                printer->Printf("%d\n", mijk);
-
-                                ij = EABints.params->rowidx[I][J];
-                                ji = EBAints.params->rowidx[J][I];
-                                jk = EBBints.params->rowidx[J][K];
-                                kj = EBBints.params->rowidx[K][J];
-                                ik = EABints.params->rowidx[I][K];
-                                ki = EBAints.params->rowidx[K][I];
-
-                                dijk = 0.0;
-                                if (fIJ.params->rowtot[Gi]) dijk += fIJ.matrix[Gi][i][i];
-                                if (fij.params->rowtot[Gj]) dijk += fij.matrix[Gj][j][j];
-                                if (fij.params->rowtot[Gk]) dijk += fij.matrix[Gk][k][k];
+                std::vector<std::array<int, 3>> ijk_list;
+                for (int i = 0; i < aoccpi[Gi]; i++) {
+                    int I = aocc_off[Gi] + i;
+                    for (int j = 0; j < boccpi[Gj]; j++) {
+                        int J = bocc_off[Gj] + j;
+                        for (int k = 0; k < boccpi[Gk]; k++) {
+                            int K = bocc_off[Gk] + k;
 
-                                /* Begin connected triples */
-
-                                for (Gab = 0; Gab < nirreps; Gab++) {
-                                    Gc = Gab ^ Gijk;
-
-                                    WAbc[Gab] = global_dpd_->dpd_block_matrix(FABints.params->coltot[Gab], bvirtpi[Gc]);
-                                }
-
-                                for (Gd = 0; Gd < nirreps; Gd++) {
-                                    /* -t_jkcd * F_IdAb */
-                                    Gab = Gid = Gi ^ Gd;
-                                    Gc = Gjk ^ Gd;
-
-                                    cd = T2BB.col_offset[Gjk][Gc];
-                                    id = FABints.row_offset[Gid][I];
-
-                                    FABints.matrix[Gid] =
-                                        global_dpd_->dpd_block_matrix(bvirtpi[Gd], FABints.params->coltot[Gid]);
-                                    global_dpd_->buf4_mat_irrep_rd_block(&FABints, Gid, id, bvirtpi[Gd]);
+                            if (J > K) ijk_list.push_back({{i, j, k}});
+                        }
+                    }
+                }
 
-                                    nrows = FABints.params->coltot[Gid];
-                                    ncols = bvirtpi[Gc];
-                                    nlinks = bvirtpi[Gd];
+#pragma omp parallel num_threads(nthreads) reduction(+ : ET_ABB)
+                {
+                    int Ga, Gb, Gc, Gd, Gl;
+                    int Gab, Gbc, Gac, Gca, Gba;
+                    int Gid, Gjd, Gkd;
+                    int Gil, Gjl, Gkl;
+                    int I, J, K, A, B, C;
+                    int i, j, k, a, b, c;
+                    int ij, ji, ik, ki, jk, kj;
+                    int ab, ac, bc;
+                    int cd, bd, ad, db, dc;
+                    int lc, lb, la;
+                    int id, jd, kd;
+                    int il, jl, kl;
+                    double dijk, denom;
+                    int nrows, ncols, nlinks;
+                    double t_ia, t_jb, t_jc, t_kb, t_kc;
+                    double f_ia, f_jb, f_jc, f_kb, f_kc;
+                    double D_jkbc, D_ikac, D_ikab, D_ijac, D_ijab;
+                    double t_jkbc, t_ikac, t_ikab, t_ijac, t_ijab;
+                    int thread = 0;
+#ifdef _OPENMP
+                    thread = omp_get_thread_num();
+#endif
+                    dpdbuf4 &FBBints = FBBints_array[thread];
+                    dpdbuf4 &FABints = FABints_array[thread];
+                    dpdbuf4 &FBAints = FBAints_array[thread];
+                    double ***WAbc = (double ***)malloc(nirreps * sizeof(double **));
+                    double ***VAbc = (double ***)malloc(nirreps * sizeof(double **));
+                    double ***WAcb = (double ***)malloc(nirreps * sizeof(double **));
+                    double ***WbAc = (double ***)malloc(nirreps * sizeof(double **));
+                    double ***WcAb = (double ***)malloc(nirreps * sizeof(double **));
+                    double ***WbcA = (double ***)malloc(nirreps * sizeof(double **));
+
+#pragma omp for schedule(static)
+                    for (int n = 0; n < (int)ijk_list.size(); n++) {
+                        i = ijk_list[n][0];
+                        j = ijk_list[n][1];
+                        k = ijk_list[n][2];
+                        I = aocc_off[Gi] + i;
+                        J = bocc_off[Gj] + j;
+                        K = bocc_off[Gk] + k;
 
-                                    if (nrows && ncols && nlinks)
-                                        C_DGEMM('t', 't', nrows, ncols, nlinks, -1.0, &(FABints.matrix[Gid][0][0]),
-                                                nrows, &(T2BB.matrix[Gjk][jk][cd]), nlinks, 1.0, &(WAbc[Gab][0][0]),
-                                                ncols);
+                        ij = EABints.params->rowidx[I][J];
+                        ji = EBAints.params->rowidx[J][I];
+                        jk = EBBints.params->rowidx[J][K];
+                        kj = EBBints.params->rowidx[K][J];
+                        ik = EABints.params->rowidx[I][K];
+                        ki = EBAints.params->rowidx[K][I];
 
-                                    global_dpd_->free_dpd_block(FABints.matrix[Gid], bvirtpi[Gd],
-                                                                FABints.params->coltot[Gid]);
-                                }
+                        dijk = 0.0;
+                        if (fIJ.params->rowtot[Gi]) dijk += fIJ.matrix[Gi][i][i];
+                        if (fij.params->rowtot[Gj]) dijk += fij.matrix[Gj][j][j];
+                        if (fij.params->rowtot[Gk]) dijk += fij.matrix[Gk][k][k];
 
-                                for (Gl = 0; Gl < nirreps; Gl++) {
-                                    /* -t_IlAb E_jklc */
-                                    Gab = Gil = Gi ^ Gl;
-                                    Gc = Gjk ^ Gl;
+                        /* Begin connected triples */
 
-                                    lc = EBBints.col_offset[Gjk][Gl];
-                                    il = T2AB.row_offset[Gil][I];
+                        for (Gab = 0; Gab < nirreps; Gab++) {
+                            Gc = Gab ^ Gijk;
 
-                                    nrows = T2AB.params->coltot[Gil];
-                                    ncols = bvirtpi[Gc];
-                                    nlinks = boccpi[Gl];
+                            WAbc[Gab] = global_dpd_->dpd_block_matrix(FABints.params->coltot[Gab], bvirtpi[Gc]);
+                        }
 
-                                    if (nrows && ncols && nlinks)
-                                        C_DGEMM('t', 'n', nrows, ncols, nlinks, -1.0, &(T2AB.matrix[Gil][il][0]), nrows,
-                                                &(EBBints.matrix[Gjk][jk][lc]), ncols, 1.0, &(WAbc[Gab][0][0]), ncols);
-                                }
+                        for (Gd = 0; Gd < nirreps; Gd++) {
+                            /* -t_jkcd * F_IdAb */
+                            Gab = Gid = Gi ^ Gd;
+                            Gc = Gjk ^ Gd;
 
-                                for (Gab = 0; Gab < nirreps; Gab++) {
-                                    Gc = Gab ^ Gijk;
+                            cd = T2BB.col_offset[Gjk][Gc];
+                            id = FABints.row_offset[Gid][I];
 
-                                    WAcb[Gab] = global_dpd_->dpd_block_matrix(FABints.params->coltot[Gab], bvirtpi[Gc]);
-                                }
+                            FABints.matrix[Gid] =
+                                global_dpd_->dpd_block_matrix(bvirtpi[Gd], FABints.params->coltot[Gid]);
+#pragma omp critical
+                            global_dpd_->buf4_mat_irrep_rd_block(&FABints, Gid, id, bvirtpi[Gd]);
 
-                                for (Gd = 0; Gd < nirreps; Gd++) {
-                                    /* +t_jkbd * F_IdAc */
-                                    Gac = Gid = Gi ^ Gd;
-                                    Gb = Gjk ^ Gd;
+                            nrows = FABints.params->coltot[Gid];
+                            ncols = bvirtpi[Gc];
+                            nlinks = bvirtpi[Gd];
 
-                                    bd = T2BB.col_offset[Gjk][Gb];
-                                    id = FABints.row_offset[Gid][I];
+                            if (nrows && ncols && nlinks)
+                                C_DGEMM('t', 't', nrows, ncols, nlinks, -1.0, &(FABints.matrix[Gid][0][0]),
+                                        nrows, &(T2BB.matrix[Gjk][jk][cd]), nlinks, 1.0, &(WAbc[Gab][0][0]), ncols);
 
-                                    FABints.matrix[Gid] =
-                                        global_dpd_->dpd_block_matrix(bvirtpi[Gd], FABints.params->coltot[Gid]);
-                                    global_dpd_->buf4_mat_irrep_rd_block(&FABints, Gid, id, bvirtpi[Gd]);
+                            global_dpd_->free_dpd_block(FABints.matrix[Gid], bvirtpi[Gd], FABints.params->coltot[Gid]);
+                        }
 
-                                    nrows = FABints.params->coltot[Gid];
-                                    ncols = bvirtpi[Gb];
-                                    nlinks = bvirtpi[Gd];
+                        for (Gl = 0; Gl < nirreps; Gl++) {
+                            /* -t_IlAb E_jklc */
+                            Gab = Gil = Gi ^ Gl;
+                            Gc = Gjk ^ Gl;
 
-                                    if (nrows && ncols && nlinks)
-                                        C_DGEMM('t', 't', nrows, ncols, nlinks, 1.0, &(FABints.matrix[Gid][0][0]),
-                                                nrows, &(T2BB.matrix[Gjk][jk][bd]), nlinks, 1.0, &(WAcb[Gac][0][0]),
-                                                ncols);
+                            lc = EBBints.col_offset[Gjk][Gl];
+                            il = T2AB.row_offset[Gil][I];
 
-                                    global_dpd_->free_dpd_block(FABints.matrix[Gid], bvirtpi[Gd],
-                                                                FABints.params->coltot[Gid]);
-                                }
+                            nrows = T2AB.params->coltot[Gil];
+                            ncols = bvirtpi[Gc];
+                            nlinks = boccpi[Gl];
 
-                                for (Gl = 0; Gl < nirreps; Gl++) {
-                                    /* +t_IlAc E_jklb */
-                                    Gac = Gil = Gi ^ Gl;
-                                    Gb = Gjk ^ Gl;
+                            if (nrows && ncols && nlinks)
+                                C_DGEMM('t', 'n', nrows, ncols, nlinks, -1.0, &(T2AB.matrix[Gil][il][0]), nrows,
+                                        &(EBBints.matrix[Gjk][jk][lc]), ncols, 1.0, &(WAbc[Gab][0][0]), ncols);
+                        }
 
-                                    lb = EBBints.col_offset[Gjk][Gl];
-                                    il = T2AB.row_offset[Gil][I];
+                        for (Gab = 0; Gab < nirreps; Gab++) {
+                            Gc = Gab ^ Gijk;
 
-                                    nrows = T2AB.params->coltot[Gil];
-                                    ncols = bvirtpi[Gb];
-                                    nlinks = boccpi[Gl];
+                            WAcb[Gab] = global_dpd_->dpd_block_matrix(FABints.params->coltot[Gab], bvirtpi[Gc]);
+                        }
 
-                                    if (nrows && ncols && nlinks)
-                                        C_DGEMM('t', 'n', nrows, ncols, nlinks, 1.0, &(T2AB.matrix[Gil][il][0]), nrows,
-                                                &(EBBints.matrix[Gjk][jk][lb]), ncols, 1.0, &(WAcb[Gac][0][0]), ncols);
-                                }
+                        for (Gd = 0; Gd < nirreps; Gd++) {
+                            /* +t_jkbd * F_IdAc */
+                            Gac = Gid = Gi ^ Gd;
+                            Gb = Gjk ^ Gd;
 
-                                global_dpd_->sort_3d(WAcb, WAbc, nirreps, Gijk, FABints.params->coltot,
-                                                     FABints.params->colidx, FABints.params->colorb,
-                                                     FABints.params->rsym, FABints.params->ssym, avir_off, bvir_off,
-                                                     bvirtpi, bvir_off, FABints.params->colidx, acb, 1);
+                            bd = T2BB.col_offset[Gjk][Gb];
+                            id = FABints.row_offset[Gid][I];
 
-                                for (Gab = 0; Gab < nirreps; Gab++) {
-                                    Gc = Gab ^ Gijk;
+                            FABints.matrix[Gid] =
+                                global_dpd_->dpd_block_matrix(bvirtpi[Gd], FABints.params->coltot[Gid]);
+#pragma omp critical
+                            global_dpd_->buf4_mat_irrep_rd_block(&FABints, Gid, id, bvirtpi[Gd]);
 
-                                    global_dpd_->free_dpd_block(WAcb[Gab], FABints.params->coltot[Gab], bvirtpi[Gc]);
+                            nrows = FABints.params->coltot[Gid];
+                            ncols = bvirtpi[Gb];
+                            nlinks = bvirtpi[Gd];
 
-                                    WbcA[Gab] = global_dpd_->dpd_block_matrix(FBBints.params->coltot[Gab], avirtpi[Gc]);
-                                }
+                            if (nrows && ncols && nlinks)
+                                C_DGEMM('t', 't', nrows, ncols, nlinks, 1.0, &(FABints.matrix[Gid][0][0]),
+                                        nrows, &(T2BB.matrix[Gjk][jk][bd]), nlinks, 1.0, &(WAcb[Gac][0][0]), ncols);
 
-                                for (Gd = 0; Gd < nirreps; Gd++) {
-                                    /* +t_IkAd * F_jdbc */
-                                    Gbc = Gjd = Gj ^ Gd;
-                                    Ga = Gik ^ Gd;
+                            global_dpd_->free_dpd_block(FABints.matrix[Gid], bvirtpi[Gd], FABints.params->coltot[Gid]);
+                        }
 
-                                    ad = T2AB.col_offset[Gik][Ga];
-                                    jd = FBBints.row_offset[Gjd][J];
+                        for (Gl = 0; Gl < nirreps; Gl++) {
+                            /* +t_IlAc E_jklb */
+                            Gac = Gil = Gi ^ Gl;
+                            Gb = Gjk ^ Gl;
 
-                                    FBBints.matrix[Gjd] =
-                                        global_dpd_->dpd_block_matrix(bvirtpi[Gd], FBBints.params->coltot[Gjd]);
-                                    global_dpd_->buf4_mat_irrep_rd_block(&FBBints, Gjd, jd, bvirtpi[Gd]);
+                            lb = EBBints.col_offset[Gjk][Gl];
+                            il = T2AB.row_offset[Gil][I];
 
-                                    nrows = FBBints.params->coltot[Gjd];
-                                    ncols = avirtpi[Ga];
-                                    nlinks = bvirtpi[Gd];
+                            nrows = T2AB.params->coltot[Gil];
+                            ncols = bvirtpi[Gb];
+                            nlinks = boccpi[Gl];
 
-                                    if (nrows && ncols && nlinks)
-                                        C_DGEMM('t', 't', nrows, ncols, nlinks, 1.0, &(FBBints.matrix[Gjd][0][0]),
-                                                nrows, &(T2AB.matrix[Gik][ik][ad]), nlinks, 1.0, &(WbcA[Gbc][0][0]),
-                                                ncols);
+                            if (nrows && ncols && nlinks)
+                                C_DGEMM('t', 'n', nrows, ncols, nlinks, 1.0, &(T2AB.matrix[Gil][il][0]), nrows,
+                                        &(EBBints.matrix[Gjk][jk][lb]), ncols, 1.0, &(WAcb[Gac][0][0]), ncols);
+                        }
 
-                                    global_dpd_->free_dpd_block(FBBints.matrix[Gjd], bvirtpi[Gd],
-                                                                FBBints.params->coltot[Gjd]);
+                        global_dpd_->sort_3d(WAcb, WAbc, nirreps, Gijk, FABints.params->coltot,
+                                             FABints.params->colidx, FABints.params->colorb,
+                                             FABints.params->rsym, FABints.params->ssym, avir_off, bvir_off,
+                                             bvirtpi, bvir_off, FABints.params->colidx, acb, 1);
 
-                                    /* -t_IjAd * F_kdbc */
-                                    Gbc = Gkd = Gk ^ Gd;
-                                    Ga = Gij ^ Gd;
+                        for (Gab = 0; Gab < nirreps; Gab++) {
+                            Gc = Gab ^ Gijk;
 
-                                    ad = T2AB.col_offset[Gij][Ga];
-                                    kd = FBBints.row_offset[Gkd][K];
+                            global_dpd_->free_dpd_block(WAcb[Gab], FABints.params->coltot[Gab], bvirtpi[Gc]);
 
-                                    FBBints.matrix[Gkd] =
-                                        global_dpd_->dpd_block_matrix(bvirtpi[Gd], FBBints.params->coltot[Gkd]);
-                                    global_dpd_->buf4_mat_irrep_rd_block(&FBBints, Gkd, kd, bvirtpi[Gd]);
+                            WbcA[Gab] = global_dpd_->dpd_block_matrix(FBBints.params->coltot[Gab], avirtpi[Gc]);
+                        }
 
-                                    nrows = FBBints.params->coltot[Gkd];
-                                    ncols = avirtpi[Ga];
-                                    nlinks = bvirtpi[Gd];
+                        for (Gd = 0; Gd < nirreps; Gd++) {
+                            /* +t_IkAd * F_jdbc */
+                            Gbc = Gjd = Gj ^ Gd;
+                            Ga = Gik ^ Gd;
 
-                                    if (nrows && ncols && nlinks)
-                                        C_DGEMM('t', 't', nrows, ncols, nlinks, -1.0, &(FBBints.matrix[Gkd][0][0]),
-                                                nrows, &(T2AB.matrix[Gij][ij][ad]), nlinks, 1.0, &(WbcA[Gbc][0][0]),
-                                                ncols);
+                            ad = T2AB.col_offset[Gik][Ga];
+                            jd = FBBints.row_offset[Gjd][J];
 
-                                    global_dpd_->free_dpd_block(FBBints.matrix[Gkd], bvirtpi[Gd],
-                                                                FBBints.params->coltot[Gkd]);
-                                }
+                            FBBints.matrix[Gjd] =
+                                global_dpd_->dpd_block_matrix(bvirtpi[Gd], FBBints.params->coltot[Gjd]);
+#pragma omp critical
+                            global_dpd_->buf4_mat_irrep_rd_block(&FBBints, Gjd, jd, bvirtpi[Gd]);
 
-                                for (Gl = 0; Gl < nirreps; Gl++) {
-                                    /* -t_jlbc E_kIlA */
-                                    Gbc = Gjl = Gj ^ Gl;
-                                    Ga = Gki ^ Gl;
+                            nrows = FBBints.params->coltot[Gjd];
+                            ncols = avirtpi[Ga];
+                            nlinks = bvirtpi[Gd];
 
-                                    la = EBAints.col_offset[Gki][Gl];
-                                    jl = T2BB.row_offset[Gjl][J];
+                            if (nrows && ncols && nlinks)
+                                C_DGEMM('t', 't', nrows, ncols, nlinks, 1.0, &(FBBints.matrix[Gjd][0][0]),
+                                        nrows, &(T2AB.matrix[Gik][ik][ad]), nlinks, 1.0, &(WbcA[Gbc][0][0]), ncols);
 
-                                    nrows = T2BB.params->coltot[Gjl];
-                                    ncols = avirtpi[Ga];
-                                    nlinks = boccpi[Gl];
+                            global_dpd_->free_dpd_block(FBBints.matrix[Gjd], bvirtpi[Gd], FBBints.params->coltot[Gjd]);
 
-                                    if (nrows && ncols && nlinks)
-                                        C_DGEMM('t', 'n', nrows, ncols, nlinks, -1.0, &(T2BB.matrix[Gjl][jl][0]), nrows,
-                                                &(EBAints.matrix[Gki][ki][la]), ncols, 1.0, &(WbcA[Gbc][0][0]), ncols);
+                            /* -t_IjAd * F_kdbc */
+                            Gbc = Gkd = Gk ^ Gd;
+                            Ga = Gij ^ Gd;
 
-                                    /* +t_klbc E_jIlA */
-                                    Gbc = Gkl = Gk ^ Gl;
-                                    Ga = Gji ^ Gl;
+                            ad = T2AB.col_offset[Gij][Ga];
+                            kd = FBBints.row_offset[Gkd][K];
 
-                                    la = EBAints.col_offset[Gji][Gl];
-                                    kl = T2BB.row_offset[Gkl][K];
+                            FBBints.matrix[Gkd] =
+                                global_dpd_->dpd_block_matrix(bvirtpi[Gd], FBBints.params->coltot[Gkd]);
+#pragma omp critical
+                            global_dpd_->buf4_mat_irrep_rd_block(&FBBints, Gkd, kd, bvirtpi[Gd]);
 
-                                    nrows = T2BB.params->coltot[Gkl];
-                                    ncols = avirtpi[Ga];
-                                    nlinks = boccpi[Gl];
+                            nrows = FBBints.params->coltot[Gkd];
+                            ncols = avirtpi[Ga];
+                            nlinks = bvirtpi[Gd];
 
-                                    if (nrows && ncols && nlinks)
-                                        C_DGEMM('t', 'n', nrows, ncols, nlinks, 1.0, &(T2BB.matrix[Gkl][kl][0]), nrows,
-                                                &(EBAints.matrix[Gji][ji][la]), ncols, 1.0, &(WbcA[Gbc][0][0]), ncols);
-                                }
+                            if (nrows && ncols && nlinks)
+                                C_DGEMM('t', 't', nrows, ncols, nlinks, -1.0, &(FBBints.matrix[Gkd][0][0]),
+                                        nrows, &(T2AB.matrix[Gij][ij][ad]), nlinks, 1.0, &(WbcA[Gbc][0][0]), ncols);
 
-                                global_dpd_->sort_3d(WbcA, WAbc, nirreps, Gijk, FBBints.params->coltot,
-                                                     FBBints.params->colidx, FBBints.params->colorb,
-                                                     FBBints.params->rsym, FBBints.params->ssym, bvir_off, bvir_off,
-                                                     avirtpi, avir_off, FABints.params->colidx, cab, 1);
+                            global_dpd_->free_dpd_block(FBBints.matrix[Gkd], bvirtpi[Gd], FBBints.params->coltot[Gkd]);
+                        }
 
-                                for (Gab = 0; Gab < nirreps; Gab++) {
-                                    Gc = Gab ^ Gijk;
+                        for (Gl = 0; Gl < nirreps; Gl++) {
+                            /* -t_jlbc E_kIlA */
+                            Gbc = Gjl = Gj ^ Gl;
+                            Ga = Gki ^ Gl;
 
-                                    global_dpd_->free_dpd_block(WbcA[Gab], FBBints.params->coltot[Gab], avirtpi[Gc]);
+                            la = EBAints.col_offset[Gki][Gl];
+                            jl = T2BB.row_offset[Gjl][J];
 
-                                    WcAb[Gab] = global_dpd_->dpd_block_matrix(FBAints.params->coltot[Gab], bvirtpi[Gc]);
-                                }
+                            nrows = T2BB.params->coltot[Gjl];
+                            ncols = avirtpi[Ga];
+                            nlinks = boccpi[Gl];
 
-                                for (Gd = 0; Gd < nirreps; Gd++) {
-                                    /* -t_IkDb * F_jDcA */
-                                    Gca = Gjd = Gj ^ Gd;
-                                    Gb = Gik ^ Gd;
+                            if (nrows && ncols && nlinks)
+                                C_DGEMM('t', 'n', nrows, ncols, nlinks, -1.0, &(T2BB.matrix[Gjl][jl][0]), nrows,
+                                        &(EBAints.matrix[Gki][ki][la]), ncols, 1.0, &(WbcA[Gbc][0][0]), ncols);
 
-                                    db = T2AB.col_offset[Gik][Gd];
-                                    jd = FBAints.row_offset[Gjd][J];
+                            /* +t_klbc E_jIlA */
+                            Gbc = Gkl = Gk ^ Gl;
+                            Ga = Gji ^ Gl;
 
-                                    FBAints.matrix[Gjd] =
-                                        global_dpd_->dpd_block_matrix(avirtpi[Gd], FBAints.params->coltot[Gjd]);
-                                    global_dpd_->buf4_mat_irrep_rd_block(&FBAints, Gjd, jd, avirtpi[Gd]);
+                            la = EBAints.col_offset[Gji][Gl];
+                            kl = T2BB.row_offset[Gkl][K];
 
-                                    nrows = FBAints.params->coltot[Gjd];
-                                    ncols = bvirtpi[Gb];
-                                    nlinks = avirtpi[Gd];
+                            nrows = T2BB.params->coltot[Gkl];
+                            ncols = avirtpi[Ga];
+                            nlinks = boccpi[Gl];
 
-                                    if (nrows && ncols && nlinks)
-                                        C_DGEMM('t', 'n', nrows, ncols, nlinks, -1.0, &(FBAints.matrix[Gjd][0][0]),
-                                                nrows, &(T2AB.matrix[Gik][ik][db]), ncols, 1.0, &(WcAb[Gca][0][0]),
-                                                ncols);
+                            if (nrows && ncols && nlinks)
+                                C_DGEMM('t', 'n', nrows, ncols, nlinks, 1.0, &(T2BB.matrix[Gkl][kl][0]), nrows,
+                                        &(EBAints.matrix[Gji][ji][la]), ncols, 1.0, &(WbcA[Gbc][0][0]), ncols);
+                        }
 
-                                    global_dpd_->free_dpd_block(FBAints.matrix[Gjd], avirtpi[Gd],
-                                                                FBAints.params->coltot[Gjd]);
+                        global_dpd_->sort_3d(WbcA, WAbc, nirreps, Gijk, FBBints.params->coltot,
+                                             FBBints.params->colidx, FBBints.params->colorb,
+                                             FBBints.params->rsym, FBBints.params->ssym, bvir_off, bvir_off,
+                                             avirtpi, avir_off, FABints.params->colidx, cab, 1);
 
-                                    /* +t_IjDb * F_kDcA */
-                                    Gca = Gkd = Gk ^ Gd;
-                                    Gb = Gij ^ Gd;
+                        for (Gab = 0; Gab < nirreps; Gab++) {
+                            Gc = Gab ^ Gijk;
 
-                                    db = T2AB.col_offset[Gij][Gd];
-                                    kd = FBAints.row_offset[Gkd][K];
+                            global_dpd_->free_dpd_block(WbcA[Gab], FBBints.params->coltot[Gab], avirtpi[Gc]);
 
-                                    FBAints.matrix[Gkd] =
-                                        global_dpd_->dpd_block_matrix(avirtpi[Gd], FBAints.params->coltot[Gkd]);
-                                    global_dpd_->buf4_mat_irrep_rd_block(&FBAints, Gkd, kd, avirtpi[Gd]);
+                            WcAb[Gab] = global_dpd_->dpd_block_matrix(FBAints.params->coltot[Gab], bvirtpi[Gc]);
+                        }
 
-                                    nrows = FBAints.params->coltot[Gkd];
-                                    ncols = bvirtpi[Gb];
-                                    nlinks = avirtpi[Gd];
+                        for (Gd = 0; Gd < nirreps; Gd++) {
+                            /* -t_IkDb * F_jDcA */
+                            Gca = Gjd = Gj ^ Gd;
+                            Gb = Gik ^ Gd;
 
-                                    if (nrows && ncols && nlinks)
-                                        C_DGEMM('t', 'n', nrows, ncols, nlinks, 1.0, &(FBAints.matrix[Gkd][0][0]),
-                                                nrows, &(T2AB.matrix[Gij][ij][db]), ncols, 1.0, &(WcAb[Gca][0][0]),
-                                                ncols);
+                            db = T2AB.col_offset[Gik][Gd];
+                            jd = FBAints.row_offset[Gjd][J];
 
-                                    global_dpd_->free_dpd_block(FBAints.matrix[Gkd], avirtpi[Gd],
-                                                                FBAints.params->coltot[Gkd]);
-                                }
+                            FBAints.matrix[Gjd] =
+                                global_dpd_->dpd_block_matrix(avirtpi[Gd], FBAints.params->coltot[Gjd]);
+#pragma omp critical
+                            global_dpd_->buf4_mat_irrep_rd_block(&FBAints, Gjd, jd, avirtpi[Gd]);
 
-                                for (Gl = 0; Gl < nirreps; Gl++) {
-                                    /* +t_jLcA E_IkLb */
-                                    Gca = Gjl = Gj ^ Gl;
-                                    Gb = Gik ^ Gl;
+                            nrows = FBAints.params->coltot[Gjd];
+                            ncols = bvirtpi[Gb];
+                            nlinks = avirtpi[Gd];
 
-                                    lb = EABints.col_offset[Gik][Gl];
-                                    jl = T2BA.row_offset[Gjl][J];
+                            if (nrows && ncols && nlinks)
+                                C_DGEMM('t', 'n', nrows, ncols, nlinks, -1.0, &(FBAints.matrix[Gjd][0][0]),
+                                        nrows, &(T2AB.matrix[Gik][ik][db]), ncols, 1.0, &(WcAb[Gca][0][0]), ncols);
 
-                                    nrows = T2BA.params->coltot[Gjl];
-                                    ncols = bvirtpi[Gb];
-                                    nlinks = aoccpi[Gl];
+                            global_dpd_->free_dpd_block(FBAints.matrix[Gjd], avirtpi[Gd], FBAints.params->coltot[Gjd]);
 
-                                    if (nrows && ncols && nlinks)
-                                        C_DGEMM('t', 'n', nrows, ncols, nlinks, 1.0, &(T2BA.matrix[Gjl][jl][0]), nrows,
-                                                &(EABints.matrix[Gik][ik][lb]), ncols, 1.0, &(WcAb[Gca][0][0]), ncols);
+                            /* +t_IjDb * F_kDcA */
+                            Gca = Gkd = Gk ^ Gd;
+                            Gb = Gij ^ Gd;
 
-                                    /* -t_kLcA E_IjLb */
-                                    Gca = Gkl = Gk ^ Gl;
-                                    Gb = Gij ^ Gl;
+                            db = T2AB.col_offset[Gij][Gd];
+                            kd = FBAints.row_offset[Gkd][K];
 
-                                    lb = EABints.col_offset[Gij][Gl];
-                                    kl = T2BA.row_offset[Gkl][K];
+                            FBAints.matrix[Gkd] =
+                                global_dpd_->dpd_block_matrix(avirtpi[Gd], FBAints.params->coltot[Gkd]);
+#pragma omp critical
+                            global_dpd_->buf4_mat_irrep_rd_block(&FBAints, Gkd, kd, avirtpi[Gd]);
 
-                                    nrows = T2BA.params->coltot[Gkl];
-                                    ncols = bvirtpi[Gb];
-                                    nlinks = aoccpi[Gl];
+                            nrows = FBAints.params->coltot[Gkd];
+                            ncols = bvirtpi[Gb];
+                            nlinks = avirtpi[Gd];
 
-                                    if (nrows && ncols && nlinks)
-                                        C_DGEMM('t', 'n', nrows, ncols, nlinks, -1.0, &(T2BA.matrix[Gkl][kl][0]), nrows,
-                                                &(EABints.matrix[Gij][ij][lb]), ncols, 1.0, &(WcAb[Gca][0][0]), ncols);
-                                }
+                            if (nrows && ncols && nlinks)
+                                C_DGEMM('t', 'n', nrows, ncols, nlinks, 1.0, &(FBAints.matrix[Gkd][0][0]),
+                                        nrows, &(T2AB.matrix[Gij][ij][db]), ncols, 1.0, &(WcAb[Gca][0][0]), ncols);
 
-                                global_dpd_->sort_3d(WcAb, WAbc, nirreps, Gijk, FBAints.params->coltot,
-                                                     FBAints.params->colidx, FBAints.params->colorb,
-                                                     FBAints.params->rsym, FBAints.params->ssym, bvir_off, avir_off,
-                                                     bvirtpi, bvir_off, FABints.params->colidx, bca, 1);
+                            global_dpd_->free_dpd_block(FBAints.matrix[Gkd], avirtpi[Gd], FBAints.params->coltot[Gkd]);
+                        }
 
-                                for (Gab = 0; Gab < nirreps; Gab++) {
-                                    Gc = Gab ^ Gijk;
+                        for (Gl = 0; Gl < nirreps; Gl++) {
+                            /* +t_jLcA E_IkLb */
+                            Gca = Gjl = Gj ^ Gl;
+                            Gb = Gik ^ Gl;
 
-                                    global_dpd_->free_dpd_block(WcAb[Gab], FBAints.params->coltot[Gab], bvirtpi[Gc]);
+                            lb = EABints.col_offset[Gik][Gl];
+                            jl = T2BA.row_offset[Gjl][J];
 
-                                    WbAc[Gab] = global_dpd_->dpd_block_matrix(FBAints.params->coltot[Gab], bvirtpi[Gc]);
-                                }
+                            nrows = T2BA.params->coltot[Gjl];
+                            ncols = bvirtpi[Gb];
+                            nlinks = aoccpi[Gl];
 
-                                for (Gd = 0; Gd < nirreps; Gd++) {
-                                    /* +t_IkDc * F_jDbA */
-                                    Gba = Gjd = Gj ^ Gd;
-                                    Gc = Gik ^ Gd;
+                            if (nrows && ncols && nlinks)
+                                C_DGEMM('t', 'n', nrows, ncols, nlinks, 1.0, &(T2BA.matrix[Gjl][jl][0]), nrows,
+                                        &(EABints.matrix[Gik][ik][lb]), ncols, 1.0, &(WcAb[Gca][0][0]), ncols);
 
-                                    dc = T2AB.col_offset[Gik][Gd];
-                                    jd = FBAints.row_offset[Gjd][J];
+                            /* -t_kLcA E_IjLb */
+                            Gca = Gkl = Gk ^ Gl;
+                            Gb = Gij ^ Gl;
 
-                                    FBAints.matrix[Gjd] =
-                                        global_dpd_->dpd_block_matrix(avirtpi[Gd], FBAints.params->coltot[Gjd]);
-                                    global_dpd_->buf4_mat_irrep_rd_block(&FBAints, Gjd, jd, avirtpi[Gd]);
+                            lb = EABints.col_offset[Gij][Gl];
+                            kl = T2BA.row_offset[Gkl][K];
 
-                                    nrows = FBAints.params->coltot[Gjd];
-                                    ncols = bvirtpi[Gc];
-                                    nlinks = avirtpi[Gd];
+                            nrows = T2BA.params->coltot[Gkl];
+                            ncols = bvirtpi[Gb];
+                            nlinks = aoccpi[Gl];
 
-                                    if (nrows && ncols && nlinks)
-                                        C_DGEMM('t', 'n', nrows, ncols, nlinks, 1.0, &(FBAints.matrix[Gjd][0][0]),
-                                                nrows, &(T2AB.matrix[Gik][ik][dc]), ncols, 1.0, &(WbAc[Gba][0][0]),
-                                                ncols);
+                            if (nrows && ncols && nlinks)
+                                C_DGEMM('t', 'n', nrows, ncols, nlinks, -1.0, &(T2BA.matrix[Gkl][kl][0]), nrows,
+                                        &(EABints.matrix[Gij][ij][lb]), ncols, 1.0, &(WcAb[Gca][0][0]), ncols);
+                        }
 
-                                    global_dpd_->free_dpd_block(FBAints.matrix[Gjd], avirtpi[Gd],
-                                                                FBAints.params->coltot[Gjd]);
+                        global_dpd_->sort_3d(WcAb, WAbc, nirreps, Gijk, FBAints.params->coltot,
+                                             FBAints.params->colidx, FBAints.params->colorb,
+                                             FBAints.params->rsym, FBAints.params->ssym, bvir_off, avir_off,
+                                             bvirtpi, bvir_off, FABints.params->colidx, bca, 1);
 
-                                    /* -t_IjDc * F_kDbA */
-                                    Gba = Gkd = Gk ^ Gd;
-                                    Gc = Gij ^ Gd;
+                        for (Gab = 0; Gab < nirreps; Gab++) {
+                            Gc = Gab ^ Gijk;
 
-                                    dc = T2AB.col_offset[Gij][Gd];
-                                    kd = FBAints.row_offset[Gkd][K];
+                            global_dpd_->free_dpd_block(WcAb[Gab], FBAints.params->coltot[Gab], bvirtpi[Gc]);
 
-                                    FBAints.matrix[Gkd] =
-                                        global_dpd_->dpd_block_matrix(avirtpi[Gd], FBAints.params->coltot[Gkd]);
-                                    global_dpd_->buf4_mat_irrep_rd_block(&FBAints, Gkd, kd, avirtpi[Gd]);
+                            WbAc[Gab] = global_dpd_->dpd_block_matrix(FBAints.params->coltot[Gab], bvirtpi[Gc]);
+                        }
 
-                                    nrows = FBAints.params->coltot[Gkd];
-                                    ncols = bvirtpi[Gc];
-                                    nlinks = avirtpi[Gd];
+                        for (Gd = 0; Gd < nirreps; Gd++) {
+                            /* +t_IkDc * F_jDbA */
+                            Gba = Gjd = Gj ^ Gd;
+                            Gc = Gik ^ Gd;
 
-                                    if (nrows && ncols && nlinks)
-                                        C_DGEMM('t', 'n', nrows, ncols, nlinks, -1.0, &(FBAints.matrix[Gkd][0][0]),
-                                                nrows, &(T2AB.matrix[Gij][ij][dc]), ncols, 1.0, &(WbAc[Gba][0][0]),
-                                                ncols);
+                            dc = T2AB.col_offset[Gik][Gd];
+                            jd = FBAints.row_offset[Gjd][J];
 
-                                    global_dpd_->free_dpd_block(FBAints.matrix[Gkd], avirtpi[Gd],
-                                                                FBAints.params->coltot[Gkd]);
-                                }
+                            FBAints.matrix[Gjd] =
+                                global_dpd_->dpd_block_matrix(avirtpi[Gd], FBAints.params->coltot[Gjd]);
+#pragma omp critical
+                            global_dpd_->buf4_mat_irrep_rd_block(&FBAints, Gjd, jd, avirtpi[Gd]);
 
-                                for (Gl = 0; Gl < nirreps; Gl++) {
-                                    /* -t_jLbA * E_IkLc */
-                                    Gba = Gjl = Gj ^ Gl;
-                                    Gc = Gik ^ Gl;
+                            nrows = FBAints.params->coltot[Gjd];
+                            ncols = bvirtpi[Gc];
+                            nlinks = avirtpi[Gd];
 
-                                    lc = EABints.col_offset[Gik][Gl];
-                                    jl = T2BA.row_offset[Gjl][J];
+                            if (nrows && ncols && nlinks)
+                                C_DGEMM('t', 'n', nrows, ncols, nlinks, 1.0, &(FBAints.matrix[Gjd][0][0]),
+                                        nrows, &(T2AB.matrix[Gik][ik][dc]), ncols, 1.0, &(WbAc[Gba][0][0]), ncols);
 
-                                    nrows = T2BA.params->coltot[Gjl];
-                                    ncols = bvirtpi[Gc];
-                                    nlinks = aoccpi[Gl];
+                            global_dpd_->free_dpd_block(FBAints.matrix[Gjd], avirtpi[Gd], FBAints.params->coltot[Gjd]);
 
-                                    if (nrows && ncols && nlinks)
-                                        C_DGEMM('t', 'n', nrows, ncols, nlinks, -1.0, &(T2BA.matrix[Gjl][jl][0]), nrows,
-                                                &(EABints.matrix[Gik][ik][lc]), ncols, 1.0, &(WbAc[Gba][0][0]), ncols);
+                            /* -t_IjDc * F_kDbA */
+                            Gba = Gkd = Gk ^ Gd;
+                            Gc = Gij ^ Gd;
 
-                                    /* +t_kLbA * E_IjLc */
-                                    Gba = Gkl = Gk ^ Gl;
-                                    Gc = Gij ^ Gl;
+                            dc = T2AB.col_offset[Gij][Gd];
+                            kd = FBAints.row_offset[Gkd][K];
 
-                                    lc = EABints.col_offset[Gij][Gl];
-                                    kl = T2BA.row_offset[Gkl][K];
+                            FBAints.matrix[Gkd] =
+                                global_dpd_->dpd_block_matrix(avirtpi[Gd], FBAints.params->coltot[Gkd]);
+#pragma omp critical
+                            global_dpd_->buf4_mat_irrep_rd_block(&FBAints, Gkd, kd, avirtpi[Gd]);
 
-                                    nrows = T2BA.params->coltot[Gkl];
-                                    ncols = bvirtpi[Gc];
-                                    nlinks = aoccpi[Gl];
+                            nrows = FBAints.params->coltot[Gkd];
+                            ncols = bvirtpi[Gc];
+                            nlinks = avirtpi[Gd];
 
-                                    if (nrows && ncols && nlinks)
-                                        C_DGEMM('t', 'n', nrows, ncols, nlinks, 1.0, &(T2BA.matrix[Gkl][kl][0]), nrows,
-                                                &(EABints.matrix[Gij][ij][lc]), ncols, 1.0, &(WbAc[Gba][0][0]), ncols);
-                                }
+                            if (nrows && ncols && nlinks)
+                                C_DGEMM('t', 'n', nrows, ncols, nlinks, -1.0, &(FBAints.matrix[Gkd][0][0]),
+                                        nrows, &(T2AB.matrix[Gij][ij][dc]), ncols, 1.0, &(WbAc[Gba][0][0]), ncols);
 
-                                global_dpd_->sort_3d(WbAc, WAbc, nirreps, Gijk, FBAints.params->coltot,
-                                                     FBAints.params->colidx, FBAints.params->colorb,
-                                                     FBAints.params->rsym, FBAints.params->ssym, bvir_off, avir_off,
-                                                     bvirtpi, bvir_off, FABints.params->colidx, bac, 1);
+                            global_dpd_->free_dpd_block(FBAints.matrix[Gkd], avirtpi[Gd], FBAints.params->coltot[Gkd]);
+                        }
 
-                                for (Gab = 0; Gab < nirreps; Gab++) {
-                                    Gc = Gab ^ Gijk;
+                        for (Gl = 0; Gl < nirreps; Gl++) {
+                            /* -t_jLbA * E_IkLc */
+                            Gba = Gjl = Gj ^ Gl;
+                            Gc = Gik ^ Gl;
 
-                                    global_dpd_->free_dpd_block(WbAc[Gab], FBAints.params->coltot[Gab], bvirtpi[Gc]);
-                                }
+                            lc = EABints.col_offset[Gik][Gl];
+                            jl = T2BA.row_offset[Gjl][J];
 
-                                /* Add disconnected triples and finish W and V */
-                                for (Gab = 0; Gab < nirreps; Gab++) {
-                                    Gc = Gab ^ Gijk;
+                            nrows = T2BA.params->coltot[Gjl];
+                            ncols = bvirtpi[Gc];
+                            nlinks = aoccpi[Gl];
 
-                                    VAbc[Gab] = global_dpd_->dpd_block_matrix(FABints.params->coltot[Gab], bvirtpi[Gc]);
+                            if (nrows && ncols && nlinks)
+                                C_DGEMM('t', 'n', nrows, ncols, nlinks, -1.0, &(T2BA.matrix[Gjl][jl][0]), nrows,
+                                        &(EABints.matrix[Gik][ik][lc]), ncols, 1.0, &(WbAc[Gba][0][0]), ncols);
 
-                                    for (ab = 0; ab < FABints.params->coltot[Gab]; ab++) {
-                                        A = FABints.params->colorb[Gab][ab][0];
-                                        Ga = FABints.params->rsym[A];
-                                        a = A - avir_off[Ga];
-                                        B = FABints.params->colorb[Gab][ab][1];
-                                        Gb = FABints.params->ssym[B];
-                                        b = B - bvir_off[Gb];
+                            /* +t_kLbA * E_IjLc */
+                            Gba = Gkl = Gk ^ Gl;
+                            Gc = Gij ^ Gl;
 
-                                        Gbc = Gb ^ Gc;
-                                        Gac = Ga ^ Gc;
+                            lc = EABints.col_offset[Gij][Gl];
+                            kl = T2BA.row_offset[Gkl][K];
 
-                                        for (c = 0; c < bvirtpi[Gc]; c++) {
-                                            C = bvir_off[Gc] + c;
+                            nrows = T2BA.params->coltot[Gkl];
+                            ncols = bvirtpi[Gc];
+                            nlinks = aoccpi[Gl];
 
-                                            bc = DBBints.params->colidx[B][C];
-                                            ac = DABints.params->colidx[A][C];
+                            if (nrows && ncols && nlinks)
+                                C_DGEMM('t', 'n', nrows, ncols, nlinks, 1.0, &(T2BA.matrix[Gkl][kl][0]), nrows,
+                                        &(EABints.matrix[Gij][ij][lc]), ncols, 1.0, &(WbAc[Gba][0][0]), ncols);
+                        }
 
-                                            /* +t_IA * D_jkbc + f_IA * t_jkbc */
-                                            if (Gi == Ga && Gjk == Gbc) {
-                                                t_ia = D_jkbc = f_ia = t_jkbc = 0.0;
-
-                                                if (T1A.params->rowtot[Gi] && T1A.params->coltot[Gi]) {
-                                                    t_ia = T1A.matrix[Gi][i][a];
-                                                    f_ia = fIA.matrix[Gi][i][a];
-                                                }
-
-                                                if (DBBints.params->rowtot[Gjk] && DBBints.params->coltot[Gjk]) {
-                                                    D_jkbc = DBBints.matrix[Gjk][jk][bc];
-                                                    t_jkbc = T2BB.matrix[Gjk][jk][bc];
-                                                }
-
-                                                VAbc[Gab][ab][c] += t_ia * D_jkbc + f_ia * t_jkbc;
-                                            }
+                        global_dpd_->sort_3d(WbAc, WAbc, nirreps, Gijk, FBAints.params->coltot,
+                                             FBAints.params->colidx, FBAints.params->colorb,
+                                             FBAints.params->rsym, FBAints.params->ssym, bvir_off, avir_off,
+                                             bvirtpi, bvir_off, FABints.params->colidx, bac, 1);
 
-                                            /* +t_jb * D_IkAc + f_jb * t_IkAc */
-                                            if (Gj == Gb && Gik == Gac) {
-                                                t_jb = D_ikac = f_jb = t_ikac = 0.0;
+                        for (Gab = 0; Gab < nirreps; Gab++) {
+                            Gc = Gab ^ Gijk;
 
-                                                if (T1B.params->rowtot[Gj] && T1B.params->coltot[Gj]) {
-                                                    t_jb = T1B.matrix[Gj][j][b];
-                                                    f_jb = fia.matrix[Gj][j][b];
-                                                }
-
-                                                if (DABints.params->rowtot[Gik] && DABints.params->coltot[Gik]) {
-                                                    D_ikac = DABints.matrix[Gik][ik][ac];
-                                                    t_ikac = T2AB.matrix[Gik][ik][ac];
-                                                }
-
-                                                VAbc[Gab][ab][c] += t_jb * D_ikac + f_jb * t_ikac;
-                                            }
+                            global_dpd_->free_dpd_block(WbAc[Gab], FBAints.params->coltot[Gab], bvirtpi[Gc]);
+                        }
 
-                                            /* -t_jc * D_IkAb - f_jc * t_IkAb */
-                                            if (Gj == Gc && Gik == Gab) {
-                                                t_jc = D_ikab = f_jc = t_ikab = 0.0;
+                        /* Add disconnected triples and finish W and V */
+                        for (Gab = 0; Gab < nirreps; Gab++) {
+                            Gc = Gab ^ Gijk;
+
+                            VAbc[Gab] = global_dpd_->dpd_block_matrix(FABints.params->coltot[Gab], bvirtpi[Gc]);
 
-                                                if (T1B.params->rowtot[Gj] && T1B.params->coltot[Gj]) {
-                                                    t_jc = T1B.matrix[Gj][j][c];
-                                                    f_jc = fia.matrix[Gj][j][c];
-                                                }
-
-                                                if (DABints.params->rowtot[Gik] && DABints.params->coltot[Gik]) {
-                                                    D_ikab = DABints.matrix[Gik][ik][ab];
-                                                    t_ikab = T2AB.matrix[Gik][ik][ab];
-                                                }
-
-                                                VAbc[Gab][ab][c] -= t_jc * D_ikab + f_jc * t_ikab;
-                                            }
-
-                                            /* -t_kb * D_IjAc - f_kb * t_IjAc */
-                                            if (Gk == Gb && Gji == Gac) {
-                                                t_kb = D_ijac = f_kb = t_ijac = 0.0;
-
-                                                if (T1B.params->rowtot[Gk] && T1B.params->coltot[Gk]) {
-                                                    t_kb = T1B.matrix[Gk][k][b];
-                                                    f_kb = fia.matrix[Gk][k][b];
-                                                }
-
-                                                if (DABints.params->rowtot[Gji] && DABints.params->coltot[Gji]) {
-                                                    D_ijac = DABints.matrix[Gji][ij][ac];
-                                                    t_ijac = T2AB.matrix[Gji][ij][ac];
-                                                }
+                            for (ab = 0; ab < FABints.params->coltot[Gab]; ab++) {
+                                A = FABints.params->colorb[Gab][ab][0];
+                                Ga = FABints.params->rsym[A];
+                                a = A - avir_off[Ga];
+                                B = FABints.params->colorb[Gab][ab][1];
+                                Gb = FABints.params->ssym[B];
+                                b = B - bvir_off[Gb];
 
-                                                VAbc[Gab][ab][c] -= t_kb * D_ijac + f_kb * t_ijac;
-                                            }
-
-                                            /* +t_kc * D_IjAb + f_kc * t_IjAb */
-                                            if (Gk == Gc && Gji == Gab) {
-                                                t_kc = D_ijab = f_kc = t_ijab = 0.0;
-
-                                                if (T1B.params->rowtot[Gk] && T1B.params->coltot[Gk]) {
-                                                    t_kc = T1B.matrix[Gk][k][c];
-                                                    f_kc = fia.matrix[Gk][k][c];
-                                                }
+                                Gbc = Gb ^ Gc;
+                                Gac = Ga ^ Gc;
 
-                                                if (DABints.params->rowtot[Gji] && DABints.params->coltot[Gji]) {
-                                                    D_ijab = DABints.matrix[Gji][ij][ab];
-                                                    t_ijab = T2AB.matrix[Gji][ij][ab];
-                                                }
-
-                                                VAbc[Gab][ab][c] += t_kc * D_ijab + f_kc * t_ijab;
-                                            }
-
-                                            /* Sum V and W into V */
-                                            VAbc[Gab][ab][c] += WAbc[Gab][ab][c];
-
-                                            /* Build the rest of the denominator and divide it into W */
-                                            denom = dijk;
-                                            if (fAB.params->rowtot[Ga]) denom -= fAB.matrix[Ga][a][a];
-                                            if (fab.params->rowtot[Gb]) denom -= fab.matrix[Gb][b][b];
-                                            if (fab.params->rowtot[Gc]) denom -= fab.matrix[Gc][c][c];
+                                for (c = 0; c < bvirtpi[Gc]; c++) {
+                                    C = bvir_off[Gc] + c;
 
-                                            WAbc[Gab][ab][c] /= denom;
-
-                                        } /* c */
-                                    }     /* ab */
-                                }         /* Gab */
-
-                                /* 1/2 Dot product of final V and W is the energy for this ijk triple */
-                                for (Gab = 0; Gab < nirreps; Gab++) {
-                                    Gc = Gab ^ Gijk;
-                                    ET_ABB +=
-                                        dot_block(WAbc[Gab], VAbc[Gab], FABints.params->coltot[Gab], bvirtpi[Gc], 0.5);
-                                    global_dpd_->free_dpd_block(WAbc[Gab], FABints.params->coltot[Gab], bvirtpi[Gc]);
-                                    global_dpd_->free_dpd_block(VAbc[Gab], FABints.params->coltot[Gab], bvirtpi[Gc]);
-                                }
+                                    bc = DBBints.params->colidx[B][C];
+                                    ac = DABints.params->colidx[A][C];
 
-                            } /* J >= K */
-
-                        } /* k */
-                    }     /* j */
-                }         /* i */
+                                    /* +t_IA * D_jkbc + f_IA * t_jkbc */
+                                    if (Gi == Ga && Gjk == Gbc) {
+                                        t_ia = D_jkbc = f_ia = t_jkbc = 0.0;
+
+                                        if (T1A.params->rowtot[Gi] && T1A.params->coltot[Gi]) {
+                                            t_ia = T1A.matrix[Gi][i][a];
+                                            f_ia = fIA.matrix[Gi][i][a];
+                                        }
+
+                                        if (DBBints.params->rowtot[Gjk] && DBBints.params->coltot[Gjk]) {
+                                            D_jkbc = DBBints.matrix[Gjk][jk][bc];
+                                            t_jkbc = T2BB.matrix[Gjk][jk][bc];
+                                        }
+
+                                        VAbc[Gab][ab][c] += t_ia * D_jkbc + f_ia * t_jkbc;
+                                    }
+
+                                    /* +t_jb * D_IkAc + f_jb * t_IkAc */
+                                    if (Gj == Gb && Gik == Gac) {
+                                        t_jb = D_ikac = f_jb = t_ikac = 0.0;
+
+                                        if (T1B.params->rowtot[Gj] && T1B.params->coltot[Gj]) {
+                                            t_jb = T1B.matrix[Gj][j][b];
+                                            f_jb = fia.matrix[Gj][j][b];
+                                        }
+
+                                        if (DABints.params->rowtot[Gik] && DABints.params->coltot[Gik]) {
+                                            D_ikac = DABints.matrix[Gik][ik][ac];
+                                            t_ikac = T2AB.matrix[Gik][ik][ac];
+                                        }
+
+                                        VAbc[Gab][ab][c] += t_jb * D_ikac + f_jb * t_ikac;
+                                    }
+
+                                    /* -t_jc * D_IkAb - f_jc * t_IkAb */
+                                    if (Gj == Gc && Gik == Gab) {
+                                        t_jc = D_ikab = f_jc = t_ikab = 0.0;
+
+                                        if (T1B.params->rowtot[Gj] && T1B.params->coltot[Gj]) {
+                                            t_jc = T1B.matrix[Gj][j][c];
+                                            f_jc = fia.matrix[Gj][j][c];
+                                        }
+
+                                        if (DABints.params->rowtot[Gik] && DABints.params->coltot[Gik]) {
+                                            D_ikab = DABints.matrix[Gik][ik][ab];
+                                            t_ikab = T2AB.matrix[Gik][ik][ab];
+                                        }
+
+                                        VAbc[Gab][ab][c] -= t_jc * D_ikab + f_jc * t_ikab;
+                                    }
+
+                                    /* -t_kb * D_IjAc - f_kb * t_IjAc */
+                                    if (Gk == Gb && Gji == Gac) {
+                                        t_kb = D_ijac = f_kb = t_ijac = 0.0;
+
+                                        if (T1B.params->rowtot[Gk] && T1B.params->coltot[Gk]) {
+                                            t_kb = T1B.matrix[Gk][k][b];
+                                            f_kb = fia.matrix[Gk][k][b];
+                                        }
+
+                                        if (DABints.params->rowtot[Gji] && DABints.params->coltot[Gji]) {
+                                            D_ijac = DABints.matrix[Gji][ij][ac];
+                                            t_ijac = T2AB.matrix[Gji][ij][ac];
+                                        }
+
+                                        VAbc[Gab][ab][c] -= t_kb * D_ijac + f_kb * t_ijac;
+                                    }
+
+                                    /* +t_kc * D_IjAb + f_kc * t_IjAb */
+                                    if (Gk == Gc && Gji == Gab) {
+                                        t_kc = D_ijab = f_kc = t_ijab = 0.0;
+
+                                        if (T1B.params->rowtot[Gk] && T1B.params->coltot[Gk]) {
+                                            t_kc = T1B.matrix[Gk][k][c];
+                                            f_kc = fia.matrix[Gk][k][c];
+                                        }
+
+                                        if (DABints.params->rowtot[Gji] && DABints.params->coltot[Gji]) {
+                                            D_ijab = DABints.matrix[Gji][ij][ab];
+                                            t_ijab = T2AB.matrix[Gji][ij][ab];
+                                        }
+
+                                        VAbc[Gab][ab][c] += t_kc * D_ijab + f_kc * t_ijab;
+                                    }
+
+                                    /* Sum V and W into V */
+                                    VAbc[Gab][ab][c] += WAbc[Gab][ab][c];
+
+                                    /* Build the rest of the denominator and divide it into W */
+                                    denom = dijk;
+                                    if (fAB.params->rowtot[Ga]) denom -= fAB.matrix[Ga][a][a];
+                                    if (fab.params->rowtot[Gb]) denom -= fab.matrix[Gb][b][b];
+                                    if (fab.params->rowtot[Gc]) denom -= fab.matrix[Gc][c][c];
+
+                                    WAbc[Gab][ab][c] /= denom;
+
+                                } /* c */
+                            }     /* ab */
+                        }         /* Gab */
+
+                        /* 1/2 Dot product of final V and W is the energy for this ijk triple */
+                        for (Gab = 0; Gab < nirreps; Gab++) {
+                            Gc = Gab ^ Gijk;
+                            ET_ABB += dot_block(WAbc[Gab], VAbc[Gab], FABints.params->coltot[Gab], bvirtpi[Gc], 0.5);
+                            global_dpd_->free_dpd_block(WAbc[Gab], FABints.params->coltot[Gab], bvirtpi[Gc]);
+                            global_dpd_->free_dpd_block(VAbc[Gab], FABints.params->coltot[Gab], bvirtpi[Gc]);
+                        }
+                    }
 
+                    free(WAbc);
+                    free(VAbc);
+                    free(WAcb);
+                    free(WbAc);
+                    free(WcAb);
+                    free(WbcA);
+                }
             } /* Gk */
         }     /* Gj */
     }         /* Gi */
 
-    free(WAbc);
-    free(VAbc);
-    free(WAcb);
-    free(WbcA);
-    free(WcAb);
-    free(WbAc);
-
     for (h = 0; h < nirreps; h++) {
         global_dpd_->buf4_mat_irrep_close(&T2BB, h);
         global_dpd_->buf4_mat_irrep_close(&T2AB, h);
@@ -768,9 +796,9 @@ double ET_UHF_ABB() {
     global_dpd_->buf4_close(&T2BB);
     global_dpd_->buf4_close(&T2AB);
     global_dpd_->buf4_close(&T2BA);
-    global_dpd_->buf4_close(&FBBints);
-    global_dpd_->buf4_close(&FABints);
-    global_dpd_->buf4_close(&FBAints);
+    for (int thread = 0; thread < nthreads; ++thread) global_dpd_->buf4_close(&FBBints_array[thread]);
+    for (int thread = 0; thread < nthreads; ++thread) global_dpd_->buf4_close(&FABints_array[thread]);
+    for (int thread = 0; thread < nthreads; ++thread) global_dpd_->buf4_close(&FBAints_array[thread]);
     global_dpd_->buf4_close(&EBBints);
     global_dpd_->buf4_close(&EABints);
     global_dpd_->buf4_close(&EBAints);
@@ -795,6 +823,8 @@ double ET_UHF_ABB() {
     global_dpd_->file2_close(&fIA);
     global_dpd_->file2_close(&fia);
 
+    threaddone();
+
     return ET_ABB;
 }
 
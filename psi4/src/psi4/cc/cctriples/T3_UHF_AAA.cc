@@ -99,6 +99,12 @@
 **   double omega: a constant to add to the final denominators -
 **   needed for CC3 EOM
 **
+** The C2 and E buffers (and the C1, D, and Fock matrix buffers) must
+** already be held in core by the caller; only the F intermediates are
+** read here, one block at a time.  Several threads may therefore build
+** T3 for different I, J, K combinations at once, provided each has its
+** own F buffer.
+**
 ** TDC, July 2004
 ** Modified to return disconnected triples, TDC, Feburary 2008
 */
@@ -117,7 +123,6 @@ namespace cctriples {
 void T3_UHF_AAA(double ***W, double ***V, int disc, int nirreps, int I, int Gi, int J, int Gj, int K, int Gk,
                 dpdbuf4 *C2, dpdbuf4 *F, dpdbuf4 *E, dpdfile2 *C1, dpdbuf4 *D, dpdfile2 *fIA, dpdfile2 *fIJ,
                 dpdfile2 *fAB, int *occpi, int *occ_off, int *virtpi, int *vir_off, double omega) {
-    int h;
     int i, j, k;
     int ij, ji, ik, ki, jk, kj;
     int Gij, Gji, Gik, Gki, Gjk, Gkj, Gijk;
@@ -147,29 +152,6 @@ void T3_UHF_AAA(double ***W, double ***V, int disc, int nirreps, int I, int Gi,
     GF = GE = F->file.my_irrep;
     GX3 = GC ^ GF;
 
-    global_dpd_->file2_mat_init(C1);
-    global_dpd_->file2_mat_rd(C1);
-
-    global_dpd_->file2_mat_init(fIJ);
-    global_dpd_->file2_mat_init(fAB);
-    global_dpd_->file2_mat_init(fIA);
-    global_dpd_->file2_mat_rd(fIJ);
-    global_dpd_->file2_mat_rd(fAB);
-    global_dpd_->file2_mat_rd(fIA);
-
-    for (h = 0; h < nirreps; h++) {
-        global_dpd_->buf4_mat_irrep_init(C2, h);
-        global_dpd_->buf4_mat_irrep_rd(C2, h);
-
-        if (disc) {
-            global_dpd_->buf4_mat_irrep_init(D, h);
-            global_dpd_->buf4_mat_irrep_rd(D, h);
-        }
-
-        global_dpd_->buf4_mat_irrep_init(E, h);
-        global_dpd_->buf4_mat_irrep_rd(E, h);
-    }
-
     i = I - occ_off[Gi];
     j = J - occ_off[Gj];
     k = K - occ_off[Gk];
@@ -215,6 +197,7 @@ void T3_UHF_AAA(double ***W, double ***V, int disc, int nirreps, int I, int Gi,
         id = F->row_offset[Gid][I];
 
         F->matrix[Gid] = global_dpd_->dpd_block_matrix(virtpi[Gd], F->params->coltot[Gid ^ GF]);
+#pragma omp critical
         global_dpd_->buf4_mat_irrep_rd_block(F, Gid, id, virtpi[Gd]);
 
         nrows = F->params->coltot[Gid ^ GF];
@@ -236,6 +219,7 @@ void T3_UHF_AAA(double ***W, double ***V, int disc, int nirreps, int I, int Gi,
         jd = F->row_offset[Gjd][J];
 
         F->matrix[Gjd] = global_dpd_->dpd_block_matrix(virtpi[Gd], F->params->coltot[Gjd ^ GF]);
+#pragma omp critical
         global_dpd_->buf4_mat_irrep_rd_block(F, Gjd, jd, virtpi[Gd]);
 
         nrows = F->params->coltot[Gjd ^ GF];
@@ -257,6 +241,7 @@ void T3_UHF_AAA(double ***W, double ***V, int disc, int nirreps, int I, int Gi,
         kd = F->row_offset[Gkd][K];
 
         F->matrix[Gkd] = global_dpd_->dpd_block_matrix(virtpi[Gd], F->params->coltot[Gkd ^ GF]);
+#pragma omp critical
         global_dpd_->buf4_mat_irrep_rd_block(F, Gkd, kd, virtpi[Gd]);
 
         nrows = F->params->coltot[Gkd ^ GF];
@@ -330,6 +315,7 @@ void T3_UHF_AAA(double ***W, double ***V, int disc, int nirreps, int I, int Gi,
         id = F->row_offset[Gid][I];
 
         F->matrix[Gid] = global_dpd_->dpd_block_matrix(virtpi[Gd], F->params->coltot[Gid ^ GF]);
+#pragma omp critical
         global_dpd_->buf4_mat_irrep_rd_block(F, Gid, id, virtpi[Gd]);
 
         nrows = F->params->coltot[Gid ^ GF];
@@ -351,6 +337,7 @@ void T3_UHF_AAA(double ***W, double ***V, int disc, int nirreps, int I, int Gi,
         jd = F->row_offset[Gjd][J];
 
         F->matrix[Gjd] = global_dpd_->dpd_block_matrix(virtpi[Gd], F->params->coltot[Gjd ^ GF]);
+#pragma omp critical
         global_dpd_->buf4_mat_irrep_rd_block(F, Gjd, jd, virtpi[Gd]);
 
         nrows = F->params->coltot[Gjd ^ GF];
@@ -372,6 +359,7 @@ void T3_UHF_AAA(double ***W, double ***V, int disc, int nirreps, int I, int Gi,
         kd = F->row_offset[Gkd][K];
 
         F->matrix[Gkd] = global_dpd_->dpd_block_matrix(virtpi[Gd], F->params->coltot[Gkd ^ GF]);
+#pragma omp critical
         global_dpd_->buf4_mat_irrep_rd_block(F, Gkd, kd, virtpi[Gd]);
 
         nrows = F->params->coltot[Gkd ^ GF];
@@ -456,6 +444,7 @@ void T3_UHF_AAA(double ***W, double ***V, int disc, int nirreps, int I, int Gi,
         id = F->row_offset[Gid][I];
 
         F->matrix[Gid] = global_dpd_->dpd_block_matrix(virtpi[Gd], F->params->coltot[Gid ^ GF]);
+#pragma omp critical
         global_dpd_->buf4_mat_irrep_rd_block(F, Gid, id, virtpi[Gd]);
 
         nrows = F->params->coltot[Gid ^ GF];
@@ -477,6 +466,7 @@ void T3_UHF_AAA(double ***W, double ***V, int disc, int nirreps, int I, int Gi,
         jd = F->row_offset[Gjd][J];
 
         F->matrix[Gjd] = global_dpd_->dpd_block_matrix(virtpi[Gd], F->params->coltot[Gjd ^ GF]);
+#pragma omp critical
         global_dpd_->buf4_mat_irrep_rd_block(F, Gjd, jd, virtpi[Gd]);
 
         nrows = F->params->coltot[Gjd ^ GF];
@@ -498,6 +488,7 @@ void T3_UHF_AAA(double ***W, double ***V, int disc, int nirreps, int I, int Gi,
         kd = F->row_offset[Gkd][K];
 
         F->matrix[Gkd] = global_dpd_->dpd_block_matrix(virtpi[Gd], F->params->coltot[Gkd ^ GF]);
+#pragma omp critical
         global_dpd_->buf4_mat_irrep_rd_block(F, Gkd, kd, virtpi[Gd]);
 
         nrows = F->params->coltot[Gkd ^ GF];
@@ -774,19 +765,6 @@ void T3_UHF_AAA(double ***W, double ***V, int disc, int nirreps, int I, int Gi,
         global_dpd_->free_dpd_block(W2[Gab], F->params->coltot[Gab], virtpi[Gc]);
     }
     free(W2);
-
-    global_dpd_->file2_mat_close(fIJ);
-    global_dpd_->file2_mat_close(fAB);
-    if (disc) {
-        global_dpd_->file2_mat_close(fIA);
-        global_dpd_->file2_mat_close(C1);
-    }
-
-    for (h = 0; h < nirreps; h++) {
-        global_dpd_->buf4_mat_irrep_close(C2, h);
-        if (disc) global_dpd_->buf4_mat_irrep_close(D, h);
-        global_dpd_->buf4_mat_irrep_close(E, h);
-    }
 }
 
 }  // namespace cctriples
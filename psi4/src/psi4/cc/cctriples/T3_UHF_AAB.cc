@@ -98,6 +98,12 @@
 **   double omega: constant to add to denominators - needed for
 **   CC3 EOM
 **
+** The T2 and E buffers (and the T1, D, and Fock matrix buffers) must
+** already be held in core by the caller; only the F intermediates are
+** read here, one block at a time.  Several threads may therefore build
+** T3 for different I, J, K combinations at once, provided each has its
+** own F buffer.
+**
 ** TDC, July 2004
 */
 
@@ -117,7 +123,6 @@ void T3_UHF_AAB(double ***W, double ***V, int disc, int nirreps, int I, int Gi,
                 dpdbuf4 *EAB, dpdbuf4 *EBA, dpdfile2 *T1A, dpdfile2 *T1B, dpdbuf4 *DAA, dpdbuf4 *DAB, dpdfile2 *fIA,
                 dpdfile2 *fia, dpdfile2 *fIJ, dpdfile2 *fij, dpdfile2 *fAB, dpdfile2 *fab, int *aoccpi, int *aocc_off,
                 int *boccpi, int *bocc_off, int *avirtpi, int *avir_off, int *bvirtpi, int *bvir_off, double omega) {
-    int h;
     int i, j, k;
     int ij, ji, ik, ki, jk, kj;
     int Gij, Gji, Gik, Gki, Gjk, Gkj, Gijk;
@@ -147,56 +152,6 @@ void T3_UHF_AAB(double ***W, double ***V, int disc, int nirreps, int I, int Gi,
     GF = GE = FAA->file.my_irrep;
     GX3 = GC ^ GF;
 
-    global_dpd_->file2_mat_init(fIJ);
-    global_dpd_->file2_mat_init(fAB);
-    global_dpd_->file2_mat_init(fij);
-    global_dpd_->file2_mat_init(fab);
-    if (disc) {
-        global_dpd_->file2_mat_init(fIA);
-        global_dpd_->file2_mat_init(fia);
-        global_dpd_->file2_mat_init(T1A);
-        global_dpd_->file2_mat_init(T1B);
-    }
-
-    global_dpd_->file2_mat_rd(fIJ);
-    global_dpd_->file2_mat_rd(fAB);
-    global_dpd_->file2_mat_rd(fij);
-    global_dpd_->file2_mat_rd(fab);
-    if (disc) {
-        global_dpd_->file2_mat_rd(fIA);
-        global_dpd_->file2_mat_rd(fia);
-        global_dpd_->file2_mat_rd(T1A);
-        global_dpd_->file2_mat_rd(T1B);
-    }
-
-    for (h = 0; h < nirreps; h++) {
-        global_dpd_->buf4_mat_irrep_init(T2AA, h);
-        global_dpd_->buf4_mat_irrep_rd(T2AA, h);
-
-        global_dpd_->buf4_mat_irrep_init(T2AB, h);
-        global_dpd_->buf4_mat_irrep_rd(T2AB, h);
-
-        global_dpd_->buf4_mat_irrep_init(T2BA, h);
-        global_dpd_->buf4_mat_irrep_rd(T2BA, h);
-
-        if (disc) {
-            global_dpd_->buf4_mat_irrep_init(DAA, h);
-            global_dpd_->buf4_mat_irrep_rd(DAA, h);
-
-            global_dpd_->buf4_mat_irrep_init(DAB, h);
-            global_dpd_->buf4_mat_irrep_rd(DAB, h);
-        }
-
-        global_dpd_->buf4_mat_irrep_init(EAA, h);
-        global_dpd_->buf4_mat_irrep_rd(EAA, h);
-
-        global_dpd_->buf4_mat_irrep_init(EAB, h);
-        global_dpd_->buf4_mat_irrep_rd(EAB, h);
-
-        global_dpd_->buf4_mat_irrep_init(EBA, h);
-        global_dpd_->buf4_mat_irrep_rd(EBA, h);
-    }
-
     i = I - aocc_off[Gi];
     j = J - aocc_off[Gj];
     k = K - bocc_off[Gk];
@@ -240,6 +195,7 @@ void T3_UHF_AAB(double ***W, double ***V, int disc, int nirreps, int I, int Gi,
         id = FAA->row_offset[Gid][I];
 
         FAA->matrix[Gid] = global_dpd_->dpd_block_matrix(avirtpi[Gd], FAA->params->coltot[Gid ^ GF]);
+#pragma omp critical
         global_dpd_->buf4_mat_irrep_rd_block(FAA, Gid, id, avirtpi[Gd]);
 
         nrows = FAA->params->coltot[Gid ^ GF];
@@ -261,6 +217,7 @@ void T3_UHF_AAB(double ***W, double ***V, int disc, int nirreps, int I, int Gi,
         jd = FAA->row_offset[Gjd][J];
 
         FAA->matrix[Gjd] = global_dpd_->dpd_block_matrix(avirtpi[Gd], FAA->params->coltot[Gjd ^ GF]);
+#pragma omp critical
         global_dpd_->buf4_mat_irrep_rd_block(FAA, Gjd, jd, avirtpi[Gd]);
 
         nrows = FAA->params->coltot[Gjd ^ GF];
@@ -324,6 +281,7 @@ void T3_UHF_AAB(double ***W, double ***V, int disc, int nirreps, int I, int Gi,
         id = FAB->row_offset[Gid][I];
 
         FAB->matrix[Gid] = global_dpd_->dpd_block_matrix(bvirtpi[Gd], FAB->params->coltot[Gid ^ GF]);
+#pragma omp critical
         global_dpd_->buf4_mat_irrep_rd_block(FAB, Gid, id, bvirtpi[Gd]);
 
         nrows = FAB->params->coltot[Gid ^ GF];
@@ -345,6 +303,7 @@ void T3_UHF_AAB(double ***W, double ***V, int disc, int nirreps, int I, int Gi,
         jd = FAB->row_offset[Gjd][J];
 
         FAB->matrix[Gjd] = global_dpd_->dpd_block_matrix(bvirtpi[Gd], FAB->params->coltot[Gjd ^ GF]);
+#pragma omp critical
         global_dpd_->buf4_mat_irrep_rd_block(FAB, Gjd, jd, bvirtpi[Gd]);
 
         nrows = FAB->params->coltot[Gjd ^ GF];
@@ -415,6 +374,7 @@ void T3_UHF_AAB(double ***W, double ***V, int disc, int nirreps, int I, int Gi,
         id = FAB->row_offset[Gid][I];
 
         FAB->matrix[Gid] = global_dpd_->dpd_block_matrix(bvirtpi[Gd], FAB->params->coltot[Gid ^ GF]);
+#pragma omp critical
         global_dpd_->buf4_mat_irrep_rd_block(FAB, Gid, id, bvirtpi[Gd]);
 
         nrows = FAB->params->coltot[Gid ^ GF];
@@ -436,6 +396,7 @@ void T3_UHF_AAB(double ***W, double ***V, int disc, int nirreps, int I, int Gi,
         jd = FAB->row_offset[Gjd][J];
 
         FAB->matrix[Gjd] = global_dpd_->dpd_block_matrix(bvirtpi[Gd], FAB->params->coltot[Gjd ^ GF]);
+#pragma omp critical
         global_dpd_->buf4_mat_irrep_rd_block(FAB, Gjd, jd, bvirtpi[Gd]);
 
         nrows = FAB->params->coltot[Gjd ^ GF];
@@ -505,6 +466,7 @@ void T3_UHF_AAB(double ***W, double ***V, int disc, int nirreps, int I, int Gi,
         kd = FBA->row_offset[Gkd][K];
 
         FBA->matrix[Gkd] = global_dpd_->dpd_block_matrix(avirtpi[Gd], FBA->params->coltot[Gkd ^ GF]);
+#pragma omp critical
         global_dpd_->buf4_mat_irrep_rd_block(FBA, Gkd, kd, avirtpi[Gd]);
 
         nrows = FBA->params->coltot[Gkd ^ GF];
@@ -558,6 +520,7 @@ void T3_UHF_AAB(double ***W, double ***V, int disc, int nirreps, int I, int Gi,
         kd = FBA->row_offset[Gkd][K];
 
         FBA->matrix[Gkd] = global_dpd_->dpd_block_matrix(avirtpi[Gd], FBA->params->coltot[Gkd ^ GF]);
+#pragma omp critical
         global_dpd_->buf4_mat_irrep_rd_block(FBA, Gkd, kd, avirtpi[Gd]);
 
         nrows = FBA->params->coltot[Gkd ^ GF];
@@ -738,32 +701,6 @@ void T3_UHF_AAB(double ***W, double ***V, int disc, int nirreps, int I, int Gi,
     }
 
     free(W2);
-
-    global_dpd_->file2_mat_close(fIJ);
-    global_dpd_->file2_mat_close(fij);
-    global_dpd_->file2_mat_close(fAB);
-    global_dpd_->file2_mat_close(fab);
-    if (disc) {
-        global_dpd_->file2_mat_close(fIA);
-        global_dpd_->file2_mat_close(fia);
-        global_dpd_->file2_mat_close(T1A);
-        global_dpd_->file2_mat_close(T1B);
-    }
-
-    for (h = 0; h < nirreps; h++) {
-        global_dpd_->buf4_mat_irrep_close(T2AA, h);
-        global_dpd_->buf4_mat_irrep_close(T2AB, h);
-        global_dpd_->buf4_mat_irrep_close(T2BA, h);
-
-        global_dpd_->buf4_mat_irrep_close(EAA, h);
-        global_dpd_->buf4_mat_irrep_close(EAB, h);
-        global_dpd_->buf4_mat_irrep_close(EBA, h);
-
-        if (disc) {
-            global_dpd_->buf4_mat_irrep_close(DAA, h);
-            global_dpd_->buf4_mat_irrep_close(DAB, h);
-        }
-    }
 }
 
 }  // namespace cctriples
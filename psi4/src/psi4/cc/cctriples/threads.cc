@@ -0,0 +1,105 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2019 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+/*! \file
+    \ingroup CCTRIPLES
+    \brief Thread count setup for the ijk-partitioned triples kernels
+*/
+#include "psi4/libdpd/dpd.h"
+#include "psi4/libpsi4util/PsiOutStream.h"
+
+#include "MOInfo.h"
+#include "Params.h"
+#define EXTERN
+#include "globals.h"
+
+// MKL Header
+#ifdef USING_LAPACK_MKL
+#include <mkl.h>
+#endif
+
+namespace psi {
+namespace cctriples {
+
+#ifdef USING_LAPACK_MKL
+static int old_mkl_threads = 1;
+#endif
+
+/* threadprep(): Determines how many threads a triples kernel may use
+** when its ijk (or abc) combinations are partitioned among explicit
+** threads.  Each thread needs its own scratch for the W/V intermediates
+** on top of the shared buffers already in core, so the requested
+** CC_NUM_THREADS is reduced if the remaining DPD memory cannot hold one
+** copy per thread.  Threaded BLAS is turned off until threaddone() is
+** called.
+**
+** Arguments:
+**
+**   long int thread_mem_estimate: words of scratch needed per thread.
+*/
+int threadprep(long int thread_mem_estimate) {
+    int nthreads = params.nthreads;
+    long int mem_avail = dpd_memfree();
+
+    outfile->Printf("    Memory available in words        : %15ld\n", mem_avail);
+    outfile->Printf("    ~Words needed per explicit thread: %15ld\n", thread_mem_estimate);
+
+    // subtract at least 1/2 for non-abc quantities (mainly 2 ijab's + other buffers)
+    if (thread_mem_estimate > 0) {
+        double tval = (double)mem_avail / (double)thread_mem_estimate;
+        int possible_nthreads = tval - 0.5;
+        if (possible_nthreads < 1) possible_nthreads = 1;
+        if (possible_nthreads < nthreads) {
+            nthreads = possible_nthreads;
+            outfile->Printf("    Reducing threads due to memory limitations.\n");
+        }
+    }
+    if (nthreads < 1) nthreads = 1;
+
+    outfile->Printf("    Number of threads for explicit ijk threading: %4d\n\n", nthreads);
+
+// Don't parallelize mkl if explicit threads are used; should be added for acml too.
+#ifdef USING_LAPACK_MKL
+    old_mkl_threads = mkl_get_max_threads();
+    mkl_set_num_threads(1);
+    outfile->Printf("    MKL num_threads set to 1 for explicit threading.\n\n");
+#endif
+
+    return nthreads;
+}
+
+/* threaddone(): Restores threaded BLAS after a kernel set up with
+** threadprep() has finished. */
+void threaddone() {
+#ifdef USING_LAPACK_MKL
+    mkl_set_num_threads(old_mkl_threads);
+#endif
+}
+
+}  // namespace cctriples
+}  // namespace psi
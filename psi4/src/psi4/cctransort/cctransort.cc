@@ -400,7 +400,10 @@ PsiReturnType cctransort(SharedWavefunction ref, Options &options) {
 
     dpd_set_default(ints->get_dpd_id());
     ints->set_keep_dpd_so_ints(true);
-    if (!options.get_bool("DELETE_TEI") || options.get_str("AO_BASIS") == "DISK") {
+    if (options.get_bool("DIRECT_TEI") && options.get_str("AO_BASIS") != "DISK") {
+        outfile->Printf("\tSO integrals will be computed directly.\n");
+        ints->set_direct_tei(true);
+    } else if (!options.get_bool("DELETE_TEI") || options.get_str("AO_BASIS") == "DISK") {
         outfile->Printf("\tIWL integrals will be retained.\n");
         ints->set_keep_iwl_so_ints(true);
     } else {
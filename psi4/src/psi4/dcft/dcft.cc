@@ -114,6 +114,19 @@ void DCFTSolver::dpd_buf4_add(dpdbuf4 *A, dpdbuf4 *B, double alpha) {
     }
 }
 
+/**
+ * Checks whether nblocks copies of the largest irrep block of A can be held in core
+ * at the same time, so that element-wise updates can be fused into a single pass
+ */
+bool DCFTSolver::dpd_buf4_fits_in_core(dpdbuf4 *A, int nblocks) {
+    long int maxblock = 0;
+    for (int h = 0; h < nirrep_; ++h) {
+        long int block = (long int)A->params->rowtot[h] * A->params->coltot[h ^ A->file.my_irrep];
+        if (block > maxblock) maxblock = block;
+    }
+    return nblocks * maxblock <= dpd_memfree();
+}
+
 DCFTSolver::~DCFTSolver() {
     delete []aocc_off_;
     delete []avir_off_;
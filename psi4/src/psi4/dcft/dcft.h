@@ -105,6 +105,7 @@ class DCFTSolver : public Wavefunction {
     void update_fock();
     void dump_density();
     void dpd_buf4_add(dpdbuf4 *A, dpdbuf4 *B, double alpha);
+    bool dpd_buf4_fits_in_core(dpdbuf4 *A, int nblocks);
     void half_transform(dpdbuf4 *A, dpdbuf4 *B, SharedMatrix &C1, SharedMatrix &C2, int *mospi_left, int *mospi_right,
                         int **so_row, int **mo_row, bool backwards, double alpha, double beta);
     void file2_transform(dpdfile2 *A, dpdfile2 *B, SharedMatrix C, bool backwards);
@@ -226,12 +227,14 @@ class DCFTSolver : public Wavefunction {
     void run_simult_dcft_oo_RHF();
     void run_simult_dcft_RHF();
     void build_tau_RHF();
+    void build_tau_in_core_RHF(dpdbuf4 *L, dpdfile2 *T_OO, dpdfile2 *T_VV, double alpha);
     void refine_tau_RHF();
     void transform_tau_RHF();
     void process_so_ints_RHF();
     void build_cumulant_intermediates_RHF();
     void form_density_weighted_fock_RHF();
     void compute_F_intermediate_RHF();
+    void compute_F_intermediate_in_core_RHF(dpdbuf4 *Lab, dpdbuf4 *F);
     double compute_cumulant_residual_RHF();
     void update_cumulant_jacobi_RHF();
     void compute_scf_energy_RHF();
@@ -243,7 +243,10 @@ int DCFTSolver::run_twostep_dcft_cumulant_updates() {
                            "Lambda <Oo|Vv>");
     global_dpd_->buf4_init(&Lbb, PSIF_LIBTRANS_DPD, 0, ID("[o>o]-"), ID("[v>v]-"), ID("[o>o]-"), ID("[v>v]-"), 0,
                            "Lambda <oo|vv>");
-    DIISManager lambdaDiisManager(maxdiis_, "DCFT DIIS Lambdas", DIISManager::LargestError, DIISManager::InCore);
+    std::string diisStorage = options_.get_str("DCFT_DIIS_STORAGE");
+    DIISManager lambdaDiisManager(maxdiis_, "DCFT DIIS Lambdas", DIISManager::LargestError,
+                                  diisStorage == "DEFAULT" ? DIISManager::InCore : DIISManager::OnDiskBlocked);
+    lambdaDiisManager.set_single_precision(diisStorage == "BLOCKED_FLOAT");
     if ((nalpha_ + nbeta_) > 1) {
         lambdaDiisManager.set_error_vector_size(3, DIISEntry::DPDBuf4, &Laa, DIISEntry::DPDBuf4, &Lab,
                                                 DIISEntry::DPDBuf4, &Lbb);
@@ -435,7 +438,10 @@ void DCFTSolver::run_simult_dcft() {
 
     auto tmp = std::make_shared<Matrix>("temp", nirrep_, nsopi_, nsopi_);
     // Set up the DIIS manager
-    DIISManager diisManager(maxdiis_, "DCFT DIIS vectors");
+    std::string diisStorage = options_.get_str("DCFT_DIIS_STORAGE");
+    DIISManager diisManager(maxdiis_, "DCFT DIIS vectors", DIISManager::LargestError,
+                            diisStorage == "DEFAULT" ? DIISManager::OnDisk : DIISManager::OnDiskBlocked);
+    diisManager.set_single_precision(diisStorage == "BLOCKED_FLOAT");
     dpdbuf4 Laa, Lab, Lbb;
     global_dpd_->buf4_init(&Laa, PSIF_LIBTRANS_DPD, 0, ID("[O>O]-"), ID("[V>V]-"), ID("[O>O]-"), ID("[V>V]-"), 0,
                            "Lambda <OO|VV>");
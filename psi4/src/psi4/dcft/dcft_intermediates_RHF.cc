@@ -33,6 +33,14 @@
 #include "psi4/libpsio/psio.hpp"
 #include "psi4/libtrans/integraltransform.h"
 #include "psi4/liboptions/liboptions.h"
+#include "psi4/libpsi4util/process.h"
+#include "psi4/libqt/qt.h"
+
+#include <cstring>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 namespace psi {
 namespace dcft {
@@ -227,6 +235,14 @@ void DCFTSolver::compute_F_intermediate_RHF() {
     global_dpd_->buf4_init(&Lab, PSIF_DCFT_DPD, 0, ID("[O,O]"), ID("[V,V]"), ID("[O,O]"), ID("[V,V]"), 0,
                            "Lambda SF <OO|VV>");  // Lambda <Oo|Vv>
 
+    if (options_.get_str("DCFT_TYPE") == "DF" && dpd_buf4_fits_in_core(&F, 2)) {
+        compute_F_intermediate_in_core_RHF(&Lab, &F);
+        global_dpd_->buf4_close(&Lab);
+        global_dpd_->buf4_close(&F);
+        psio_->close(PSIF_LIBTRANS_DPD, 1);
+        return;
+    }
+
     // F_IjAb += lambda_IjCb F_AC
     global_dpd_->file2_init(&F_VV, PSIF_LIBTRANS_DPD, 0, ID('V'), ID('V'), "F <V|V>");
     global_dpd_->contract244(&F_VV, &Lab, &F, 1, 2, 1, 1.0, 0.0);
@@ -249,6 +265,81 @@ void DCFTSolver::compute_F_intermediate_RHF() {
     psio_->close(PSIF_LIBTRANS_DPD, 1);
 }
 
+/**
+ * In-core version of the F intermediate: each irrep block of Lambda is read once and all four
+ * Fock contractions are done with DGEMMs on contiguous sub-blocks of that irrep block
+ */
+void DCFTSolver::compute_F_intermediate_in_core_RHF(dpdbuf4 *Lab, dpdbuf4 *F) {
+    int nthreads = 1;
+#ifdef _OPENMP
+    nthreads = Process::environment.get_n_threads();
+#endif
+    dpdfile2 F_OO, F_VV;
+    dpdparams4 *params = F->params;
+
+    global_dpd_->file2_init(&F_OO, PSIF_LIBTRANS_DPD, 0, ID('O'), ID('O'), "F <O|O>");
+    global_dpd_->file2_init(&F_VV, PSIF_LIBTRANS_DPD, 0, ID('V'), ID('V'), "F <V|V>");
+    global_dpd_->file2_mat_init(&F_OO);
+    global_dpd_->file2_mat_init(&F_VV);
+    global_dpd_->file2_mat_rd(&F_OO);
+    global_dpd_->file2_mat_rd(&F_VV);
+
+    for (int h = 0; h < nirrep_; ++h) {
+        int nrows = params->rowtot[h];
+        int ncols = params->coltot[h];
+        global_dpd_->buf4_mat_irrep_init(F, h);
+        if (nrows == 0 || ncols == 0) {
+            global_dpd_->buf4_mat_irrep_wrt(F, h);
+            global_dpd_->buf4_mat_irrep_close(F, h);
+            continue;
+        }
+        global_dpd_->buf4_mat_irrep_init(Lab, h);
+        global_dpd_->buf4_mat_irrep_rd(Lab, h);
+        double **Lp = Lab->matrix[h];
+        double **Fp = F->matrix[h];
+        ::memset(Fp[0], 0, sizeof(double) * nrows * ncols);
+
+        // F_IjAb += lambda_IjCb F_AC + lambda_IjAc F_bc
+#pragma omp parallel for schedule(static) num_threads(nthreads)
+        for (int row = 0; row < nrows; ++row) {
+            for (int Ga = 0; Ga < nirrep_; ++Ga) {
+                int Gb = h ^ Ga;
+                int na = params->rpi[Ga];
+                int nb = params->spi[Gb];
+                if (na == 0 || nb == 0) continue;
+                int col = params->colidx[params->roff[Ga]][params->soff[Gb]];
+                C_DGEMM('N', 'N', na, nb, na, 1.0, F_VV.matrix[Ga][0], na, &Lp[row][col], nb, 1.0, &Fp[row][col], nb);
+                C_DGEMM('N', 'T', na, nb, nb, 1.0, &Lp[row][col], nb, F_VV.matrix[Gb][0], nb, 1.0, &Fp[row][col], nb);
+            }
+        }
+
+        // F_IjAb -= lambda_KjAb F_IK + lambda_IkAb F_jk
+        for (int Gi = 0; Gi < nirrep_; ++Gi) {
+            int Gj = h ^ Gi;
+            int ni = params->ppi[Gi];
+            int nj = params->qpi[Gj];
+            if (ni == 0 || nj == 0) continue;
+            int row = params->rowidx[params->poff[Gi]][params->qoff[Gj]];
+            int length = nj * ncols;
+            C_DGEMM('N', 'N', ni, length, ni, -1.0, F_OO.matrix[Gi][0], ni, Lp[row], length, 1.0, Fp[row], length);
+#pragma omp parallel for schedule(static) num_threads(nthreads)
+            for (int i = 0; i < ni; ++i) {
+                C_DGEMM('N', 'N', nj, ncols, nj, -1.0, F_OO.matrix[Gj][0], nj, Lp[row + i * nj], ncols, 1.0,
+                        Fp[row + i * nj], ncols);
+            }
+        }
+
+        global_dpd_->buf4_mat_irrep_wrt(F, h);
+        global_dpd_->buf4_mat_irrep_close(F, h);
+        global_dpd_->buf4_mat_irrep_close(Lab, h);
+    }
+
+    global_dpd_->file2_mat_close(&F_OO);
+    global_dpd_->file2_mat_close(&F_VV);
+    global_dpd_->file2_close(&F_OO);
+    global_dpd_->file2_close(&F_VV);
+}
+
 void DCFTSolver::form_density_weighted_fock_RHF() {
     psio_->open(PSIF_LIBTRANS_DPD, PSIO_OPEN_OLD);
 
@@ -28,7 +28,9 @@
 
 #include "dcft.h"
 #include "psi4/libdpd/dpd.h"
+#include "psi4/liboptions/liboptions.h"
 #include "psi4/libpsio/psio.hpp"
+#include "psi4/libqt/qt.h"
 #include "psi4/libtrans/integraltransform.h"
 #include "psi4/psifiles.h"
 #include "psi4/psifiles.h"
@@ -54,23 +56,59 @@ double DCFTSolver::compute_cumulant_residual_RHF() {
      * R_ijab = G_ijab + F_ijab
      */
 
-    // R_IjAb = G_IjAb
     global_dpd_->buf4_init(&G, PSIF_DCFT_DPD, 0, ID("[O,O]"), ID("[V,V]"), ID("[O,O]"), ID("[V,V]"), 0,
-                           "G <OO|VV>");                        // G <Oo|Vv>
-    global_dpd_->buf4_copy(&G, PSIF_DCFT_DPD, "R SF <OO|VV>");  // R <Oo|Vv>
-    global_dpd_->buf4_close(&G);
-    global_dpd_->buf4_init(&R, PSIF_DCFT_DPD, 0, ID("[O,O]"), ID("[V,V]"), ID("[O,O]"), ID("[V,V]"), 0,
-                           "R SF <OO|VV>");  // R <Oo|Vv>
-
-    // R_IjAb += F_IjAb
+                           "G <OO|VV>");  // G <Oo|Vv>
     global_dpd_->buf4_init(&F, PSIF_DCFT_DPD, 0, ID("[O,O]"), ID("[V,V]"), ID("[O,O]"), ID("[V,V]"), 0,
                            "F <OO|VV>");  // F <Oo|Vv>
-    dpd_buf4_add(&R, &F, 1.0);
-    global_dpd_->buf4_close(&F);
-    for (int h = 0; h < nirrep_; ++h) nElements += R.params->coltot[h] * R.params->rowtot[h];
 
-    sumSQ += global_dpd_->buf4_dot_self(&R);
-    global_dpd_->buf4_close(&R);
+    if (options_.get_str("DCFT_TYPE") == "DF" && dpd_buf4_fits_in_core(&G, 3)) {
+        // Form R, and its norm, in a single in-core pass over each irrep block of G and F
+        global_dpd_->buf4_init(&R, PSIF_DCFT_DPD, 0, ID("[O,O]"), ID("[V,V]"), ID("[O,O]"), ID("[V,V]"), 0,
+                               "R SF <OO|VV>");  // R <Oo|Vv>
+        for (int h = 0; h < nirrep_; ++h) {
+            global_dpd_->buf4_mat_irrep_init(&G, h);
+            global_dpd_->buf4_mat_irrep_init(&F, h);
+            global_dpd_->buf4_mat_irrep_init(&R, h);
+            global_dpd_->buf4_mat_irrep_rd(&G, h);
+            global_dpd_->buf4_mat_irrep_rd(&F, h);
+
+            double **Gp = G.matrix[h];
+            double **Fp = F.matrix[h];
+            double **Rp = R.matrix[h];
+            int ncols = R.params->coltot[h];
+#pragma omp parallel for reduction(+ : sumSQ)
+            for (int row = 0; row < R.params->rowtot[h]; ++row) {
+                for (int col = 0; col < ncols; ++col) {
+                    double value = Gp[row][col] + Fp[row][col];
+                    Rp[row][col] = value;
+                    sumSQ += value * value;
+                }
+            }
+            nElements += (size_t)R.params->rowtot[h] * R.params->coltot[h];
+
+            global_dpd_->buf4_mat_irrep_wrt(&R, h);
+            global_dpd_->buf4_mat_irrep_close(&G, h);
+            global_dpd_->buf4_mat_irrep_close(&F, h);
+            global_dpd_->buf4_mat_irrep_close(&R, h);
+        }
+        global_dpd_->buf4_close(&G);
+        global_dpd_->buf4_close(&F);
+        global_dpd_->buf4_close(&R);
+    } else {
+        // R_IjAb = G_IjAb
+        global_dpd_->buf4_copy(&G, PSIF_DCFT_DPD, "R SF <OO|VV>");  // R <Oo|Vv>
+        global_dpd_->buf4_close(&G);
+        global_dpd_->buf4_init(&R, PSIF_DCFT_DPD, 0, ID("[O,O]"), ID("[V,V]"), ID("[O,O]"), ID("[V,V]"), 0,
+                               "R SF <OO|VV>");  // R <Oo|Vv>
+
+        // R_IjAb += F_IjAb
+        dpd_buf4_add(&R, &F, 1.0);
+        global_dpd_->buf4_close(&F);
+        for (int h = 0; h < nirrep_; ++h) nElements += R.params->coltot[h] * R.params->rowtot[h];
+
+        sumSQ += global_dpd_->buf4_dot_self(&R);
+        global_dpd_->buf4_close(&R);
+    }
 
     dcft_timer_off("DCFTSolver::compute_lambda_residual()");
 
@@ -99,22 +137,87 @@ void DCFTSolver::update_cumulant_jacobi_RHF() {
                            "D <OO|VV>");  // D <Oo|Vv>
     global_dpd_->buf4_init(&R, PSIF_DCFT_DPD, 0, ID("[O,O]"), ID("[V,V]"), ID("[O,O]"), ID("[V,V]"), 0,
                            "R SF <OO|VV>");  // R <Oo|Vv>
-    global_dpd_->buf4_dirprd(&D, &R);
-    global_dpd_->buf4_close(&D);
-    // Update new cumulant
     global_dpd_->buf4_init(&L, PSIF_DCFT_DPD, 0, ID("[O,O]"), ID("[V,V]"), ID("[O,O]"), ID("[V,V]"), 0,
                            "Lambda SF <OO|VV>");  // Lambda <Oo|Vv>
-    dpd_buf4_add(&L, &R, 1.0);
-    global_dpd_->buf4_close(&L);
-
-    global_dpd_->buf4_close(&R);
 
-    /* update lambda <OO|VV> for tau and G intermediates */
-    global_dpd_->buf4_init(&L, PSIF_DCFT_DPD, 0, ID("[O,O]"), ID("[V,V]"), ID("[O,O]"), ID("[V,V]"), 1,
-                           "Lambda SF <OO|VV>");
-    global_dpd_->buf4_copy(&L, PSIF_DCFT_DPD, "Lambda <OO|VV>");
-    global_dpd_->buf4_copy(&L, PSIF_DCFT_DPD, "Lambda <oo|vv>");
-    global_dpd_->buf4_close(&L);
+    if (options_.get_str("DCFT_TYPE") == "DF" && dpd_buf4_fits_in_core(&L, 4)) {
+        /*
+         * Scale the residual, update the spin-free cumulant and build its antisymmetrized
+         * same-spin counterpart in one in-core pass, rather than round-tripping each step through disk
+         */
+        dpdbuf4 Laa, Lbb;
+        global_dpd_->buf4_init(&Laa, PSIF_DCFT_DPD, 0, ID("[O,O]"), ID("[V,V]"), ID("[O,O]"), ID("[V,V]"), 0,
+                               "Lambda <OO|VV>");
+        global_dpd_->buf4_init(&Lbb, PSIF_DCFT_DPD, 0, ID("[O,O]"), ID("[V,V]"), ID("[O,O]"), ID("[V,V]"), 0,
+                               "Lambda <oo|vv>");
+        for (int h = 0; h < nirrep_; ++h) {
+            global_dpd_->buf4_mat_irrep_init(&D, h);
+            global_dpd_->buf4_mat_irrep_init(&R, h);
+            global_dpd_->buf4_mat_irrep_init(&L, h);
+            global_dpd_->buf4_mat_irrep_rd(&D, h);
+            global_dpd_->buf4_mat_irrep_rd(&R, h);
+            global_dpd_->buf4_mat_irrep_rd(&L, h);
+
+            double **Dp = D.matrix[h];
+            double **Rp = R.matrix[h];
+            double **Lp = L.matrix[h];
+            int nrows = L.params->rowtot[h];
+            int ncols = L.params->coltot[h];
+#pragma omp parallel for
+            for (int row = 0; row < nrows; ++row) {
+                for (int col = 0; col < ncols; ++col) {
+                    double value = Rp[row][col] * Dp[row][col];
+                    Rp[row][col] = value;
+                    Lp[row][col] += value;
+                }
+            }
+            global_dpd_->buf4_mat_irrep_wrt(&R, h);
+            global_dpd_->buf4_mat_irrep_wrt(&L, h);
+            global_dpd_->buf4_mat_irrep_close(&R, h);
+            global_dpd_->buf4_mat_irrep_close(&D, h);
+
+            // Lambda_IJAB = Lambda_IjAb - Lambda_IjBa
+            global_dpd_->buf4_mat_irrep_init(&Laa, h);
+            double **Lap = Laa.matrix[h];
+#pragma omp parallel for
+            for (int row = 0; row < nrows; ++row) {
+                for (int col = 0; col < ncols; ++col) {
+                    int a = L.params->colorb[h][col][0];
+                    int b = L.params->colorb[h][col][1];
+                    Lap[row][col] = Lp[row][col] - Lp[row][L.params->colidx[b][a]];
+                }
+            }
+            global_dpd_->buf4_mat_irrep_close(&L, h);
+
+            // Lambda_ijab = Lambda_IJAB
+            global_dpd_->buf4_mat_irrep_init(&Lbb, h);
+            if (nrows && ncols) C_DCOPY((size_t)nrows * ncols, Lap[0], 1, Lbb.matrix[h][0], 1);
+            global_dpd_->buf4_mat_irrep_wrt(&Laa, h);
+            global_dpd_->buf4_mat_irrep_wrt(&Lbb, h);
+            global_dpd_->buf4_mat_irrep_close(&Laa, h);
+            global_dpd_->buf4_mat_irrep_close(&Lbb, h);
+        }
+        global_dpd_->buf4_close(&Laa);
+        global_dpd_->buf4_close(&Lbb);
+        global_dpd_->buf4_close(&D);
+        global_dpd_->buf4_close(&R);
+        global_dpd_->buf4_close(&L);
+    } else {
+        global_dpd_->buf4_dirprd(&D, &R);
+        global_dpd_->buf4_close(&D);
+        // Update new cumulant
+        dpd_buf4_add(&L, &R, 1.0);
+        global_dpd_->buf4_close(&L);
+
+        global_dpd_->buf4_close(&R);
+
+        /* update lambda <OO|VV> for tau and G intermediates */
+        global_dpd_->buf4_init(&L, PSIF_DCFT_DPD, 0, ID("[O,O]"), ID("[V,V]"), ID("[O,O]"), ID("[V,V]"), 1,
+                               "Lambda SF <OO|VV>");
+        global_dpd_->buf4_copy(&L, PSIF_DCFT_DPD, "Lambda <OO|VV>");
+        global_dpd_->buf4_copy(&L, PSIF_DCFT_DPD, "Lambda <oo|vv>");
+        global_dpd_->buf4_close(&L);
+    }
 
     psio_->close(PSIF_LIBTRANS_DPD, 1);
 
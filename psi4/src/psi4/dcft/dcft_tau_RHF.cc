@@ -36,9 +36,16 @@
 #include "psi4/psifiles.h"
 #include "psi4/libtrans/integraltransform.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/process.h"
 
 #include <algorithm>
+#include <cstring>
 #include <functional>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 namespace psi {
 namespace dcft {
@@ -62,33 +69,60 @@ void DCFTSolver::build_tau_RHF() {
 
     global_dpd_->buf4_init(&L1, PSIF_DCFT_DPD, 0, _ints->DPD_ID("[O,O]"), _ints->DPD_ID("[V,V]"), ID("[O,O]"),
                            ID("[V,V]"), 0, "Lambda <OO|VV>");
-    global_dpd_->buf4_init(&L2, PSIF_DCFT_DPD, 0, _ints->DPD_ID("[O,O]"), _ints->DPD_ID("[V,V]"), ID("[O,O]"),
-                           ID("[V,V]"), 0, "Lambda <OO|VV>");
 
-    /*
-     * Tau_IJ = -1/2 Lambda_IKAB Lambda_JKAB
-     */
-    global_dpd_->contract442(&L1, &L2, &T_OO, 0, 0, -0.5, 0.0);
-    /*
-     * Tau_AB = +1/2 Lambda_IJAC Lambda_IJBC
-     */
-    global_dpd_->contract442(&L1, &L2, &T_VV, 2, 2, 0.5, 0.0);
-    global_dpd_->buf4_close(&L1);
-    global_dpd_->buf4_close(&L2);
+    if (options_.get_str("DCFT_TYPE") == "DF" && dpd_buf4_fits_in_core(&L1, 1)) {
+        // The cumulant blocks fit in memory: contract each irrep block once with threaded DGEMMs
+        global_dpd_->file2_mat_init(&T_OO);
+        global_dpd_->file2_mat_init(&T_VV);
+        for (int h = 0; h < nirrep_; ++h) {
+            if (naoccpi_[h]) ::memset(T_OO.matrix[h][0], 0, sizeof(double) * naoccpi_[h] * naoccpi_[h]);
+            if (navirpi_[h]) ::memset(T_VV.matrix[h][0], 0, sizeof(double) * navirpi_[h] * navirpi_[h]);
+        }
+        // Tau_IJ = -1/2 Lambda_IKAB Lambda_JKAB, Tau_AB = +1/2 Lambda_IJAC Lambda_IJBC
+        build_tau_in_core_RHF(&L1, &T_OO, &T_VV, 0.5);
+        global_dpd_->buf4_close(&L1);
+
+        global_dpd_->buf4_init(&L1, PSIF_DCFT_DPD, 0, ID("[O,O]"), ID("[V,V]"), ID("[O,O]"), ID("[V,V]"), 0,
+                               "Lambda SF <OO|VV>");  // Lambda <Oo|Vv>
+        // Tau_IJ -= Lambda_IkAb Lambda_JkAb, Tau_AB += Lambda_IjAc Lambda_IjBc
+        build_tau_in_core_RHF(&L1, &T_OO, &T_VV, 1.0);
+        global_dpd_->buf4_close(&L1);
+
+        global_dpd_->file2_mat_wrt(&T_OO);
+        global_dpd_->file2_mat_wrt(&T_VV);
+        global_dpd_->file2_mat_close(&T_OO);
+        global_dpd_->file2_mat_close(&T_VV);
+    } else {
+        global_dpd_->buf4_init(&L2, PSIF_DCFT_DPD, 0, _ints->DPD_ID("[O,O]"), _ints->DPD_ID("[V,V]"), ID("[O,O]"),
+                               ID("[V,V]"), 0, "Lambda <OO|VV>");
 
-    global_dpd_->buf4_init(&L1, PSIF_DCFT_DPD, 0, ID("[O,O]"), ID("[V,V]"), ID("[O,O]"), ID("[V,V]"), 0,
-                           "Lambda SF <OO|VV>");  // Lambda <Oo|Vv>
-    global_dpd_->buf4_init(&L2, PSIF_DCFT_DPD, 0, ID("[O,O]"), ID("[V,V]"), ID("[O,O]"), ID("[V,V]"), 0,
-                           "Lambda SF <OO|VV>");  // Lambda <Oo|Vv>
+        /*
+         * Tau_IJ = -1/2 Lambda_IKAB Lambda_JKAB
+         */
+        global_dpd_->contract442(&L1, &L2, &T_OO, 0, 0, -0.5, 0.0);
+        /*
+         * Tau_AB = +1/2 Lambda_IJAC Lambda_IJBC
+         */
+        global_dpd_->contract442(&L1, &L2, &T_VV, 2, 2, 0.5, 0.0);
+        global_dpd_->buf4_close(&L1);
+        global_dpd_->buf4_close(&L2);
 
-    /*
-     * Tau_IJ -= 1/2 Lambda_IkAb Lambda_JkAb - 1/2 Lambda_IkaB Lambda_JkaB
-     */
-    global_dpd_->contract442(&L1, &L2, &T_OO, 0, 0, -1.0, 1.0);
-    /*
-     * Tau_AB += 1/2 Lambda_IjAc Lambda_IjBc + 1/2 Lambda_iJAc Lambda_iJBc
-     */
-    global_dpd_->contract442(&L1, &L2, &T_VV, 2, 2, 1.0, 1.0);
+        global_dpd_->buf4_init(&L1, PSIF_DCFT_DPD, 0, ID("[O,O]"), ID("[V,V]"), ID("[O,O]"), ID("[V,V]"), 0,
+                               "Lambda SF <OO|VV>");  // Lambda <Oo|Vv>
+        global_dpd_->buf4_init(&L2, PSIF_DCFT_DPD, 0, ID("[O,O]"), ID("[V,V]"), ID("[O,O]"), ID("[V,V]"), 0,
+                               "Lambda SF <OO|VV>");  // Lambda <Oo|Vv>
+
+        /*
+         * Tau_IJ -= 1/2 Lambda_IkAb Lambda_JkAb - 1/2 Lambda_IkaB Lambda_JkaB
+         */
+        global_dpd_->contract442(&L1, &L2, &T_OO, 0, 0, -1.0, 1.0);
+        /*
+         * Tau_AB += 1/2 Lambda_IjAc Lambda_IjBc + 1/2 Lambda_iJAc Lambda_iJBc
+         */
+        global_dpd_->contract442(&L1, &L2, &T_VV, 2, 2, 1.0, 1.0);
+        global_dpd_->buf4_close(&L1);
+        global_dpd_->buf4_close(&L2);
+    }
 
     global_dpd_->file2_close(&T_OO);
     global_dpd_->file2_close(&T_VV);
@@ -125,6 +159,72 @@ void DCFTSolver::build_tau_RHF() {
     dcft_timer_off("DCFTSolver::build_tau()");
 }
 
+/**
+ * Accumulates the contribution of one in-core cumulant into the occupied and virtual Tau blocks,
+ * Tau_IJ -= alpha Lambda_IKAB Lambda_JKAB and Tau_AB += alpha Lambda_IJAC Lambda_IJBC.
+ * The rows of Lambda with a fixed first index are contiguous, so each occupied block is a single
+ * DGEMM; the virtual blocks are accumulated row by row into per-thread buffers.
+ */
+void DCFTSolver::build_tau_in_core_RHF(dpdbuf4 *L, dpdfile2 *T_OO, dpdfile2 *T_VV, double alpha) {
+    int nthreads = 1;
+#ifdef _OPENMP
+    nthreads = Process::environment.get_n_threads();
+#endif
+    dpdparams4 *params = L->params;
+
+    std::vector<size_t> vir_offset(nirrep_ + 1, 0);
+    for (int h = 0; h < nirrep_; ++h) vir_offset[h + 1] = vir_offset[h] + (size_t)navirpi_[h] * navirpi_[h];
+    std::vector<std::vector<double>> T_VV_thread(nthreads, std::vector<double>(vir_offset[nirrep_], 0.0));
+
+    for (int h = 0; h < nirrep_; ++h) {
+        int nrows = params->rowtot[h];
+        int ncols = params->coltot[h];
+        if (nrows == 0 || ncols == 0) continue;
+        global_dpd_->buf4_mat_irrep_init(L, h);
+        global_dpd_->buf4_mat_irrep_rd(L, h);
+        double **Lp = L->matrix[h];
+
+        // Tau_IJ -= alpha Lambda_IKAB Lambda_JKAB
+        for (int Gi = 0; Gi < nirrep_; ++Gi) {
+            int Gk = h ^ Gi;
+            int ni = params->ppi[Gi];
+            int nk = params->qpi[Gk];
+            if (ni == 0 || nk == 0) continue;
+            int row = params->rowidx[params->poff[Gi]][params->qoff[Gk]];
+            int length = nk * ncols;
+            C_DGEMM('N', 'T', ni, ni, length, -alpha, Lp[row], length, Lp[row], length, 1.0, T_OO->matrix[Gi][0],
+                    ni);
+        }
+
+        // Tau_AB += alpha Lambda_IJAC Lambda_IJBC
+#pragma omp parallel for schedule(static) num_threads(nthreads)
+        for (int row = 0; row < nrows; ++row) {
+            int thread = 0;
+#ifdef _OPENMP
+            thread = omp_get_thread_num();
+#endif
+            for (int Ga = 0; Ga < nirrep_; ++Ga) {
+                int Gc = h ^ Ga;
+                int na = params->rpi[Ga];
+                int nc = params->spi[Gc];
+                if (na == 0 || nc == 0) continue;
+                double *Lrow = &Lp[row][params->colidx[params->roff[Ga]][params->soff[Gc]]];
+                C_DGEMM('N', 'T', na, na, nc, alpha, Lrow, nc, Lrow, nc, 1.0, &T_VV_thread[thread][vir_offset[Ga]],
+                        na);
+            }
+        }
+        global_dpd_->buf4_mat_irrep_close(L, h);
+    }
+
+    for (int h = 0; h < nirrep_; ++h) {
+        size_t size = vir_offset[h + 1] - vir_offset[h];
+        if (size == 0) continue;
+        for (int thread = 0; thread < nthreads; ++thread) {
+            C_DAXPY(size, 1.0, &T_VV_thread[thread][vir_offset[h]], 1, T_VV->matrix[h][0], 1);
+        }
+    }
+}
+
 void DCFTSolver::refine_tau_RHF() {
     dcft_timer_on("DCFTSolver::refine_tau()");
 
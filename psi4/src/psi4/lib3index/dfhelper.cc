@@ -178,23 +178,20 @@ void DFHelper::initialize() {
         outfile->Printf("%s in-core AOs.\n\n", (memory_ < required_core_size_) ? "Turning off" : "Using");
     }
 
+    // wK is only built from in-core, symmetric (STORE) AOs
+    if (do_wK_ && (!AO_core_ || direct_ || direct_iaQ_)) {
+        std::stringstream error;
+        error << "DFHelper: wK builds require the in-core STORE algorithm; the AOs need "
+              << required_core_size_ * 8 / (1024 * 1024 * 1024.0) << " [GiB].";
+        throw PSIEXCEPTION(error.str().c_str());
+    }
+
     // prepare AOs for STORE method
     if (AO_core_) {
         prepare_AO_core();
-        if (do_wK_) {
-            std::stringstream error;
-            error << "DFHelper: not equipped to do wK";
-            throw PSIEXCEPTION(error.str().c_str());
-            // TODO prepare_AO_wK_core();
-        }
+        if (do_wK_) prepare_AO_wK_core();
     } else if (!direct_ && !direct_iaQ_) {
         prepare_AO();
-        if (do_wK_) {
-            std::stringstream error;
-            error << "DFHelper: not equipped to do wK";
-            throw PSIEXCEPTION(error.str().c_str());
-            // TODO prepare_AO_wK();
-        }
     }
 
     built_ = true;
@@ -213,7 +210,7 @@ void DFHelper::AO_core() {
         required_core_size_ = naux_ * nbf_ * nbf_;
     } else {
         // total size of sparse AOs
-        required_core_size_ = (do_wK_ ? 3 * big_skips_[nbf_] : big_skips_[nbf_]);
+        required_core_size_ = (do_wK_ ? 2 * big_skips_[nbf_] : big_skips_[nbf_]);
     }
 
     // Auxiliary metric
@@ -514,7 +511,7 @@ void DFHelper::prepare_AO_core() {
 
             // contract metric
             timer_on("DFH: AO-Met. Contraction");
-            contract_metric_AO_core_symm(Mp, metp, begin, end);
+            contract_metric_AO_core_symm(Mp, Ppq_.get(), metp, begin, end);
             timer_off("DFH: AO-Met. Contraction");
         }
         // no more need for metrics
@@ -522,6 +519,62 @@ void DFHelper::prepare_AO_core() {
     }
     // outfile->Printf("\n    ==> End AO Blocked Construction <==");
 }
+void DFHelper::prepare_AO_wK_core() {
+    // get each thread an erf-attenuated eri object
+    std::shared_ptr<BasisSet> zero = BasisSet::zero_ao_basis_set();
+    auto rifactory = std::make_shared<IntegralFactory>(aux_, zero, primary_, primary_);
+    std::vector<std::shared_ptr<TwoBodyAOInt>> weri(nthreads_);
+#pragma omp parallel num_threads(nthreads_)
+    {
+        int rank = 0;
+#ifdef _OPENMP
+        rank = omp_get_thread_num();
+#endif
+        weri[rank] = std::shared_ptr<TwoBodyAOInt>(rifactory->erf_eri(omega_));
+    }
+
+    // determine blocking, Ppq_ is already held in core
+    std::vector<std::pair<size_t, size_t>> psteps;
+    std::pair<size_t, size_t> plargest = pshell_blocks_for_AO_build(memory_ - big_skips_[nbf_], 1, psteps);
+
+    wPpq_ = std::unique_ptr<double[]>(new double[big_skips_[nbf_]]);
+
+    // declare sparse buffer
+    std::unique_ptr<double[]> Qpq(new double[std::get<0>(plargest)]);
+    double* Mp = Qpq.get();
+    std::unique_ptr<double[]> metric;
+    double* metp;
+
+    // (A|mn) J^mpower J^wpower (A|w|mn) = (A|mn) J^-1 (A|w|mn)
+    double wpower = -1.0 - mpower_;
+    if (!hold_met_) {
+        metric = std::unique_ptr<double[]>(new double[naux_ * naux_]);
+        metp = metric.get();
+        std::string filename = return_metfile(wpower);
+        get_tensor_(std::get<0>(files_[filename]), metp, 0, naux_ - 1, 0, naux_ - 1);
+    } else {
+        prepare_metric_core();
+        metp = metric_prep_core(wpower);
+    }
+
+    for (size_t i = 0; i < psteps.size(); i++) {
+        size_t start = std::get<0>(psteps[i]);
+        size_t stop = std::get<1>(psteps[i]);
+        size_t begin = pshell_aggs_[start];
+        size_t end = pshell_aggs_[stop + 1] - 1;
+
+        // compute
+        timer_on("DFH: wAO Construction");
+        compute_sparse_pQq_blocking_p_symm(start, stop, Mp, weri);
+        timer_off("DFH: wAO Construction");
+
+        // contract metric
+        timer_on("DFH: wAO-Met. Contraction");
+        contract_metric_AO_core_symm(Mp, wPpq_.get(), metp, begin, end);
+        timer_off("DFH: wAO-Met. Contraction");
+    }
+    if (hold_met_) metrics_.clear();
+}
 std::pair<size_t, size_t> DFHelper::pshell_blocks_for_AO_build(const size_t mem, size_t symm,
                                                                std::vector<std::pair<size_t, size_t>>& b) {
     size_t full_3index = (symm ? big_skips_[nbf_] : 0);
@@ -641,7 +694,7 @@ std::tuple<size_t, size_t> DFHelper::Qshell_blocks_for_JK_build(std::vector<std:
     size_t T3 = std::max(nthreads_ * nbf_ * nbf_, nthreads_ * nbf_ * max_nocc);
 
     // total AO buffer size is max if core alg is used, otherwise init to 0
-    size_t total_AO_buffer = (AO_core_ ? big_skips_[nbf_] : 0);
+    size_t total_AO_buffer = (AO_core_ ? (do_wK_ ? 2 : 1) * big_skips_[nbf_] : 0);
 
     size_t block_size = 0, largest = 0;
     for (size_t i = 0, tmpbs = 0, count = 1; i < Qshells_; i++, count++) {
@@ -1374,7 +1427,7 @@ void DFHelper::contract_metric_AO_core(double* Qpq, double* metp) {
     }
 }
 
-void DFHelper::contract_metric_AO_core_symm(double* Qpq, double* metp, size_t begin, size_t end) {
+void DFHelper::contract_metric_AO_core_symm(double* Qpq, double* Ppq, double* metp, size_t begin, size_t end) {
     // loop and contract
     size_t startind = symm_big_skips_[begin];
 #pragma omp parallel for num_threads(nthreads_) schedule(guided)
@@ -1384,11 +1437,10 @@ void DFHelper::contract_metric_AO_core_symm(double* Qpq, double* metp, size_t be
         size_t jump = symm_ignored_columns_[j];
         size_t skip1 = big_skips_[j];
         size_t skip2 = symm_big_skips_[j] - startind;
-        C_DGEMM('N', 'N', naux_, mi, naux_, 1.0, metp, naux_, &Qpq[skip2], mi, 0.0, &Ppq_[skip1 + jump], si);
+        C_DGEMM('N', 'N', naux_, mi, naux_, 1.0, metp, naux_, &Qpq[skip2], mi, 0.0, &Ppq[skip1 + jump], si);
     }
 
     // copy upper-to-lower
-    double* Ppq = Ppq_.get();
 #pragma omp parallel for num_threads(nthreads_) schedule(static)
     for (size_t omu = begin; omu <= end; omu++) {
         for (size_t Q = 0; Q < naux_; Q++) {
@@ -2692,20 +2744,20 @@ std::tuple<size_t, size_t, size_t> DFHelper::get_tensor_shape(std::string name)
     return sizes_[std::get<1>(files_[name])];
 }
 void DFHelper::build_JK(std::vector<SharedMatrix> Cleft, std::vector<SharedMatrix> Cright, std::vector<SharedMatrix> D,
-                        std::vector<SharedMatrix> J, std::vector<SharedMatrix> K, size_t max_nocc, bool do_J, bool do_K,
-                        bool do_wK, bool lr_symmetric) {
+                        std::vector<SharedMatrix> J, std::vector<SharedMatrix> K, std::vector<SharedMatrix> wK,
+                        size_t max_nocc, bool do_J, bool do_K, bool do_wK, bool lr_symmetric) {
     if (debug_) {
         outfile->Printf("Entering DFHelper::build_JK\n");
     }
 
-    if (do_J || do_K) {
+    if (do_wK && !wPpq_) {
+        throw PSIEXCEPTION("DFHelper::build_JK: wK requested, but wK AOs were not built in initialize().");
+    }
+
+    if (do_J || do_K || do_wK) {
         timer_on("DFH: compute_JK()");
-        compute_JK(Cleft, Cright, D, J, K, max_nocc, do_J, do_K, do_wK, lr_symmetric);
+        compute_JK(Cleft, Cright, D, J, K, wK, max_nocc, do_J, do_K, do_wK, lr_symmetric);
         timer_off("DFH: compute_JK()");
-    } else {
-        timer_on("DFH: compute_wK()");
-        ;  // TODO compute_wK(Cleft, Cright, D, J, K, max_nocc, do_J, do_K, do_wK);
-        timer_off("DFH: compute_wK()");
     }
 
     if (debug_) {
@@ -2714,7 +2766,8 @@ void DFHelper::build_JK(std::vector<SharedMatrix> Cleft, std::vector<SharedMatri
 }
 void DFHelper::compute_JK(std::vector<SharedMatrix> Cleft, std::vector<SharedMatrix> Cright,
                           std::vector<SharedMatrix> D, std::vector<SharedMatrix> J, std::vector<SharedMatrix> K,
-                          size_t max_nocc, bool do_J, bool do_K, bool do_wK, bool lr_symmetric) {
+                          std::vector<SharedMatrix> wK, size_t max_nocc, bool do_J, bool do_K, bool do_wK,
+                          bool lr_symmetric) {
     // outfile->Printf("\n     ==> DFHelper:--Begin J/K builds <==\n\n");
     // outfile->Printf("\n     ==> Using the %s directive with AO_CORE = %d <==\n\n", method_.c_str(), AO_core_);
 
@@ -2729,13 +2782,32 @@ void DFHelper::compute_JK(std::vector<SharedMatrix> Cleft, std::vector<SharedMat
     // the strided disk reads for the AOs will result in a definite loss to DiskDFJK in the disk-bound realm
     // 2. we could allocate the buffers only once, instead of every time compute_JK() is called
     std::vector<std::pair<size_t, size_t>> Qsteps;
-    std::tuple<size_t, size_t> info = Qshell_blocks_for_JK_build(Qsteps, max_nocc, lr_symmetric);
+    // wK always needs a second (right) transform, as does non-symmetric K
+    std::tuple<size_t, size_t> info = Qshell_blocks_for_JK_build(Qsteps, max_nocc, lr_symmetric && !do_wK);
     size_t tots = std::get<0>(info);
     size_t totsb = std::get<1>(info);
 
     // prep stream, blocking
     if (!direct_ && !AO_core_) stream_check(AO_files_[AO_names_[1]], "rb");
 
+    // local K: D = L L^T with pivoted Cholesky vectors, which are as local as D itself.
+    // any rotation of the occupied space leaves K unchanged, so L replaces Cleft/Cright.
+    bool local_K = do_K && local_K_ && lr_symmetric;
+
+    // with wK tasked, canonical K shares the left transforms and is built alongside it
+    bool fused_K = do_K && do_wK && !local_K;
+    std::vector<SharedMatrix> Cloc;
+    if (local_K) {
+        for (size_t i = 0; i < K.size(); i++) {
+            SharedMatrix L = D[i]->partial_cholesky_factorize(1.0E-12);
+            // buffers are sized for max_nocc, keep the canonical orbitals if the rank came out larger
+            Cloc.push_back(L->colspi()[0] <= Cleft[i]->colspi()[0] ? L : Cleft[i]);
+        }
+    }
+    // the orbital domains only depend on Cloc and the sparsity, not on the Q block
+    std::vector<LocalKDomains> local_domains;
+    if (local_K) local_domains = build_K_local_domains(Cloc);
+
     std::vector<std::vector<double>> C_buffers(nthreads_);
 
 // prepare C buffers
@@ -2761,7 +2833,7 @@ void DFHelper::compute_JK(std::vector<SharedMatrix> Cleft, std::vector<SharedMat
 
     // if lr_symmetric, we can be more clever with mem usage. T2 is used for both the
     // second tmp in the K build, as well as the completed, pruned J build.
-    if (lr_symmetric) {
+    if (lr_symmetric && !do_wK) {
         Ktmp_size = nbf_ * nbf_;  // size for pruned J build
     } else {
         Ktmp_size = std::max(nbf_ * nbf_, Ktmp_size);  // max necessary
@@ -2807,12 +2879,22 @@ void DFHelper::compute_JK(std::vector<SharedMatrix> Cleft, std::vector<SharedMat
             timer_off("DFH: compute_J");
         }
 
-        if (do_K) {
+        if (do_K && !fused_K) {
             timer_on("DFH: compute_K");
-            compute_K(Cleft, Cright, K, T1p, T2p, Mp, bcount, block_size, C_buffers, lr_symmetric);
+            if (local_K) {
+                compute_K_local(Cloc, local_domains, K, T1p, Mp, bcount, block_size, C_buffers);
+            } else {
+                compute_K(Cleft, Cright, K, T1p, T2p, Mp, bcount, block_size, C_buffers, lr_symmetric);
+            }
             timer_off("DFH: compute_K");
         }
 
+        if (do_wK) {
+            timer_on("DFH: compute_wK");
+            compute_wK(Cleft, Cright, K, wK, T1p, T2p, Mp, bcount, block_size, C_buffers, lr_symmetric, fused_K);
+            timer_off("DFH: compute_wK");
+        }
+
         bcount += block_size;
     }
     // outfile->Printf("\n     ==> DFHelper:--End J/K Builds (disk)<==\n\n");
@@ -2969,4 +3051,176 @@ void DFHelper::compute_K(std::vector<SharedMatrix> Cleft, std::vector<SharedMatr
     }
 }
 
+void DFHelper::compute_wK(std::vector<SharedMatrix> Cleft, std::vector<SharedMatrix> Cright, std::vector<SharedMatrix> K,
+                          std::vector<SharedMatrix> wK, double* T1p, double* T2p, double* Mp, size_t bcount,
+                          size_t block_size, std::vector<std::vector<double>>& C_buffers, bool lr_symmetric,
+                          bool do_K) {
+    // Mp and wPpq_ are both in-core here, wK is not built from disk AOs
+    double* wMp = wPpq_.get();
+    for (size_t i = 0; i < wK.size(); i++) {
+        size_t nocc = Cleft[i]->colspi()[0];
+        if (!nocc) {
+            continue;
+        }
+
+        double* Clp = Cleft[i]->pointer()[0];
+        double* Crp = Cright[i]->pointer()[0];
+        double* wKp = wK[i]->pointer()[0];
+
+        // compute the shared left tmp
+        first_transform_pQq(nocc, bcount, block_size, Mp, T1p, Clp, C_buffers);
+
+        // compute K from it first, while T2 is free
+        if (do_K) {
+            double* Kp = K[i]->pointer()[0];
+            double* Kr = T1p;
+            if (!lr_symmetric) {
+                first_transform_pQq(nocc, bcount, block_size, Mp, T2p, Crp, C_buffers);
+                Kr = T2p;
+            }
+            C_DGEMM('N', 'T', nbf_, nbf_, nocc * block_size, 1.0, T1p, nocc * block_size, Kr, nocc * block_size, 1.0,
+                    Kp, nbf_);
+        }
+
+        // compute the attenuated right tmp
+        first_transform_pQq(nocc, bcount, block_size, wMp, T2p, Crp, C_buffers);
+
+        // compute wK
+        C_DGEMM('N', 'T', nbf_, nbf_, nocc * block_size, 1.0, T1p, nocc * block_size, T2p, nocc * block_size, 1.0,
+                wKp, nbf_);
+    }
+}
+
+std::vector<DFHelper::LocalKDomains> DFHelper::build_K_local_domains(std::vector<SharedMatrix> Cloc) {
+    std::vector<LocalKDomains> domains(Cloc.size());
+    for (size_t i = 0; i < Cloc.size(); i++) {
+        size_t nocc = Cloc[i]->colspi()[0];
+        if (!nocc) {
+            continue;
+        }
+
+        double* Cp = Cloc[i]->pointer()[0];
+        std::vector<std::vector<size_t>>& p_orbs = domains[i].p_orbs;
+        std::vector<size_t>& p_starts = domains[i].p_starts;
+        std::vector<std::vector<std::pair<size_t, size_t>>>& orb_domains = domains[i].orb_domains;
+
+        // orbitals with a significant coefficient on each function m
+        std::vector<std::vector<size_t>> m_orbs(nbf_);
+        for (size_t m = 0; m < nbf_; m++) {
+            for (size_t a = 0; a < nocc; a++) {
+                if (std::fabs(Cp[m * nocc + a]) >= local_K_cutoff_) m_orbs[m].push_back(a);
+            }
+        }
+
+        // orbitals reaching each p through a Schwarz-significant (pm| pair
+        p_orbs.resize(nbf_);
+#pragma omp parallel num_threads(nthreads_)
+        {
+            std::vector<char> hit(nocc);
+#pragma omp for schedule(guided)
+            for (size_t p = 0; p < nbf_; p++) {
+                std::fill(hit.begin(), hit.end(), 0);
+                for (size_t m = 0; m < nbf_; m++) {
+                    if (schwarz_fun_mask_[p * nbf_ + m]) {
+                        for (size_t a : m_orbs[m]) hit[a] = 1;
+                    }
+                }
+                for (size_t a = 0; a < nocc; a++) {
+                    if (hit[a]) p_orbs[p].push_back(a);
+                }
+            }
+        }
+
+        // compressed (p|Q|a) starts, and each orbital's domain as (p, column in p's block)
+        p_starts.assign(nbf_ + 1, 0);
+        orb_domains.resize(nocc);
+        for (size_t p = 0; p < nbf_; p++) {
+            p_starts[p + 1] = p_starts[p] + p_orbs[p].size();
+            for (size_t c = 0; c < p_orbs[p].size(); c++) orb_domains[p_orbs[p][c]].push_back(std::make_pair(p, c));
+        }
+    }
+    return domains;
+}
+
+void DFHelper::compute_K_local(std::vector<SharedMatrix> Cloc, const std::vector<LocalKDomains>& domains,
+                               std::vector<SharedMatrix> K, double* T1p, double* Mp, size_t bcount,
+                               size_t block_size, std::vector<std::vector<double>>& C_buffers) {
+    // per-thread (b_i|Q) gathers and (b_i|b_i) products, grown on demand
+    std::vector<std::vector<double>> X_buffers(nthreads_);
+    std::vector<std::vector<double>> K_buffers(nthreads_);
+
+    for (size_t i = 0; i < K.size(); i++) {
+        size_t nocc = Cloc[i]->colspi()[0];
+        if (!nocc) {
+            continue;
+        }
+
+        double* Cp = Cloc[i]->pointer()[0];
+        double* Kp = K[i]->pointer()[0];
+        const std::vector<std::vector<size_t>>& p_orbs = domains[i].p_orbs;
+        const std::vector<size_t>& p_starts = domains[i].p_starts;
+        const std::vector<std::vector<std::pair<size_t, size_t>>>& orb_domains = domains[i].orb_domains;
+
+// first transform, only over the orbitals present at each p
+#pragma omp parallel for schedule(guided) num_threads(nthreads_)
+        for (size_t p = 0; p < nbf_; p++) {
+            size_t norb = p_orbs[p].size();
+            if (!norb) continue;
+
+            size_t sp_size = small_skips_[p];
+            size_t jump = (AO_core_ ? big_skips_[p] + bcount * sp_size : (big_skips_[p] * block_size) / naux_);
+
+            int rank = 0;
+#ifdef _OPENMP
+            rank = omp_get_thread_num();
+#endif
+            double* Csub = C_buffers[rank].data();
+            for (size_t m = 0, sp_count = 0; m < nbf_; m++) {
+                if (schwarz_fun_mask_[p * nbf_ + m]) {
+                    for (size_t c = 0; c < norb; c++) Csub[sp_count * norb + c] = Cp[m * nocc + p_orbs[p][c]];
+                    sp_count++;
+                }
+            }
+
+            // (Qm)(ma)->(Qa)
+            C_DGEMM('N', 'N', block_size, norb, sp_size, 1.0, &Mp[jump], sp_size, Csub, norb, 0.0,
+                    &T1p[block_size * p_starts[p]], norb);
+        }
+
+// K_pq += sum_a (p|Q|a)(q|Q|a), one dense product per orbital domain
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads_)
+        for (size_t a = 0; a < nocc; a++) {
+            const std::vector<std::pair<size_t, size_t>>& domain = orb_domains[a];
+            size_t nB = domain.size();
+            if (!nB) continue;
+
+            int rank = 0;
+#ifdef _OPENMP
+            rank = omp_get_thread_num();
+#endif
+            std::vector<double>& X = X_buffers[rank];
+            std::vector<double>& Kl = K_buffers[rank];
+            if (X.size() < nB * block_size) X.resize(nB * block_size);
+            if (Kl.size() < nB * nB) Kl.resize(nB * nB);
+
+            for (size_t b = 0; b < nB; b++) {
+                size_t p = domain[b].first;
+                size_t norb = p_orbs[p].size();
+                double* Tp = &T1p[block_size * p_starts[p] + domain[b].second];
+                for (size_t Q = 0; Q < block_size; Q++) X[b * block_size + Q] = Tp[Q * norb];
+            }
+
+            C_DGEMM('N', 'T', nB, nB, block_size, 1.0, X.data(), block_size, X.data(), block_size, 0.0, Kl.data(), nB);
+
+            for (size_t b1 = 0; b1 < nB; b1++) {
+                size_t row = domain[b1].first * nbf_;
+                for (size_t b2 = 0; b2 < nB; b2++) {
+#pragma omp atomic update
+                    Kp[row + domain[b2].first] += Kl[b1 * nB + b2];
+                }
+            }
+        }
+    }
+}
+
 }  // End namespaces
@@ -145,7 +145,23 @@ class PSI_API DFHelper {
     /// @param omega double indicating parameter for other type
     ///
     void set_omega(double omega) { omega_ = omega; }
-    size_t get_omega() { return omega_; }
+    double get_omega() { return omega_; }
+
+    ///
+    /// Build symmetric K from Cholesky-localized occupied orbitals, restricting
+    /// each orbital to the AO functions it (and its Schwarz partners) touches
+    /// @param local_K boolean indicating to use the local K build
+    ///
+    void set_local_K(bool local_K) { local_K_ = local_K; }
+    bool get_local_K() { return local_K_; }
+
+    ///
+    /// sets the coefficient magnitude below which a localized orbital is
+    /// considered absent from an AO function
+    /// @param cutoff double, defaults to 1e-5
+    ///
+    void set_local_K_cutoff(double cutoff) { local_K_cutoff_ = cutoff; }
+    double get_local_K_cutoff() { return local_K_cutoff_; }
 
     ///
     /// set the printing verbosity parameter
@@ -274,8 +290,8 @@ class PSI_API DFHelper {
 
     /// builds J/K
     void build_JK(std::vector<SharedMatrix> Cleft, std::vector<SharedMatrix> Cright, std::vector<SharedMatrix> D,
-                  std::vector<SharedMatrix> J, std::vector<SharedMatrix> K, size_t max_nocc, bool do_J, bool do_K,
-                  bool do_wK, bool lr_symmetric);
+                  std::vector<SharedMatrix> J, std::vector<SharedMatrix> K, std::vector<SharedMatrix> wK,
+                  size_t max_nocc, bool do_J, bool do_K, bool do_wK, bool lr_symmetric);
 
    protected:
     // => basis sets <=
@@ -306,6 +322,8 @@ class PSI_API DFHelper {
     bool ordered_ = false;
     bool do_wK_ = false;
     double omega_;
+    bool local_K_ = false;
+    double local_K_cutoff_ = 1e-5;
     bool debug_ = false;
     bool sparsity_prepared_ = false;
     int print_lvl_ = 1;
@@ -313,11 +331,14 @@ class PSI_API DFHelper {
     // => in-core machinery <=
     void AO_core();
     std::unique_ptr<double[]> Ppq_;
+    // erf-attenuated AOs, fit with the complementary metric power so that Ppq_ * wPpq_ ~ (A|mn) J^-1 (A|w|mn)
+    std::unique_ptr<double[]> wPpq_;
     std::map<double, SharedMatrix> metrics_;
 
     // => AO building machinery <=
     void prepare_AO();
     void prepare_AO_core();
+    void prepare_AO_wK_core();
     void compute_dense_Qpq_blocking_Q(const size_t start, const size_t stop, double* Mp,
                                       std::vector<std::shared_ptr<TwoBodyAOInt>> eri);
     void compute_sparse_pQq_blocking_Q(const size_t start, const size_t stop, double* Mp,
@@ -326,7 +347,7 @@ class PSI_API DFHelper {
                                        std::vector<std::shared_ptr<TwoBodyAOInt>> eri);
     void compute_sparse_pQq_blocking_p_symm(const size_t start, const size_t stop, double* Mp,
                                             std::vector<std::shared_ptr<TwoBodyAOInt>> eri);
-    void contract_metric_AO_core_symm(double* Qpq, double* metp, size_t begin, size_t end);
+    void contract_metric_AO_core_symm(double* Qpq, double* Ppq, double* metp, size_t begin, size_t end);
     void grab_AO(const size_t start, const size_t stop, double* Mp);
 
     // first integral transforms
@@ -447,8 +468,8 @@ class PSI_API DFHelper {
 
     // => JK <=
     void compute_JK(std::vector<SharedMatrix> Cleft, std::vector<SharedMatrix> Cright, std::vector<SharedMatrix> D,
-                    std::vector<SharedMatrix> J, std::vector<SharedMatrix> K, size_t max_nocc, bool do_J, bool do_K,
-                    bool do_wK, bool lr_symmetric);
+                    std::vector<SharedMatrix> J, std::vector<SharedMatrix> K, std::vector<SharedMatrix> wK,
+                    size_t max_nocc, bool do_J, bool do_K, bool do_wK, bool lr_symmetric);
     void compute_D(std::vector<SharedMatrix> D, std::vector<SharedMatrix> Cleft, std::vector<SharedMatrix> Cright);
     void compute_J(std::vector<SharedMatrix> D, std::vector<SharedMatrix> J, double* Mp, double* T1p, double* T2p,
                    std::vector<std::vector<double>>& D_buffers, size_t bcount, size_t block_size);
@@ -457,6 +478,22 @@ class PSI_API DFHelper {
     void compute_K(std::vector<SharedMatrix> Cleft, std::vector<SharedMatrix> Cright, std::vector<SharedMatrix> K,
                    double* Tp, double* Jtmp, double* Mp, size_t bcount, size_t block_size,
                    std::vector<std::vector<double>>& C_buffers, bool lr_symmetric);
+    void compute_wK(std::vector<SharedMatrix> Cleft, std::vector<SharedMatrix> Cright, std::vector<SharedMatrix> K,
+                    std::vector<SharedMatrix> wK, double* T1p, double* T2p, double* Mp, size_t bcount,
+                    size_t block_size, std::vector<std::vector<double>>& C_buffers, bool lr_symmetric, bool do_K);
+    /// Sparsity of the local-K transforms for one set of local orbitals, independent of the Q block
+    struct LocalKDomains {
+        /// orbitals reaching each p through a Schwarz-significant (pm| pair
+        std::vector<std::vector<size_t>> p_orbs;
+        /// running sum of p_orbs sizes; times the block size, the offset of p in the compressed (p|Q|a)
+        std::vector<size_t> p_starts;
+        /// each orbital's domain as (p, column in p's block)
+        std::vector<std::vector<std::pair<size_t, size_t>>> orb_domains;
+    };
+    std::vector<LocalKDomains> build_K_local_domains(std::vector<SharedMatrix> Cloc);
+    void compute_K_local(std::vector<SharedMatrix> Cloc, const std::vector<LocalKDomains>& domains,
+                         std::vector<SharedMatrix> K, double* T1p, double* Mp, size_t bcount, size_t block_size,
+                         std::vector<std::vector<double>>& C_buffers);
     std::tuple<size_t, size_t> Qshell_blocks_for_JK_build(std::vector<std::pair<size_t, size_t>>& b, size_t max_nocc,
                                                           bool lr_symmetric);
 
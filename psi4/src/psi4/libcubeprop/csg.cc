@@ -29,6 +29,7 @@
 #include "csg.h"
 
 #include <algorithm>
+#include <cmath>
 #ifdef _OPENMP
 #include <omp.h>
 #endif
@@ -45,6 +46,7 @@
 #include "psi4/libmints/molecule.h"
 #include "psi4/libmints/potential.h"
 #include "psi4/libmints/sieve.h"
+#include "psi4/libmints/vector3.h"
 #include "psi4/libmints/vector.h"
 #include "psi4/liboptions/liboptions.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
@@ -65,6 +67,11 @@ CubicScalarGrid::CubicScalarGrid(std::shared_ptr<BasisSet> primary, Options& opt
     D_ = new double[3];
     O_ = new double[3];
 
+    nthreads_ = 1;
+#ifdef _OPENMP
+    nthreads_ = Process::environment.get_n_threads();
+#endif
+
     build_grid();  // Defaults from Options
 }
 CubicScalarGrid::~CubicScalarGrid() {
@@ -165,7 +172,9 @@ void CubicScalarGrid::populate_grid() {
     nxyz_ = std::llround(pow((double)max_points, 1.0 / 3.0));
 
     blocks_.clear();
+    block_offsets_.clear();
     size_t offset = 0L;
+    size_t max_block = 0L;
     for (int istart = 0L; istart <= N_[0]; istart += nxyz_) {
         int ni = (istart + nxyz_ > N_[0] ? (N_[0] + 1) - istart : nxyz_);
         for (int jstart = 0L; jstart <= N_[1]; jstart += nxyz_) {
@@ -177,6 +186,7 @@ void CubicScalarGrid::populate_grid() {
                 double* yp = &y_[offset];
                 double* zp = &z_[offset];
                 double* wp = &w_[offset];
+                block_offsets_.push_back(offset);
 
                 size_t block_size = 0L;
                 for (int i = istart; i < istart + ni; i++) {
@@ -191,10 +201,13 @@ void CubicScalarGrid::populate_grid() {
                         }
                     }
                 }
+                max_block = std::max(max_block, block_size);
                 blocks_.push_back(std::make_shared<BlockOPoints>(0, block_size, xp, yp, zp, wp, extents_));
             }
         }
     }
+    // Blocks are ordered slab-major, so each slab of nxyz_ x-planes is a contiguous run of blocks
+    nslab_blocks_ = ((N_[1] + nxyz_) / nxyz_) * ((N_[2] + nxyz_) / nxyz_);
 
     int max_functions = 0L;
     for (int ind = 0; ind < blocks_.size(); ind++) {
@@ -203,8 +216,11 @@ void CubicScalarGrid::populate_grid() {
                              : blocks_[ind]->functions_local_to_global().size());
     }
 
-    points_ = std::make_shared<RKSFunctions>(primary_, max_points, max_functions);
-    points_->set_ansatz(0);
+    points_.clear();
+    for (int thread = 0; thread < nthreads_; thread++) {
+        points_.push_back(std::make_shared<RKSFunctions>(primary_, max_block, max_functions));
+        points_[thread]->set_ansatz(0);
+    }
 }
 void CubicScalarGrid::print_header() {
     outfile->Printf("  ==> CubicScalarGrid <==\n\n");
@@ -224,6 +240,7 @@ void CubicScalarGrid::print_header() {
     outfile->Printf("    X Maximum    = %16.3E\n", O_[0] + D_[0] * N_[0]);
     outfile->Printf("    Y Maximum    = %16.3E\n", O_[1] + D_[1] * N_[1]);
     outfile->Printf("    Z Maximum    = %16.3E\n", O_[2] + D_[2] * N_[2]);
+    outfile->Printf("    Threads      = %16d\n", nthreads_);
     outfile->Printf("\n");
 
     primary_->print();
@@ -236,32 +253,7 @@ void CubicScalarGrid::write_gen_file(double* v, const std::string& name, const s
         throw PSIEXCEPTION("CubicScalarGrid: Unrecognized output file type");
     }
 }
-void CubicScalarGrid::write_cube_file(double* v, const std::string& name, const std::string& comment) {
-    // => Reorder the grid <= //
-
-    double* v2 = new double[npoints_];
-    size_t offset = 0L;
-    for (int istart = 0L; istart <= N_[0]; istart += nxyz_) {
-        int ni = (istart + nxyz_ > N_[0] ? (N_[0] + 1) - istart : nxyz_);
-        for (int jstart = 0L; jstart <= N_[1]; jstart += nxyz_) {
-            int nj = (jstart + nxyz_ > N_[1] ? (N_[1] + 1) - jstart : nxyz_);
-            for (int kstart = 0L; kstart <= N_[2]; kstart += nxyz_) {
-                int nk = (kstart + nxyz_ > N_[2] ? (N_[2] + 1) - kstart : nxyz_);
-                for (int i = istart; i < istart + ni; i++) {
-                    for (int j = jstart; j < jstart + nj; j++) {
-                        for (int k = kstart; k < kstart + nk; k++) {
-                            size_t index = i * (N_[1] + 1L) * (N_[2] + 1L) + j * (N_[2] + 1L) + k;
-                            v2[index] = v[offset];
-                            offset++;
-                        }
-                    }
-                }
-            }
-        }
-    }
-
-    // => Drop the grid out <= //
-
+FILE* CubicScalarGrid::open_cube_file(const std::string& name, const std::string& comment) {
     std::stringstream ss;
     ss << filepath_ << "/" << name << ".cube";
 
@@ -291,28 +283,228 @@ void CubicScalarGrid::write_cube_file(double* v, const std::string& name, const
                 mol_->z(A));
     }
 
-    // Data, striped (x, y, z)
-    for (size_t ind = 0; ind < npoints_; ind++) {
+    return fh;
+}
+void CubicScalarGrid::write_cube_slab(FILE* fh, double* v, int istart, int ni) {
+    // => Reorder the slab <= //
+
+    size_t nplane = (N_[1] + 1L) * (N_[2] + 1L);
+    std::vector<double> v2(ni * nplane);
+    size_t offset = 0L;
+    for (int jstart = 0L; jstart <= N_[1]; jstart += nxyz_) {
+        int nj = (jstart + nxyz_ > N_[1] ? (N_[1] + 1) - jstart : nxyz_);
+        for (int kstart = 0L; kstart <= N_[2]; kstart += nxyz_) {
+            int nk = (kstart + nxyz_ > N_[2] ? (N_[2] + 1) - kstart : nxyz_);
+            for (int i = 0; i < ni; i++) {
+                for (int j = jstart; j < jstart + nj; j++) {
+                    for (int k = kstart; k < kstart + nk; k++) {
+                        size_t index = i * nplane + j * (N_[2] + 1L) + k;
+                        v2[index] = v[offset];
+                        offset++;
+                    }
+                }
+            }
+        }
+    }
+
+    // => Drop the slab out <= //
+
+    // Data, striped (x, y, z), six values per line counted over the whole grid
+    size_t global = istart * nplane;
+    for (size_t ind = 0; ind < v2.size(); ind++, global++) {
         fprintf(fh, "%12.5E ", v2[ind]);
-        if (ind % 6 == 5) fprintf(fh, "\n");
+        if (global % 6 == 5) fprintf(fh, "\n");
+    }
+}
+void CubicScalarGrid::write_cube_file(double* v, const std::string& name, const std::string& comment) {
+    FILE* fh = open_cube_file(name, comment);
+
+    for (size_t start = 0L; start < blocks_.size(); start += nslab_blocks_) {
+        int istart = (start / nslab_blocks_) * nxyz_;
+        int ni = (istart + nxyz_ > N_[0] ? (N_[0] + 1) - istart : nxyz_);
+        write_cube_slab(fh, &v[block_offsets_[start]], istart, ni);
     }
 
     fclose(fh);
 }
-void CubicScalarGrid::add_density(double* v, std::shared_ptr<Matrix> D) {
-    points_->set_pointers(D);
-    std::shared_ptr<Vector> rho = points_->point_value("RHO_A");
-    double* rhop = rho->pointer();
+void CubicScalarGrid::stream_gen_files(const std::vector<std::string>& names, const std::string& type,
+                                       const std::vector<std::string>& comments,
+                                       const std::function<void(double**, size_t, size_t)>& compute) {
+    if (type != "CUBE") {
+        throw PSIEXCEPTION("CubicScalarGrid: Unrecognized output file type");
+    }
+    if (names.empty()) return;
+
+    size_t nfield = names.size();
+    size_t max_slab = nxyz_ * (N_[1] + 1L) * (N_[2] + 1L);
+    double** v = block_matrix(nfield, max_slab);
+
+    std::vector<FILE*> fhs;
+    for (size_t k = 0; k < nfield; k++) {
+        fhs.push_back(open_cube_file(names[k], (k < comments.size() ? comments[k] : "")));
+    }
+
+    for (size_t start = 0L; start < blocks_.size(); start += nslab_blocks_) {
+        int istart = (start / nslab_blocks_) * nxyz_;
+        int ni = (istart + nxyz_ > N_[0] ? (N_[0] + 1) - istart : nxyz_);
+
+        memset(v[0], '\0', nfield * max_slab * sizeof(double));
+        compute(v, start, start + nslab_blocks_);
+        for (size_t k = 0; k < nfield; k++) {
+            write_cube_slab(fhs[k], v[k], istart, ni);
+        }
+    }
+
+    for (FILE* fh : fhs) fclose(fh);
+    free_block(v);
+}
+void CubicScalarGrid::add_density(double* v, std::shared_ptr<Matrix> D) { add_density(v, D, 0L, blocks_.size()); }
+void CubicScalarGrid::add_density(double* v, std::shared_ptr<Matrix> D, size_t start, size_t stop) {
+    for (int thread = 0; thread < nthreads_; thread++) {
+        points_[thread]->set_pointers(D);
+    }
+
+    size_t base = block_offsets_[start];
+
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads_)
+    for (size_t ind = start; ind < stop; ind++) {
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+
+        std::shared_ptr<RKSFunctions> points = points_[thread];
+        points->compute_points(blocks_[ind]);
+        double* rhop = points->point_value("RHO_A")->pointer();
 
-    size_t offset = 0L;
-    for (int ind = 0; ind < blocks_.size(); ind++) {
-        points_->compute_points(blocks_[ind]);
         size_t npoints = blocks_[ind]->npoints();
-        C_DAXPY(npoints, 0.5, rhop, 1, &v[offset], 1);
-        offset += npoints;
+        C_DAXPY(npoints, 0.5, rhop, 1, &v[block_offsets_[ind] - base], 1);
     }
 }
-void CubicScalarGrid::add_esp(double* v, std::shared_ptr<Matrix> D, const std::vector<double>& nuc_weights) {
+double CubicScalarGrid::multipole_potential(const ESPPair& pair, double x, double y, double z) {
+    x -= pair.C[0];
+    y -= pair.C[1];
+    z -= pair.C[2];
+    double R2 = x * x + y * y + z * z;
+    double R = std::sqrt(R2);
+    double R3inv = 1.0 / (R2 * R);
+    double R5inv = R3inv / R2;
+    const double* mu = pair.mu;
+    const double* Q = pair.Q;
+    double V = pair.q / R;
+    V += (mu[0] * x + mu[1] * y + mu[2] * z) * R3inv;
+    V += 0.5 * R5inv *
+         (Q[0] * (3.0 * x * x - R2) + Q[3] * (3.0 * y * y - R2) + Q[5] * (3.0 * z * z - R2) +
+          6.0 * (Q[1] * x * y + Q[2] * x * z + Q[4] * y * z));
+    return V;
+}
+std::vector<CubicScalarGrid::ESPPair> CubicScalarGrid::build_esp_pairs(std::shared_ptr<Matrix> D) {
+    double cutoff = options_.get_double("INTS_TOLERANCE");
+    double** Dp = D->pointer();
+
+    auto sieve = std::make_shared<ERISieve>(primary_, cutoff);
+    const std::vector<std::pair<int, int>>& shell_pairs = sieve->shell_pairs();
+
+    auto factory = std::make_shared<IntegralFactory>(primary_, primary_, primary_, primary_);
+    std::vector<std::shared_ptr<OneBodyAOInt>> Sints;
+    std::vector<std::shared_ptr<OneBodyAOInt>> Mints;
+    for (int thread = 0; thread < nthreads_; thread++) {
+        Sints.push_back(std::shared_ptr<OneBodyAOInt>(factory->ao_overlap()));
+        Mints.push_back(std::shared_ptr<OneBodyAOInt>(factory->ao_multipoles(2)));
+    }
+
+    std::vector<ESPPair> pairs(shell_pairs.size());
+    std::vector<char> significant(shell_pairs.size(), 0);
+
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads_)
+    for (size_t task = 0; task < shell_pairs.size(); task++) {
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+
+        int M = shell_pairs[task].first;
+        int N = shell_pairs[task].second;
+        const GaussianShell& Mshell = primary_->shell(M);
+        const GaussianShell& Nshell = primary_->shell(N);
+        int nM = Mshell.nfunction();
+        int oM = Mshell.function_index();
+        int nN = Nshell.nfunction();
+        int oN = Nshell.function_index();
+
+        // Density-weighted Schwarz screening of the distribution
+        double Dmax = 0.0;
+        for (int m = 0; m < nM; m++) {
+            for (int n = 0; n < nN; n++) {
+                Dmax = std::max(Dmax, std::fabs(Dp[m + oM][n + oN]));
+            }
+        }
+        if (Dmax * std::sqrt(sieve->shell_pair_value(M, N)) < cutoff) continue;
+
+        ESPPair& pair = pairs[task];
+        pair.M = M;
+        pair.N = N;
+
+        // Expand about the product center of the most diffuse primitive pair
+        const double* A = Mshell.center();
+        const double* B = Nshell.center();
+        double aM = Mshell.exp(0);
+        double aN = Nshell.exp(0);
+        for (int i = 1; i < Mshell.nprimitive(); i++) aM = std::min(aM, Mshell.exp(i));
+        for (int j = 1; j < Nshell.nprimitive(); j++) aN = std::min(aN, Nshell.exp(j));
+        for (int k = 0; k < 3; k++) {
+            pair.C[k] = (aM * A[k] + aN * B[k]) / (aM + aN);
+        }
+
+        // Every primitive product Gaussian lies within dmax of C, and penetrates at most
+        // sqrt(-ln(cutoff) / p) beyond its own center before erfc(sqrt(p) r) drops below cutoff
+        double dmax = 0.0;
+        for (int i = 0; i < Mshell.nprimitive(); i++) {
+            for (int j = 0; j < Nshell.nprimitive(); j++) {
+                double a = Mshell.exp(i);
+                double b = Nshell.exp(j);
+                double d2 = 0.0;
+                for (int k = 0; k < 3; k++) {
+                    double dk = (a * A[k] + b * B[k]) / (a + b) - pair.C[k];
+                    d2 += dk * dk;
+                }
+                dmax = std::max(dmax, std::sqrt(d2));
+            }
+        }
+        pair.R = dmax + std::sqrt(-std::log(cutoff) / (aM + aN));
+
+        // Electronic moments about C (the multipole integrals already carry the electron charge)
+        Sints[thread]->compute_shell(M, N);
+        const double* Sbuffer = Sints[thread]->buffer();
+        Mints[thread]->set_origin(Vector3(pair.C));
+        Mints[thread]->compute_shell(M, N);
+        const double* Mbuffer = Mints[thread]->buffer();
+
+        size_t nMN = nM * (size_t)nN;
+        double fac = (M == N ? 1.0 : 2.0);
+        pair.q = 0.0;
+        for (int k = 0; k < 3; k++) pair.mu[k] = 0.0;
+        for (int k = 0; k < 6; k++) pair.Q[k] = 0.0;
+        for (int m = 0; m < nM; m++) {
+            for (int n = 0; n < nN; n++) {
+                size_t mn = m * (size_t)nN + n;
+                double Dmn = fac * Dp[m + oM][n + oN];
+                pair.q -= Dmn * Sbuffer[mn];
+                for (int k = 0; k < 3; k++) pair.mu[k] += Dmn * Mbuffer[k * nMN + mn];
+                for (int k = 0; k < 6; k++) pair.Q[k] += Dmn * Mbuffer[(k + 3) * nMN + mn];
+            }
+        }
+
+        significant[task] = 1;
+    }
+
+    std::vector<ESPPair> significant_pairs;
+    for (size_t task = 0; task < pairs.size(); task++) {
+        if (significant[task]) significant_pairs.push_back(pairs[task]);
+    }
+    return significant_pairs;
+}
+std::shared_ptr<Vector> CubicScalarGrid::fit_esp_density(std::shared_ptr<Matrix> D) {
     // => Auxiliary Basis Set <= //
 
     if (!auxiliary_) {
@@ -328,17 +520,12 @@ void CubicScalarGrid::add_esp(double* v, std::shared_ptr<Matrix> D, const std::v
     int naux = auxiliary_->nbf();
     int maxP = auxiliary_->max_function_per_shell();
 
-    int nthreads = 1;
-#ifdef _OPENMP
-    nthreads = Process::environment.get_n_threads();
-#endif
-
     // => Density Fitting (TODO: Could be sped up) <= //
 
     std::shared_ptr<IntegralFactory> Ifact =
         std::make_shared<IntegralFactory>(auxiliary_, BasisSet::zero_ao_basis_set(), primary_, primary_);
     std::vector<std::shared_ptr<TwoBodyAOInt>> ints;
-    for (int thread = 0; thread < nthreads; thread++) {
+    for (int thread = 0; thread < nthreads_; thread++) {
         ints.push_back(std::shared_ptr<TwoBodyAOInt>(Ifact->eri()));
     }
 
@@ -360,8 +547,8 @@ void CubicScalarGrid::add_esp(double* v, std::shared_ptr<Matrix> D, const std::v
         Amn->zero();
 
 // Integrals
-#pragma omp parallel for schedule(dynamic)
-        for (int task = 0; task < pairs.size(); task++) {
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads_)
+        for (size_t task = 0; task < pairs.size(); task++) {
             int thread = 0;
 #ifdef _OPENMP
             thread = omp_get_thread_num();
@@ -430,15 +617,22 @@ void CubicScalarGrid::add_esp(double* v, std::shared_ptr<Matrix> D, const std::v
     J->power(-1.0, condition);
 
     auto d = std::make_shared<Vector>("d", naux);
+    C_DGEMV('N', naux, naux, 1.0, Jp[0], naux, cp, 1, 0.0, d->pointer(), 1);
+    return d;
+}
+void CubicScalarGrid::add_esp(double* v, std::shared_ptr<Matrix> D, const std::vector<double>& nuc_weights) {
+    if (options_.get_str("CUBIC_ESP_ALGORITHM") == "DIRECT") {
+        std::vector<ESPPair> pairs = build_esp_pairs(D);
+        add_esp(v, D, pairs, nuc_weights, 0L, blocks_.size());
+    } else {
+        add_esp_fitted(v, fit_esp_density(D), nuc_weights, 0L, blocks_.size());
+    }
+}
+void CubicScalarGrid::add_esp_fitted(double* v, std::shared_ptr<Vector> d, const std::vector<double>& nuc_weights,
+                                     size_t start, size_t stop) {
+    int naux = auxiliary_->nbf();
     double* dp = d->pointer();
 
-    C_DGEMV('N', naux, naux, 1.0, Jp[0], naux, cp, 1, 0.0, dp, 1);
-
-    // c->print();
-    // d->print();
-
-    J.reset();
-
     // => Electronic Part <= //
 
     std::shared_ptr<IntegralFactory> Vfact = std::make_shared<IntegralFactory>(
@@ -446,62 +640,186 @@ void CubicScalarGrid::add_esp(double* v, std::shared_ptr<Matrix> D, const std::v
     std::vector<std::shared_ptr<Matrix>> ZxyzT;
     std::vector<std::shared_ptr<Matrix>> VtempT;
     std::vector<std::shared_ptr<PotentialInt>> VintT;
-    for (int thread = 0; thread < nthreads; thread++) {
+    for (int thread = 0; thread < nthreads_; thread++) {
         ZxyzT.push_back(std::make_shared<Matrix>("Zxyz", 1, 4));
         VtempT.push_back(std::make_shared<Matrix>("Vtemp", naux, 1));
         VintT.push_back(std::shared_ptr<PotentialInt>(static_cast<PotentialInt*>(Vfact->ao_potential())));
         VintT[thread]->set_charge_field(ZxyzT[thread]);
     }
 
-#pragma omp parallel for schedule(dynamic)
-    for (int P = 0; P < npoints_; P++) {
-        // Thread info
+    size_t base = block_offsets_[start];
+
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads_)
+    for (size_t ind = start; ind < stop; ind++) {
         int thread = 0;
 #ifdef _OPENMP
         thread = omp_get_thread_num();
 #endif
 
-        // Pointers
+        std::shared_ptr<BlockOPoints> block = blocks_[ind];
+        double* vp = &v[block_offsets_[ind] - base];
         double** ZxyzTp = ZxyzT[thread]->pointer();
         double** VtempTp = VtempT[thread]->pointer();
 
-        // Integrals
-        VtempT[thread]->zero();
-        ZxyzTp[0][0] = 1.0;
-        ZxyzTp[0][1] = x_[P];
-        ZxyzTp[0][2] = y_[P];
-        ZxyzTp[0][3] = z_[P];
-        VintT[thread]->compute(VtempT[thread]);
+        for (size_t P = 0; P < block->npoints(); P++) {
+            // Integrals
+            VtempT[thread]->zero();
+            ZxyzTp[0][0] = 1.0;
+            ZxyzTp[0][1] = block->x()[P];
+            ZxyzTp[0][2] = block->y()[P];
+            ZxyzTp[0][3] = block->z()[P];
+            VintT[thread]->compute(VtempT[thread]);
+
+            // Contraction
+            vp[P] += C_DDOT(naux, dp, 1, VtempTp[0], 1);  // Potential integrals are negative definite already
+        }
+    }
 
-        // Contraction
-        v[P] += C_DDOT(naux, dp, 1, VtempTp[0], 1);  // Potential integrals are negative definite already
+    add_esp_nuclear(v, nuc_weights, start, stop);
+}
+void CubicScalarGrid::add_esp_nuclear(double* v, const std::vector<double>& nuc_weights, size_t start,
+                                      size_t stop) {
+    size_t base = block_offsets_[start];
+
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads_)
+    for (size_t ind = start; ind < stop; ind++) {
+        std::shared_ptr<BlockOPoints> block = blocks_[ind];
+        double* xp = block->x();
+        double* yp = block->y();
+        double* zp = block->z();
+        double* vp = &v[block_offsets_[ind] - base];
+
+        for (size_t P = 0; P < block->npoints(); P++) {
+            for (int A = 0; A < mol_->natom(); A++) {
+                double Z = mol_->Z(A) * (nuc_weights.size() ? nuc_weights[A] : 1.0);
+                double dx = mol_->x(A) - xp[P];
+                double dy = mol_->y(A) - yp[P];
+                double dz = mol_->z(A) - zp[P];
+                double R = sqrt(dx * dx + dy * dy + dz * dz);
+                vp[P] += (R >= 1.0E-15 ? Z / R : 0.0);
+            }
+        }
     }
+}
+void CubicScalarGrid::add_esp(double* v, std::shared_ptr<Matrix> D, const std::vector<ESPPair>& pairs,
+                              const std::vector<double>& nuc_weights, size_t start, size_t stop) {
+    // Pairs whose distribution is farther than ratio * R from a point enter through their multipoles
+    double ratio = options_.get_double("CUBIC_ESP_MULTIPOLE_RATIO");
+    bool do_multipoles = (ratio > 0.0);
 
-    // => Nuclear Part <= //
+    double** Dp = D->pointer();
 
-    for (int A = 0; A < mol_->natom(); A++) {
-        double Z = mol_->Z(A) * (nuc_weights.size() ? nuc_weights[A] : 1.0);
-        double x = mol_->x(A);
-        double y = mol_->y(A);
-        double z = mol_->z(A);
-        for (int P = 0; P < npoints_; P++) {
-            double R = sqrt((x - x_[P]) * (x - x_[P]) + (y - y_[P]) * (y - y_[P]) + (z - z_[P]) * (z - z_[P]));
-            v[P] += (R >= 1.0E-15 ? Z / R : 0.0);
+    // => Near-Field Integrals <= //
+
+    auto factory = std::make_shared<IntegralFactory>(primary_, primary_, primary_, primary_);
+    std::vector<std::shared_ptr<Matrix>> ZxyzT;
+    std::vector<std::shared_ptr<PotentialInt>> VintT;
+    for (int thread = 0; thread < nthreads_; thread++) {
+        ZxyzT.push_back(std::make_shared<Matrix>("Zxyz", 1, 4));
+        VintT.push_back(std::shared_ptr<PotentialInt>(static_cast<PotentialInt*>(factory->ao_potential())));
+        VintT[thread]->set_charge_field(ZxyzT[thread]);
+    }
+
+    size_t base = block_offsets_[start];
+
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads_)
+    for (size_t ind = start; ind < stop; ind++) {
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+
+        std::shared_ptr<BlockOPoints> block = blocks_[ind];
+        size_t npoints = block->npoints();
+        double* xp = block->x();
+        double* yp = block->y();
+        double* zp = block->z();
+        double* vp = &v[block_offsets_[ind] - base];
+
+        // => Pairs in the far field of the whole block <= //
+
+        std::vector<const ESPPair*> near_pairs;
+        std::vector<const ESPPair*> far_pairs;
+        const Vector3& xc = block->xc();
+        for (const ESPPair& pair : pairs) {
+            double dx = pair.C[0] - xc[0];
+            double dy = pair.C[1] - xc[1];
+            double dz = pair.C[2] - xc[2];
+            double dist = std::sqrt(dx * dx + dy * dy + dz * dz) - block->R();
+            if (do_multipoles && dist > ratio * pair.R) {
+                far_pairs.push_back(&pair);
+            } else {
+                near_pairs.push_back(&pair);
+            }
+        }
+
+        double** Zp = ZxyzT[thread]->pointer();
+        const double* Vbuffer = VintT[thread]->buffer();
+
+        for (size_t P = 0; P < npoints; P++) {
+            double val = 0.0;
+
+            for (const ESPPair* pair : far_pairs) {
+                val += multipole_potential(*pair, xp[P], yp[P], zp[P]);
+            }
+
+            Zp[0][0] = 1.0;
+            Zp[0][1] = xp[P];
+            Zp[0][2] = yp[P];
+            Zp[0][3] = zp[P];
+            for (const ESPPair* pair : near_pairs) {
+                double dx = xp[P] - pair->C[0];
+                double dy = yp[P] - pair->C[1];
+                double dz = zp[P] - pair->C[2];
+                double Rcut = ratio * pair->R;
+                if (do_multipoles && dx * dx + dy * dy + dz * dz > Rcut * Rcut) {
+                    val += multipole_potential(*pair, xp[P], yp[P], zp[P]);
+                    continue;
+                }
+
+                int M = pair->M;
+                int N = pair->N;
+                int nM = primary_->shell(M).nfunction();
+                int oM = primary_->shell(M).function_index();
+                int nN = primary_->shell(N).nfunction();
+                int oN = primary_->shell(N).function_index();
+                double fac = (M == N ? 1.0 : 2.0);
+
+                // Potential integrals are negative definite already
+                VintT[thread]->compute_shell(M, N);
+                for (int m = 0; m < nM; m++) {
+                    for (int n = 0; n < nN; n++) {
+                        val += fac * Dp[m + oM][n + oN] * Vbuffer[m * nN + n];
+                    }
+                }
+            }
+            vp[P] += val;
         }
     }
+
+    add_esp_nuclear(v, nuc_weights, start, stop);
 }
 void CubicScalarGrid::add_basis_functions(double** v, const std::vector<int>& indices) {
-    std::shared_ptr<Matrix> phi = points_->basis_value("PHI");
-    double** phip = phi->pointer();
+    add_basis_functions(v, indices, 0L, blocks_.size());
+}
+void CubicScalarGrid::add_basis_functions(double** v, const std::vector<int>& indices, size_t start, size_t stop) {
+    size_t base = block_offsets_[start];
 
-    size_t offset = 0L;
-    for (int ind = 0; ind < blocks_.size(); ind++) {
-        points_->compute_functions(blocks_[ind]);
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads_)
+    for (size_t ind = start; ind < stop; ind++) {
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+
+        std::shared_ptr<RKSFunctions> points = points_[thread];
+        points->compute_functions(blocks_[ind]);
+        double** phip = points->basis_value("PHI")->pointer();
 
         size_t npoints = blocks_[ind]->npoints();
+        size_t offset = block_offsets_[ind] - base;
         const std::vector<int>& function_map = blocks_[ind]->functions_local_to_global();
-        int nlocal = function_map.size();
-        int nglobal = points_->max_functions();
+        int nglobal = points->max_functions();
 
         for (int ind1 = 0; ind1 < indices.size(); ind1++) {
             for (int ind2 = 0; ind2 < function_map.size(); ind2++) {
@@ -510,44 +828,61 @@ void CubicScalarGrid::add_basis_functions(double** v, const std::vector<int>& in
                 }
             }
         }
-
-        offset += npoints;
     }
 }
-void CubicScalarGrid::add_orbitals(double** v, std::shared_ptr<Matrix> C) {
+void CubicScalarGrid::add_orbitals(double** v, std::shared_ptr<Matrix> C) { add_orbitals(v, C, 0L, blocks_.size()); }
+void CubicScalarGrid::add_orbitals(double** v, std::shared_ptr<Matrix> C, size_t start, size_t stop) {
     int na = C->colspi()[0];
 
-    points_->set_Cs(C);
-    std::shared_ptr<Matrix> psi = points_->orbital_value("PSI_A");
-    double** psip = psi->pointer();
+    for (int thread = 0; thread < nthreads_; thread++) {
+        points_[thread]->set_Cs(C);
+    }
 
-    size_t offset = 0L;
-    for (int ind = 0; ind < blocks_.size(); ind++) {
-        points_->compute_orbitals(blocks_[ind]);
+    size_t base = block_offsets_[start];
+
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads_)
+    for (size_t ind = start; ind < stop; ind++) {
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+
+        std::shared_ptr<RKSFunctions> points = points_[thread];
+        points->compute_orbitals(blocks_[ind]);
+        double** psip = points->orbital_value("PSI_A")->pointer();
 
         size_t npoints = blocks_[ind]->npoints();
+        size_t offset = block_offsets_[ind] - base;
         for (int a = 0; a < na; a++) {
             C_DAXPY(npoints, 1.0, psip[a], 1, &v[a][offset], 1);
         }
-
-        offset += npoints;
     }
 }
-void CubicScalarGrid::add_LOL(double* v, std::shared_ptr<Matrix> D) {
-    points_->set_ansatz(2);
-    points_->set_pointers(D);
-
-    std::shared_ptr<Vector> rho = points_->point_value("RHO_A");
-    std::shared_ptr<Vector> tau = points_->point_value("TAU_A");
-    double* rhop = rho->pointer();
-    double* taup = tau->pointer();
+void CubicScalarGrid::add_LOL(double* v, std::shared_ptr<Matrix> D) { add_LOL(v, D, 0L, blocks_.size()); }
+void CubicScalarGrid::add_LOL(double* v, std::shared_ptr<Matrix> D, size_t start, size_t stop) {
+    for (int thread = 0; thread < nthreads_; thread++) {
+        points_[thread]->set_ansatz(2);
+        points_[thread]->set_pointers(D);
+    }
 
     double C = 3.0 / 5.0 * pow(6.0 * M_PI * M_PI, 2.0 / 3.0);
 
-    size_t offset = 0L;
-    for (int ind = 0; ind < blocks_.size(); ind++) {
-        points_->compute_points(blocks_[ind]);
+    size_t base = block_offsets_[start];
+
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads_)
+    for (size_t ind = start; ind < stop; ind++) {
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+
+        std::shared_ptr<RKSFunctions> points = points_[thread];
+        points->compute_points(blocks_[ind]);
+        double* rhop = points->point_value("RHO_A")->pointer();
+        double* taup = points->point_value("TAU_A")->pointer();
+
         size_t npoints = blocks_[ind]->npoints();
+        size_t offset = block_offsets_[ind] - base;
         for (int P = 0; P < npoints; P++) {
             double tau_LSDA = C * pow(0.5 * rhop[P], 5.0 / 3.0);
             double tau_EX = taup[P];
@@ -555,28 +890,38 @@ void CubicScalarGrid::add_LOL(double* v, std::shared_ptr<Matrix> D) {
             double v2 = (std::fabs(tau_EX / tau_LSDA) < 1.0E-15 ? 1.0 : t / (1.0 + t));
             v[P + offset] += v2;
         }
-        offset += npoints;
     }
 
-    points_->set_ansatz(0);
+    for (int thread = 0; thread < nthreads_; thread++) {
+        points_[thread]->set_ansatz(0);
+    }
 }
-void CubicScalarGrid::add_ELF(double* v, std::shared_ptr<Matrix> D) {
-    points_->set_ansatz(2);
-    points_->set_pointers(D);
-
-    std::shared_ptr<Vector> rho = points_->point_value("RHO_A");
-    std::shared_ptr<Vector> gam = points_->point_value("GAMMA_AA");
-    std::shared_ptr<Vector> tau = points_->point_value("TAU_A");
-    double* rhop = rho->pointer();
-    double* gamp = gam->pointer();
-    double* taup = tau->pointer();
+void CubicScalarGrid::add_ELF(double* v, std::shared_ptr<Matrix> D) { add_ELF(v, D, 0L, blocks_.size()); }
+void CubicScalarGrid::add_ELF(double* v, std::shared_ptr<Matrix> D, size_t start, size_t stop) {
+    for (int thread = 0; thread < nthreads_; thread++) {
+        points_[thread]->set_ansatz(2);
+        points_[thread]->set_pointers(D);
+    }
 
     double C = 3.0 / 5.0 * pow(6.0 * M_PI * M_PI, 2.0 / 3.0);
 
-    size_t offset = 0L;
-    for (int ind = 0; ind < blocks_.size(); ind++) {
-        points_->compute_points(blocks_[ind]);
+    size_t base = block_offsets_[start];
+
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads_)
+    for (size_t ind = start; ind < stop; ind++) {
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+
+        std::shared_ptr<RKSFunctions> points = points_[thread];
+        points->compute_points(blocks_[ind]);
+        double* rhop = points->point_value("RHO_A")->pointer();
+        double* gamp = points->point_value("GAMMA_AA")->pointer();
+        double* taup = points->point_value("TAU_A")->pointer();
+
         size_t npoints = blocks_[ind]->npoints();
+        size_t offset = block_offsets_[ind] - base;
         for (int P = 0; P < npoints; P++) {
             double tau_LSDA = C * pow(0.5 * rhop[P], 5.0 / 3.0);
             double tau_EX = taup[P];
@@ -586,12 +931,14 @@ void CubicScalarGrid::add_ELF(double* v, std::shared_ptr<Matrix> D) {
             double v2 = (std::fabs(D_LSDA / D_EX) < 1.0E-15 ? 0.0 : 1.0 / (1.0 + B * B));
             v[P + offset] += v2;
         }
-        offset += npoints;
     }
 
-    points_->set_ansatz(0);
+    for (int thread = 0; thread < nthreads_; thread++) {
+        points_[thread]->set_ansatz(0);
+    }
 }
 void CubicScalarGrid::compute_density(std::shared_ptr<Matrix> D, const std::string& name, const std::string& type) {
+    // The adaptive isocontour range in the header needs the whole grid
     double* v = new double[npoints_];
     memset(v, '\0', npoints_ * sizeof(double));
     add_density(v, D);
@@ -607,23 +954,27 @@ void CubicScalarGrid::compute_density(std::shared_ptr<Matrix> D, const std::stri
 }
 void CubicScalarGrid::compute_esp(std::shared_ptr<Matrix> D, const std::vector<double>& w, const std::string& name,
                                   const std::string& type) {
-    double* v = new double[npoints_];
-    memset(v, '\0', npoints_ * sizeof(double));
-    add_esp(v, D, w);
-    write_gen_file(v, name, type, " [Eh/e]");
-    delete[] v;
+    if (options_.get_str("CUBIC_ESP_ALGORITHM") == "DIRECT") {
+        std::vector<ESPPair> pairs = build_esp_pairs(D);
+        stream_gen_files({name}, type, {" [Eh/e]"},
+                         [&](double** v, size_t start, size_t stop) { add_esp(v[0], D, pairs, w, start, stop); });
+    } else {
+        std::shared_ptr<Vector> d = fit_esp_density(D);
+        stream_gen_files({name}, type, {" [Eh/e]"},
+                         [&](double** v, size_t start, size_t stop) { add_esp_fitted(v[0], d, w, start, stop); });
+    }
 }
 void CubicScalarGrid::compute_basis_functions(const std::vector<int>& indices, const std::string& name,
                                               const std::string& type) {
-    double** v = block_matrix(indices.size(), npoints_);
-    memset(v[0], '\0', indices.size() * npoints_ * sizeof(double));
-    add_basis_functions(v, indices);
+    std::vector<std::string> names;
     for (int k = 0; k < indices.size(); k++) {
         std::stringstream ss;
         ss << name << "_" << (indices[k] + 1);
-        write_gen_file(v[k], ss.str(), type);
+        names.push_back(ss.str());
     }
-    free_block(v);
+    stream_gen_files(names, type, {}, [&](double** v, size_t start, size_t stop) {
+        add_basis_functions(v, indices, start, stop);
+    });
 }
 void CubicScalarGrid::compute_orbitals(std::shared_ptr<Matrix> C, const std::vector<int>& indices,
                                        const std::vector<std::string>& labels, const std::string& name,
@@ -680,18 +1031,12 @@ void CubicScalarGrid::compute_difference(std::shared_ptr<Matrix> C, const std::v
     write_gen_file(&vp[0], label, type, comment.str());
 }
 void CubicScalarGrid::compute_LOL(std::shared_ptr<Matrix> D, const std::string& name, const std::string& type) {
-    double* v = new double[npoints_];
-    memset(v, '\0', npoints_ * sizeof(double));
-    add_LOL(v, D);
-    write_gen_file(v, name, type);
-    delete[] v;
+    stream_gen_files({name}, type, {},
+                     [&](double** v, size_t start, size_t stop) { add_LOL(v[0], D, start, stop); });
 }
 void CubicScalarGrid::compute_ELF(std::shared_ptr<Matrix> D, const std::string& name, const std::string& type) {
-    double* v = new double[npoints_];
-    memset(v, '\0', npoints_ * sizeof(double));
-    add_ELF(v, D);
-    write_gen_file(v, name, type);
-    delete[] v;
+    stream_gen_files({name}, type, {},
+                     [&](double** v, size_t start, size_t stop) { add_ELF(v[0], D, start, stop); });
 }
 std::pair<double, double> CubicScalarGrid::compute_isocontour_range(double* v2, double exponent) {
     double cumulative_threshold = options_.get_double("CUBEPROP_ISOCONTOUR_THRESHOLD");
@@ -29,6 +29,8 @@
 #ifndef _psi_src_lib_libcubeprop_csg_h_
 #define _psi_src_lib_libcubeprop_csg_h_
 
+#include <cstdio>
+#include <functional>
 #include <map>
 #include <memory>
 #include <string>
@@ -43,6 +45,7 @@ class Matrix;
 class Molecule;
 class Options;
 class RKSFunctions;
+class Vector;
 
 class CubicScalarGrid {
    protected:
@@ -54,7 +57,7 @@ class CubicScalarGrid {
     std::shared_ptr<Molecule> mol_;
     /// Basis set this grid is built around
     std::shared_ptr<BasisSet> primary_;
-    /// The auxiliary basisset for ESP contractions
+    /// The auxiliary basisset for fitted ESP contractions
     std::shared_ptr<BasisSet> auxiliary_;
     /// File path for grid storage
     std::string filepath_;
@@ -72,6 +75,10 @@ class CubicScalarGrid {
     size_t npoints_;
     /// Sparsity blocking in all cardinal directions
     size_t nxyz_;
+    /// Number of blocks in each slab of nxyz_ x-planes
+    size_t nslab_blocks_;
+    /// Number of threads for the block loops
+    int nthreads_;
 
     /// x coordinates of grid
     double* x_;
@@ -86,16 +93,65 @@ class CubicScalarGrid {
 
     /// Vector of blocks
     std::vector<std::shared_ptr<BlockOPoints> > blocks_;
+    /// Offset of each block in the fast ordering
+    std::vector<size_t> block_offsets_;
     /// Points to basis extents, built internally
     std::shared_ptr<BasisExtents> extents_;
-    /// RKS points object
-    std::shared_ptr<RKSFunctions> points_;
+    /// RKS points objects, one per thread
+    std::vector<std::shared_ptr<RKSFunctions> > points_;
+
+    // => ESP Shell Pairs <= //
+
+    /// A density-contracted shell pair charge distribution for the direct ESP
+    struct ESPPair {
+        /// Shell indices (M >= N)
+        int M;
+        int N;
+        /// Expansion center of the distribution
+        double C[3];
+        /// Radius beyond which the distribution is a pure multipole to INTS_TOLERANCE
+        double R;
+        /// Electronic charge, dipole, and Cartesian second moments (xx, xy, xz, yy, yz, zz) about C
+        double q;
+        double mu[3];
+        double Q[6];
+    };
+
+    /// Density-screened shell pairs and their multipoles through second order
+    std::vector<ESPPair> build_esp_pairs(std::shared_ptr<Matrix> D);
+    /// Potential at (x, y, z) of a pair distribution truncated after its second moments
+    static double multipole_potential(const ESPPair& pair, double x, double y, double z);
+    /// Density fitting coefficients of D in the auxiliary basis (Coulomb metric)
+    std::shared_ptr<Vector> fit_esp_density(std::shared_ptr<Matrix> D);
 
     // => Helper Routines <= //
 
     /// Setup grid from info in N_, D_, O_
     void populate_grid();
 
+    /// Open a Gaussian cube file at filepath/name.cube and write its header
+    FILE* open_cube_file(const std::string& name, const std::string& comment);
+    /// Write the slab of x-planes [istart, istart + ni) of v (in fast ordering, starting at the slab) to fh
+    void write_cube_slab(FILE* fh, double* v, int istart, int ni);
+    /// Compute fields slab by slab and stream them to filepath/names[k].ext, without holding the full grid.
+    /// compute(v, start, stop) must add the fields of blocks [start, stop) to v[k] (relative to block start)
+    void stream_gen_files(const std::vector<std::string>& names, const std::string& type,
+                          const std::vector<std::string>& comments,
+                          const std::function<void(double**, size_t, size_t)>& compute);
+
+    // => Block-Range Scalar Field Computation (v is relative to the first block) <= //
+
+    void add_density(double* v, std::shared_ptr<Matrix> D, size_t start, size_t stop);
+    void add_esp(double* v, std::shared_ptr<Matrix> D, const std::vector<ESPPair>& pairs,
+                 const std::vector<double>& nuc_weights, size_t start, size_t stop);
+    void add_esp_fitted(double* v, std::shared_ptr<Vector> d, const std::vector<double>& nuc_weights, size_t start,
+                        size_t stop);
+    void add_esp_nuclear(double* v, const std::vector<double>& nuc_weights, size_t start, size_t stop);
+    void add_basis_functions(double** v, const std::vector<int>& indices, size_t start, size_t stop);
+    void add_orbitals(double** v, std::shared_ptr<Matrix> C, size_t start, size_t stop);
+    void add_LOL(double* v, std::shared_ptr<Matrix> D, size_t start, size_t stop);
+    void add_ELF(double* v, std::shared_ptr<Matrix> D, size_t start, size_t stop);
+
    public:
     // => Constructors <= //
 
@@ -113,7 +169,7 @@ class CubicScalarGrid {
     /// Header info
     void print_header();
 
-    /// Set the auxiliary for ESP if desired
+    /// Set the auxiliary for ESP if desired (required unless CUBIC_ESP_ALGORITHM is DIRECT)
     void set_auxiliary_basis(std::shared_ptr<BasisSet> aux) { auxiliary_ = aux; }
 
     // => High-Level Set Routines <= //
@@ -159,7 +215,8 @@ class CubicScalarGrid {
 
     /// Add a density-type property to the scalar field
     void add_density(double* v, std::shared_ptr<Matrix> D);
-    /// Add an ESP-type property to the scalar field (total density matrix, must set DF_BASIS_SCF option)
+    /// Add an ESP-type property to the scalar field (total density matrix, DF_BASIS_SCF fitted unless
+    /// CUBIC_ESP_ALGORITHM is DIRECT)
     void add_esp(double* v, std::shared_ptr<Matrix> D, const std::vector<double>& nuc_weights = std::vector<double>());
     /// Add a basis function property for desired indices to the scalar fields in v (rows are basis functions)
     void add_basis_functions(double** v, const std::vector<int>& indices);
@@ -174,10 +231,10 @@ class CubicScalarGrid {
 
     /// Compute a density-type property and drop a file corresponding to name and type
     void compute_density(std::shared_ptr<Matrix> D, const std::string& name, const std::string& type = "CUBE");
-    /// Compute an ESP-type property and drop a file corresponding to name and type
+    /// Compute an ESP-type property and stream a file corresponding to name and type
     void compute_esp(std::shared_ptr<Matrix> D, const std::vector<double>& nuc_weights, const std::string& name,
                      const std::string& type = "CUBE");
-    /// Compute a set of basis function-type properties and drop files corresponding to name, index, and type
+    /// Compute a set of basis function-type properties and stream files corresponding to name, index, and type
     void compute_basis_functions(const std::vector<int>& indices, const std::string& name,
                                  const std::string& type = "CUBE");
     /// Compute a set of orbital-type properties and drop files corresponding to name, index, symmetry label, and type
@@ -188,9 +245,9 @@ class CubicScalarGrid {
     void compute_difference(std::shared_ptr<Matrix> C, const std::vector<int>& indices,
                           const std::string& label, bool square = false, const std::string& type = "CUBE");
 
-    /// Compute a LOL-type property and drop a file corresponding to name and type
+    /// Compute a LOL-type property and stream a file corresponding to name and type
     void compute_LOL(std::shared_ptr<Matrix> D, const std::string& name, const std::string& type = "CUBE");
-    /// Compute an ELF-type property and drop a file corresponding to name and type (TODO: this seems very unstable)
+    /// Compute an ELF-type property and stream a file corresponding to name and type (TODO: this seems very unstable)
     void compute_ELF(std::shared_ptr<Matrix> D, const std::string& name, const std::string& type = "CUBE");
 
     /// Compute the isocountour range that capture a given fraction of a property. Exponent is used
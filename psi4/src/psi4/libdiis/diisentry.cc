@@ -30,19 +30,23 @@ PRAGMA_WARNING_PUSH
 PRAGMA_WARNING_IGNORE_DEPRECATED_DECLARATIONS
 #include <memory>
 PRAGMA_WARNING_POP
+#include "psi4/libpsio/psio.h"
 #include "psi4/libpsio/psio.hpp"
 #include "diisentry.h"
 #include <cmath>
 #include "psi4/libqt/qt.h"
 #include "psi4/psifiles.h"
+#include <algorithm>
 #include <sstream>
+#include <vector>
 
 namespace psi {
 
-DIISEntry::DIISEntry(std::string label, int ID, int orderAdded, int errorVectorSize, double *errorVector,
-                     int vectorSize, double *vector, std::shared_ptr<PSIO> psio)
+DIISEntry::DIISEntry(std::string label, int ID, int orderAdded, size_t errorVectorSize, double *errorVector,
+                     size_t vectorSize, double *vector, std::shared_ptr<PSIO> psio)
     : _vectorSize(vectorSize),
       _errorVectorSize(errorVectorSize),
+      _singlePrecision(false),
       _vector(vector),
       _errorVector(errorVector),
       _ID(ID),
@@ -58,6 +62,28 @@ DIISEntry::DIISEntry(std::string label, int ID, int orderAdded, int errorVectorS
     _label = s.str();
 }
 
+DIISEntry::DIISEntry(std::string label, int ID, int orderAdded, size_t errorVectorSize, size_t vectorSize,
+                     bool singlePrecision, std::shared_ptr<PSIO> psio)
+    : _vectorSize(vectorSize),
+      _errorVectorSize(errorVectorSize),
+      _singlePrecision(singlePrecision),
+      _vector(nullptr),
+      _errorVector(nullptr),
+      _ID(ID),
+      _orderAdded(orderAdded),
+      _rmsError(0.0),
+      _label(label),
+      _psio(psio) {
+    std::stringstream s;
+    s << _label << ":entry " << ID;
+    _label = s.str();
+}
+
+void DIISEntry::set_norm(double sumSQ) {
+    _rmsError = sqrt(sumSQ / _errorVectorSize);
+    set_dot_with(_ID, sumSQ);
+}
+
 void DIISEntry::open_psi_file() {
     if (_psio->open_check(PSIF_LIBDIIS) == 0) {
         _psio->open(PSIF_LIBDIIS, PSIO_OPEN_OLD);
@@ -102,6 +128,35 @@ void DIISEntry::read_error_vector_from_disk() {
     }
 }
 
+void DIISEntry::write_block(bool error, const double *block, size_t offset, size_t length) {
+    std::string label = _label + (error ? " error" : " vector");
+    open_psi_file();
+    psio_address end;
+    if (_singlePrecision) {
+        std::vector<float> buffer(block, block + length);
+        _psio->write(PSIF_LIBDIIS, label.c_str(), (char *)buffer.data(), length * sizeof(float),
+                     psio_get_address(PSIO_ZERO, offset * sizeof(float)), &end);
+    } else {
+        _psio->write(PSIF_LIBDIIS, label.c_str(), (char *)block, length * sizeof(double),
+                     psio_get_address(PSIO_ZERO, offset * sizeof(double)), &end);
+    }
+}
+
+void DIISEntry::read_block(bool error, double *block, size_t offset, size_t length) {
+    std::string label = _label + (error ? " error" : " vector");
+    open_psi_file();
+    psio_address end;
+    if (_singlePrecision) {
+        std::vector<float> buffer(length);
+        _psio->read(PSIF_LIBDIIS, label.c_str(), (char *)buffer.data(), length * sizeof(float),
+                    psio_get_address(PSIO_ZERO, offset * sizeof(float)), &end);
+        std::copy(buffer.begin(), buffer.end(), block);
+    } else {
+        _psio->read(PSIF_LIBDIIS, label.c_str(), (char *)block, length * sizeof(double),
+                    psio_get_address(PSIO_ZERO, offset * sizeof(double)), &end);
+    }
+}
+
 void DIISEntry::free_vector_memory() {
     if (_vector) delete[] _vector;
     _vector = nullptr;
@@ -59,8 +59,11 @@ class DIISEntry {
      * Psio     - The PSIO object to use for I/O
      */
     enum InputType { DPDBuf4, DPDFile2, Matrix, Vector, Pointer };
-    DIISEntry(std::string label, int ID, int count, int vectorSize, double *vector, int errorVectorSize,
-              double *errorVector, std::shared_ptr<PSIO> psio);
+    DIISEntry(std::string label, int ID, int count, size_t errorVectorSize, double *errorVector, size_t vectorSize,
+              double *vector, std::shared_ptr<PSIO> psio);
+    /// An entry whose data is written to disk block by block, see write_block()
+    DIISEntry(std::string label, int ID, int count, size_t errorVectorSize, size_t vectorSize, bool singlePrecision,
+              std::shared_ptr<PSIO> psio);
     ~DIISEntry();
     /// Whether the dot product of this entry's and the nth entry's error vector is known
     bool dot_is_known_with(int n) { return _knownDotProducts[n]; }
@@ -75,6 +78,8 @@ class DIISEntry {
         _knownDotProducts[n] = true;
         _dotProducts[n] = val;
     }
+    /// Sets the squared norm of the error vector, and the RMS error derived from it
+    void set_norm(double sumSQ);
     /// Marks the dot product with vector n as invalid
     void invalidate_dot(int n) { _knownDotProducts[n] = false; }
     /// Set the vector
@@ -89,6 +94,10 @@ class DIISEntry {
     void dump_error_vector_to_disk();
     /// Allocate error vector memory and read from disk
     void read_error_vector_from_disk();
+    /// Write length elements of the (error) vector to disk, starting at element offset
+    void write_block(bool error, const double *block, size_t offset, size_t length);
+    /// Read length elements of the (error) vector from disk, starting at element offset
+    void read_block(bool error, double *block, size_t offset, size_t length);
     /// Free vector memory
     void free_vector_memory();
     /// Free error vector memory
@@ -114,9 +123,11 @@ class DIISEntry {
     /// The list of known dot products with other DIISEntries
     std::map<int, double> _dotProducts;
     /// The length of the error vector
-    int _errorVectorSize;
+    size_t _errorVectorSize;
     /// The length of the vector
-    int _vectorSize;
+    size_t _vectorSize;
+    /// Whether blocks are stored on disk in single precision
+    bool _singlePrecision;
     /// The absolute number of this entry
     int _orderAdded;
     /// The number of this entry in the current subspace
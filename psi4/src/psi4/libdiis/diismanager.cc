@@ -31,6 +31,7 @@
 #include <cmath>
 #include <cstdarg>
 #include <memory>
+#include <numeric>
 
 #include "psi4/psifiles.h"
 
@@ -67,6 +68,17 @@ DIISManager::DIISManager(int maxSubspaceSize, const std::string &label, RemovalP
 
 int DIISManager::subspace_size() { return _subspace.size(); }
 
+/**
+ * Requests that the OnDiskBlocked history be stored as floats.  The new error vector is always
+ * dotted in double precision, so only the stored history is rounded.
+ */
+void DIISManager::set_single_precision(bool singlePrecision) {
+    if (_subspace.size())
+        throw SanityCheckError("DIISManager: The storage precision must be set before any entries are added", __FILE__,
+                               __LINE__);
+    _singlePrecision = singlePrecision;
+}
+
 /**
  * Determines the size of the error vector from a list of input quantities.  This function should
  * not be called until set_error_vector_size() has been called.
@@ -87,38 +99,40 @@ void DIISManager::set_vector_size(int numQuantities, ...) {
     for (int i = 0; i < numQuantities; ++i) {
         DIISEntry::InputType type = static_cast<DIISEntry::InputType>(va_arg(args, int));
         _componentTypes.push_back(type);
-        size_t size = 0;
+        std::vector<size_t> blocks;
         switch (type) {
             case DIISEntry::Pointer:
-                size += va_arg(args, int);
+                blocks.push_back(va_arg(args, int));
                 break;
             case DIISEntry::DPDBuf4:
                 buf4 = va_arg(args, dpdbuf4 *);
                 for (int h = 0; h < buf4->params->nirreps; ++h) {
-                    size += static_cast<unsigned long> (buf4->params->rowtot[h]) * buf4->params->coltot[h];
+                    blocks.push_back(static_cast<size_t>(buf4->params->rowtot[h]) * buf4->params->coltot[h]);
                 }
                 break;
             case DIISEntry::DPDFile2:
                 file2 = va_arg(args, dpdfile2 *);
                 for (int h = 0; h < file2->params->nirreps; ++h) {
-                    size += static_cast<unsigned long> (file2->params->rowtot[h]) * file2->params->coltot[h];
+                    blocks.push_back(static_cast<size_t>(file2->params->rowtot[h]) * file2->params->coltot[h]);
                 }
                 break;
             case DIISEntry::Matrix:
                 matrix = va_arg(args, Matrix *);
                 for (int h = 0; h < matrix->nirrep(); ++h) {
-                    size += static_cast<unsigned long> (matrix->rowspi()[h]) * matrix->colspi()[h];
+                    blocks.push_back(static_cast<size_t>(matrix->rowspi()[h]) * matrix->colspi()[h]);
                 }
                 break;
             case DIISEntry::Vector:
                 vector = va_arg(args, Vector *);
                 for (int h = 0; h < vector->nirrep(); ++h) {
-                    size += vector->dimpi()[h];
+                    blocks.push_back(vector->dimpi()[h]);
                 }
                 break;
             default:
                 throw SanityCheckError("Unknown input type", __FILE__, __LINE__);
         }
+        size_t size = std::accumulate(blocks.begin(), blocks.end(), size_t(0));
+        _componentBlockSizes.push_back(blocks);
         _componentSizes.push_back(size);
         _vectorSize += size;
     }
@@ -141,38 +155,40 @@ void DIISManager::set_error_vector_size(int numQuantities, ...) {
     for (int i = 0; i < numQuantities; ++i) {
         DIISEntry::InputType type = static_cast<DIISEntry::InputType>(va_arg(args, int));
         _componentTypes.push_back(type);
-        size_t size = 0;
+        std::vector<size_t> blocks;
         switch (type) {
             case DIISEntry::Pointer:
-                size += va_arg(args, int);
+                blocks.push_back(va_arg(args, int));
                 break;
             case DIISEntry::DPDBuf4:
                 buf4 = va_arg(args, dpdbuf4 *);
                 for (int h = 0; h < buf4->params->nirreps; ++h) {
-                    size += static_cast<unsigned long> (buf4->params->rowtot[h]) * buf4->params->coltot[h];
+                    blocks.push_back(static_cast<size_t>(buf4->params->rowtot[h]) * buf4->params->coltot[h]);
                 }
                 break;
             case DIISEntry::DPDFile2:
                 file2 = va_arg(args, dpdfile2 *);
                 for (int h = 0; h < file2->params->nirreps; ++h) {
-                    size += static_cast<unsigned long> (file2->params->rowtot[h]) * file2->params->coltot[h];
+                    blocks.push_back(static_cast<size_t>(file2->params->rowtot[h]) * file2->params->coltot[h]);
                 }
                 break;
             case DIISEntry::Matrix:
                 matrix = va_arg(args, Matrix *);
                 for (int h = 0; h < matrix->nirrep(); ++h) {
-                    size += static_cast<unsigned long> (matrix->rowspi()[h]) * matrix->colspi()[h];
+                    blocks.push_back(static_cast<size_t>(matrix->rowspi()[h]) * matrix->colspi()[h]);
                 }
                 break;
             case DIISEntry::Vector:
                 vector = va_arg(args, Vector *);
                 for (int h = 0; h < vector->nirrep(); ++h) {
-                    size += vector->dimpi()[h];
+                    blocks.push_back(vector->dimpi()[h]);
                 }
                 break;
             default:
                 throw SanityCheckError("Unknown input type", __FILE__, __LINE__);
         }
+        size_t size = std::accumulate(blocks.begin(), blocks.end(), size_t(0));
+        _componentBlockSizes.push_back(blocks);
         _componentSizes.push_back(size);
         _errorVectorSize += size;
     }
@@ -201,13 +217,19 @@ bool DIISManager::add_entry(int numQuantities, ...) {
             __FILE__, __LINE__);
 
     timer_on("DIISManager::add_entry");
+    va_list args;
+    va_start(args, numQuantities);
+    if (_storagePolicy == OnDiskBlocked) {
+        bool updated = add_blocked_entry(numQuantities, args);
+        va_end(args);
+        timer_off("DIISManager::add_entry");
+        return updated;
+    }
     dpdfile2 *file2;
     dpdbuf4 *buf4;
     Vector *vector;
     Matrix *matrix;
     double *array;
-    va_list args;
-    va_start(args, numQuantities);
     auto *errorVectorPtr = new double[_errorVectorSize];
     auto *vectorPtr = new double[_vectorSize];
     double *arrayPtr = errorVectorPtr;
@@ -294,6 +316,106 @@ bool DIISManager::add_entry(int numQuantities, ...) {
     return true;
 }
 
+/**
+ * Adds a new entry without ever assembling it in memory.  Each irrep block of each component is
+ * written straight to disk, and the block of the new error vector is dotted against the matching
+ * block of every stored error vector, so the new row of the B matrix is complete once the last
+ * block has been streamed.
+ */
+bool DIISManager::add_blocked_entry(int numQuantities, va_list args) {
+    int entryID = get_next_entry_id();
+    auto *entry = new DIISEntry(_label, entryID, _entryCount++, _errorVectorSize, _vectorSize, _singlePrecision, _psio);
+
+    std::vector<double> dots(_subspace.size(), 0.0);
+    std::vector<double> stored;
+    double sumSQ = 0.0;
+    size_t offset = 0;
+    bool error = true;
+    auto stream = [&](double *block, size_t length) {
+        entry->write_block(error, block, offset, length);
+        if (error) {
+            sumSQ += C_DDOT(length, block, 1, block, 1);
+            stored.resize(length);
+            for (int n = 0; n < _subspace.size(); ++n) {
+                if (n == entryID) continue;
+                _subspace[n]->read_block(true, stored.data(), offset, length);
+                dots[n] += C_DDOT(length, block, 1, stored.data(), 1);
+            }
+        }
+        offset += length;
+    };
+
+    dpdfile2 *file2;
+    dpdbuf4 *buf4;
+    Vector *vector;
+    Matrix *matrix;
+    double *array;
+    for (int i = 0; i < numQuantities; ++i) {
+        // The error vector and the vector are stored under separate labels
+        if (i == _numErrorVectorComponents) {
+            error = false;
+            offset = 0;
+        }
+        const std::vector<size_t> &blocks = _componentBlockSizes[i];
+        switch (_componentTypes[i]) {
+            case DIISEntry::Pointer:
+                array = va_arg(args, double *);
+                if (blocks[0]) stream(array, blocks[0]);
+                break;
+            case DIISEntry::DPDBuf4:
+                buf4 = va_arg(args, dpdbuf4 *);
+                for (int h = 0; h < buf4->params->nirreps; ++h) {
+                    if (!blocks[h]) continue;
+                    global_dpd_->buf4_mat_irrep_init(buf4, h);
+                    global_dpd_->buf4_mat_irrep_rd(buf4, h);
+                    stream(buf4->matrix[h][0], blocks[h]);
+                    global_dpd_->buf4_mat_irrep_close(buf4, h);
+                }
+                break;
+            case DIISEntry::DPDFile2:
+                file2 = va_arg(args, dpdfile2 *);
+                global_dpd_->file2_mat_init(file2);
+                global_dpd_->file2_mat_rd(file2);
+                for (int h = 0; h < file2->params->nirreps; ++h) {
+                    if (blocks[h]) stream(file2->matrix[h][0], blocks[h]);
+                }
+                global_dpd_->file2_mat_close(file2);
+                break;
+            case DIISEntry::Matrix:
+                matrix = va_arg(args, Matrix *);
+                for (int h = 0; h < matrix->nirrep(); ++h) {
+                    if (blocks[h]) stream(matrix->pointer(h)[0], blocks[h]);
+                }
+                break;
+            case DIISEntry::Vector:
+                vector = va_arg(args, Vector *);
+                for (int h = 0; h < vector->nirrep(); ++h) {
+                    if (blocks[h]) stream(vector->pointer(h), blocks[h]);
+                }
+                break;
+            default:
+                throw SanityCheckError("Unknown input type", __FILE__, __LINE__);
+        }
+    }
+
+    if (_subspace.size() < _maxSubspaceSize) {
+        _subspace.push_back(entry);
+    } else {
+        delete _subspace[entryID];
+        _subspace[entryID] = entry;
+    }
+
+    // Unlike the other policies, every inner product involving the new entry is already known
+    entry->set_norm(sumSQ);
+    for (int n = 0; n < dots.size(); ++n) {
+        if (n == entryID) continue;
+        entry->set_dot_with(n, dots[n]);
+        _subspace[n]->set_dot_with(entryID, dots[n]);
+    }
+
+    return true;
+}
+
 /**
  * Figures out the ID of the next entry to be added by determining whether an entry
  * must be removed in order to add a new one.
@@ -357,8 +479,10 @@ bool DIISManager::extrapolate(int numQuantities, ...) {
             if (entryI->dot_is_known_with(j)) {
                 bMatrix[i][j] = entryI->dot_with(j);
             } else {
-                double dot = C_DDOT(_errorVectorSize, const_cast<double *>(entryI->errorVector()), 1,
-                                    const_cast<double *>(entryJ->errorVector()), 1);
+                double dot = _storagePolicy == OnDiskBlocked
+                                 ? blocked_dot(entryI, entryJ)
+                                 : C_DDOT(_errorVectorSize, const_cast<double *>(entryI->errorVector()), 1,
+                                          const_cast<double *>(entryJ->errorVector()), 1);
                 bMatrix[i][j] = dot;
                 entryI->set_dot_with(j, dot);
                 entryJ->set_dot_with(i, dot);
@@ -419,6 +543,25 @@ bool DIISManager::extrapolate(int numQuantities, ...) {
 
     timer_on("New vector");
 
+    if (_storagePolicy == OnDiskBlocked) {
+        int print = Process::environment.options.get_int("PRINT");
+        if (print > 2) {
+            outfile->Printf("DIIS coefficients: ");
+            for (int n = 0; n < _subspace.size(); ++n) outfile->Printf(" %.3f ", coefficients[n]);
+            outfile->Printf("\n");
+        }
+        va_list args;
+        va_start(args, numQuantities);
+        extrapolate_blocked(coefficients, numQuantities, args);
+        va_end(args);
+
+        timer_off("New vector");
+        delete[] coefficients;
+        delete[] force;
+        timer_off("DIISManager::extrapolate");
+        return true;
+    }
+
     dpdfile2 *file2;
     dpdbuf4 *buf4;
     Vector *vector;
@@ -518,6 +661,95 @@ bool DIISManager::extrapolate(int numQuantities, ...) {
     return true;
 }
 
+/**
+ * Forms the extrapolated vector for the OnDiskBlocked policy.  Each irrep block of the output is
+ * zeroed and accumulated from the matching block of every stored vector before moving on, so
+ * only one output block and one stored block are in memory at any time.
+ */
+void DIISManager::extrapolate_blocked(const double *coefficients, int numQuantities, va_list args) {
+    std::vector<double> stored;
+    size_t offset = 0;
+    auto accumulate = [&](double *block, size_t length) {
+        ::memset(block, 0, length * sizeof(double));
+        stored.resize(length);
+        for (int n = 0; n < _subspace.size(); ++n) {
+            _subspace[n]->read_block(false, stored.data(), offset, length);
+            C_DAXPY(length, coefficients[n], stored.data(), 1, block, 1);
+        }
+        offset += length;
+    };
+
+    dpdfile2 *file2;
+    dpdbuf4 *buf4;
+    Vector *vector;
+    Matrix *matrix;
+    double *array;
+    for (int i = 0; i < numQuantities; ++i) {
+        int componentIndex = i + _numErrorVectorComponents;
+        const std::vector<size_t> &blocks = _componentBlockSizes[componentIndex];
+        switch (_componentTypes[componentIndex]) {
+            case DIISEntry::Pointer:
+                array = va_arg(args, double *);
+                if (blocks[0]) accumulate(array, blocks[0]);
+                break;
+            case DIISEntry::DPDBuf4:
+                buf4 = va_arg(args, dpdbuf4 *);
+                for (int h = 0; h < buf4->params->nirreps; ++h) {
+                    if (!blocks[h]) continue;
+                    global_dpd_->buf4_mat_irrep_init(buf4, h);
+                    accumulate(buf4->matrix[h][0], blocks[h]);
+                    global_dpd_->buf4_mat_irrep_wrt(buf4, h);
+                    global_dpd_->buf4_mat_irrep_close(buf4, h);
+                }
+                break;
+            case DIISEntry::DPDFile2:
+                file2 = va_arg(args, dpdfile2 *);
+                global_dpd_->file2_mat_init(file2);
+                for (int h = 0; h < file2->params->nirreps; ++h) {
+                    if (blocks[h]) accumulate(file2->matrix[h][0], blocks[h]);
+                }
+                global_dpd_->file2_mat_wrt(file2);
+                global_dpd_->file2_mat_close(file2);
+                break;
+            case DIISEntry::Matrix:
+                matrix = va_arg(args, Matrix *);
+                for (int h = 0; h < matrix->nirrep(); ++h) {
+                    if (blocks[h]) accumulate(matrix->pointer(h)[0], blocks[h]);
+                }
+                break;
+            case DIISEntry::Vector:
+                vector = va_arg(args, Vector *);
+                for (int h = 0; h < vector->nirrep(); ++h) {
+                    if (blocks[h]) accumulate(vector->pointer(h), blocks[h]);
+                }
+                break;
+            default:
+                throw SanityCheckError("Unknown input type", __FILE__, __LINE__);
+        }
+    }
+}
+
+/**
+ * Computes the dot product of two stored error vectors without reading either one in full.
+ */
+double DIISManager::blocked_dot(DIISEntry *entryI, DIISEntry *entryJ) {
+    std::vector<double> blockI, blockJ;
+    double dot = 0.0;
+    size_t offset = 0;
+    for (int i = 0; i < _numErrorVectorComponents; ++i) {
+        for (size_t length : _componentBlockSizes[i]) {
+            if (!length) continue;
+            blockI.resize(length);
+            blockJ.resize(length);
+            entryI->read_block(true, blockI.data(), offset, length);
+            entryJ->read_block(true, blockJ.data(), offset, length);
+            dot += C_DDOT(length, blockI.data(), 1, blockJ.data(), 1);
+            offset += length;
+        }
+    }
+    return dot;
+}
+
 /**
  * Removes any vectors existing in the DIIS subspace.
  */
@@ -29,6 +29,7 @@
 #ifndef _PSI_SRC_LIB_LIBDIIS_DIISMANAGER_H_
 #define _PSI_SRC_LIB_LIBDIIS_DIISMANAGER_H_
 
+#include <cstdarg>
 #include <vector>
 #include <map>
 
@@ -51,8 +52,10 @@ class PSI_API DIISManager {
      *
      * OnDisk - Stored on disk, and retrieved when required
      * InCore - Stored in memory throughout
+     * OnDiskBlocked - Stored on disk and streamed one irrep block at a time, so that
+     *                 no complete vector is ever held in memory by the manager
      */
-    enum StoragePolicy { InCore, OnDisk };
+    enum StoragePolicy { InCore, OnDisk, OnDiskBlocked };
     /**
      * @brief How vectors are removed from the subspace, when required
      *
@@ -82,6 +85,9 @@ class PSI_API DIISManager {
 
     bool extrapolate(SharedMatrix extrapolated) { return DIISManager::extrapolate(1, extrapolated.get()); }
 
+    /// Store the OnDiskBlocked history in single precision, halving its I/O.  Must be set before any entries are added.
+    void set_single_precision(bool singlePrecision);
+
     int remove_entry();
     void reset_subspace();
     void delete_diis_file();
@@ -90,6 +96,12 @@ class PSI_API DIISManager {
 
    protected:
     int get_next_entry_id();
+    /// Streams a new entry to disk block by block, accumulating its B matrix row as it goes
+    bool add_blocked_entry(int numQuantities, va_list args);
+    /// Builds the extrapolated vector one block at a time from the on-disk history
+    void extrapolate_blocked(const double* coefficients, int numQuantities, va_list args);
+    /// The dot product of two error vectors, streamed block by block from disk
+    double blocked_dot(DIISEntry* entryI, DIISEntry* entryJ);
 
     /// How the vectors are handled in memory
     StoragePolicy _storagePolicy;
@@ -98,9 +110,9 @@ class PSI_API DIISManager {
     /// The maximum number of vectors allowed in the subspace
     int _maxSubspaceSize;
     /// The size of the error vector
-    int _errorVectorSize;
+    size_t _errorVectorSize;
     /// The size of the vector
-    int _vectorSize;
+    size_t _vectorSize;
     /// The number of components in the error vector
     int _numErrorVectorComponents;
     /// The number of components in the vector
@@ -113,6 +125,10 @@ class PSI_API DIISManager {
     std::vector<DIISEntry::InputType> _componentTypes;
     /// The types used in the vector
     std::vector<size_t> _componentSizes;
+    /// The sizes of the irrep blocks making up each component
+    std::vector<std::vector<size_t>> _componentBlockSizes;
+    /// Whether the OnDiskBlocked history is stored in single precision
+    bool _singlePrecision = false;
     /// The label used in disk storage of the DIISEntry objects
     std::string _label;
     /// The PSIO object to use for I/O
@@ -0,0 +1,301 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2019 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#include "jk.h"
+#include "cubature.h"
+#include "points.h"
+
+#include "psi4/libmints/basisset.h"
+#include "psi4/libmints/integral.h"
+#include "psi4/libmints/matrix.h"
+#include "psi4/libmints/potential.h"
+#include "psi4/libmints/sieve.h"
+#include "psi4/libmints/twobody.h"
+#include "psi4/liboptions/liboptions.h"
+#include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/exception.h"
+#include "psi4/libqt/qt.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace psi {
+
+COSK::COSK(std::shared_ptr<BasisSet> primary, Options& options) : DirectJK(primary), options_(options) {
+    density_cutoff_ = options_.get_double("COSX_DENSITY_TOLERANCE");
+}
+COSK::~COSK() {}
+size_t COSK::memory_estimate() {
+    return 0;  // Effectively
+}
+void COSK::print_header() const {
+    if (print_) {
+        outfile->Printf("  ==> COSK: Integral-Direct J, Seminumerical K <==\n\n");
+
+        outfile->Printf("    J tasked:          %11s\n", (do_J_ ? "Yes" : "No"));
+        outfile->Printf("    K tasked:          %11s\n", (do_K_ ? "Yes" : "No"));
+        outfile->Printf("    wK tasked:         %11s\n", (do_wK_ ? "Yes" : "No"));
+        outfile->Printf("    Integrals threads: %11d\n", df_ints_num_threads_);
+        outfile->Printf("    Schwarz Cutoff:    %11.0E\n", cutoff_);
+        outfile->Printf("    Density Cutoff:    %11.0E\n", density_cutoff_);
+        outfile->Printf("    K Grid:            %5d x %5d\n\n", options_.get_int("COSX_RADIAL_POINTS"),
+                        options_.get_int("COSX_SPHERICAL_POINTS"));
+    }
+}
+void COSK::preiterations() {
+    DirectJK::preiterations();
+
+    std::map<std::string, int> opt_int_map;
+    opt_int_map["DFT_RADIAL_POINTS"] = options_.get_int("COSX_RADIAL_POINTS");
+    opt_int_map["DFT_SPHERICAL_POINTS"] = options_.get_int("COSX_SPHERICAL_POINTS");
+    std::map<std::string, std::string> opt_map;
+    grid_ = std::make_shared<DFTGrid>(primary_->molecule(), primary_, opt_int_map, opt_map, options_);
+}
+void COSK::postiterations() {
+    DirectJK::postiterations();
+    grid_.reset();
+}
+void COSK::compute_JK() {
+    if (do_wK_) throw PSIEXCEPTION("COSK: range-separated exchange is not implemented, use another SCF_TYPE.");
+
+    if (do_J_) {
+        auto factory = std::make_shared<IntegralFactory>(primary_, primary_, primary_, primary_);
+        std::vector<std::shared_ptr<TwoBodyAOInt> > ints;
+        ints.push_back(std::shared_ptr<TwoBodyAOInt>(factory->eri()));
+        for (int thread = 1; thread < df_ints_num_threads_; thread++) {
+            if (ints[0]->cloneable())
+                ints.push_back(std::shared_ptr<TwoBodyAOInt>(ints[0]->clone()));
+            else
+                ints.push_back(std::shared_ptr<TwoBodyAOInt>(factory->eri()));
+        }
+        std::vector<std::shared_ptr<Matrix> > temp;
+        build_JK(ints, D_ao_, J_ao_, temp);
+    }
+
+    if (do_K_) {
+        build_cosK(D_ao_, K_ao_);
+    }
+}
+void COSK::build_cosK(std::vector<std::shared_ptr<Matrix> >& D, std::vector<std::shared_ptr<Matrix> >& K) {
+    timer_on("COSK: K");
+
+    for (size_t ind = 0; ind < K.size(); ind++) {
+        K[ind]->zero();
+    }
+
+    // => Sizing <= //
+
+    size_t ndens = D.size();
+    int nbf = primary_->nbf();
+    int nshell = primary_->nshell();
+    int nthread = df_ints_num_threads_;
+    int max_points = grid_->max_points();
+    int max_functions = grid_->max_functions();
+    const std::vector<std::shared_ptr<BlockOPoints> >& blocks = grid_->blocks();
+
+    // => Shell pair partners, for the potential integrals <= //
+
+    std::vector<std::vector<int> > partners(nshell);
+    for (int L = 0; L < nshell; L++) {
+        for (int N = 0; N < nshell; N++) {
+            if (sieve_->shell_pair_significant(N, L)) partners[L].push_back(N);
+        }
+    }
+
+    // => Per-thread workers <= //
+
+    auto factory = std::make_shared<IntegralFactory>(primary_);
+    std::vector<std::shared_ptr<BasisFunctions> > bworkers;
+    std::vector<std::shared_ptr<PotentialInt> > vints;
+    std::vector<SharedMatrix> charges;
+    for (int thread = 0; thread < nthread; thread++) {
+        bworkers.push_back(std::make_shared<BasisFunctions>(primary_, max_points, max_functions));
+        vints.push_back(std::shared_ptr<PotentialInt>(static_cast<PotentialInt*>(factory->ao_potential())));
+        // A charge of -1, since PotentialInt returns the attraction -Z (m|1/|r-C||n)
+        charges.push_back(std::make_shared<Matrix>("Grid Point Charge", 1, 4));
+        charges[thread]->set(0, 0, -1.0);
+        vints[thread]->set_charge_field(charges[thread]);
+    }
+
+    size_t computed_pairs = 0L;
+
+// ==> Master Block Loop <== //
+
+#pragma omp parallel for num_threads(nthread) schedule(dynamic) reduction(+ : computed_pairs)
+    for (size_t Q = 0; Q < blocks.size(); Q++) {
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+
+        std::shared_ptr<BlockOPoints> block = blocks[Q];
+        int npoints = block->npoints();
+        double* x = block->x();
+        double* y = block->y();
+        double* z = block->z();
+        double* w = block->w();
+        const std::vector<int>& function_map = block->functions_local_to_global();
+        int nlocal = function_map.size();
+        if (nlocal == 0) continue;
+
+        bworkers[thread]->compute_functions(block);
+        SharedMatrix phi_mat = bworkers[thread]->basis_value("PHI");
+        double** phi = phi_mat->pointer();
+        int coll_funcs = phi_mat->ncol();
+
+        // => F_s(g) = sum_l phi_l(g) D_ls, and the shells where it matters <= //
+
+        std::vector<SharedMatrix> F(ndens);
+        std::vector<SharedMatrix> G(ndens);
+        auto Dlocal = std::make_shared<Matrix>("D local", nlocal, nbf);
+        double** Dlocalp = Dlocal->pointer();
+        for (size_t ind = 0; ind < ndens; ind++) {
+            double** Dp = D[ind]->pointer();
+            for (int ml = 0; ml < nlocal; ml++) {
+                ::memcpy(Dlocalp[ml], Dp[function_map[ml]], nbf * sizeof(double));
+            }
+            F[ind] = std::make_shared<Matrix>("F", npoints, nbf);
+            G[ind] = std::make_shared<Matrix>("G", npoints, nbf);
+            C_DGEMM('N', 'N', npoints, nbf, nlocal, 1.0, phi[0], coll_funcs, Dlocalp[0], nbf, 0.0,
+                    F[ind]->pointer()[0], nbf);
+        }
+
+        std::vector<bool> significant(nshell, false);
+        std::vector<int> sig_shells;
+        for (int L = 0; L < nshell; L++) {
+            int Lsize = primary_->shell(L).nfunction();
+            int Loff = primary_->shell(L).function_index();
+            double Fmax = 0.0;
+            for (size_t ind = 0; ind < ndens; ind++) {
+                double** Fp = F[ind]->pointer();
+                for (int P = 0; P < npoints; P++) {
+                    for (int l = Loff; l < Loff + Lsize; l++) {
+                        Fmax = std::max(Fmax, std::fabs(Fp[P][l]));
+                    }
+                }
+            }
+            if (Fmax >= density_cutoff_) {
+                significant[L] = true;
+                sig_shells.push_back(L);
+            }
+        }
+        if (sig_shells.empty()) continue;
+
+        // => G_n(g) = sum_s A_ns(g) F_s(g) <= //
+
+        std::vector<bool> touched(nshell, false);
+        std::shared_ptr<PotentialInt> vint = vints[thread];
+        double** Zp = charges[thread]->pointer();
+        const double* buffer = vint->buffer();
+        for (int P = 0; P < npoints; P++) {
+            Zp[0][1] = x[P];
+            Zp[0][2] = y[P];
+            Zp[0][3] = z[P];
+            for (int L : sig_shells) {
+                int Lsize = primary_->shell(L).nfunction();
+                int Loff = primary_->shell(L).function_index();
+                for (int N : partners[L]) {
+                    // (N|L) with both shells significant is computed once, for the larger index
+                    if (significant[N] && N > L) continue;
+                    int Nsize = primary_->shell(N).nfunction();
+                    int Noff = primary_->shell(N).function_index();
+
+                    vint->compute_shell(N, L);
+                    computed_pairs++;
+                    touched[N] = true;
+                    bool mirror = (significant[N] && N != L);
+                    if (mirror) touched[L] = true;
+
+                    for (size_t ind = 0; ind < ndens; ind++) {
+                        double* Fp = F[ind]->pointer()[P];
+                        double* Gp = G[ind]->pointer()[P];
+                        C_DGEMV('N', Nsize, Lsize, 1.0, const_cast<double*>(buffer), Lsize, &Fp[Loff], 1, 1.0,
+                                &Gp[Noff], 1);
+                        if (mirror) {
+                            C_DGEMV('T', Nsize, Lsize, 1.0, const_cast<double*>(buffer), Lsize, &Fp[Noff], 1, 1.0,
+                                    &Gp[Loff], 1);
+                        }
+                    }
+                }
+            }
+        }
+
+        // => K_mn <- sum_g w_g phi_m(g) G_n(g) <= //
+
+        auto wphi = std::make_shared<Matrix>("w phi", npoints, nlocal);
+        double** wphip = wphi->pointer();
+        for (int P = 0; P < npoints; P++) {
+            for (int ml = 0; ml < nlocal; ml++) {
+                wphip[P][ml] = w[P] * phi[P][ml];
+            }
+        }
+        auto Klocal = std::make_shared<Matrix>("K local", nlocal, nbf);
+        double** Klocalp = Klocal->pointer();
+        for (size_t ind = 0; ind < ndens; ind++) {
+            C_DGEMM('T', 'N', nlocal, nbf, npoints, 1.0, wphip[0], nlocal, G[ind]->pointer()[0], nbf, 0.0,
+                    Klocalp[0], nbf);
+
+            // => Unpacking <= //
+            double** Kp = K[ind]->pointer();
+            for (int N = 0; N < nshell; N++) {
+                if (!touched[N]) continue;
+                int Nsize = primary_->shell(N).nfunction();
+                int Noff = primary_->shell(N).function_index();
+                for (int ml = 0; ml < nlocal; ml++) {
+                    int mg = function_map[ml];
+                    for (int n = Noff; n < Noff + Nsize; n++) {
+#pragma omp atomic update
+                        Kp[mg][n] += Klocalp[ml][n];
+                    }
+                }
+            }
+        }
+    }
+
+    // The quadrature is on one index only, so symmetric densities get a symmetrized K
+    if (lr_symmetric_) {
+        for (size_t ind = 0; ind < K.size(); ind++) {
+            K[ind]->hermitivitize();
+        }
+    }
+
+    if (bench_) {
+        auto mode = std::ostream::app;
+        auto printer = std::make_shared<PsiOutStream>("bench.dat", mode);
+        printer->Printf("COSK: Computed %20zu potential shell pairs over %zu grid blocks\n", computed_pairs,
+                        blocks.size());
+    }
+
+    timer_off("COSK: K");
+}
+
+}  // namespace psi
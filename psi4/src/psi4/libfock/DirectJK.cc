@@ -95,9 +95,6 @@ void DirectJK::compute_JK() {
             build_JK(ints, D_ao_, J_ao_, wK_ao_);
         } else {
             std::vector<std::shared_ptr<Matrix> > temp;
-            for (size_t i = 0; i < D_ao_.size(); i++) {
-                temp.push_back(std::make_shared<Matrix>("temp", primary_->nbf(), primary_->nbf()));
-            }
             build_JK(ints, D_ao_, temp, wK_ao_);
         }
     }
@@ -115,15 +112,9 @@ void DirectJK::compute_JK() {
             build_JK(ints, D_ao_, J_ao_, K_ao_);
         } else if (do_J_) {
             std::vector<std::shared_ptr<Matrix> > temp;
-            for (size_t i = 0; i < D_ao_.size(); i++) {
-                temp.push_back(std::make_shared<Matrix>("temp", primary_->nbf(), primary_->nbf()));
-            }
             build_JK(ints, D_ao_, J_ao_, temp);
         } else {
             std::vector<std::shared_ptr<Matrix> > temp;
-            for (size_t i = 0; i < D_ao_.size(); i++) {
-                temp.push_back(std::make_shared<Matrix>("temp", primary_->nbf(), primary_->nbf()));
-            }
             build_JK(ints, D_ao_, temp, K_ao_);
         }
     }
@@ -222,21 +213,101 @@ void DirectJK::build_JK(std::vector<std::shared_ptr<TwoBodyAOInt> >& ints, std::
     size_t ntask_pair = task_pairs.size();
     size_t ntask_pair2 = ntask_pair * ntask_pair;
 
+    // => Shell-Pair-Major Density Packing <= //
+
+    /*
+     * Each shell pair block (M|N) holds the M x N elements of every density with the
+     * density index running fastest, so one integral updates all of the densities with
+     * a unit-stride kernel. The J/K accumulators share this layout.
+     */
+
+    // Either of J or K may be passed empty, and is then skipped
+    size_t ndens = D.size();
+    bool do_J = !J.empty();
+    bool do_K = !K.empty();
+    std::vector<size_t> pair_offsets(nshell * (size_t)nshell + 1L, 0L);
+    for (int M = 0; M < nshell; M++) {
+        for (int N = 0; N < nshell; N++) {
+            size_t MN = M * (size_t)nshell + N;
+            pair_offsets[MN + 1] =
+                pair_offsets[MN] + (size_t)primary_->shell(M).nfunction() * primary_->shell(N).nfunction() * ndens;
+        }
+    }
+    size_t packed_size = pair_offsets.back();
+
+    // Dpack holds D, Jpack holds D + D^T for the Coulomb contractions
+    std::vector<double> Dpack(packed_size);
+    std::vector<double> Jpack(packed_size);
+
+#pragma omp parallel for num_threads(nthread) schedule(dynamic)
+    for (int M = 0; M < nshell; M++) {
+        int Msize = primary_->shell(M).nfunction();
+        int Moff = primary_->shell(M).function_index();
+        for (int N = 0; N < nshell; N++) {
+            int Nsize = primary_->shell(N).nfunction();
+            int Noff = primary_->shell(N).function_index();
+            double* Dpackp = &Dpack[pair_offsets[M * (size_t)nshell + N]];
+            double* Jpackp = &Jpack[pair_offsets[M * (size_t)nshell + N]];
+            for (size_t ind = 0; ind < ndens; ind++) {
+                double** Dp = D[ind]->pointer();
+                for (int m = 0; m < Msize; m++) {
+                    for (int n = 0; n < Nsize; n++) {
+                        size_t mn = (m * (size_t)Nsize + n) * ndens + ind;
+                        Dpackp[mn] = Dp[m + Moff][n + Noff];
+                        Jpackp[mn] = Dp[m + Moff][n + Noff] + Dp[n + Noff][m + Moff];
+                    }
+                }
+            }
+        }
+    }
+
+    // => Accumulators <= //
+
+    // Thread-local accumulators avoid atomics entirely, but fall back to one shared copy if memory is short
+    size_t nmat = (do_J ? 1L : 0L) + (do_K ? 1L : 0L);
+    bool thread_accumulators = (nthread > 1) && (nmat * nthread * packed_size <= memory_);
+    int naccum = (thread_accumulators ? nthread : 1);
+    std::vector<std::vector<double> > Jacc(naccum, std::vector<double>(do_J ? packed_size : 0L, 0.0));
+    std::vector<std::vector<double> > Kacc(naccum, std::vector<double>(do_K ? packed_size : 0L, 0.0));
+    bool atomic_stripe = (naccum < nthread);
+
     // => Intermediate Buffers <= //
 
-    std::vector<std::vector<std::shared_ptr<Matrix> > > JKT;
-    for (int thread = 0; thread < nthread; thread++) {
-        std::vector<std::shared_ptr<Matrix> > JK2;
-        for (size_t ind = 0; ind < D.size(); ind++) {
-            JK2.push_back(std::make_shared<Matrix>("JKT", (lr_symmetric_ ? 6 : 10) * max_task, max_task));
+    size_t block_size = max_task * max_task * ndens;
+    std::vector<std::vector<double> > JKT(nthread, std::vector<double>((lr_symmetric_ ? 6 : 10) * block_size));
+
+    // Adds a task buffer into the accumulator of shell pair (M|N) for a run of ndens densities per element
+    auto stripe_out = [&](std::vector<double>& acc, const double* src, int M, int N, int Moff2, int Noff2,
+                          int dNsize) {
+        int Msize = primary_->shell(M).nfunction();
+        int Nsize = primary_->shell(N).nfunction();
+        double* accp = &acc[pair_offsets[M * (size_t)nshell + N]];
+        for (int m = 0; m < Msize; m++) {
+            for (int n = 0; n < Nsize; n++) {
+                double* dst = &accp[(m * (size_t)Nsize + n) * ndens];
+                const double* srcp = &src[((m + Moff2) * (size_t)dNsize + n + Noff2) * ndens];
+                if (atomic_stripe) {
+                    for (size_t ind = 0; ind < ndens; ind++) {
+#pragma omp atomic
+                        dst[ind] += srcp[ind];
+                    }
+                } else {
+                    for (size_t ind = 0; ind < ndens; ind++) {
+                        dst[ind] += srcp[ind];
+                    }
+                }
+            }
         }
-        JKT.push_back(JK2);
-    }
+    };
 
     // => Benchmarks <= //
 
     size_t computed_shells = 0L;
 
+    // Per-thread trace timers, recorded only when trace timers are enabled
+    int trace_quartets = trace_timer_register("DirectJK: Quartets");
+    int trace_stripe = trace_timer_register("DirectJK: Stripe");
+
 // ==> Master Task Loop <== //
 
 #pragma omp parallel for num_threads(nthread) schedule(dynamic) reduction(+ : computed_shells)
@@ -278,8 +349,26 @@ void DirectJK::build_JK(std::vector<std::shared_ptr<TwoBodyAOInt> >& ints, std::
         thread = omp_get_thread_num();
 #endif
 
+        double* J1p = &JKT[thread][0L * block_size];
+        double* J2p = &JKT[thread][1L * block_size];
+        double* K1p = &JKT[thread][2L * block_size];
+        double* K2p = &JKT[thread][3L * block_size];
+        double* K3p = &JKT[thread][4L * block_size];
+        double* K4p = &JKT[thread][5L * block_size];
+        double* K5p = nullptr;
+        double* K6p = nullptr;
+        double* K7p = nullptr;
+        double* K8p = nullptr;
+        if (!lr_symmetric_) {
+            K5p = &JKT[thread][6L * block_size];
+            K6p = &JKT[thread][7L * block_size];
+            K7p = &JKT[thread][8L * block_size];
+            K8p = &JKT[thread][9L * block_size];
+        }
+
         // => Master shell quartet loops <= //
 
+        trace_timer_on(trace_quartets);
         bool touched = false;
         for (int P2 = P2start; P2 < P2start + nPtask; P2++) {
             for (int Q2 = Q2start; Q2 < Q2start + nQtask; Q2++) {
@@ -298,290 +387,225 @@ void DirectJK::build_JK(std::vector<std::shared_ptr<TwoBodyAOInt> >& ints, std::
 
                         // printf("Quartet: %2d %2d %2d %2d\n", P, Q, R, S);
 
-                        // if (thread == 0) timer_on("JK: Ints");
                         if (ints[thread]->compute_shell(P, Q, R, S) == 0)
                             continue;  // No integrals in this shell quartet
                         computed_shells++;
-                        // if (thread == 0) timer_off("JK: Ints");
 
-                        const double* buffer = ints[thread]->buffer();
+                        const double* buffer2 = ints[thread]->buffer();
 
                         int Psize = primary_->shell(P).nfunction();
                         int Qsize = primary_->shell(Q).nfunction();
                         int Rsize = primary_->shell(R).nfunction();
                         int Ssize = primary_->shell(S).nfunction();
 
-                        int Poff = primary_->shell(P).function_index();
-                        int Qoff = primary_->shell(Q).function_index();
-                        int Roff = primary_->shell(R).function_index();
-                        int Soff = primary_->shell(S).function_index();
-
                         int Poff2 = task_offsets[P2] - task_offsets[P2start];
                         int Qoff2 = task_offsets[Q2] - task_offsets[Q2start];
                         int Roff2 = task_offsets[R2] - task_offsets[R2start];
                         int Soff2 = task_offsets[S2] - task_offsets[S2start];
 
-                        // if (thread == 0) timer_on("JK: GEMV");
-                        for (size_t ind = 0; ind < D.size(); ind++) {
-                            double** Dp = D[ind]->pointer();
-                            double** JKTp = JKT[thread][ind]->pointer();
-                            const double* buffer2 = buffer;
-
-                            if (!touched) {
-                                ::memset((void*)JKTp[0L * max_task], '\0', dPsize * dQsize * sizeof(double));
-                                ::memset((void*)JKTp[1L * max_task], '\0', dRsize * dSsize * sizeof(double));
-                                ::memset((void*)JKTp[2L * max_task], '\0', dPsize * dRsize * sizeof(double));
-                                ::memset((void*)JKTp[3L * max_task], '\0', dPsize * dSsize * sizeof(double));
-                                ::memset((void*)JKTp[4L * max_task], '\0', dQsize * dRsize * sizeof(double));
-                                ::memset((void*)JKTp[5L * max_task], '\0', dQsize * dSsize * sizeof(double));
-                                if (!lr_symmetric_) {
-                                    ::memset((void*)JKTp[6L * max_task], '\0', dRsize * dPsize * sizeof(double));
-                                    ::memset((void*)JKTp[7L * max_task], '\0', dSsize * dPsize * sizeof(double));
-                                    ::memset((void*)JKTp[8L * max_task], '\0', dRsize * dQsize * sizeof(double));
-                                    ::memset((void*)JKTp[9L * max_task], '\0', dSsize * dQsize * sizeof(double));
-                                }
-                            }
-
-                            double* J1p = JKTp[0L * max_task];
-                            double* J2p = JKTp[1L * max_task];
-                            double* K1p = JKTp[2L * max_task];
-                            double* K2p = JKTp[3L * max_task];
-                            double* K3p = JKTp[4L * max_task];
-                            double* K4p = JKTp[5L * max_task];
-                            double* K5p;
-                            double* K6p;
-                            double* K7p;
-                            double* K8p;
+                        if (!touched) {
+                            ::memset((void*)J1p, '\0', dPsize * dQsize * ndens * sizeof(double));
+                            ::memset((void*)J2p, '\0', dRsize * dSsize * ndens * sizeof(double));
+                            ::memset((void*)K1p, '\0', dPsize * dRsize * ndens * sizeof(double));
+                            ::memset((void*)K2p, '\0', dPsize * dSsize * ndens * sizeof(double));
+                            ::memset((void*)K3p, '\0', dQsize * dRsize * ndens * sizeof(double));
+                            ::memset((void*)K4p, '\0', dQsize * dSsize * ndens * sizeof(double));
                             if (!lr_symmetric_) {
-                                K5p = JKTp[6L * max_task];
-                                K6p = JKTp[7L * max_task];
-                                K7p = JKTp[8L * max_task];
-                                K8p = JKTp[9L * max_task];
+                                ::memset((void*)K5p, '\0', dRsize * dPsize * ndens * sizeof(double));
+                                ::memset((void*)K6p, '\0', dSsize * dPsize * ndens * sizeof(double));
+                                ::memset((void*)K7p, '\0', dRsize * dQsize * ndens * sizeof(double));
+                                ::memset((void*)K8p, '\0', dSsize * dQsize * ndens * sizeof(double));
                             }
+                        }
 
-                            double prefactor = 1.0;
-                            if (P == Q) prefactor *= 0.5;
-                            if (R == S) prefactor *= 0.5;
-                            if (P == R && Q == S) prefactor *= 0.5;
-
-                            for (int p = 0; p < Psize; p++) {
-                                for (int q = 0; q < Qsize; q++) {
-                                    for (int r = 0; r < Rsize; r++) {
-                                        for (int s = 0; s < Ssize; s++) {
-                                            J1p[(p + Poff2) * dQsize + q + Qoff2] +=
-                                                prefactor * (Dp[r + Roff][s + Soff] + Dp[s + Soff][r + Roff]) *
-                                                (*buffer2);
-                                            J2p[(r + Roff2) * dSsize + s + Soff2] +=
-                                                prefactor * (Dp[p + Poff][q + Qoff] + Dp[q + Qoff][p + Poff]) *
-                                                (*buffer2);
-                                            K1p[(p + Poff2) * dRsize + r + Roff2] +=
-                                                prefactor * (Dp[q + Qoff][s + Soff]) * (*buffer2);
-                                            K2p[(p + Poff2) * dSsize + s + Soff2] +=
-                                                prefactor * (Dp[q + Qoff][r + Roff]) * (*buffer2);
-                                            K3p[(q + Qoff2) * dRsize + r + Roff2] +=
-                                                prefactor * (Dp[p + Poff][s + Soff]) * (*buffer2);
-                                            K4p[(q + Qoff2) * dSsize + s + Soff2] +=
-                                                prefactor * (Dp[p + Poff][r + Roff]) * (*buffer2);
-                                            if (!lr_symmetric_) {
-                                                K5p[(r + Roff2) * dPsize + p + Poff2] +=
-                                                    prefactor * (Dp[s + Soff][q + Qoff]) * (*buffer2);
-                                                K6p[(s + Soff2) * dPsize + p + Poff2] +=
-                                                    prefactor * (Dp[r + Roff][q + Qoff]) * (*buffer2);
-                                                K7p[(r + Roff2) * dQsize + q + Qoff2] +=
-                                                    prefactor * (Dp[s + Soff][p + Poff]) * (*buffer2);
-                                                K8p[(s + Soff2) * dQsize + q + Qoff2] +=
-                                                    prefactor * (Dp[r + Roff][p + Poff]) * (*buffer2);
+                        // Packed density blocks touched by this quartet
+                        const double* Dpq = &Jpack[pair_offsets[P * (size_t)nshell + Q]];
+                        const double* Drs = &Jpack[pair_offsets[R * (size_t)nshell + S]];
+                        const double* Dqs = &Dpack[pair_offsets[Q * (size_t)nshell + S]];
+                        const double* Dqr = &Dpack[pair_offsets[Q * (size_t)nshell + R]];
+                        const double* Dps = &Dpack[pair_offsets[P * (size_t)nshell + S]];
+                        const double* Dpr = &Dpack[pair_offsets[P * (size_t)nshell + R]];
+                        const double* Dsq = &Dpack[pair_offsets[S * (size_t)nshell + Q]];
+                        const double* Drq = &Dpack[pair_offsets[R * (size_t)nshell + Q]];
+                        const double* Dsp = &Dpack[pair_offsets[S * (size_t)nshell + P]];
+                        const double* Drp = &Dpack[pair_offsets[R * (size_t)nshell + P]];
+
+                        double prefactor = 1.0;
+                        if (P == Q) prefactor *= 0.5;
+                        if (R == S) prefactor *= 0.5;
+                        if (P == R && Q == S) prefactor *= 0.5;
+
+                        for (int p = 0; p < Psize; p++) {
+                            for (int q = 0; q < Qsize; q++) {
+                                const double* Dpqp = &Dpq[(p * (size_t)Qsize + q) * ndens];
+                                double* J1 = &J1p[((p + Poff2) * (size_t)dQsize + q + Qoff2) * ndens];
+                                for (int r = 0; r < Rsize; r++) {
+                                    const double* Dqrp = &Dqr[(q * (size_t)Rsize + r) * ndens];
+                                    const double* Dprp = &Dpr[(p * (size_t)Rsize + r) * ndens];
+                                    double* K1 = &K1p[((p + Poff2) * (size_t)dRsize + r + Roff2) * ndens];
+                                    double* K3 = &K3p[((q + Qoff2) * (size_t)dRsize + r + Roff2) * ndens];
+                                    for (int s = 0; s < Ssize; s++) {
+                                        double val = prefactor * (*buffer2++);
+                                        const double* Drsp = &Drs[(r * (size_t)Ssize + s) * ndens];
+                                        const double* Dqsp = &Dqs[(q * (size_t)Ssize + s) * ndens];
+                                        const double* Dpsp = &Dps[(p * (size_t)Ssize + s) * ndens];
+                                        double* J2 = &J2p[((r + Roff2) * (size_t)dSsize + s + Soff2) * ndens];
+                                        double* K2 = &K2p[((p + Poff2) * (size_t)dSsize + s + Soff2) * ndens];
+                                        double* K4 = &K4p[((q + Qoff2) * (size_t)dSsize + s + Soff2) * ndens];
+                                        if (do_J) {
+                                            for (size_t ind = 0; ind < ndens; ind++) {
+                                                J1[ind] += val * Drsp[ind];
+                                                J2[ind] += val * Dpqp[ind];
+                                            }
+                                        }
+                                        if (do_K) {
+                                            for (size_t ind = 0; ind < ndens; ind++) {
+                                                K1[ind] += val * Dqsp[ind];
+                                                K2[ind] += val * Dqrp[ind];
+                                                K3[ind] += val * Dpsp[ind];
+                                                K4[ind] += val * Dprp[ind];
+                                            }
+                                        }
+                                        if (do_K && !lr_symmetric_) {
+                                            const double* Dsqp = &Dsq[(s * (size_t)Qsize + q) * ndens];
+                                            const double* Drqp = &Drq[(r * (size_t)Qsize + q) * ndens];
+                                            const double* Dspp = &Dsp[(s * (size_t)Psize + p) * ndens];
+                                            const double* Drpp = &Drp[(r * (size_t)Psize + p) * ndens];
+                                            double* K5 = &K5p[((r + Roff2) * (size_t)dPsize + p + Poff2) * ndens];
+                                            double* K6 = &K6p[((s + Soff2) * (size_t)dPsize + p + Poff2) * ndens];
+                                            double* K7 = &K7p[((r + Roff2) * (size_t)dQsize + q + Qoff2) * ndens];
+                                            double* K8 = &K8p[((s + Soff2) * (size_t)dQsize + q + Qoff2) * ndens];
+                                            for (size_t ind = 0; ind < ndens; ind++) {
+                                                K5[ind] += val * Dsqp[ind];
+                                                K6[ind] += val * Drqp[ind];
+                                                K7[ind] += val * Dspp[ind];
+                                                K8[ind] += val * Drpp[ind];
                                             }
-                                            buffer2++;
                                         }
                                     }
                                 }
                             }
                         }
                         touched = true;
-                        // if (thread == 0) timer_off("JK: GEMV");
                     }
                 }
             }
         }  // End Shell Quartets
+        trace_timer_off(trace_quartets);
 
         if (!touched) continue;
 
         // => Stripe out <= //
 
-        // if (thread == 0) timer_on("JK: Atomic");
-        for (size_t ind = 0; ind < D.size(); ind++) {
-            double** JKTp = JKT[thread][ind]->pointer();
-            double** Jp = J[ind]->pointer();
-            double** Kp = K[ind]->pointer();
-
-            double* J1p = JKTp[0L * max_task];
-            double* J2p = JKTp[1L * max_task];
-            double* K1p = JKTp[2L * max_task];
-            double* K2p = JKTp[3L * max_task];
-            double* K3p = JKTp[4L * max_task];
-            double* K4p = JKTp[5L * max_task];
-            double* K5p;
-            double* K6p;
-            double* K7p;
-            double* K8p;
-            if (!lr_symmetric_) {
-                K5p = JKTp[6L * max_task];
-                K6p = JKTp[7L * max_task];
-                K7p = JKTp[8L * max_task];
-                K8p = JKTp[9L * max_task];
-            }
-
-            // > J_PQ < //
+        trace_timer_on(trace_stripe);
+        std::vector<double>& Jt = Jacc[atomic_stripe ? 0 : thread];
+        std::vector<double>& Kt = Kacc[atomic_stripe ? 0 : thread];
 
-            for (int P2 = 0; P2 < nPtask; P2++) {
-                for (int Q2 = 0; Q2 < nQtask; Q2++) {
-                    int P = task_shells[P2start + P2];
-                    int Q = task_shells[Q2start + Q2];
-                    int Psize = primary_->shell(P).nfunction();
-                    int Qsize = primary_->shell(Q).nfunction();
-                    int Poff = primary_->shell(P).function_index();
-                    int Qoff = primary_->shell(Q).function_index();
-                    int Poff2 = task_offsets[P2 + P2start] - task_offsets[P2start];
-                    int Qoff2 = task_offsets[Q2 + Q2start] - task_offsets[Q2start];
-                    for (int p = 0; p < Psize; p++) {
-                        for (int q = 0; q < Qsize; q++) {
-#pragma omp atomic
-                            Jp[p + Poff][q + Qoff] += J1p[(p + Poff2) * dQsize + q + Qoff2];
-                        }
-                    }
-                }
-            }
+        for (int P2 = 0; P2 < nPtask; P2++) {
+            int P = task_shells[P2start + P2];
+            int Poff2 = task_offsets[P2 + P2start] - task_offsets[P2start];
 
-            // > J_RS < //
+            // > J_PQ < //
 
-            for (int R2 = 0; R2 < nRtask; R2++) {
-                for (int S2 = 0; S2 < nStask; S2++) {
-                    int R = task_shells[R2start + R2];
-                    int S = task_shells[S2start + S2];
-                    int Rsize = primary_->shell(R).nfunction();
-                    int Ssize = primary_->shell(S).nfunction();
-                    int Roff = primary_->shell(R).function_index();
-                    int Soff = primary_->shell(S).function_index();
-                    int Roff2 = task_offsets[R2 + R2start] - task_offsets[R2start];
-                    int Soff2 = task_offsets[S2 + S2start] - task_offsets[S2start];
-                    for (int r = 0; r < Rsize; r++) {
-                        for (int s = 0; s < Ssize; s++) {
-#pragma omp atomic
-                            Jp[r + Roff][s + Soff] += J2p[(r + Roff2) * dSsize + s + Soff2];
-                        }
-                    }
-                }
+            for (int Q2 = 0; Q2 < nQtask; Q2++) {
+                int Q = task_shells[Q2start + Q2];
+                int Qoff2 = task_offsets[Q2 + Q2start] - task_offsets[Q2start];
+                if (do_J) stripe_out(Jt, J1p, P, Q, Poff2, Qoff2, dQsize);
             }
 
             // > K_PR < //
 
-            for (int P2 = 0; P2 < nPtask; P2++) {
-                for (int R2 = 0; R2 < nRtask; R2++) {
-                    int P = task_shells[P2start + P2];
-                    int R = task_shells[R2start + R2];
-                    int Psize = primary_->shell(P).nfunction();
-                    int Rsize = primary_->shell(R).nfunction();
-                    int Poff = primary_->shell(P).function_index();
-                    int Roff = primary_->shell(R).function_index();
-                    int Poff2 = task_offsets[P2 + P2start] - task_offsets[P2start];
-                    int Roff2 = task_offsets[R2 + R2start] - task_offsets[R2start];
-                    for (int p = 0; p < Psize; p++) {
-                        for (int r = 0; r < Rsize; r++) {
-#pragma omp atomic
-                            Kp[p + Poff][r + Roff] += K1p[(p + Poff2) * dRsize + r + Roff2];
-                            if (!lr_symmetric_) {
-#pragma omp atomic
-                                Kp[r + Roff][p + Poff] += K5p[(r + Roff2) * dPsize + p + Poff2];
-                            }
-                        }
-                    }
-                }
+            for (int R2 = 0; R2 < nRtask; R2++) {
+                int R = task_shells[R2start + R2];
+                int Roff2 = task_offsets[R2 + R2start] - task_offsets[R2start];
+                if (do_K) stripe_out(Kt, K1p, P, R, Poff2, Roff2, dRsize);
+                if (do_K && !lr_symmetric_) stripe_out(Kt, K5p, R, P, Roff2, Poff2, dPsize);
             }
 
             // > K_PS < //
 
-            for (int P2 = 0; P2 < nPtask; P2++) {
-                for (int S2 = 0; S2 < nStask; S2++) {
-                    int P = task_shells[P2start + P2];
-                    int S = task_shells[S2start + S2];
-                    int Psize = primary_->shell(P).nfunction();
-                    int Ssize = primary_->shell(S).nfunction();
-                    int Poff = primary_->shell(P).function_index();
-                    int Soff = primary_->shell(S).function_index();
-                    int Poff2 = task_offsets[P2 + P2start] - task_offsets[P2start];
-                    int Soff2 = task_offsets[S2 + S2start] - task_offsets[S2start];
-                    for (int p = 0; p < Psize; p++) {
-                        for (int s = 0; s < Ssize; s++) {
-#pragma omp atomic
-                            Kp[p + Poff][s + Soff] += K2p[(p + Poff2) * dSsize + s + Soff2];
-                            if (!lr_symmetric_) {
-#pragma omp atomic
-                                Kp[s + Soff][p + Poff] += K6p[(s + Soff2) * dPsize + p + Poff2];
-                            }
-                        }
-                    }
-                }
+            for (int S2 = 0; S2 < nStask; S2++) {
+                int S = task_shells[S2start + S2];
+                int Soff2 = task_offsets[S2 + S2start] - task_offsets[S2start];
+                if (do_K) stripe_out(Kt, K2p, P, S, Poff2, Soff2, dSsize);
+                if (do_K && !lr_symmetric_) stripe_out(Kt, K6p, S, P, Soff2, Poff2, dPsize);
             }
+        }
+
+        for (int Q2 = 0; Q2 < nQtask; Q2++) {
+            int Q = task_shells[Q2start + Q2];
+            int Qoff2 = task_offsets[Q2 + Q2start] - task_offsets[Q2start];
 
             // > K_QR < //
 
-            for (int Q2 = 0; Q2 < nQtask; Q2++) {
-                for (int R2 = 0; R2 < nRtask; R2++) {
-                    int Q = task_shells[Q2start + Q2];
-                    int R = task_shells[R2start + R2];
-                    int Qsize = primary_->shell(Q).nfunction();
-                    int Rsize = primary_->shell(R).nfunction();
-                    int Qoff = primary_->shell(Q).function_index();
-                    int Roff = primary_->shell(R).function_index();
-                    int Qoff2 = task_offsets[Q2 + Q2start] - task_offsets[Q2start];
-                    int Roff2 = task_offsets[R2 + R2start] - task_offsets[R2start];
-                    for (int q = 0; q < Qsize; q++) {
-                        for (int r = 0; r < Rsize; r++) {
-#pragma omp atomic
-                            Kp[q + Qoff][r + Roff] += K3p[(q + Qoff2) * dRsize + r + Roff2];
-                            if (!lr_symmetric_) {
-#pragma omp atomic
-                                Kp[r + Roff][q + Qoff] += K7p[(r + Roff2) * dQsize + q + Qoff2];
-                            }
-                        }
-                    }
-                }
+            for (int R2 = 0; R2 < nRtask; R2++) {
+                int R = task_shells[R2start + R2];
+                int Roff2 = task_offsets[R2 + R2start] - task_offsets[R2start];
+                if (do_K) stripe_out(Kt, K3p, Q, R, Qoff2, Roff2, dRsize);
+                if (do_K && !lr_symmetric_) stripe_out(Kt, K7p, R, Q, Roff2, Qoff2, dQsize);
             }
 
             // > K_QS < //
 
-            for (int Q2 = 0; Q2 < nQtask; Q2++) {
-                for (int S2 = 0; S2 < nStask; S2++) {
-                    int Q = task_shells[Q2start + Q2];
-                    int S = task_shells[S2start + S2];
-                    int Qsize = primary_->shell(Q).nfunction();
-                    int Ssize = primary_->shell(S).nfunction();
-                    int Qoff = primary_->shell(Q).function_index();
-                    int Soff = primary_->shell(S).function_index();
-                    int Qoff2 = task_offsets[Q2 + Q2start] - task_offsets[Q2start];
-                    int Soff2 = task_offsets[S2 + S2start] - task_offsets[S2start];
-                    for (int q = 0; q < Qsize; q++) {
-                        for (int s = 0; s < Ssize; s++) {
-#pragma omp atomic
-                            Kp[q + Qoff][s + Soff] += K4p[(q + Qoff2) * dSsize + s + Soff2];
-                            if (!lr_symmetric_) {
-#pragma omp atomic
-                                Kp[s + Soff][q + Qoff] += K8p[(s + Soff2) * dQsize + q + Qoff2];
-                            }
-                        }
-                    }
-                }
+            for (int S2 = 0; S2 < nStask; S2++) {
+                int S = task_shells[S2start + S2];
+                int Soff2 = task_offsets[S2 + S2start] - task_offsets[S2start];
+                if (do_K) stripe_out(Kt, K4p, Q, S, Qoff2, Soff2, dSsize);
+                if (do_K && !lr_symmetric_) stripe_out(Kt, K8p, S, Q, Soff2, Qoff2, dQsize);
             }
+        }
 
-        }  // End stripe out
-        // if (thread == 0) timer_off("JK: Atomic");
+        // > J_RS < //
+
+        for (int R2 = 0; R2 < nRtask; R2++) {
+            int R = task_shells[R2start + R2];
+            int Roff2 = task_offsets[R2 + R2start] - task_offsets[R2start];
+            for (int S2 = 0; S2 < nStask; S2++) {
+                int S = task_shells[S2start + S2];
+                int Soff2 = task_offsets[S2 + S2start] - task_offsets[S2start];
+                if (do_J) stripe_out(Jt, J2p, R, S, Roff2, Soff2, dSsize);
+            }
+        }
+        trace_timer_off(trace_stripe);
 
     }  // End master task list
 
-    for (size_t ind = 0; ind < D.size(); ind++) {
+    // => Reduction and unpacking <= //
+
+#pragma omp parallel for num_threads(nthread) schedule(dynamic)
+    for (int M = 0; M < nshell; M++) {
+        int Msize = primary_->shell(M).nfunction();
+        int Moff = primary_->shell(M).function_index();
+        for (int N = 0; N < nshell; N++) {
+            int Nsize = primary_->shell(N).nfunction();
+            int Noff = primary_->shell(N).function_index();
+            size_t start = pair_offsets[M * (size_t)nshell + N];
+            size_t stop = pair_offsets[M * (size_t)nshell + N + 1];
+            for (int t = 1; t < naccum; t++) {
+                for (size_t i = start; i < stop; i++) {
+                    if (do_J) Jacc[0][i] += Jacc[t][i];
+                    if (do_K) Kacc[0][i] += Kacc[t][i];
+                }
+            }
+            for (size_t ind = 0; ind < ndens; ind++) {
+                double** Jp = (do_J ? J[ind]->pointer() : nullptr);
+                double** Kp = (do_K ? K[ind]->pointer() : nullptr);
+                for (int m = 0; m < Msize; m++) {
+                    for (int n = 0; n < Nsize; n++) {
+                        size_t mn = start + (m * (size_t)Nsize + n) * ndens + ind;
+                        if (do_J) Jp[m + Moff][n + Noff] = Jacc[0][mn];
+                        if (do_K) Kp[m + Moff][n + Noff] = Kacc[0][mn];
+                    }
+                }
+            }
+        }
+    }
+
+    for (size_t ind = 0; ind < J.size(); ind++) {
         J[ind]->scale(2.0);
         J[ind]->hermitivitize();
+    }
+    for (size_t ind = 0; ind < K.size(); ind++) {
         if (lr_symmetric_) {
             K[ind]->scale(2.0);
             K[ind]->hermitivitize();
@@ -65,6 +65,7 @@ void MemDFJK::common_init() { dfh_ = std::make_shared<DFHelper>(primary_, auxili
 size_t MemDFJK::memory_estimate() {
     dfh_->set_nthreads(omp_nthread_);
     dfh_->set_schwarz_cutoff(cutoff_);
+    dfh_->set_do_wK(do_wK_);
     return dfh_->get_core_size();
 }
 
@@ -80,29 +81,22 @@ void MemDFJK::preiterations() {
     dfh_->set_memory(memory_ - memory_overhead());
     dfh_->set_do_wK(do_wK_);
     dfh_->set_omega(omega_);
+    dfh_->set_local_K(local_K_);
+    dfh_->set_local_K_cutoff(local_K_cutoff_);
 
     // we need to prepare the AOs here, and that's it.
-    // DFHelper takes care of all the housekeeping
-
-    if (do_wK_) {
-        // TODO add wK integrals.
-        // DFHelper class will throw
-        // initialize_wK()
-        throw PSIEXCEPTION("MemDFJK does not yet support wK builds.");
-    } else {
-        dfh_->initialize();
-    }
+    // DFHelper takes care of all the housekeeping, including the (Q|w|mn) AOs
+    dfh_->initialize();
 }
 void MemDFJK::compute_JK() {
-    dfh_->build_JK(C_left_ao_, C_right_ao_, D_ao_, J_ao_, K_ao_, max_nocc(), do_J_, do_K_, do_wK_, lr_symmetric_);
-}
-void set_do_wK(bool do_wK) {
-    if (do_wK) {
-        std::stringstream message;
-        message << "MemDFJK cannot compute wK integrals. Please use DiskDFJK." << std::endl;
-        message << "  If you are not a developer or using Psi4NumPy please report this issue at github.com/psi4/psi4."
-                << std::endl;
-        throw PSIEXCEPTION(message.str());
+    dfh_->build_JK(C_left_ao_, C_right_ao_, D_ao_, J_ao_, K_ao_, wK_ao_, max_nocc(), do_J_, do_K_, do_wK_,
+                   lr_symmetric_);
+
+    // Bring the wK matrices back to Hermitian
+    if (do_wK_ && lr_symmetric_) {
+        for (size_t N = 0; N < wK_ao_.size(); N++) {
+            wK_ao_[N]->hermitivitize();
+        }
     }
 }
 void MemDFJK::postiterations() {}
@@ -120,7 +114,10 @@ void MemDFJK::print_header() const {
         outfile->Printf("    Algorithm:          %11s\n", (dfh_->get_AO_core() ? "Core" : "Disk"));
         outfile->Printf("    Schwarz Cutoff:     %11.0E\n", cutoff_);
         outfile->Printf("    Mask sparsity (%%):  %11.4f\n", 100. * dfh_->ao_sparsity());
-        outfile->Printf("    Fitting Condition:  %11.0E\n\n", condition_);
+        outfile->Printf("    Fitting Condition:  %11.0E\n", condition_);
+        outfile->Printf("    Local K:            %11s\n", (local_K_ ? "Yes" : "No"));
+        if (local_K_) outfile->Printf("    Local K Cutoff:     %11.0E\n", local_K_cutoff_);
+        outfile->Printf("\n");
 
         outfile->Printf("   => Auxiliary Basis Set <=\n\n");
         auxiliary_->print_by_level("outfile", print_);
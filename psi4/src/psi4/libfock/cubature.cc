@@ -47,6 +47,12 @@
 #include <limits>
 #include <cctype>
 #include <cassert>
+#include <algorithm>
+#include <list>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <tuple>
 
 #ifdef _OPENMP
 #include <omp.h>
@@ -3465,6 +3471,7 @@ class RadialPruneMgr {
    public:
     static int WhichPruneScheme(const char *schemename);
     static const char *SchemeName(int which) { return pruneschemes[which].name; }
+    static bool IsAdaptive(int which) { return strcmp(pruneschemes[which].name, "ADAPTIVE") == 0; }
     RadialPruneMgr(MolecularGrid::MolecularGridOptions const &opt);
     int GetPrunedNumAngPts(double rho);
 };
@@ -3476,6 +3483,7 @@ RadialPruneMgr::PruneSchemeTable RadialPruneMgr::pruneschemes[] = {{"FLAT", flat
                                                                    {"P_GAUSSIAN", p_gaussian},
                                                                    {"D_GAUSSIAN", d_gaussian},
                                                                    {"LOG_GAUSSIAN", log_gaussian},
+                                                                   {"ADAPTIVE", flat},  // See AdaptivePruneMgr
                                                                    {nullptr, nullptr}};
 
 int RadialPruneMgr::WhichPruneScheme(const char *schemename) {
@@ -3497,22 +3505,197 @@ int RadialPruneMgr::GetPrunedNumAngPts(double rho) {
     return LebedevGridMgr::findNPointsByOrder_roundUp(pruned_order);
 }
 
-void MolecularGrid::buildGridFromOptions(MolecularGridOptions const &opt) {
+/**
+ * Per-atom, per-radial-shell spherical orders for the ADAPTIVE pruning scheme.
+ *
+ * On the sphere of radius r about atom A, the density-like product c^2 exp(-2a r_B^2) r_B^2l
+ * of a primitive on atom B at distance d has Legendre components about A that fall off as
+ * exp(-2a (r - d)^2) exp(-L(L+1) / 2x), x = 4ard, on top of the 2l carried by the polynomial.
+ * Each radial shell gets the lowest Lebedev order that leaves every primitive significant on it
+ * (according to the basis extents) below the tolerance, never more than the nominal order.
+ */
+class AdaptivePruneMgr {
+   private:
+    // A shell that can reach some sphere about an atom: it is significant for lo <= r <= hi
+    struct NearShell {
+        double lo;
+        double hi;
+        double d;  // Distance from the atom to the shell center
+        int P;
+    };
+
+    std::shared_ptr<BasisSet> basis_;
+    // Per atom, the shells with a nonempty radial window, sorted by the start of the window
+    std::vector<std::vector<NearShell>> near_shells_;
+    int nominal_order_;
+    int nradpts_;
+    double tolerance_;
+
+   public:
+    AdaptivePruneMgr(std::shared_ptr<Molecule> molecule, std::shared_ptr<BasisExtents> extents,
+                     MolecularGrid::MolecularGridOptions const &opt);
+    int GetNumRadPts(int Z) const;
+    int GetNumAngPts(int A, double r, double *error) const;
+};
+
+AdaptivePruneMgr::AdaptivePruneMgr(std::shared_ptr<Molecule> molecule, std::shared_ptr<BasisExtents> extents,
+                                   MolecularGrid::MolecularGridOptions const &opt)
+    : basis_(extents->basis()) {
+    nominal_order_ = LebedevGridMgr::findOrderByNPoints(opt.nangpts);
+    nradpts_ = opt.nradpts;
+    tolerance_ = opt.pruning_tolerance;
+
+    // Shell P is significant on the sphere of radius r about A only if |r - d| <= extent
+    const double *radius = extents->shell_extents()->pointer();
+    near_shells_.resize(molecule->natom());
+    for (int A = 0; A < molecule->natom(); A++) {
+        Vector3 RA = molecule->xyz(A);
+        for (int P = 0; P < basis_->nshell(); P++) {
+            double d = RA.distance(molecule->xyz(basis_->shell(P).ncenter()));
+            near_shells_[A].push_back({std::max(0.0, d - radius[P]), d + radius[P], d, P});
+        }
+        std::sort(near_shells_[A].begin(), near_shells_[A].end(),
+                  [](const NearShell &a, const NearShell &b) { return a.lo < b.lo; });
+    }
+}
+int AdaptivePruneMgr::GetNumRadPts(int Z) const {
+    // Not error-controlled: H and He use a fixed ~80% of the radial points of the heavier rows (Treutler & Ahlrichs)
+    return (Z <= 2 ? (int)std::ceil(0.8 * nradpts_) : nradpts_);
+}
+int AdaptivePruneMgr::GetNumAngPts(int A, double r, double *error) const {
+    // (weight, x, 2l) of every primitive significant on this sphere
+    std::vector<std::tuple<double, double, int>> terms;
+    int order = 0;
+    for (const NearShell &near : near_shells_[A]) {
+        if (near.lo > r) break;
+        if (near.hi < r) continue;
+        const GaussianShell &shell = basis_->shell(near.P);
+        double d = near.d;
+
+        int l2 = 2 * shell.am();
+        order = std::max(order, l2);
+        for (int K = 0; K < shell.nprimitive(); K++) {
+            double a = shell.exp(K);
+            double w = shell.coef(K) * shell.coef(K) * std::exp(-2.0 * a * (r - d) * (r - d));
+            double x = 4.0 * a * r * d;
+            if (w <= tolerance_ || x == 0.0) continue;
+            terms.emplace_back(w, x, l2);
+
+            // smallest L with w exp(-L(L+1) / 2x) <= tolerance
+            double LL = 2.0 * x * std::log(w / tolerance_);
+            order = std::max(order, l2 + (int)std::ceil(0.5 * (std::sqrt(1.0 + 4.0 * LL) - 1.0)));
+        }
+    }
+    order = std::min(std::max(order, 3), nominal_order_);
+    int npoints = LebedevGridMgr::findNPointsByOrder_roundUp(order);
+
+    // What the chosen order leaves behind, relative to the nominal grid
+    *error = 0.0;
+    order = LebedevGridMgr::findOrderByNPoints(npoints);
+    if (order < nominal_order_) {
+        for (const auto &term : terms) {
+            double w = std::get<0>(term);
+            int L = order - std::get<2>(term);
+            *error += (L < 0 ? w : w * std::exp(-L * (L + 1.0) / (2.0 * std::get<1>(term))));
+        }
+    }
+    return npoints;
+}
+
+/**
+ * Process-wide memo of the unpartitioned atomic grids and of the spherical grids.
+ *
+ * Unless the pruning is ADAPTIVE, the radial nodes and spherical orders of an atom depend only on
+ * its element and the grid options, so a grid on any later geometry, fragment or job only has to
+ * orient these points and apply its nuclear weights. Only sphere() may be called from a parallel region.
+ */
+class AtomicGridCache {
+   public:
+    struct AtomicGrid {
+        std::shared_ptr<RadialGrid> radial;
+        std::vector<std::shared_ptr<SphericalGrid>> spheres;
+        std::vector<MassPoint> points;  // Centered on the nucleus, before orientation and nuclear weights
+    };
+
+    static const AtomicGrid &get(int Z, MolecularGrid::MolecularGridOptions const &opt);
+    static std::shared_ptr<SphericalGrid> sphere(int npoints);
+    static void clear() {
+        grids_.clear();
+        spheres_.clear();
+    }
+
+   private:
+    // Z, radial scheme, pruning scheme, radial points, spherical points, BS radius alpha, pruning alpha
+    typedef std::tuple<int, short, short, int, int, double, double> Key;
+    static std::map<Key, AtomicGrid> grids_;
+    static std::map<int, std::shared_ptr<SphericalGrid>> spheres_;
+};
+
+std::map<AtomicGridCache::Key, AtomicGridCache::AtomicGrid> AtomicGridCache::grids_;
+std::map<int, std::shared_ptr<SphericalGrid>> AtomicGridCache::spheres_;
+
+std::shared_ptr<SphericalGrid> AtomicGridCache::sphere(int npoints) {
+    std::shared_ptr<SphericalGrid> sphere;
+#pragma omp critical(AtomicGridCache_sphere)
+    {
+        std::shared_ptr<SphericalGrid> &cached = spheres_[npoints];
+        if (!cached) cached = SphericalGrid::build("Unknown", npoints, LebedevGridMgr::findGridByNPoints(npoints));
+        sphere = cached;
+    }
+    return sphere;
+}
+const AtomicGridCache::AtomicGrid &AtomicGridCache::get(int Z, MolecularGrid::MolecularGridOptions const &opt) {
+    Key key(Z, opt.radscheme, opt.prunescheme, opt.nradpts, opt.nangpts, opt.bs_radius_alpha, opt.pruning_alpha);
+    auto it = grids_.find(key);
+    if (it != grids_.end()) return it->second;
+
+    AtomicGrid &atom = grids_[key];
+    RadialPruneMgr prune(opt);
+    std::vector<double> r(opt.nradpts), wr(opt.nradpts);
+    double alpha = GetBSRadius(Z) * opt.bs_radius_alpha;
+    RadialGridMgr::makeRadialGrid(opt.nradpts, RadialGridMgr::MuraKnowlesHack(opt.radscheme, Z), r.data(), wr.data(),
+                                  alpha);
+    atom.radial = RadialGrid::build("Unknown", opt.nradpts, r.data(), wr.data(), alpha);
+
+    for (int i = 0; i < opt.nradpts; i++) {
+        int numAngPts = prune.GetPrunedNumAngPts(r[i] / alpha);
+        const MassPoint *anggrid = LebedevGridMgr::findGridByNPoints(numAngPts);
+        atom.spheres.push_back(sphere(numAngPts));
+        for (int j = 0; j < numAngPts; j++) {
+            MassPoint mp = {r[i] * anggrid[j].x, r[i] * anggrid[j].y, r[i] * anggrid[j].z, wr[i] * anggrid[j].w};
+            atom.points.push_back(mp);
+        }
+    }
+    return atom;
+}
+
+void MolecularGrid::buildGridFromOptions(MolecularGridOptions const &opt, std::shared_ptr<BasisExtents> extents) {
     options_ = opt;                                                // Save a copy
     std::vector<std::vector<MassPoint>> grid(molecule_->natom());  // This is just for the first pass.
 
     OrientationMgr std_orientation(molecule_);
-    RadialPruneMgr prune(opt);
     NuclearWeightMgr nuc(molecule_, opt.nucscheme);
 
+    std::unique_ptr<AdaptivePruneMgr> adaptive;
+    if (RadialPruneMgr::IsAdaptive(opt.prunescheme)) {
+        if (!extents) throw PSIEXCEPTION("MolecularGrid: ADAPTIVE pruning requires the basis extents.");
+        adaptive = std::unique_ptr<AdaptivePruneMgr>(new AdaptivePruneMgr(molecule_, extents, opt));
+    }
+    std::vector<double> atom_errors(molecule_->natom(), 0.0);
+
     // RMP: Like, I want to keep this info, yo?
     orientation_ = std_orientation.orientation();
     radial_grids_.clear();
     spherical_grids_.clear();
 
+    // Memoized atomic grids and spheres, looked up before the parallel loop
+    std::vector<const AtomicGridCache::AtomicGrid *> atomic_grids(molecule_->natom(), nullptr);
     if (opt.namedGrid == -1) {
         radial_grids_.resize(molecule_->natom());
         spherical_grids_.resize(molecule_->natom());
+        for (int A = 0; A < molecule_->natom() && !adaptive; A++) {
+            atomic_grids[A] = &AtomicGridCache::get(molecule_->true_atomic_number(A), opt);
+        }
     }
 
 // Iterate over atoms
@@ -3521,23 +3704,37 @@ void MolecularGrid::buildGridFromOptions(MolecularGridOptions const &opt) {
         int Z = molecule_->true_atomic_number(A);
         double stratmannCutoff = nuc.GetStratmannCutoff(A);
 
-        if (opt.namedGrid == -1) {  // Not using a named grid
-            std::vector<double> r(opt.nradpts), wr(opt.nradpts);
+        if (atomic_grids[A]) {  // Element grid from the cache, only orientation and partitioning are per molecule
+            radial_grids_[A] = atomic_grids[A]->radial;
+            spherical_grids_[A] = atomic_grids[A]->spheres;
+            grid[A].reserve(atomic_grids[A]->points.size());
+            for (MassPoint mp : atomic_grids[A]->points) {
+                mp = std_orientation.MoveIntoPosition(mp, A);
+                mp.w *= nuc.computeNuclearWeight(mp, A, stratmannCutoff);
+                grid[A].push_back(mp);
+                assert(!std::isnan(mp.w));
+            }
+        } else if (opt.namedGrid == -1) {  // ADAPTIVE pruning, orders depend on the neighbours
+            int nradpts = adaptive->GetNumRadPts(Z);
+            std::vector<double> r(nradpts), wr(nradpts);
             double alpha = GetBSRadius(Z) * opt.bs_radius_alpha;
-            RadialGridMgr::makeRadialGrid(opt.nradpts, RadialGridMgr::MuraKnowlesHack(opt.radscheme, Z), r.data(),
+            RadialGridMgr::makeRadialGrid(nradpts, RadialGridMgr::MuraKnowlesHack(opt.radscheme, Z), r.data(),
                                           wr.data(), alpha);
 
             // RMP: Want this stuff too
-            radial_grids_[A] = RadialGrid::build("Unknown", opt.nradpts, r.data(), wr.data(), alpha);
+            radial_grids_[A] = RadialGrid::build("Unknown", nradpts, r.data(), wr.data(), alpha);
             std::vector<std::shared_ptr<SphericalGrid>> spheres;
             spherical_grids_[A] = spheres;
 
-            for (int i = 0; i < opt.nradpts; i++) {
-                int numAngPts = prune.GetPrunedNumAngPts(r[i] / alpha);
+            for (int i = 0; i < nradpts; i++) {
+                double error;
+                int numAngPts = adaptive->GetNumAngPts(A, r[i], &error);
+                // Lebedev weights integrate to 4 pi
+                atom_errors[A] += 4.0 * M_PI * wr[i] * error;
                 const MassPoint *anggrid = LebedevGridMgr::findGridByNPoints(numAngPts);
 
                 // RMP: And this stuff! This whole thing is completely and utterly FUBAR.
-                spherical_grids_[A].push_back(SphericalGrid::build("Unknown", numAngPts, anggrid));
+                spherical_grids_[A].push_back(AtomicGridCache::sphere(numAngPts));
                 for (int j = 0; j < numAngPts; j++) {
                     MassPoint mp = {r[i] * anggrid[j].x, r[i] * anggrid[j].y, r[i] * anggrid[j].z,
                                     wr[i] * anggrid[j].w};
@@ -3565,6 +3762,9 @@ void MolecularGrid::buildGridFromOptions(MolecularGridOptions const &opt) {
         }
     }
 
+    pruning_error_ = 0.0;
+    for (double err : atom_errors) pruning_error_ += err;
+
     npoints_ = 0;
     for (int i = 0; i < grid.size(); ++i) {
         npoints_ += grid[i].size();
@@ -3633,7 +3833,7 @@ void MolecularGrid::buildGridFromOptions(MolecularGridOptions const &opt, const
             const MassPoint *anggrid = LebedevGridMgr::findGridByNPoints(numAngPts);
 
             // RMP: And this stuff! This whole thing is completely and utterly FUBAR.
-            spherical_grids_[A].push_back(SphericalGrid::build("Unknown", numAngPts, anggrid));
+            spherical_grids_[A].push_back(AtomicGridCache::sphere(numAngPts));
 
             for (int j = 0; j < numAngPts; j++) {
                 MassPoint mp = {r[i] * anggrid[j].x, r[i] * anggrid[j].y, r[i] * anggrid[j].z, wr[i] * anggrid[j].w};
@@ -3966,6 +4166,7 @@ void DFTGrid::buildGridFromOptions(std::map<std::string, int> int_opts_map,
     MolecularGridOptions opt;
     opt.bs_radius_alpha = options_.get_double("DFT_BS_RADIUS_ALPHA");
     opt.pruning_alpha = options_.get_double("DFT_PRUNING_ALPHA");
+    opt.pruning_tolerance = options_.get_double("DFT_PRUNING_TOLERANCE");
     opt.radscheme = RadialGridMgr::WhichScheme(full_str_options["DFT_RADIAL_SCHEME"].c_str());
     opt.prunescheme = RadialPruneMgr::WhichPruneScheme(full_str_options["DFT_PRUNING_SCHEME"].c_str());
     opt.nucscheme = NuclearWeightMgr::WhichScheme(full_str_options["DFT_NUCLEAR_SCHEME"].c_str());
@@ -3978,17 +4179,145 @@ void DFTGrid::buildGridFromOptions(std::map<std::string, int> int_opts_map,
         throw PSIEXCEPTION("Invalid number of spherical points (not a Lebedev number)");
     }
 
-    MolecularGrid::buildGridFromOptions(opt);
+    double epsilon = options_.get_double("DFT_BASIS_TOLERANCE");
+    auto extents = std::make_shared<BasisExtents>(primary_, epsilon);
 
     // Blocking/sieving info
     int max_points = full_int_options["DFT_BLOCK_MAX_POINTS"];
     int min_points = full_int_options["DFT_BLOCK_MIN_POINTS"];
     double max_radius = options_.get_double("DFT_BLOCK_MAX_RADIUS");
-    double epsilon = options_.get_double("DFT_BASIS_TOLERANCE");
-    auto extents = std::make_shared<BasisExtents>(primary_, epsilon);
+
+    // Same grid, basis and geometry as an earlier grid in this process: skip partitioning and blocking
+    size_t cache_size = options_.get_int("DFT_GRID_CACHE_SIZE");
+    std::vector<double> key;
+    if (cache_size) {
+        int block_scheme = (options_.get_str("DFT_BLOCK_SCHEME") == "OCTREE");
+        key = cache_key(opt, epsilon, max_points, min_points, max_radius, block_scheme);
+        if (load_cached_grid(key, opt, extents)) return;
+    }
+
+    MolecularGrid::buildGridFromOptions(opt, extents);
     postProcess(extents, max_points, min_points, max_radius);
+
+    if (cache_size) store_cached_grid(key, cache_size);
+}
+
+/// A finished (sieved and blocked) DFTGrid, as kept in the process-wide cache
+struct CachedDFTGrid {
+    std::vector<double> key;
+    double pruning_error;
+    int max_points;
+    int max_functions;
+    size_t collocation_size;
+    std::vector<double> x, y, z, w;
+    std::vector<int> index;
+    std::vector<std::tuple<size_t, size_t, size_t>> blocks;  // (block index, first point, number of points)
+    std::shared_ptr<Matrix> orientation;
+    std::vector<std::shared_ptr<RadialGrid>> radial_grids;
+    std::vector<std::vector<std::shared_ptr<SphericalGrid>>> spherical_grids;
+};
+// Most recently stored first
+static std::list<std::shared_ptr<CachedDFTGrid>> cached_dft_grids;
+// Grids served from cached_dft_grids since the last clear_cache()
+static size_t cached_dft_grid_hits = 0;
+
+std::vector<double> DFTGrid::cache_key(MolecularGridOptions const &opt, double epsilon, int max_points,
+                                       int min_points, double max_radius, int block_scheme) const {
+    std::vector<double> key = {opt.bs_radius_alpha, opt.pruning_alpha, opt.pruning_tolerance};
+    key.insert(key.end(), {(double)opt.radscheme, (double)opt.prunescheme, (double)opt.nucscheme,
+                           (double)opt.namedGrid, (double)opt.nradpts, (double)opt.nangpts});
+    key.insert(key.end(), {epsilon, (double)max_points, (double)min_points, max_radius, (double)block_scheme});
+
+    key.push_back(molecule_->natom());
+    for (int A = 0; A < molecule_->natom(); A++) {
+        Vector3 R = molecule_->xyz(A);
+        key.insert(key.end(), {molecule_->Z(A), (double)molecule_->true_atomic_number(A), R[0], R[1], R[2]});
+    }
+
+    key.push_back(primary_->nshell());
+    for (int P = 0; P < primary_->nshell(); P++) {
+        const GaussianShell &shell = primary_->shell(P);
+        Vector3 R = shell.center();
+        key.insert(key.end(), {R[0], R[1], R[2], (double)shell.am(), (double)shell.is_pure(),
+                               (double)shell.nprimitive()});
+        for (int K = 0; K < shell.nprimitive(); K++) key.insert(key.end(), {shell.exp(K), shell.coef(K)});
+    }
+    return key;
+}
+
+bool DFTGrid::load_cached_grid(const std::vector<double> &key, MolecularGridOptions const &opt,
+                               std::shared_ptr<BasisExtents> extents) {
+    auto it = std::find_if(cached_dft_grids.begin(), cached_dft_grids.end(),
+                           [&key](const std::shared_ptr<CachedDFTGrid> &grid) { return grid->key == key; });
+    if (it == cached_dft_grids.end()) return false;
+    std::shared_ptr<CachedDFTGrid> cached = *it;
+    cached_dft_grids.erase(it);
+    cached_dft_grids.push_front(cached);
+    cached_dft_grid_hits++;
+
+    MolecularGrid::options_ = opt;
+    pruning_error_ = cached->pruning_error;
+    orientation_ = cached->orientation;
+    radial_grids_ = cached->radial_grids;
+    spherical_grids_ = cached->spherical_grids;
+    extents_ = extents;
+    MolecularGrid::primary_ = extents->basis();
+
+    npoints_ = cached->x.size();
+    x_ = new double[npoints_];
+    y_ = new double[npoints_];
+    z_ = new double[npoints_];
+    w_ = new double[npoints_];
+    index_ = new int[npoints_];
+    std::copy(cached->x.begin(), cached->x.end(), x_);
+    std::copy(cached->y.begin(), cached->y.end(), y_);
+    std::copy(cached->z.begin(), cached->z.end(), z_);
+    std::copy(cached->w.begin(), cached->w.end(), w_);
+    std::copy(cached->index.begin(), cached->index.end(), index_);
+
+    // The blocks point into this grid's arrays and the caller's extents
+    for (const auto &block : cached->blocks) {
+        size_t Q = std::get<1>(block);
+        blocks_.push_back(std::make_shared<BlockOPoints>(std::get<0>(block), std::get<2>(block), &x_[Q], &y_[Q],
+                                                         &z_[Q], &w_[Q], extents_));
+    }
+    max_points_ = cached->max_points;
+    max_functions_ = cached->max_functions;
+    collocation_size_ = cached->collocation_size;
+    return true;
+}
+
+void DFTGrid::store_cached_grid(const std::vector<double> &key, size_t max_grids) const {
+    auto cached = std::make_shared<CachedDFTGrid>();
+    cached->key = key;
+    cached->pruning_error = pruning_error_;
+    cached->max_points = max_points_;
+    cached->max_functions = max_functions_;
+    cached->collocation_size = collocation_size_;
+    cached->x.assign(x_, x_ + npoints_);
+    cached->y.assign(y_, y_ + npoints_);
+    cached->z.assign(z_, z_ + npoints_);
+    cached->w.assign(w_, w_ + npoints_);
+    cached->index.assign(index_, index_ + npoints_);
+    for (const auto &block : blocks_) {
+        cached->blocks.emplace_back(block->index(), block->x() - x_, block->npoints());
+    }
+    cached->orientation = orientation_;
+    cached->radial_grids = radial_grids_;
+    cached->spherical_grids = spherical_grids_;
+
+    cached_dft_grids.push_front(cached);
+    while (cached_dft_grids.size() > max_grids) cached_dft_grids.pop_back();
+}
+
+void DFTGrid::clear_cache() {
+    cached_dft_grids.clear();
+    cached_dft_grid_hits = 0;
+    AtomicGridCache::clear();
 }
 
+size_t DFTGrid::cache_hits() { return cached_dft_grid_hits; }
+
 PseudospectralGrid::PseudospectralGrid(std::shared_ptr<Molecule> molecule, std::shared_ptr<BasisSet> primary,
                                        Options &options)
     : MolecularGrid(molecule), primary_(primary), filename_(""), options_(options) {
@@ -4000,6 +4329,7 @@ void PseudospectralGrid::buildGridFromOptions() {
     MolecularGridOptions opt;
     opt.bs_radius_alpha = options_.get_double("PS_BS_RADIUS_ALPHA");
     opt.pruning_alpha = options_.get_double("PS_PRUNING_ALPHA");
+    opt.pruning_tolerance = 0.0;
     opt.radscheme = RadialGridMgr::WhichScheme(options_.get_str("PS_RADIAL_SCHEME").c_str());
     opt.prunescheme = RadialPruneMgr::WhichPruneScheme(options_.get_str("PS_PRUNING_SCHEME").c_str());
     opt.nucscheme = NuclearWeightMgr::WhichScheme(options_.get_str("PS_NUCLEAR_SCHEME").c_str());
@@ -4131,6 +4461,10 @@ void MolecularGrid::print(std::string out, int /*print*/) const {
     printer->Printf("\n");
     printer->Printf("    BS radius alpha        = %14g\n", options_.bs_radius_alpha);
     printer->Printf("    Pruning alpha          = %14g\n", options_.pruning_alpha);
+    if (RadialPruneMgr::IsAdaptive(options_.prunescheme)) {
+        printer->Printf("    Pruning tolerance      = %14.3E\n", options_.pruning_tolerance);
+        printer->Printf("    Est. pruning error     = %14.3E\n", pruning_error_);
+    }
     printer->Printf("    Radial Points          = %14d\n", options_.nradpts);
     printer->Printf("    Spherical Points       = %14d\n", options_.nangpts);
     printer->Printf("    Total Points           = %14d\n", npoints_);
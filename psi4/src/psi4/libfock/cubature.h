@@ -114,7 +114,8 @@ class MolecularGrid {
     struct MolecularGridOptions {
         double bs_radius_alpha;
         double pruning_alpha;
-        short radscheme;  // Effectively an enumeration
+        double pruning_tolerance;  // Target angular error per radial shell, ADAPTIVE pruning only
+        short radscheme;           // Effectively an enumeration
         short prunescheme;
         short nucscheme;
         short namedGrid;  // -1 = None, 0 = SG-0, 1 = SG-1
@@ -125,13 +126,15 @@ class MolecularGrid {
    protected:
     /// A copy of the options used, for printing purposes.
     MolecularGridOptions options_;
+    /// Estimated integration error introduced by ADAPTIVE pruning
+    double pruning_error_ = 0.0;
 
    public:
     MolecularGrid(std::shared_ptr<Molecule> molecule);
     virtual ~MolecularGrid();
 
-    /// Build the grid
-    void buildGridFromOptions(MolecularGridOptions const& opt);
+    /// Build the grid, ADAPTIVE pruning selects the spherical orders from the basis extents
+    void buildGridFromOptions(MolecularGridOptions const& opt, std::shared_ptr<BasisExtents> extents = nullptr);
     /// Build the grid
     void buildGridFromOptions(MolecularGridOptions const& opt,
                               const std::vector<std::vector<double> >& rs,  // Radial nodes,     per atom
@@ -173,6 +176,8 @@ class MolecularGrid {
 
     /// Pointer to basis extents
     std::shared_ptr<BasisExtents> extents() const { return extents_; }
+    /// Estimated integration error of the ADAPTIVE pruning (zero for the fixed schemes)
+    double pruning_error() const { return pruning_error_; }
     /// Set of spatially sieved blocks of points, generated by sieve() internally
     const std::vector<std::shared_ptr<BlockOPoints> >& blocks() const { return blocks_; }
 
@@ -207,11 +212,25 @@ class DFTGrid : public MolecularGrid {
     /// The Options object
     Options& options_;
 
+    /// Everything a finished grid depends on: grid and blocking options, basis and geometry
+    std::vector<double> cache_key(MolecularGridOptions const& opt, double epsilon, int max_points, int min_points,
+                                  double max_radius, int block_scheme) const;
+    /// Restore the finished grid for key from the process-wide cache, false if it is not there
+    bool load_cached_grid(const std::vector<double>& key, MolecularGridOptions const& opt,
+                          std::shared_ptr<BasisExtents> extents);
+    /// Place this finished grid in the process-wide cache, evicting the oldest beyond max_grids
+    void store_cached_grid(const std::vector<double>& key, size_t max_grids) const;
+
    public:
     DFTGrid(std::shared_ptr<Molecule> molecule, std::shared_ptr<BasisSet> primary, Options& options);
     DFTGrid(std::shared_ptr<Molecule> molecule, std::shared_ptr<BasisSet> primary,
             std::map<std::string, int> int_opts_map, std::map<std::string, std::string> opts_map, Options& options);
     ~DFTGrid() override;
+
+    /// Drop the memoized atomic grids and finished molecular grids
+    static void clear_cache();
+    /// Number of grids served whole from the finished-grid cache since the last clear_cache()
+    static size_t cache_hits();
 };
 
 class RadialGrid {
@@ -410,6 +429,12 @@ class BlockOPoints {
     const std::vector<int>& shells_local_to_global() const { return shells_local_to_global_; }
     /// Relevant functions, local -> global
     const std::vector<int>& functions_local_to_global() const { return functions_local_to_global_; }
+    /// Center of the bounding sphere
+    const Vector3& xc() const { return xc_; }
+    /// Radius of the bounding sphere
+    double R() const { return R_; }
+    /// Basis extents the significant shells were determined from
+    std::shared_ptr<BasisExtents> extents() const { return extents_; }
 };
 
 class BasisExtents {
@@ -103,6 +103,8 @@ std::shared_ptr<JK> JK::build_JK(std::shared_ptr<BasisSet> primary, std::shared_
     } else if (jk_type == "MEM_DF") {
         MemDFJK* jk = new MemDFJK(primary, auxiliary);
         _set_dfjk_options<MemDFJK>(jk, options);
+        jk->set_local_K(options.get_bool("DF_LOCAL_K"));
+        jk->set_local_K_cutoff(options.get_double("DF_LOCAL_K_TOLERANCE"));
 
         return std::shared_ptr<JK>(jk);
 
@@ -137,6 +139,18 @@ std::shared_ptr<JK> JK::build_JK(std::shared_ptr<BasisSet> primary, std::shared_
 
         return std::shared_ptr<JK>(jk);
 
+    } else if (jk_type == "COSX") {
+        COSK* jk = new COSK(primary, options);
+
+        if (options["INTS_TOLERANCE"].has_changed()) jk->set_cutoff(options.get_double("INTS_TOLERANCE"));
+        if (options["PRINT"].has_changed()) jk->set_print(options.get_int("PRINT"));
+        if (options["DEBUG"].has_changed()) jk->set_debug(options.get_int("DEBUG"));
+        if (options["BENCH"].has_changed()) jk->set_bench(options.get_int("BENCH"));
+        if (options["DF_INTS_NUM_THREADS"].has_changed())
+            jk->set_df_ints_num_threads(options.get_int("DF_INTS_NUM_THREADS"));
+
+        return std::shared_ptr<JK>(jk);
+
     } else {
         std::stringstream message;
         message << "JK::build_JK: Unkown SCF Type '" << jk_type << "'" << std::endl;
@@ -151,20 +165,16 @@ std::shared_ptr<JK> JK::build_JK(std::shared_ptr<BasisSet> primary, std::shared_
 std::shared_ptr<JK> JK::build_JK(std::shared_ptr<BasisSet> primary, std::shared_ptr<BasisSet> auxiliary,
                                  Options& options, bool do_wK, size_t doubles) {
     std::string jk_type = options.get_str("SCF_TYPE");
-    if (do_wK && jk_type == "MEM_DF") {  // throw instead of auto fallback?
-        std::stringstream error;
-        error << "Cannot do SCF_TYPE == 'MEM_DF' and do_wK (yet), please set SCF_TYPE = 'DISK_DF' ";
-        throw PSIEXCEPTION(error.str().c_str());
-    }
 
     if (jk_type == "DF") {
         // logic for MemDFJK vs DiskDFJK
-        if (do_wK || options["DF_INTS_IO"].has_changed()) {
+        if (options["DF_INTS_IO"].has_changed()) {
             return build_JK(primary, auxiliary, options, "DISK_DF");
 
         } else {
-            // Build exact estimate via Schwarz metrics
+            // Build exact estimate via Schwarz metrics, wK needs the (Q|w|mn) AOs in core as well
             auto jk = build_JK(primary, auxiliary, options, "MEM_DF");
+            jk->set_do_wK(do_wK);
             if (jk->memory_estimate() < doubles) {
                 return jk;
             }
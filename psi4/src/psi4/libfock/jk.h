@@ -47,6 +47,7 @@ class TwoBodyAOInt;
 class Options;
 class PSIO;
 class DFHelper;
+class DFTGrid;
 
 namespace pk {
 class PKManager;
@@ -679,7 +680,12 @@ class PSI_API DirectJK : public JK {
     /// Delete integrals, files, etc
     void postiterations() override;
 
-    /// Build the J and K matrices for this integral class
+    /**
+     * Build the J and K matrices for this integral class. Every shell quartet is
+     * computed once and contracted against all of the densities, which are packed
+     * shell-pair-major with the density index fastest. J/K accumulate in
+     * thread-local copies when memory_ allows, and are reduced once at the end.
+     */
     void build_JK(std::vector<std::shared_ptr<TwoBodyAOInt> >& ints, std::vector<std::shared_ptr<Matrix> >& D,
                   std::vector<std::shared_ptr<Matrix> >& J, std::vector<std::shared_ptr<Matrix> >& K);
 
@@ -717,6 +723,67 @@ class PSI_API DirectJK : public JK {
     void print_header() const override;
 };
 
+/**
+ * Class COSK
+ *
+ * JK implementation with integral-direct J and seminumerical
+ * (chain-of-spheres) K:
+ *
+ *  K_mn = sum_g w_g phi_m(g) sum_s A_ns(g) sum_l phi_l(g) D_ls
+ *
+ * where A_ns(g) = (n|1/|r-g||s) are the analytic potential
+ * integrals of a unit charge on grid point g. The grid is a
+ * DFTGrid, and both the basis function extents of each block
+ * and the magnitude of (phi D) on it screen the potential
+ * integrals, so the cost of K grows nearly linearly with
+ * system size.
+ *
+ * Range-separated exchange is not available.
+ */
+class PSI_API COSK : public DirectJK {
+   protected:
+    /// Options object, for the grid specification
+    Options& options_;
+    /// Screening threshold on the density-contracted basis functions (phi D)
+    double density_cutoff_;
+    /// Exchange integration grid
+    std::shared_ptr<DFTGrid> grid_;
+
+    std::string name() override { return "COSK"; }
+    size_t memory_estimate() override;
+
+    // => Required Algorithm-Specific Methods <= //
+
+    /// Setup the sieve and the exchange grid
+    void preiterations() override;
+    /// Compute J/K for current C/D
+    void compute_JK() override;
+    /// Delete the sieve and the grid
+    void postiterations() override;
+
+    /// Build the seminumerical exchange matrices for the densities in D
+    void build_cosK(std::vector<std::shared_ptr<Matrix> >& D, std::vector<std::shared_ptr<Matrix> >& K);
+
+   public:
+    // => Constructors < = //
+
+    /**
+     * @param primary primary basis set for this system.
+     * @param options options object, for the COSX_* grid settings
+     */
+    COSK(std::shared_ptr<BasisSet> primary, Options& options);
+    /// Destructor
+    ~COSK() override;
+
+    // => Accessors <= //
+
+    /**
+    * Print header information regarding JK
+    * type on output file
+    */
+    void print_header() const override;
+};
+
 /** \brief Derived class extending the JK object to GTFock
  *
  *   Unfortunately GTFock needs to know the number of density
@@ -996,6 +1063,10 @@ class PSI_API MemDFJK : public JK {
     int df_ints_num_threads_;
     /// Condition cutoff in fitting metric, defaults to 1.0E-12
     double condition_ = 1.0E-12;
+    /// Build K from localized occupied orbitals? defaults to false
+    bool local_K_ = false;
+    /// Coefficient cutoff for localized orbital domains, defaults to 1.0E-5
+    double local_K_cutoff_ = 1.0E-5;
 
     // => Required Algorithm-Specific Methods <= //
 
@@ -1042,6 +1113,20 @@ class PSI_API MemDFJK : public JK {
      */
     void set_df_ints_num_threads(int val) { df_ints_num_threads_ = val; }
 
+    /**
+     * Build symmetric K from Cholesky-localized occupied orbitals,
+     * each contracted only over its own AO domain
+     * @param local_K use the local K build, defaults to false
+     */
+    void set_local_K(bool local_K) { local_K_ = local_K; }
+
+    /**
+     * Coefficient magnitude below which a localized orbital is
+     * dropped from an AO function in the local K build
+     * @param cutoff defaults to 1.0E-5
+     */
+    void set_local_K_cutoff(double cutoff) { local_K_cutoff_ = cutoff; }
+
     // => Accessors <= //
 
     /**
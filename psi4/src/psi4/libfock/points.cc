@@ -38,10 +38,45 @@
 
 #include "gau2grid/gau2grid.h"
 
+#include <algorithm>
 #include <cmath>
 
 namespace psi {
 
+namespace {
+/**
+ * Copies out the primitives of a shell that are significant somewhere beyond rmin.
+ *
+ * As in BasisExtents, a primitive is modeled by the radial envelope |c| r^L exp(-a r^2). Each Cartesian
+ * derivative of x^l y^m z^n exp(-a r^2) is bounded by that envelope times (L/r + 2ar + sqrt(2a)), so all
+ * derivatives up to deriv are bounded by E(r) = |c| r^L (L/r + 2ar + sqrt(2a))^deriv exp(-a r^2). Expanded,
+ * E is a sum of r^p exp(-a r^2) terms with p <= L + deriv, each decreasing beyond sqrt(p / 2a), so E(rmin)
+ * bounds the whole region r >= rmin once rmin^2 >= (L + deriv) / 2a. This tail is where the screening acts:
+ * a tight primitive far from the block. Closer in, the values alone are bounded by the envelope maximum,
+ * and primitives are always kept when derivatives are needed. A zero cutoff (DFT_BASIS_TOLERANCE 0.0)
+ * keeps every primitive.
+ * @return the number of primitives kept
+ */
+int screen_primitives(int L, int nprim, const double* alpha, const double* norm, double rmin, double cutoff,
+                      int deriv, double* alpha_kept, double* norm_kept) {
+    int nkept = 0;
+    for (int K = 0; K < nprim; K++) {
+        double r2_decay = (L + deriv) / (2.0 * alpha[K]);
+        if (deriv == 0 || rmin * rmin >= r2_decay) {
+            double r2 = std::max(rmin * rmin, r2_decay);
+            double r = std::sqrt(r2);
+            double bound = std::fabs(norm[K]) * std::pow(r, L) * std::exp(-alpha[K] * r2);
+            if (deriv) bound *= std::pow(L / r + 2.0 * alpha[K] * r + std::sqrt(2.0 * alpha[K]), deriv);
+            if (bound < cutoff) continue;
+        }
+        alpha_kept[nkept] = alpha[K];
+        norm_kept[nkept] = norm[K];
+        nkept++;
+    }
+    return nkept;
+}
+}  // namespace
+
 RKSFunctions::RKSFunctions(std::shared_ptr<BasisSet> primary, int max_points, int max_functions)
     : PointFunctions(primary, max_points, max_functions) {
     set_ansatz(0);
@@ -84,6 +119,7 @@ void RKSFunctions::allocate() {
         point_values_["RHO_ZZ"] = std::make_shared<Vector>("RHO_ZZ", max_points_);
         point_values_["TAU_A"] = std::make_shared<Vector>("TAU_A", max_points_);
     }
+    point_buffer_ = XCBuffer::from_map(point_values_);
     build_temps();
 }
 void RKSFunctions::set_pointers(SharedMatrix D_AO) { D_AO_ = D_AO; }
@@ -128,7 +164,7 @@ void RKSFunctions::compute_points(std::shared_ptr<BlockOPoints> block, bool forc
 
     // => Build LSDA quantities <= //
     double** phip = basis_value("PHI")->pointer();
-    double* rhoap = point_value("RHO_A")->pointer();
+    double* rhoap = point_buffer_[XCValue::RHO_A];
     size_t coll_funcs = basis_value("PHI")->ncol();
 
     // Rho_a = 2.0 * D_xy phi_xa phi_ya
@@ -143,10 +179,10 @@ void RKSFunctions::compute_points(std::shared_ptr<BlockOPoints> block, bool forc
         double** phixp = basis_value("PHI_X")->pointer();
         double** phiyp = basis_value("PHI_Y")->pointer();
         double** phizp = basis_value("PHI_Z")->pointer();
-        double* rhoaxp = point_value("RHO_AX")->pointer();
-        double* rhoayp = point_value("RHO_AY")->pointer();
-        double* rhoazp = point_value("RHO_AZ")->pointer();
-        double* gammaaap = point_value("GAMMA_AA")->pointer();
+        double* rhoaxp = point_buffer_[XCValue::RHO_AX];
+        double* rhoayp = point_buffer_[XCValue::RHO_AY];
+        double* rhoazp = point_buffer_[XCValue::RHO_AZ];
+        double* gammaaap = point_buffer_[XCValue::GAMMA_AA];
 
         for (int P = 0; P < npoints; P++) {
             // 2.0 for Px D P + P D Px
@@ -165,7 +201,7 @@ void RKSFunctions::compute_points(std::shared_ptr<BlockOPoints> block, bool forc
         double** phixp = basis_value("PHI_X")->pointer();
         double** phiyp = basis_value("PHI_Y")->pointer();
         double** phizp = basis_value("PHI_Z")->pointer();
-        double* taup = point_value("TAU_A")->pointer();
+        double* taup = point_buffer_[XCValue::TAU_A];
 
         std::fill(taup, taup + npoints, 0.0);
 
@@ -350,6 +386,7 @@ void UKSFunctions::allocate() {
         point_values_["TAU_A"] = std::make_shared<Vector>("TAU_A", max_points_);
         point_values_["TAU_B"] = std::make_shared<Vector>("TAU_A", max_points_);
     }
+    point_buffer_ = XCBuffer::from_map(point_values_);
     build_temps();
 }
 void UKSFunctions::set_pointers(SharedMatrix /*Da_AO*/) {
@@ -403,8 +440,8 @@ void UKSFunctions::compute_points(std::shared_ptr<BlockOPoints> block, bool forc
 
     // => Build LSDA quantities <= //
     double** phip = basis_value("PHI")->pointer();
-    double* rhoap = point_value("RHO_A")->pointer();
-    double* rhobp = point_value("RHO_B")->pointer();
+    double* rhoap = point_buffer_[XCValue::RHO_A];
+    double* rhobp = point_buffer_[XCValue::RHO_B];
     size_t coll_funcs = basis_value("PHI")->ncol();
 
     C_DGEMM('N', 'N', npoints, nlocal, nlocal, 1.0, phip[0], coll_funcs, Da2p[0], nglobal, 0.0, Tap[0], nglobal);
@@ -422,15 +459,15 @@ void UKSFunctions::compute_points(std::shared_ptr<BlockOPoints> block, bool forc
         double** phixp = basis_value("PHI_X")->pointer();
         double** phiyp = basis_value("PHI_Y")->pointer();
         double** phizp = basis_value("PHI_Z")->pointer();
-        double* rhoaxp = point_value("RHO_AX")->pointer();
-        double* rhoayp = point_value("RHO_AY")->pointer();
-        double* rhoazp = point_value("RHO_AZ")->pointer();
-        double* rhobxp = point_value("RHO_BX")->pointer();
-        double* rhobyp = point_value("RHO_BY")->pointer();
-        double* rhobzp = point_value("RHO_BZ")->pointer();
-        double* gammaaap = point_value("GAMMA_AA")->pointer();
-        double* gammaabp = point_value("GAMMA_AB")->pointer();
-        double* gammabbp = point_value("GAMMA_BB")->pointer();
+        double* rhoaxp = point_buffer_[XCValue::RHO_AX];
+        double* rhoayp = point_buffer_[XCValue::RHO_AY];
+        double* rhoazp = point_buffer_[XCValue::RHO_AZ];
+        double* rhobxp = point_buffer_[XCValue::RHO_BX];
+        double* rhobyp = point_buffer_[XCValue::RHO_BY];
+        double* rhobzp = point_buffer_[XCValue::RHO_BZ];
+        double* gammaaap = point_buffer_[XCValue::GAMMA_AA];
+        double* gammaabp = point_buffer_[XCValue::GAMMA_AB];
+        double* gammabbp = point_buffer_[XCValue::GAMMA_BB];
 
         for (int P = 0; P < npoints; P++) {
             // 2.0 for Px D P + P D Px
@@ -457,8 +494,8 @@ void UKSFunctions::compute_points(std::shared_ptr<BlockOPoints> block, bool forc
         double** phixp = basis_value("PHI_X")->pointer();
         double** phiyp = basis_value("PHI_Y")->pointer();
         double** phizp = basis_value("PHI_Z")->pointer();
-        double* tauap = point_value("TAU_A")->pointer();
-        double* taubp = point_value("TAU_B")->pointer();
+        double* tauap = point_buffer_[XCValue::TAU_A];
+        double* taubp = point_buffer_[XCValue::TAU_B];
 
         std::fill(tauap, tauap + npoints, 0.0);
         std::fill(taubp, taubp + npoints, 0.0);
@@ -635,7 +672,15 @@ void BasisFunctions::allocate() {
         basis_temps_["PHI_ZZ"] = std::make_shared<Matrix>("PHI_ZZ", max_points_, max_functions_);
     }
 
-    if (deriv_ >= 3) throw PSIEXCEPTION("BasisFunctions: Only up to Hessians are currently supported");
+    if (deriv_ >= 3) {
+        for (const std::string& key : {"PHI_XXX", "PHI_XXY", "PHI_XXZ", "PHI_XYY", "PHI_XYZ", "PHI_XZZ", "PHI_YYY",
+                                       "PHI_YYZ", "PHI_YZZ", "PHI_ZZZ"}) {
+            basis_values_[key] = std::make_shared<Matrix>(key, max_points_, max_functions_);
+            basis_temps_[key] = std::make_shared<Matrix>(key, max_points_, max_functions_);
+        }
+    }
+
+    if (deriv_ >= 4) throw PSIEXCEPTION("BasisFunctions: Only up to third derivatives are currently supported");
 }
 void BasisFunctions::compute_functions(std::shared_ptr<BlockOPoints> block) {
     // Pull out data
@@ -646,6 +691,14 @@ void BasisFunctions::compute_functions(std::shared_ptr<BlockOPoints> block) {
 
     const std::vector<int>& shells = block->shells_local_to_global();
 
+    // Primitives that are negligible over the whole bounding sphere of the block are dropped
+    // before collocation, using a per-primitive share of the basis extents cutoff
+    const Vector3& xc = block->xc();
+    double R = block->R();
+    double delta = block->extents()->delta();
+    prim_alpha_.resize(primary_->max_nprimitive());
+    prim_norm_.resize(primary_->max_nprimitive());
+
     // Declare tmps
     std::vector<double> center(3, 0.0);
 
@@ -654,6 +707,10 @@ void BasisFunctions::compute_functions(std::shared_ptr<BlockOPoints> block) {
     double *tmp_xxp, *tmp_xyp, *tmp_xzp, *tmp_yyp, *tmp_yzp, *tmp_zzp;
     double *valuesp, *values_xp, *values_yp, *values_zp;
     double *values_xxp, *values_xyp, *values_xzp, *values_yyp, *values_yzp, *values_zzp;
+    const char* deriv3_keys[10] = {"PHI_XXX", "PHI_XXY", "PHI_XXZ", "PHI_XYY", "PHI_XYZ",
+                                   "PHI_XZZ", "PHI_YYY", "PHI_YYZ", "PHI_YZZ", "PHI_ZZZ"};
+    double* tmp_3p[10];
+    double* values_3p[10];
 
     if (deriv_ >= 0) {
         tmpp = basis_temps_["PHI"]->pointer()[0];
@@ -681,6 +738,16 @@ void BasisFunctions::compute_functions(std::shared_ptr<BlockOPoints> block) {
         values_yzp = basis_values_["PHI_YZ"]->pointer()[0];
         values_zzp = basis_values_["PHI_ZZ"]->pointer()[0];
     }
+    if (deriv_ >= 3) {
+        for (int k = 0; k < 10; k++) {
+            tmp_3p[k] = basis_temps_[deriv3_keys[k]]->pointer()[0];
+            values_3p[k] = basis_values_[deriv3_keys[k]]->pointer()[0];
+        }
+    }
+
+    // All temps gg writes into, for shells whose primitives are all screened out
+    std::vector<double*> active_tmps;
+    for (auto& kv : basis_temps_) active_tmps.push_back(kv.second->pointer()[0]);
 
     int nvals = 0;
     for (size_t Qlocal = 0; Qlocal < shells.size(); Qlocal++) {
@@ -689,9 +756,7 @@ void BasisFunctions::compute_functions(std::shared_ptr<BlockOPoints> block) {
         Vector3 v = Qshell.center();
         int L = Qshell.am();
         int nQ = Qshell.nfunction();
-        int nprim = Qshell.nprimitive();
-        const double* alpha = Qshell.exps();
-        const double* norm = Qshell.coefs();
+        int nrows = (puream_ ? 2 * L + 1 : nQ);
 
         // Copy over centerp to a double*
         center[0] = v[0];
@@ -702,6 +767,23 @@ void BasisFunctions::compute_functions(std::shared_ptr<BlockOPoints> block) {
         size_t row_shift = nvals * npoints;
         double* phi_start = tmpp + row_shift;
 
+        // Screen primitives against the closest approach of the block to this center
+        double Rc = std::sqrt((v[0] - xc[0]) * (v[0] - xc[0]) + (v[1] - xc[1]) * (v[1] - xc[1]) +
+                              (v[2] - xc[2]) * (v[2] - xc[2]));
+        double rmin = std::max(0.0, Rc - R);
+        int nprim = screen_primitives(L, Qshell.nprimitive(), Qshell.exps(), Qshell.coefs(), rmin,
+                                      delta / Qshell.nprimitive(), deriv_, prim_alpha_.data(), prim_norm_.data());
+        const double* alpha = prim_alpha_.data();
+        const double* norm = prim_norm_.data();
+
+        if (nprim == 0) {
+            for (double* tmp : active_tmps) {
+                std::fill(tmp + row_shift, tmp + row_shift + (size_t)nrows * npoints, 0.0);
+            }
+            nvals += nrows;
+            continue;
+        }
+
         // Copmute collocation
         if (deriv_ == 0) {
             gg_collocation(L, npoints, x, y, z, nprim, norm, alpha, center.data(), (int)puream_, phi_start);
@@ -725,13 +807,17 @@ void BasisFunctions::compute_functions(std::shared_ptr<BlockOPoints> block) {
             gg_collocation_deriv2(L, npoints, x, y, z, nprim, norm, alpha, center.data(), (int)puream_, phi_start,
                                   phi_x_start, phi_y_start, phi_z_start, phi_xx_start, phi_xy_start, phi_xz_start,
                                   phi_yy_start, phi_yz_start, phi_zz_start);
+        } else if (deriv_ == 3) {
+            gg_collocation_deriv3(L, npoints, x, y, z, nprim, norm, alpha, center.data(), (int)puream_, phi_start,
+                                  tmp_xp + row_shift, tmp_yp + row_shift, tmp_zp + row_shift, tmp_xxp + row_shift,
+                                  tmp_xyp + row_shift, tmp_xzp + row_shift, tmp_yyp + row_shift, tmp_yzp + row_shift,
+                                  tmp_zzp + row_shift, tmp_3p[0] + row_shift, tmp_3p[1] + row_shift,
+                                  tmp_3p[2] + row_shift, tmp_3p[3] + row_shift, tmp_3p[4] + row_shift,
+                                  tmp_3p[5] + row_shift, tmp_3p[6] + row_shift, tmp_3p[7] + row_shift,
+                                  tmp_3p[8] + row_shift, tmp_3p[9] + row_shift);
         }
 
-        if (puream_) {
-            nvals += 2 * L + 1;
-        } else {
-            nvals += nQ;  // Cartesian is already computed
-        }
+        nvals += nrows;
     }
 
     // GG spits it out tranpose of what we need
@@ -750,6 +836,11 @@ void BasisFunctions::compute_functions(std::shared_ptr<BlockOPoints> block) {
         gg_fast_transpose(nso, npoints, tmp_yzp, values_yzp);
         gg_fast_transpose(nso, npoints, tmp_zzp, values_zzp);
     }
+    if (deriv_ >= 3) {
+        for (int k = 0; k < 10; k++) {
+            gg_fast_transpose(nso, npoints, tmp_3p[k], values_3p[k]);
+        }
+    }
 }
 void BasisFunctions::print(std::string out, int print) const {
     std::shared_ptr<psi::PsiOutStream> printer = (out == "outfile" ? outfile : std::make_shared<PsiOutStream>(out));
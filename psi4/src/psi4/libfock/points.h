@@ -30,6 +30,7 @@
 #define libfock_points_H
 
 #include "psi4/libmints/typedefs.h"
+#include "psi4/libfunctional/functional.h"
 #include "psi4/pragma.h"
 
 #include <cstdio>
@@ -61,6 +62,10 @@ class PSI_API BasisFunctions {
     std::map<std::string, SharedMatrix> basis_values_;
     /// Map of temp names to Matrices containing temps
     std::map<std::string, SharedMatrix> basis_temps_;
+    /// Exponents of the primitives of the current shell that survive block screening
+    std::vector<double> prim_alpha_;
+    /// Coefficients of the primitives of the current shell that survive block screening
+    std::vector<double> prim_norm_;
     /// Allocate registers
     virtual void allocate();
 
@@ -118,6 +123,8 @@ class PointFunctions : public BasisFunctions {
     int ansatz_;
     /// Map of value names to Vectors containing values
     std::map<std::string, std::shared_ptr<Vector>> point_values_;
+    /// XCValue-indexed view of point_values_, rebuilt by allocate()
+    XCBuffer point_buffer_;
 
     // => Orbital Collocation <= //
 
@@ -143,6 +150,7 @@ class PointFunctions : public BasisFunctions {
 
     std::shared_ptr<Vector> point_value(const std::string& key);
     std::map<std::string, SharedVector>& point_values() { return point_values_; }
+    const XCBuffer& point_buffer() const { return point_buffer_; }
 
     SharedMatrix basis_value(const std::string& key) { return (*current_basis_map_)[key]; }
     std::map<std::string, SharedMatrix>& basis_values() { return (*current_basis_map_); }
@@ -46,6 +46,7 @@
 #include "psi4/libpsi4util/PsiOutStream.h"
 #include "psi4/libpsi4util/process.h"
 
+#include <algorithm>
 #include <cstdlib>
 #include <numeric>
 #include <sstream>
@@ -67,6 +68,7 @@ void VBase::common_init() {
     debug_ = options_.get_int("DEBUG");
     v2_rho_cutoff_ = options_.get_double("DFT_V2_RHO_CUTOFF");
     vv10_rho_cutoff_ = options_.get_double("DFT_VV10_RHO_CUTOFF");
+    vv10_theta_ = options_.get_double("DFT_VV10_THETA");
     grac_initialized_ = false;
     cache_map_deriv_ = -1;
     num_threads_ = 1;
@@ -141,6 +143,9 @@ void VBase::initialize() {
 }
 SharedMatrix VBase::compute_gradient() { throw PSIEXCEPTION("VBase: gradient not implemented for this V instance."); }
 SharedMatrix VBase::compute_hessian() { throw PSIEXCEPTION("VBase: hessian not implemented for this V instance."); }
+std::vector<SharedMatrix> VBase::compute_fock_derivatives(int first, int count) {
+    throw PSIEXCEPTION("VBase: Fock derivatives not implemented for this V instance.");
+}
 void VBase::compute_V(std::vector<SharedMatrix> ret) {
     throw PSIEXCEPTION("VBase: deriv not implemented for this V instance.");
 }
@@ -279,8 +284,63 @@ void VBase::build_collocation_cache(size_t memory) {
         outfile->Printf("  Cached %.1lf%% of DFT collocation blocks in %.3lf [GiB].\n\n", fraction, mib_saved);
     }
 }
-void VBase::prepare_vv10_cache(DFTGrid& nlgrid, SharedMatrix D,
-                               std::vector<std::map<std::string, SharedVector>>& vv10_cache,
+namespace {
+// Fold two VV10 cells into their parent's far-field pseudo-point
+void merge_vv10_cells(VV10Cell& parent, const VV10Cell& a, const VV10Cell& b) {
+    parent.w_rho = a.w_rho + b.w_rho;
+    const double fa = (parent.w_rho > 0.0 ? a.w_rho / parent.w_rho : 0.5);
+    const double fb = 1.0 - fa;
+    for (int k = 0; k < 3; k++) parent.center[k] = fa * a.center[k] + fb * b.center[k];
+    parent.W0 = fa * a.W0 + fb * b.W0;
+    parent.kappa = fa * a.kappa + fb * b.kappa;
+
+    double ra = 0.0, rb = 0.0;
+    for (int k = 0; k < 3; k++) {
+        ra += (a.center[k] - parent.center[k]) * (a.center[k] - parent.center[k]);
+        rb += (b.center[k] - parent.center[k]) * (b.center[k] - parent.center[k]);
+    }
+    parent.radius = std::max(std::sqrt(ra) + a.radius, std::sqrt(rb) + b.radius);
+}
+
+// Recursive bisection of the leaves along the longest extent of their centers.
+// Nodes are stored pre-order, so the root is always vv10_tree[0].
+int build_vv10_tree(std::vector<VV10Cell>& vv10_tree, std::vector<VV10Cell>& leaves, size_t begin, size_t end) {
+    if (end - begin == 1) {
+        vv10_tree.push_back(leaves[begin]);
+        return static_cast<int>(vv10_tree.size() - 1);
+    }
+
+    const int node = static_cast<int>(vv10_tree.size());
+    vv10_tree.push_back(VV10Cell());
+
+    double lo[3], hi[3];
+    for (int k = 0; k < 3; k++) lo[k] = hi[k] = leaves[begin].center[k];
+    for (size_t c = begin + 1; c < end; c++) {
+        for (int k = 0; k < 3; k++) {
+            lo[k] = std::min(lo[k], leaves[c].center[k]);
+            hi[k] = std::max(hi[k], leaves[c].center[k]);
+        }
+    }
+    int axis = 0;
+    for (int k = 1; k < 3; k++) {
+        if (hi[k] - lo[k] > hi[axis] - lo[axis]) axis = k;
+    }
+
+    const size_t mid = (begin + end) / 2;
+    std::nth_element(leaves.begin() + begin, leaves.begin() + mid, leaves.begin() + end,
+                     [axis](const VV10Cell& a, const VV10Cell& b) { return a.center[axis] < b.center[axis]; });
+
+    const int left = build_vv10_tree(vv10_tree, leaves, begin, mid);
+    const int right = build_vv10_tree(vv10_tree, leaves, mid, end);
+
+    vv10_tree[node].children[0] = left;
+    vv10_tree[node].children[1] = right;
+    merge_vv10_cells(vv10_tree[node], vv10_tree[left], vv10_tree[right]);
+    return node;
+}
+}  // namespace
+
+void VBase::prepare_vv10_cache(DFTGrid& nlgrid, SharedMatrix D, std::vector<VV10Cell>& vv10_tree,
                                std::vector<std::shared_ptr<PointFunctions>>& nl_point_workers, int ansatz) {
     // Densities should be set by the calling functional
     int rank = 0;
@@ -297,9 +357,8 @@ void VBase::prepare_vv10_cache(DFTGrid& nlgrid, SharedMatrix D,
         nl_point_workers.push_back(point_tmp);
     }
 
-    // => Make the return and "interior" cache <=
-    std::vector<std::map<std::string, SharedVector>> vv10_tmp_cache;
-    vv10_tmp_cache.resize(nlgrid.blocks().size());
+    // => Build the leaves, one per (already spatially compact) grid block <=
+    std::vector<VV10Cell> leaves(nlgrid.blocks().size());
 
 #pragma omp parallel for private(rank) schedule(guided) num_threads(num_threads_)
     for (size_t Q = 0; Q < nlgrid.blocks().size(); Q++) {
@@ -312,51 +371,61 @@ void VBase::prepare_vv10_cache(DFTGrid& nlgrid, SharedMatrix D,
         std::shared_ptr<SuperFunctional> fworker = functional_workers_[rank];
         std::shared_ptr<PointFunctions> pworker = nl_point_workers[rank];
         std::shared_ptr<BlockOPoints> block = nlgrid.blocks()[Q];
-        // printf("Block %zu\n", Q);
 
         pworker->compute_points(block);
-        vv10_tmp_cache[Q] =
-            fworker->compute_vv10_cache(pworker->point_values(), block, vv10_rho_cutoff_, block->npoints(), false);
-    }
-
-    // Stitch the cache together to make a single contiguous cache
-    size_t total_size = 0;
-    for (auto cache : vv10_tmp_cache) {
-        total_size += cache["W"]->dimpi()[0];
-    }
-
-    // printf("VV10 NL Total size %zu\n", total_size);
-
-    // Leave this as a vector of maps in case we ever revisit the on-the fly manipulation
-    vv10_cache.resize(1);
-    vv10_cache[0]["W"] = std::make_shared<Vector>("W Grid points", total_size);
-    vv10_cache[0]["X"] = std::make_shared<Vector>("X Grid points", total_size);
-    vv10_cache[0]["Y"] = std::make_shared<Vector>("Y Grid points", total_size);
-    vv10_cache[0]["Z"] = std::make_shared<Vector>("Z Grid points", total_size);
-    vv10_cache[0]["RHO"] = std::make_shared<Vector>("RHO Grid points", total_size);
-    vv10_cache[0]["W0"] = std::make_shared<Vector>("W0 Grid points", total_size);
-    vv10_cache[0]["KAPPA"] = std::make_shared<Vector>("KAPPA Grid points", total_size);
-
-    double* w_vecp = vv10_cache[0]["W"]->pointer();
-    double* x_vecp = vv10_cache[0]["X"]->pointer();
-    double* y_vecp = vv10_cache[0]["Y"]->pointer();
-    double* z_vecp = vv10_cache[0]["Z"]->pointer();
-    double* rho_vecp = vv10_cache[0]["RHO"]->pointer();
-    double* w0_vecp = vv10_cache[0]["W0"]->pointer();
-    double* kappa_vecp = vv10_cache[0]["KAPPA"]->pointer();
-
-    size_t offset = 0;
-    for (auto cache : vv10_tmp_cache) {
-        size_t csize = cache["W"]->dimpi()[0];
-        C_DCOPY(csize, cache["W"]->pointer(), 1, (w_vecp + offset), 1);
-        C_DCOPY(csize, cache["X"]->pointer(), 1, (x_vecp + offset), 1);
-        C_DCOPY(csize, cache["Y"]->pointer(), 1, (y_vecp + offset), 1);
-        C_DCOPY(csize, cache["Z"]->pointer(), 1, (z_vecp + offset), 1);
-        C_DCOPY(csize, cache["RHO"]->pointer(), 1, (rho_vecp + offset), 1);
-        C_DCOPY(csize, cache["W0"]->pointer(), 1, (w0_vecp + offset), 1);
-        C_DCOPY(csize, cache["KAPPA"]->pointer(), 1, (kappa_vecp + offset), 1);
-
-        offset += csize;
+        VV10Cell& leaf = leaves[Q];
+        std::map<std::string, SharedVector> cache =
+            fworker->compute_vv10_cache(pworker->point_buffer(), block, vv10_rho_cutoff_, block->npoints(), false);
+
+        const size_t npoints = cache["W_RHO"]->dimpi()[0];
+        if (!npoints) continue;
+        leaf.p_x.assign(cache["X"]->pointer(), cache["X"]->pointer() + npoints);
+        leaf.p_y.assign(cache["Y"]->pointer(), cache["Y"]->pointer() + npoints);
+        leaf.p_z.assign(cache["Z"]->pointer(), cache["Z"]->pointer() + npoints);
+        leaf.p_w_rho.assign(cache["W_RHO"]->pointer(), cache["W_RHO"]->pointer() + npoints);
+        leaf.p_W0.assign(cache["W0"]->pointer(), cache["W0"]->pointer() + npoints);
+        leaf.p_kappa.assign(cache["KAPPA"]->pointer(), cache["KAPPA"]->pointer() + npoints);
+        const double* x = leaf.p_x.data();
+        const double* y = leaf.p_y.data();
+        const double* z = leaf.p_z.data();
+        const double* w_rho = leaf.p_w_rho.data();
+        const double* W0 = leaf.p_W0.data();
+        const double* kappa = leaf.p_kappa.data();
+
+        // Far-field pseudo-point, w*rho weighted
+        double wsum = 0.0;
+        for (size_t P = 0; P < npoints; P++) wsum += w_rho[P];
+        const double wscale = (wsum > 0.0 ? 1.0 / wsum : 0.0);
+        for (size_t P = 0; P < npoints; P++) {
+            const double f = (wsum > 0.0 ? w_rho[P] * wscale : 1.0 / npoints);
+            leaf.center[0] += f * x[P];
+            leaf.center[1] += f * y[P];
+            leaf.center[2] += f * z[P];
+            leaf.W0 += f * W0[P];
+            leaf.kappa += f * kappa[P];
+        }
+        leaf.w_rho = wsum;
+
+        double R2 = 0.0;
+        for (size_t P = 0; P < npoints; P++) {
+            const double dx = x[P] - leaf.center[0];
+            const double dy = y[P] - leaf.center[1];
+            const double dz = z[P] - leaf.center[2];
+            R2 = std::max(R2, dx * dx + dy * dy + dz * dz);
+        }
+        leaf.radius = std::sqrt(R2);
+    }
+
+    // Blocks with no point above the density cutoff do not enter the tree
+    leaves.erase(std::remove_if(leaves.begin(), leaves.end(),
+                                [](const VV10Cell& leaf) { return leaf.npoints() == 0; }),
+                 leaves.end());
+
+    // => Stitch the leaves into a bisection tree <=
+    vv10_tree.clear();
+    if (leaves.size()) {
+        vv10_tree.reserve(2 * leaves.size() - 1);
+        build_vv10_tree(vv10_tree, leaves, 0, leaves.size());
     }
 }
 double VBase::vv10_nlc(SharedMatrix D, SharedMatrix ret) {
@@ -372,9 +441,9 @@ double VBase::vv10_nlc(SharedMatrix D, SharedMatrix ret) {
     opt_int_map["DFT_SPHERICAL_POINTS"] = options_.get_int("DFT_VV10_SPHERICAL_POINTS");
 
     DFTGrid nlgrid = DFTGrid(primary_->molecule(), primary_, opt_int_map, opt_map, options_);
-    std::vector<std::map<std::string, SharedVector>> vv10_cache;
+    std::vector<VV10Cell> vv10_tree;
     std::vector<std::shared_ptr<PointFunctions>> nl_point_workers;
-    prepare_vv10_cache(nlgrid, D, vv10_cache, nl_point_workers);
+    prepare_vv10_cache(nlgrid, D, vv10_tree, nl_point_workers);
 
     timer_off("Setup");
 
@@ -409,11 +478,8 @@ double VBase::vv10_nlc(SharedMatrix D, SharedMatrix ret) {
         // Compute Rho, Phi, etc
         pworker->compute_points(block);
 
-        // Updates the vals map and returns the energy
-        std::map<std::string, SharedVector> vals = fworker->values();
-
         parallel_timer_on("Kernel", rank);
-        vv10_exc[rank] += fworker->compute_vv10_kernel(pworker->point_values(), vv10_cache, block);
+        vv10_exc[rank] += fworker->compute_vv10_kernel(pworker->point_buffer(), vv10_tree, block, -1, false, vv10_theta_);
         parallel_timer_off("Kernel", rank);
 
         parallel_timer_on("VV10 Fock", rank);
@@ -462,9 +528,9 @@ SharedMatrix VBase::vv10_nlc_gradient(SharedMatrix D) {
     opt_int_map["DFT_SPHERICAL_POINTS"] = options_.get_int("DFT_VV10_SPHERICAL_POINTS");
 
     DFTGrid nlgrid = DFTGrid(primary_->molecule(), primary_, opt_int_map, opt_map, options_);
-    std::vector<std::map<std::string, SharedVector>> vv10_cache;
+    std::vector<VV10Cell> vv10_tree;
     std::vector<std::shared_ptr<PointFunctions>> nl_point_workers;
-    prepare_vv10_cache(nlgrid, D, vv10_cache, nl_point_workers, 2);
+    prepare_vv10_cache(nlgrid, D, vv10_tree, nl_point_workers, 2);
 
     timer_off("Setup");
 
@@ -504,11 +570,8 @@ SharedMatrix VBase::vv10_nlc_gradient(SharedMatrix D) {
         // Compute Rho, Phi, etc
         pworker->compute_points(block);
 
-        // Updates the vals map and returns the energy
-        std::map<std::string, SharedVector> vals = fworker->values();
-
         parallel_timer_on("Kernel", rank);
-        vv10_exc[rank] += fworker->compute_vv10_kernel(pworker->point_values(), vv10_cache, block, npoints, true);
+        vv10_exc[rank] += fworker->compute_vv10_kernel(pworker->point_buffer(), vv10_tree, block, npoints, true, vv10_theta_);
         parallel_timer_off("Kernel", rank);
 
         parallel_timer_on("V_xc gradient", rank);
@@ -635,7 +698,7 @@ void RV::compute_V(std::vector<SharedMatrix> ret) {
 
         // Compute functional values
         parallel_timer_on("Functional", rank);
-        fworker->compute_functional(pworker->point_values());
+        fworker->compute_functional(pworker->point_buffer(), block->npoints());
         parallel_timer_off("Functional", rank);
 
         if (debug_ > 4) {
@@ -816,14 +879,14 @@ void RV::compute_Vx(std::vector<SharedMatrix> Dx, std::vector<SharedMatrix> ret)
         // Compute functional values
 
         parallel_timer_on("Functional", rank);
-        std::map<std::string, SharedVector>& vals = fworker->compute_functional(pworker->point_values(), npoints);
+        const XCBuffer& vals = fworker->compute_functional(pworker->point_buffer(), npoints);
         parallel_timer_off("Functional", rank);
 
         // => Grab quantities <= //
         // LDA
         double** phi = pworker->basis_value("PHI")->pointer();
-        double* rho_a = pworker->point_value("RHO_A")->pointer();
-        double* v2_rho2 = vals["V_RHO_A_RHO_A"]->pointer();
+        double* rho_a = pworker->point_buffer()[XCValue::RHO_A];
+        double* v2_rho2 = vals[XCValue::V_RHO_A_RHO_A];
         double* rho_k = R_rho_k[rank]->pointer();
         size_t coll_funcs = pworker->basis_value("PHI")->ncol();
 
@@ -846,9 +909,9 @@ void RV::compute_Vx(std::vector<SharedMatrix> Dx, std::vector<SharedMatrix> ret)
             phi_x = pworker->basis_value("PHI_X")->pointer();
             phi_y = pworker->basis_value("PHI_Y")->pointer();
             phi_z = pworker->basis_value("PHI_Z")->pointer();
-            rho_x = pworker->point_value("RHO_AX")->pointer();
-            rho_y = pworker->point_value("RHO_AY")->pointer();
-            rho_z = pworker->point_value("RHO_AZ")->pointer();
+            rho_x = pworker->point_buffer()[XCValue::RHO_AX];
+            rho_y = pworker->point_buffer()[XCValue::RHO_AY];
+            rho_z = pworker->point_buffer()[XCValue::RHO_AZ];
         }
 
         // Meta
@@ -905,9 +968,9 @@ void RV::compute_Vx(std::vector<SharedMatrix> Dx, std::vector<SharedMatrix> ret)
             // => GGA contribution <= //
             // parallel_timer_on("GGA", rank);
             if (ansatz >= 1) {
-                double* v_gamma = vals["V_GAMMA_AA"]->pointer();
-                double* v2_gamma_gamma = vals["V_GAMMA_AA_GAMMA_AA"]->pointer();
-                double* v2_rho_gamma = vals["V_RHO_A_GAMMA_AA"]->pointer();
+                double* v_gamma = vals[XCValue::V_GAMMA_AA];
+                double* v2_gamma_gamma = vals[XCValue::V_GAMMA_AA_GAMMA_AA];
+                double* v2_rho_gamma = vals[XCValue::V_RHO_A_GAMMA_AA];
                 double tmp_val = 0.0, v2_val = 0.0;
 
                 for (int P = 0; P < npoints; P++) {
@@ -1038,7 +1101,7 @@ SharedMatrix RV::compute_gradient() {
         parallel_timer_off("Properties", rank);
 
         parallel_timer_on("Functional", rank);
-        std::map<std::string, SharedVector>& vals = fworker->compute_functional(pworker->point_values());
+        const XCBuffer& vals = fworker->compute_functional(pworker->point_buffer(), block->npoints());
         parallel_timer_off("Functional", rank);
 
         parallel_timer_on("V_xc gradient", rank);
@@ -1097,9 +1160,116 @@ SharedMatrix RV::compute_gradient() {
     return G;
 }
 
+namespace {
+
+/*
+ * Nuclear derivatives of the RKS density on one block of points, at fixed D.
+ * Row 3 a + i holds the derivative with respect to coordinate i of the a-th
+ * atom that owns functions in the block (phi_m,i = d phi_m / d r_i):
+ *
+ *      rho^{Ai}      = -4 sum_{m in A} phi_m,i (phi D)_m
+ *      d_k rho^{Ai}  = -4 sum_{m in A} [phi_m,ik (phi D)_m + phi_m,i (phi_k D)_m]
+ *      gamma^{Ai}    =  2 sum_k d_k rho d_k rho^{Ai}
+ */
+struct RKSNuclearDensityDerivs {
+    /// Global index of each local atom
+    std::vector<int> atoms;
+    /// Local atom owning each local function
+    std::vector<int> func_atom;
+    /// Number of perturbations, 3 * atoms.size()
+    int nrow;
+    /// phi D and phi_k D, npoints x nlocal
+    std::vector<double> T;
+    std::vector<double> Tk[3];
+    /// First-order densities, nrow x npoints
+    std::vector<double> rho;
+    std::vector<double> grad[3];
+    std::vector<double> gamma;
+
+    void compute(std::shared_ptr<BasisSet> primary, std::shared_ptr<BlockOPoints> block,
+                 std::shared_ptr<PointFunctions> pworker, bool gga) {
+        int npoints = block->npoints();
+        const std::vector<int>& function_map = block->functions_local_to_global();
+        int nlocal = function_map.size();
+        size_t coll_funcs = pworker->basis_value("PHI")->ncol();
+        SharedMatrix D = pworker->D_scratch()[0];
+        double** Dp = D->pointer();
+        int ldD = D->ncol();
+
+        // => Local atoms <= //
+        atoms.clear();
+        func_atom.resize(nlocal);
+        for (int ml = 0; ml < nlocal; ml++) {
+            int A = primary->function_to_center(function_map[ml]);
+            auto it = std::find(atoms.begin(), atoms.end(), A);
+            func_atom[ml] = it - atoms.begin();
+            if (it == atoms.end()) atoms.push_back(A);
+        }
+        nrow = 3 * atoms.size();
+
+        double** phi = pworker->basis_value("PHI")->pointer();
+        double** phi_i[3] = {pworker->basis_value("PHI_X")->pointer(), pworker->basis_value("PHI_Y")->pointer(),
+                             pworker->basis_value("PHI_Z")->pointer()};
+
+        T.assign(npoints * (size_t)nlocal, 0.0);
+        C_DGEMM('N', 'N', npoints, nlocal, nlocal, 1.0, phi[0], coll_funcs, Dp[0], ldD, 0.0, T.data(), nlocal);
+
+        rho.assign(nrow * (size_t)npoints, 0.0);
+        for (int i = 0; i < 3; i++) {
+            for (int P = 0; P < npoints; P++) {
+                for (int ml = 0; ml < nlocal; ml++) {
+                    rho[(3 * func_atom[ml] + i) * (size_t)npoints + P] -=
+                        4.0 * phi_i[i][P][ml] * T[P * (size_t)nlocal + ml];
+                }
+            }
+        }
+        if (!gga) return;
+
+        double** phi_ij[3][3];
+        phi_ij[0][0] = pworker->basis_value("PHI_XX")->pointer();
+        phi_ij[0][1] = phi_ij[1][0] = pworker->basis_value("PHI_XY")->pointer();
+        phi_ij[0][2] = phi_ij[2][0] = pworker->basis_value("PHI_XZ")->pointer();
+        phi_ij[1][1] = pworker->basis_value("PHI_YY")->pointer();
+        phi_ij[1][2] = phi_ij[2][1] = pworker->basis_value("PHI_YZ")->pointer();
+        phi_ij[2][2] = pworker->basis_value("PHI_ZZ")->pointer();
+        double* rho_k[3] = {pworker->point_buffer()[XCValue::RHO_AX], pworker->point_buffer()[XCValue::RHO_AY],
+                            pworker->point_buffer()[XCValue::RHO_AZ]};
+
+        for (int k = 0; k < 3; k++) {
+            Tk[k].assign(npoints * (size_t)nlocal, 0.0);
+            C_DGEMM('N', 'N', npoints, nlocal, nlocal, 1.0, phi_i[k][0], coll_funcs, Dp[0], ldD, 0.0, Tk[k].data(),
+                    nlocal);
+        }
+
+        gamma.assign(nrow * (size_t)npoints, 0.0);
+        for (int k = 0; k < 3; k++) {
+            grad[k].assign(nrow * (size_t)npoints, 0.0);
+            for (int i = 0; i < 3; i++) {
+                for (int P = 0; P < npoints; P++) {
+                    for (int ml = 0; ml < nlocal; ml++) {
+                        size_t Pm = P * (size_t)nlocal + ml;
+                        grad[k][(3 * func_atom[ml] + i) * (size_t)npoints + P] -=
+                            4.0 * (phi_ij[i][k][P][ml] * T[Pm] + phi_i[i][P][ml] * Tk[k][Pm]);
+                    }
+                }
+            }
+            for (int row = 0; row < nrow; row++) {
+                for (int P = 0; P < npoints; P++) {
+                    gamma[row * (size_t)npoints + P] += 2.0 * rho_k[k][P] * grad[k][row * (size_t)npoints + P];
+                }
+            }
+        }
+    }
+};
+
+}  // namespace
+
+// The XC Hessian and the V_xc derivatives below move the basis functions with the atoms but keep the grid weights
+// fixed: the grid-weight derivative terms are not included, so they agree with finite differences of analytic
+// gradients only to the accuracy of the grid.
 SharedMatrix RV::compute_hessian() {
-    if (functional_->is_gga() || functional_->is_meta())
-        throw PSIEXCEPTION("Hessians for GGA and meta GGA functionals are not yet implemented.");
+    if (functional_->is_meta())
+        throw PSIEXCEPTION("Hessians for meta GGA functionals are not yet implemented.");
 
     if ((D_AO_.size() != 1)) throw PSIEXCEPTION("V: RKS should have only one D Matrix");
 
@@ -1107,45 +1277,55 @@ SharedMatrix RV::compute_hessian() {
         throw PSIEXCEPTION("V: RKS cannot compute VV10 Hessian contribution.");
     }
 
-    // Build the target Hessian Matrix
+    timer_on("RV: Form Hessian");
+
     int natom = primary_->molecule()->natom();
-    auto H = std::make_shared<Matrix>("XC Hessian", 3 * natom, 3 * natom);
-    double** Hp = H->pointer();
+    bool gga = functional_->is_gga();
 
     // Thread info
     int rank = 0;
 
-    // Set Hessian derivative level in properties
-    int old_deriv = point_workers_[0]->deriv();
+    // Basis function derivatives one order past the Hessian for GGAs, functional second derivatives
+    int old_point_deriv = point_workers_[0]->deriv();
     int old_func_deriv = functional_->deriv();
-
-    // How many functions are there (for lda in Vtemp, T)
-    int max_functions = grid_->max_functions();
-    int max_points = grid_->max_points();
-
-    int derivlev = (functional_->is_gga() || functional_->is_meta()) ? 3 : 2;
-    functional_->set_deriv(derivlev);
-
-    // Setup the pointers
     for (size_t i = 0; i < num_threads_; i++) {
         point_workers_[i]->set_pointers(D_AO_[0]);
-        point_workers_[i]->set_deriv(derivlev);
-        functional_workers_[i]->set_deriv(derivlev);
+        point_workers_[i]->set_deriv(gga ? 3 : 2);
+        functional_workers_[i]->set_deriv(2);
         functional_workers_[i]->allocate();
     }
 
     // Per thread temporaries
-    std::vector<SharedMatrix> V_local;
-    std::vector<std::shared_ptr<Vector>> Q_temp;
+    std::vector<SharedMatrix> H_local;
     for (size_t i = 0; i < num_threads_; i++) {
-        V_local.push_back(std::make_shared<Matrix>("V Temp", max_functions, max_functions));
-        Q_temp.push_back(std::make_shared<Vector>("Quadrature Tempt", max_points));
+        H_local.push_back(std::make_shared<Matrix>("H Temp", 3 * natom, 3 * natom));
+    }
+
+    // phi_ijk, as stored by BasisFunctions
+    const char* deriv3_keys[10] = {"PHI_XXX", "PHI_XXY", "PHI_XXZ", "PHI_XYY", "PHI_XYZ",
+                                   "PHI_XZZ", "PHI_YYY", "PHI_YYZ", "PHI_YZZ", "PHI_ZZZ"};
+    int deriv3_index[3][3][3];
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            for (int k = 0; k < 3; k++) {
+                int ijk[3] = {i, j, k};
+                std::sort(ijk, ijk + 3);
+                int index = 0;
+                for (int a = 0; a < 3; a++) {
+                    for (int b = a; b < 3; b++) {
+                        for (int c = b; c < 3; c++, index++) {
+                            if (a == ijk[0] && b == ijk[1] && c == ijk[2]) deriv3_index[i][j][k] = index;
+                        }
+                    }
+                }
+            }
+        }
     }
 
-    auto QT = std::make_shared<Vector>("Quadrature Temp", max_points);
-    double* QTp = QT->pointer();
     const std::vector<std::shared_ptr<BlockOPoints>>& blocks = grid_->blocks();
 
+// Traverse the blocks of points
+#pragma omp parallel for private(rank) schedule(dynamic) num_threads(num_threads_)
     for (size_t Q = 0; Q < blocks.size(); Q++) {
 // Get thread info
 #ifdef _OPENMP
@@ -1154,208 +1334,445 @@ SharedMatrix RV::compute_hessian() {
 
         std::shared_ptr<SuperFunctional> fworker = functional_workers_[rank];
         std::shared_ptr<PointFunctions> pworker = point_workers_[rank];
-        double** V2p = V_local[rank]->pointer();
-        double* QTp = Q_temp[rank]->pointer();
-        double** Dp = pworker->D_scratch()[0]->pointer();
-
-        // Scratch
-        double** Tp = pworker->scratch()[0]->pointer();
-        SharedMatrix U_local(pworker->scratch()[0]->clone());
-        double** Up = U_local->pointer();
-
-        // ACS TODO: these need to be threaded eventually, to fit in with the new infrastructure
-        auto Tmpx = std::make_shared<Vector>("Tx", max_functions);
-        auto Tmpy = std::make_shared<Vector>("Ty", max_functions);
-        auto Tmpz = std::make_shared<Vector>("Tz", max_functions);
-        double* pTx = Tmpx->pointer();
-        double* pTy = Tmpy->pointer();
-        double* pTz = Tmpz->pointer();
-        SharedMatrix Tx(U_local->clone());
-        SharedMatrix Ty(U_local->clone());
-        SharedMatrix Tz(U_local->clone());
-        double** pTx2 = Tx->pointer();
-        double** pTy2 = Ty->pointer();
-        double** pTz2 = Tz->pointer();
+        double** Hp = H_local[rank]->pointer();
 
         std::shared_ptr<BlockOPoints> block = blocks[Q];
         int npoints = block->npoints();
-        double* x = block->x();
-        double* y = block->y();
-        double* z = block->z();
         double* w = block->w();
         const std::vector<int>& function_map = block->functions_local_to_global();
         int nlocal = function_map.size();
 
-        pworker->compute_points(block);
-        std::map<std::string, SharedVector>& vals = fworker->compute_functional(pworker->point_values(), npoints);
+        // The collocation cache only holds the SCF derivative level
+        parallel_timer_on("Properties", rank);
+        pworker->compute_points(block, true);
+        parallel_timer_off("Properties", rank);
 
-        double** phi = pworker->basis_value("PHI")->pointer();
-        double** phi_x = pworker->basis_value("PHI_X")->pointer();
-        double** phi_y = pworker->basis_value("PHI_Y")->pointer();
-        double** phi_z = pworker->basis_value("PHI_Z")->pointer();
-        double** phi_xx = pworker->basis_value("PHI_XX")->pointer();
-        double** phi_xy = pworker->basis_value("PHI_XY")->pointer();
-        double** phi_xz = pworker->basis_value("PHI_XZ")->pointer();
-        double** phi_yy = pworker->basis_value("PHI_YY")->pointer();
-        double** phi_yz = pworker->basis_value("PHI_YZ")->pointer();
-        double** phi_zz = pworker->basis_value("PHI_ZZ")->pointer();
-        double* v_rho_a = vals["V_RHO_A"]->pointer();
-        double* v_rho_aa = vals["V_RHO_A_RHO_A"]->pointer();
-        size_t coll_funcs = pworker->basis_value("PHI")->ncol();
+        parallel_timer_on("Functional", rank);
+        const XCBuffer& vals = fworker->compute_functional(pworker->point_buffer(), npoints);
+        parallel_timer_off("Functional", rank);
 
-        for (int P = 0; P < npoints; P++) {
-            std::fill(Up[P], Up[P] + nlocal, 0.0);
-            C_DAXPY(nlocal, 4.0 * w[P] * v_rho_aa[P], Tp[P], 1, Up[P], 1);
+        parallel_timer_on("V_xc Hessian", rank);
+
+        RKSNuclearDensityDerivs d;
+        d.compute(primary_, block, pworker, gga);
+        int nrow = d.nrow;
+
+        double* rho_a = pworker->point_buffer()[XCValue::RHO_A];
+        double* v_rho = vals[XCValue::V_RHO_A];
+        double* v_rho_rho = vals[XCValue::V_RHO_A_RHO_A];
+        double* v_gamma = nullptr;
+        double* v_rho_gamma = nullptr;
+        double* v_gamma_gamma = nullptr;
+        double* rho_k[3] = {nullptr, nullptr, nullptr};
+        if (gga) {
+            v_gamma = vals[XCValue::V_GAMMA_AA];
+            v_rho_gamma = vals[XCValue::V_RHO_A_GAMMA_AA];
+            v_gamma_gamma = vals[XCValue::V_GAMMA_AA_GAMMA_AA];
+            rho_k[0] = pworker->point_buffer()[XCValue::RHO_AX];
+            rho_k[1] = pworker->point_buffer()[XCValue::RHO_AY];
+            rho_k[2] = pworker->point_buffer()[XCValue::RHO_AZ];
         }
 
-        // => LSDA Contribution <= //
+        double** phi_i[3] = {pworker->basis_value("PHI_X")->pointer(), pworker->basis_value("PHI_Y")->pointer(),
+                             pworker->basis_value("PHI_Z")->pointer()};
+        double** phi_ij[3][3];
+        phi_ij[0][0] = pworker->basis_value("PHI_XX")->pointer();
+        phi_ij[0][1] = phi_ij[1][0] = pworker->basis_value("PHI_XY")->pointer();
+        phi_ij[0][2] = phi_ij[2][0] = pworker->basis_value("PHI_XZ")->pointer();
+        phi_ij[1][1] = pworker->basis_value("PHI_YY")->pointer();
+        phi_ij[1][2] = phi_ij[2][1] = pworker->basis_value("PHI_YZ")->pointer();
+        phi_ij[2][2] = pworker->basis_value("PHI_ZZ")->pointer();
+        double** phi_ijk[10];
+        if (gga) {
+            for (int q = 0; q < 10; q++) phi_ijk[q] = pworker->basis_value(deriv3_keys[q])->pointer();
+        }
+        size_t coll_funcs = pworker->basis_value("PHI")->ncol();
+        double** Dp = pworker->D_scratch()[0]->pointer();
 
         /*
-         *                        m             n  ∂^2 F
-         *  H_mn <- 4 D_ab ɸ_a ɸ_b  D_cd ɸ_c ɸ_d   ------
-         *                                         ∂ ρ^2
+         * => Products of first-order densities <=
+         *
+         *  H_AB <- f_rr rho^A rho^B + f_rg (rho^A gamma^B + gamma^A rho^B) + f_gg gamma^A gamma^B
+         *          + 2 f_g d_k rho^A d_k rho^B
          */
+        std::vector<double> X(nrow * (size_t)npoints);
+        std::vector<double> Hloc(nrow * (size_t)nrow);
+        for (int row = 0; row < nrow; row++) {
+            for (int P = 0; P < npoints; P++) {
+                size_t rP = row * (size_t)npoints + P;
+                double f_rr = (rho_a[P] < v2_rho_cutoff_ ? 0.0 : v_rho_rho[P]);
+                X[rP] = w[P] * f_rr * d.rho[rP];
+                if (gga && rho_a[P] >= v2_rho_cutoff_) X[rP] += w[P] * v_rho_gamma[P] * d.gamma[rP];
+            }
+        }
+        C_DGEMM('N', 'T', nrow, nrow, npoints, 1.0, X.data(), npoints, d.rho.data(), npoints, 0.0, Hloc.data(),
+                nrow);
+        if (gga) {
+            for (int row = 0; row < nrow; row++) {
+                for (int P = 0; P < npoints; P++) {
+                    size_t rP = row * (size_t)npoints + P;
+                    X[rP] = 0.0;
+                    if (rho_a[P] >= v2_rho_cutoff_) {
+                        X[rP] = w[P] * (v_rho_gamma[P] * d.rho[rP] + v_gamma_gamma[P] * d.gamma[rP]);
+                    }
+                }
+            }
+            C_DGEMM('N', 'T', nrow, nrow, npoints, 1.0, X.data(), npoints, d.gamma.data(), npoints, 1.0,
+                    Hloc.data(), nrow);
+            for (int k = 0; k < 3; k++) {
+                for (int row = 0; row < nrow; row++) {
+                    for (int P = 0; P < npoints; P++) {
+                        size_t rP = row * (size_t)npoints + P;
+                        X[rP] = 2.0 * w[P] * v_gamma[P] * d.grad[k][rP];
+                    }
+                }
+                C_DGEMM('N', 'T', nrow, nrow, npoints, 1.0, X.data(), npoints, d.grad[k].data(), npoints, 1.0,
+                        Hloc.data(), nrow);
+            }
+        }
+        for (int a = 0; a < nrow; a++) {
+            int Ai = 3 * d.atoms[a / 3] + a % 3;
+            for (int b = 0; b < nrow; b++) {
+                Hp[Ai][3 * d.atoms[b / 3] + b % 3] += Hloc[a * (size_t)nrow + b];
+            }
+        }
 
-        // T = ɸ D
-        C_DGEMM('N', 'N', npoints, nlocal, nlocal, 1.0, phi[0], coll_funcs, Dp[0], max_functions, 0.0, Tp[0],
-                max_functions);
-
-        // Compute rho, to filter out small values
-        for (int P = 0; P < npoints; P++) {
-            double rho = C_DDOT(nlocal, phi[P], 1, Tp[P], 1);
-            if (std::fabs(rho) < 1E-8) {
-                v_rho_a[P] = 0.0;
-                v_rho_aa[P] = 0.0;
+        /*
+         * => Second-order densities <=
+         *
+         *  H_AB <- f_r rho^{AB} + 2 f_g d_k rho d_k rho^{AB}, with
+         *
+         *  rho^{AiBj}     = 4 d_AB sum_{m in A} phi_m,ij (phi D)_m + 4 sum_{m in A, n in B} phi_m,i D_mn phi_n,j
+         *  d_k rho^{AiBj} = 4 d_AB sum_{m in A} [phi_m,ijk (phi D)_m + phi_m,ij (phi_k D)_m]
+         *                   + 4 sum_{m in A, n in B} D_mn [phi_m,ik phi_n,j + phi_m,i phi_n,jk]
+         */
+        std::vector<double> v(npoints), u[3];
+        for (int P = 0; P < npoints; P++) v[P] = w[P] * v_rho[P];
+        if (gga) {
+            for (int k = 0; k < 3; k++) {
+                u[k].resize(npoints);
+                for (int P = 0; P < npoints; P++) u[k][P] = 2.0 * w[P] * v_gamma[P] * rho_k[k][P];
             }
-            //            outfile->Printf("%f %f %f\n", w[P], v_rho_a[P], v_rho_aa[P]);
         }
 
+        // One-center part, Z = v (phi D) + u_k (phi_k D)
+        std::vector<double> Z(npoints * (size_t)nlocal);
         for (int P = 0; P < npoints; P++) {
-            std::fill(Up[P], Up[P] + nlocal, 0.0);
-            C_DAXPY(nlocal, 4.0 * w[P] * v_rho_aa[P], Tp[P], 1, Up[P], 1);
+            for (int ml = 0; ml < nlocal; ml++) {
+                size_t Pm = P * (size_t)nlocal + ml;
+                Z[Pm] = v[P] * d.T[Pm];
+                if (gga) Z[Pm] += u[0][P] * d.Tk[0][Pm] + u[1][P] * d.Tk[1][Pm] + u[2][P] * d.Tk[2][Pm];
+            }
         }
-
         for (int ml = 0; ml < nlocal; ml++) {
-            pTx[ml] = C_DDOT(npoints, &Tp[0][ml], max_functions, &phi_x[0][ml], coll_funcs);
-            pTy[ml] = C_DDOT(npoints, &Tp[0][ml], max_functions, &phi_y[0][ml], coll_funcs);
-            pTz[ml] = C_DDOT(npoints, &Tp[0][ml], max_functions, &phi_z[0][ml], coll_funcs);
+            int A = d.atoms[d.func_atom[ml]];
+            for (int i = 0; i < 3; i++) {
+                for (int j = i; j < 3; j++) {
+                    double val = 0.0;
+                    for (int P = 0; P < npoints; P++) {
+                        size_t Pm = P * (size_t)nlocal + ml;
+                        val += phi_ij[i][j][P][ml] * Z[Pm];
+                        if (gga) {
+                            for (int k = 0; k < 3; k++) {
+                                val += u[k][P] * d.T[Pm] * phi_ijk[deriv3_index[i][j][k]][P][ml];
+                            }
+                        }
+                    }
+                    Hp[3 * A + i][3 * A + j] += 4.0 * val;
+                    if (i != j) Hp[3 * A + j][3 * A + i] += 4.0 * val;
+                }
+            }
         }
 
-        for (int ml = 0; ml < nlocal; ml++) {
-            int A = primary_->function_to_center(function_map[ml]);
-            double mx = C_DDOT(npoints, &Up[0][ml], max_functions, &phi_x[0][ml], coll_funcs);
-            double my = C_DDOT(npoints, &Up[0][ml], max_functions, &phi_y[0][ml], coll_funcs);
-            double mz = C_DDOT(npoints, &Up[0][ml], max_functions, &phi_z[0][ml], coll_funcs);
-            for (int nl = 0; nl < nlocal; nl++) {
-                int B = primary_->function_to_center(function_map[nl]);
-                Hp[3 * A + 0][3 * B + 0] += mx * pTx[nl];
-                Hp[3 * A + 0][3 * B + 1] += mx * pTy[nl];
-                Hp[3 * A + 0][3 * B + 2] += mx * pTz[nl];
-                Hp[3 * A + 1][3 * B + 0] += my * pTx[nl];
-                Hp[3 * A + 1][3 * B + 1] += my * pTy[nl];
-                Hp[3 * A + 1][3 * B + 2] += my * pTz[nl];
-                Hp[3 * A + 2][3 * B + 0] += mz * pTx[nl];
-                Hp[3 * A + 2][3 * B + 1] += mz * pTy[nl];
-                Hp[3 * A + 2][3 * B + 2] += mz * pTz[nl];
+        // Two-center part, M^ij = G^i^T phi_j + phi_i^T U^j with G^i = v phi_i + U^i and U^i = u_k phi_ik
+        std::vector<double> G[3], U[3];
+        for (int i = 0; i < 3; i++) {
+            G[i].resize(npoints * (size_t)nlocal);
+            if (gga) U[i].assign(npoints * (size_t)nlocal, 0.0);
+            for (int P = 0; P < npoints; P++) {
+                for (int ml = 0; ml < nlocal; ml++) {
+                    size_t Pm = P * (size_t)nlocal + ml;
+                    double Uval = 0.0;
+                    if (gga) {
+                        Uval = u[0][P] * phi_ij[i][0][P][ml] + u[1][P] * phi_ij[i][1][P][ml] +
+                               u[2][P] * phi_ij[i][2][P][ml];
+                        U[i][Pm] = Uval;
+                    }
+                    G[i][Pm] = v[P] * phi_i[i][P][ml] + Uval;
+                }
+            }
+        }
+        std::vector<double> M(nlocal * (size_t)nlocal);
+        for (int i = 0; i < 3; i++) {
+            for (int j = i; j < 3; j++) {
+                C_DGEMM('T', 'N', nlocal, nlocal, npoints, 1.0, G[i].data(), nlocal, phi_i[j][0], coll_funcs, 0.0,
+                        M.data(), nlocal);
+                if (gga) {
+                    C_DGEMM('T', 'N', nlocal, nlocal, npoints, 1.0, phi_i[i][0], coll_funcs, U[j].data(), nlocal,
+                            1.0, M.data(), nlocal);
+                }
+                for (int ml = 0; ml < nlocal; ml++) {
+                    int A = d.atoms[d.func_atom[ml]];
+                    for (int nl = 0; nl < nlocal; nl++) {
+                        int B = d.atoms[d.func_atom[nl]];
+                        double val = 4.0 * Dp[ml][nl] * M[ml * (size_t)nlocal + nl];
+                        Hp[3 * A + i][3 * B + j] += val;
+                        if (i != j) Hp[3 * B + j][3 * A + i] += val;
+                    }
+                }
             }
         }
 
-        /*
-         *                        mn  ∂ F
-         *  H_mn <- 2 D_ab ɸ_a ɸ_b    ---
-         *                            ∂ ρ
-         */
-        for (int P = 0; P < npoints; P++) {
-            std::fill(Up[P], Up[P] + nlocal, 0.0);
-            C_DAXPY(nlocal, 2.0 * w[P] * v_rho_a[P], Tp[P], 1, Up[P], 1);
+        parallel_timer_off("V_xc Hessian", rank);
+    }
+
+    // Sum up the matrix
+    auto H = std::make_shared<Matrix>("XC Hessian", 3 * natom, 3 * natom);
+    for (auto const& val : H_local) {
+        H->add(val);
+    }
+    H->hermitivitize();
+
+    // Reset the workers
+    for (size_t i = 0; i < num_threads_; i++) {
+        point_workers_[i]->set_deriv(old_point_deriv);
+        functional_workers_[i]->set_deriv(old_func_deriv);
+        functional_workers_[i]->allocate();
+    }
+
+    timer_off("RV: Form Hessian");
+    return H;
+}
+
+std::vector<SharedMatrix> RV::compute_fock_derivatives(int first, int count) {
+    if (functional_->is_meta())
+        throw PSIEXCEPTION("V: RKS Fock derivatives are not yet implemented for meta GGA functionals.");
+
+    if ((D_AO_.size() != 1)) throw PSIEXCEPTION("V: RKS should have only one D Matrix");
+
+    if (functional_->needs_vv10()) {
+        throw PSIEXCEPTION("V: RKS cannot compute VV10 Fock derivative contribution.");
+    }
+
+    timer_on("RV: Form Fock Derivatives");
+
+    int natom = primary_->molecule()->natom();
+    bool gga = functional_->is_gga();
+
+    // Thread info
+    int rank = 0;
+
+    int old_point_deriv = point_workers_[0]->deriv();
+    int old_func_deriv = functional_->deriv();
+    for (size_t i = 0; i < num_threads_; i++) {
+        point_workers_[i]->set_pointers(D_AO_[0]);
+        point_workers_[i]->set_deriv(gga ? 2 : 1);
+        functional_workers_[i]->set_deriv(2);
+        functional_workers_[i]->allocate();
+    }
+
+    if (first < 0 || count < 0 || first + count > 3 * natom)
+        throw PSIEXCEPTION("V: RKS Fock derivative range is out of bounds.");
+
+    // Only the requested perturbations are held, so callers can batch over atoms
+    std::vector<SharedMatrix> Vx;
+    for (int A = first; A < first + count; A++) {
+        std::stringstream ss;
+        ss << "V_xc^" << A;
+        Vx.push_back(std::make_shared<Matrix>(ss.str(), nbf_, nbf_));
+    }
+
+    // Atoms with at least one requested coordinate
+    std::vector<bool> atom_requested(natom, false);
+    for (int A = first; A < first + count; A++) atom_requested[A / 3] = true;
+
+    const std::vector<std::shared_ptr<BlockOPoints>>& blocks = grid_->blocks();
+
+// Traverse the blocks of points
+#pragma omp parallel for private(rank) schedule(dynamic) num_threads(num_threads_)
+    for (size_t Q = 0; Q < blocks.size(); Q++) {
+// Get thread info
+#ifdef _OPENMP
+        rank = omp_get_thread_num();
+#endif
+
+        std::shared_ptr<SuperFunctional> fworker = functional_workers_[rank];
+        std::shared_ptr<PointFunctions> pworker = point_workers_[rank];
+
+        std::shared_ptr<BlockOPoints> block = blocks[Q];
+        int npoints = block->npoints();
+        double* w = block->w();
+        const std::vector<int>& function_map = block->functions_local_to_global();
+        int nlocal = function_map.size();
+
+        // Only blocks carrying a function on a requested atom contribute
+        bool needed = false;
+        for (int ml = 0; ml < nlocal && !needed; ml++) {
+            needed = atom_requested[primary_->function_to_center(function_map[ml])];
         }
-        for (int ml = 0; ml < nlocal; ml++) {
-            int A = primary_->function_to_center(function_map[ml]);
-            double Txx = C_DDOT(npoints, &Up[0][ml], max_functions, &phi_xx[0][ml], coll_funcs);
-            double Txy = C_DDOT(npoints, &Up[0][ml], max_functions, &phi_xy[0][ml], coll_funcs);
-            double Txz = C_DDOT(npoints, &Up[0][ml], max_functions, &phi_xz[0][ml], coll_funcs);
-            double Tyy = C_DDOT(npoints, &Up[0][ml], max_functions, &phi_yy[0][ml], coll_funcs);
-            double Tyz = C_DDOT(npoints, &Up[0][ml], max_functions, &phi_yz[0][ml], coll_funcs);
-            double Tzz = C_DDOT(npoints, &Up[0][ml], max_functions, &phi_zz[0][ml], coll_funcs);
-            Hp[3 * A + 0][3 * A + 0] += Txx;
-            Hp[3 * A + 0][3 * A + 1] += Txy;
-            Hp[3 * A + 0][3 * A + 2] += Txz;
-            Hp[3 * A + 1][3 * A + 0] += Txy;
-            Hp[3 * A + 1][3 * A + 1] += Tyy;
-            Hp[3 * A + 1][3 * A + 2] += Tyz;
-            Hp[3 * A + 2][3 * A + 0] += Txz;
-            Hp[3 * A + 2][3 * A + 1] += Tyz;
-            Hp[3 * A + 2][3 * A + 2] += Tzz;
+        if (!needed) continue;
+
+        parallel_timer_on("Properties", rank);
+        pworker->compute_points(block, true);
+        parallel_timer_off("Properties", rank);
+
+        parallel_timer_on("Functional", rank);
+        const XCBuffer& vals = fworker->compute_functional(pworker->point_buffer(), npoints);
+        parallel_timer_off("Functional", rank);
+
+        parallel_timer_on("V_xc derivatives", rank);
+
+        RKSNuclearDensityDerivs d;
+        d.compute(primary_, block, pworker, gga);
+        int nrow = d.nrow;
+
+        double* rho_a = pworker->point_buffer()[XCValue::RHO_A];
+        double* v_rho = vals[XCValue::V_RHO_A];
+        double* v_rho_rho = vals[XCValue::V_RHO_A_RHO_A];
+        double* v_gamma = nullptr;
+        double* v_rho_gamma = nullptr;
+        double* v_gamma_gamma = nullptr;
+        double* rho_k[3] = {nullptr, nullptr, nullptr};
+        if (gga) {
+            v_gamma = vals[XCValue::V_GAMMA_AA];
+            v_rho_gamma = vals[XCValue::V_RHO_A_GAMMA_AA];
+            v_gamma_gamma = vals[XCValue::V_GAMMA_AA_GAMMA_AA];
+            rho_k[0] = pworker->point_buffer()[XCValue::RHO_AX];
+            rho_k[1] = pworker->point_buffer()[XCValue::RHO_AY];
+            rho_k[2] = pworker->point_buffer()[XCValue::RHO_AZ];
         }
 
+        double** phi = pworker->basis_value("PHI")->pointer();
+        double** phi_i[3] = {pworker->basis_value("PHI_X")->pointer(), pworker->basis_value("PHI_Y")->pointer(),
+                             pworker->basis_value("PHI_Z")->pointer()};
+        double** phi_ij[3][3];
+        if (gga) {
+            phi_ij[0][0] = pworker->basis_value("PHI_XX")->pointer();
+            phi_ij[0][1] = phi_ij[1][0] = pworker->basis_value("PHI_XY")->pointer();
+            phi_ij[0][2] = phi_ij[2][0] = pworker->basis_value("PHI_XZ")->pointer();
+            phi_ij[1][1] = pworker->basis_value("PHI_YY")->pointer();
+            phi_ij[1][2] = phi_ij[2][1] = pworker->basis_value("PHI_YZ")->pointer();
+            phi_ij[2][2] = pworker->basis_value("PHI_ZZ")->pointer();
+        }
+        size_t coll_funcs = pworker->basis_value("PHI")->ncol();
+
         /*
-         *                    m    n  ∂ F
-         *  H_mn <- 2 D_ab ɸ_a  ɸ_b   ---
-         *                            ∂ ρ
+         * => Basis function derivatives <=
+         *
+         *  V^{Ai}_mn <- -[phi_m,i X_n + Y^i_m phi_n] - (m <-> n), for m (resp. n) on A
+         *
+         *  X_n = f_r phi_n + 2 f_g d_k rho phi_n,k     Y^i_m = 2 f_g d_k rho phi_m,ik
          */
-        // T = ɸ_x D
-        C_DGEMM('N', 'N', npoints, nlocal, nlocal, 1.0, phi_x[0], coll_funcs, Dp[0], max_functions, 0.0, pTx2[0],
-                max_functions);
-        C_DGEMM('N', 'N', npoints, nlocal, nlocal, 1.0, phi_y[0], coll_funcs, Dp[0], max_functions, 0.0, pTy2[0],
-                max_functions);
-        C_DGEMM('N', 'N', npoints, nlocal, nlocal, 1.0, phi_z[0], coll_funcs, Dp[0], max_functions, 0.0, pTz2[0],
-                max_functions);
-        // x derivatives
-        for (int P = 0; P < npoints; P++) {
-            std::fill(Up[P], Up[P] + nlocal, 0.0);
-            C_DAXPY(nlocal, 2.0 * w[P] * v_rho_a[P], pTx2[P], 1, Up[P], 1);
-        }
-        for (int ml = 0; ml < nlocal; ml++) {
-            int A = primary_->function_to_center(function_map[ml]);
-            Hp[3 * A + 0][3 * A + 0] += C_DDOT(npoints, &pTx2[0][ml], max_functions, &Up[0][ml], max_functions);
-            Hp[3 * A + 0][3 * A + 1] += C_DDOT(npoints, &pTy2[0][ml], max_functions, &Up[0][ml], max_functions);
-            Hp[3 * A + 0][3 * A + 2] += C_DDOT(npoints, &pTz2[0][ml], max_functions, &Up[0][ml], max_functions);
-        }
-        // y derivatives
+        std::vector<double> Xw(npoints * (size_t)nlocal), Yw(npoints * (size_t)nlocal);
         for (int P = 0; P < npoints; P++) {
-            std::fill(Up[P], Up[P] + nlocal, 0.0);
-            C_DAXPY(nlocal, 2.0 * w[P] * v_rho_a[P], pTy2[P], 1, Up[P], 1);
-        }
-        for (int ml = 0; ml < nlocal; ml++) {
-            int A = primary_->function_to_center(function_map[ml]);
-            Hp[3 * A + 1][3 * A + 0] += C_DDOT(npoints, &pTx2[0][ml], max_functions, &Up[0][ml], max_functions);
-            Hp[3 * A + 1][3 * A + 1] += C_DDOT(npoints, &pTy2[0][ml], max_functions, &Up[0][ml], max_functions);
-            Hp[3 * A + 1][3 * A + 2] += C_DDOT(npoints, &pTz2[0][ml], max_functions, &Up[0][ml], max_functions);
+            for (int ml = 0; ml < nlocal; ml++) {
+                double val = v_rho[P] * phi[P][ml];
+                if (gga) {
+                    val += 2.0 * v_gamma[P] *
+                           (rho_k[0][P] * phi_i[0][P][ml] + rho_k[1][P] * phi_i[1][P][ml] +
+                            rho_k[2][P] * phi_i[2][P][ml]);
+                }
+                Xw[P * (size_t)nlocal + ml] = w[P] * val;
+            }
         }
-        // x derivatives
-        for (int P = 0; P < npoints; P++) {
-            std::fill(Up[P], Up[P] + nlocal, 0.0);
-            C_DAXPY(nlocal, 2.0 * w[P] * v_rho_a[P], pTz2[P], 1, Up[P], 1);
+        std::vector<double> Qi[3];
+        for (int i = 0; i < 3; i++) {
+            Qi[i].resize(nlocal * (size_t)nlocal);
+            C_DGEMM('T', 'N', nlocal, nlocal, npoints, 1.0, phi_i[i][0], coll_funcs, Xw.data(), nlocal, 0.0,
+                    Qi[i].data(), nlocal);
+            if (gga) {
+                for (int P = 0; P < npoints; P++) {
+                    for (int ml = 0; ml < nlocal; ml++) {
+                        Yw[P * (size_t)nlocal + ml] =
+                            2.0 * w[P] * v_gamma[P] *
+                            (rho_k[0][P] * phi_ij[i][0][P][ml] + rho_k[1][P] * phi_ij[i][1][P][ml] +
+                             rho_k[2][P] * phi_ij[i][2][P][ml]);
+                    }
+                }
+                C_DGEMM('T', 'N', nlocal, nlocal, npoints, 1.0, Yw.data(), nlocal, phi[0], coll_funcs, 1.0,
+                        Qi[i].data(), nlocal);
+            }
         }
-        for (int ml = 0; ml < nlocal; ml++) {
-            int A = primary_->function_to_center(function_map[ml]);
-            Hp[3 * A + 2][3 * A + 0] += C_DDOT(npoints, &pTx2[0][ml], max_functions, &Up[0][ml], max_functions);
-            Hp[3 * A + 2][3 * A + 1] += C_DDOT(npoints, &pTy2[0][ml], max_functions, &Up[0][ml], max_functions);
-            Hp[3 * A + 2][3 * A + 2] += C_DDOT(npoints, &pTz2[0][ml], max_functions, &Up[0][ml], max_functions);
+
+        /*
+         * => Density response to the basis function derivatives <=
+         *
+         *  V^{Ai}_mn <- s phi_m phi_n + 2 t_k d_k (phi_m phi_n)
+         *
+         *  s = f_rr rho^{Ai} + f_rg gamma^{Ai}     t_k = (f_rg rho^{Ai} + f_gg gamma^{Ai}) d_k rho + f_g d_k rho^{Ai}
+         */
+        std::vector<double> Tw(npoints * (size_t)nlocal);
+        std::vector<double> Vloc(nlocal * (size_t)nlocal);
+        for (int row = 0; row < nrow; row++) {
+            int a = row / 3;
+            int i = row % 3;
+            int pert = 3 * d.atoms[a] + i;
+            if (pert < first || pert >= first + count) continue;
+            for (int P = 0; P < npoints; P++) {
+                size_t rP = row * (size_t)npoints + P;
+                bool v2 = rho_a[P] >= v2_rho_cutoff_;
+                double s = (v2 ? v_rho_rho[P] * d.rho[rP] : 0.0);
+                double* Twp = &Tw[P * (size_t)nlocal];
+                if (gga) {
+                    double t_r = 0.0;
+                    if (v2) {
+                        s += v_rho_gamma[P] * d.gamma[rP];
+                        t_r = v_rho_gamma[P] * d.rho[rP] + v_gamma_gamma[P] * d.gamma[rP];
+                    }
+                    double t[3];
+                    for (int k = 0; k < 3; k++) t[k] = t_r * rho_k[k][P] + v_gamma[P] * d.grad[k][rP];
+                    for (int ml = 0; ml < nlocal; ml++) {
+                        Twp[ml] = w[P] * (0.5 * s * phi[P][ml] +
+                                          2.0 * (t[0] * phi_i[0][P][ml] + t[1] * phi_i[1][P][ml] +
+                                                 t[2] * phi_i[2][P][ml]));
+                    }
+                } else {
+                    for (int ml = 0; ml < nlocal; ml++) Twp[ml] = 0.5 * w[P] * s * phi[P][ml];
+                }
+            }
+            C_DGEMM('T', 'N', nlocal, nlocal, npoints, 1.0, phi[0], coll_funcs, Tw.data(), nlocal, 0.0, Vloc.data(),
+                    nlocal);
+
+            // Symmetrize, then remove the basis function derivative rows owned by this atom
+            for (int ml = 0; ml < nlocal; ml++) {
+                for (int nl = 0; nl <= ml; nl++) {
+                    double val = Vloc[ml * (size_t)nlocal + nl] + Vloc[nl * (size_t)nlocal + ml];
+                    Vloc[ml * (size_t)nlocal + nl] = Vloc[nl * (size_t)nlocal + ml] = val;
+                }
+            }
+            for (int ml = 0; ml < nlocal; ml++) {
+                if (d.func_atom[ml] != a) continue;
+                for (int nl = 0; nl < nlocal; nl++) {
+                    double val = Qi[i][ml * (size_t)nlocal + nl];
+                    Vloc[ml * (size_t)nlocal + nl] -= val;
+                    Vloc[nl * (size_t)nlocal + ml] -= val;
+                }
+            }
+
+            // => Unpacking <= //
+            double** Vxp = Vx[pert - first]->pointer();
+            for (int ml = 0; ml < nlocal; ml++) {
+                int mg = function_map[ml];
+                for (int nl = 0; nl < nlocal; nl++) {
+                    int ng = function_map[nl];
+#pragma omp atomic update
+                    Vxp[mg][ng] += Vloc[ml * (size_t)nlocal + nl];
+                }
+            }
         }
-    }
 
-    if (debug_) {
-        outfile->Printf("   => XC Hessian: Numerical Integrals <=\n\n");
-        outfile->Printf("    Functional Value:  %24.16E\n", quad_values_["FUNCTIONAL"]);
-        outfile->Printf("    <\\rho_a>        :  %24.16E\n", quad_values_["RHO_A"]);
-        outfile->Printf("    <\\rho_b>        :  %24.16E\n", quad_values_["RHO_B"]);
-        outfile->Printf("    <\\vec r\\rho_a>  : <%24.16E,%24.16E,%24.16E>\n", quad_values_["RHO_AX"],
-                        quad_values_["RHO_AY"], quad_values_["RHO_AZ"]);
-        outfile->Printf("    <\\vec r\\rho_b>  : <%24.16E,%24.16E,%24.16E>\n\n", quad_values_["RHO_BX"],
-                        quad_values_["RHO_BY"], quad_values_["RHO_BZ"]);
+        parallel_timer_off("V_xc derivatives", rank);
     }
 
+    // Reset the workers
     for (size_t i = 0; i < num_threads_; i++) {
-        point_workers_[i]->set_deriv(old_deriv);
+        point_workers_[i]->set_deriv(old_point_deriv);
+        functional_workers_[i]->set_deriv(old_func_deriv);
+        functional_workers_[i]->allocate();
     }
-    functional_->set_deriv(old_func_deriv);
 
-    // RKS
-    H->scale(2.0);
-    H->hermitivitize();
-
-    return H;
+    timer_off("RV: Form Fock Derivatives");
+    return Vx;
 }
 
 UV::UV(std::shared_ptr<SuperFunctional> functional, std::shared_ptr<BasisSet> primary, Options& options)
@@ -1457,7 +1874,7 @@ void UV::compute_V(std::vector<SharedMatrix> ret) {
         parallel_timer_off("Properties", rank);
 
         parallel_timer_on("Functional", rank);
-        std::map<std::string, SharedVector>& vals = fworker->compute_functional(pworker->point_values(), npoints);
+        const XCBuffer& vals = fworker->compute_functional(pworker->point_buffer(), npoints);
         parallel_timer_off("Functional", rank);
 
         if (debug_ > 3) {
@@ -1467,11 +1884,11 @@ void UV::compute_V(std::vector<SharedMatrix> ret) {
 
         parallel_timer_on("V_xc", rank);
         double** phi = pworker->basis_value("PHI")->pointer();
-        double* rho_a = pworker->point_value("RHO_A")->pointer();
-        double* rho_b = pworker->point_value("RHO_B")->pointer();
-        double* zk = vals["V"]->pointer();
-        double* v_rho_a = vals["V_RHO_A"]->pointer();
-        double* v_rho_b = vals["V_RHO_B"]->pointer();
+        double* rho_a = pworker->point_buffer()[XCValue::RHO_A];
+        double* rho_b = pworker->point_buffer()[XCValue::RHO_B];
+        double* zk = vals[XCValue::V];
+        double* v_rho_a = vals[XCValue::V_RHO_A];
+        double* v_rho_b = vals[XCValue::V_RHO_B];
         size_t coll_funcs = pworker->basis_value("PHI")->ncol();
 
         // => Quadrature values <= //
@@ -1505,15 +1922,15 @@ void UV::compute_V(std::vector<SharedMatrix> ret) {
             double** phix = pworker->basis_value("PHI_X")->pointer();
             double** phiy = pworker->basis_value("PHI_Y")->pointer();
             double** phiz = pworker->basis_value("PHI_Z")->pointer();
-            double* rho_ax = pworker->point_value("RHO_AX")->pointer();
-            double* rho_ay = pworker->point_value("RHO_AY")->pointer();
-            double* rho_az = pworker->point_value("RHO_AZ")->pointer();
-            double* rho_bx = pworker->point_value("RHO_BX")->pointer();
-            double* rho_by = pworker->point_value("RHO_BY")->pointer();
-            double* rho_bz = pworker->point_value("RHO_BZ")->pointer();
-            double* v_sigma_aa = vals["V_GAMMA_AA"]->pointer();
-            double* v_sigma_ab = vals["V_GAMMA_AB"]->pointer();
-            double* v_sigma_bb = vals["V_GAMMA_BB"]->pointer();
+            double* rho_ax = pworker->point_buffer()[XCValue::RHO_AX];
+            double* rho_ay = pworker->point_buffer()[XCValue::RHO_AY];
+            double* rho_az = pworker->point_buffer()[XCValue::RHO_AZ];
+            double* rho_bx = pworker->point_buffer()[XCValue::RHO_BX];
+            double* rho_by = pworker->point_buffer()[XCValue::RHO_BY];
+            double* rho_bz = pworker->point_buffer()[XCValue::RHO_BZ];
+            double* v_sigma_aa = vals[XCValue::V_GAMMA_AA];
+            double* v_sigma_ab = vals[XCValue::V_GAMMA_AB];
+            double* v_sigma_bb = vals[XCValue::V_GAMMA_BB];
 
             for (int P = 0; P < npoints; P++) {
                 C_DAXPY(nlocal, w[P] * (2.0 * v_sigma_aa[P] * rho_ax[P] + v_sigma_ab[P] * rho_bx[P]), phix[P], 1,
@@ -1554,8 +1971,8 @@ void UV::compute_V(std::vector<SharedMatrix> ret) {
             double** phix = pworker->basis_value("PHI_X")->pointer();
             double** phiy = pworker->basis_value("PHI_Y")->pointer();
             double** phiz = pworker->basis_value("PHI_Z")->pointer();
-            double* v_tau_a = vals["V_TAU_A"]->pointer();
-            double* v_tau_b = vals["V_TAU_B"]->pointer();
+            double* v_tau_a = vals[XCValue::V_TAU_A];
+            double* v_tau_b = vals[XCValue::V_TAU_B];
 
             double** phi[3];
             phi[0] = phix;
@@ -1779,17 +2196,17 @@ void UV::compute_Vx(std::vector<SharedMatrix> Dx, std::vector<SharedMatrix> ret)
 
         // Compute functional values
         parallel_timer_on("Functional", rank);
-        std::map<std::string, SharedVector>& vals = fworker->compute_functional(pworker->point_values(), npoints);
+        const XCBuffer& vals = fworker->compute_functional(pworker->point_buffer(), npoints);
         parallel_timer_off("Functional", rank);
 
         // => Grab quantities <= //
         // LDA
         double** phi = pworker->basis_value("PHI")->pointer();
-        double* rho_a = pworker->point_value("RHO_A")->pointer();
-        double* rho_b = pworker->point_value("RHO_B")->pointer();
-        double* v2_rho2_aa = vals["V_RHO_A_RHO_A"]->pointer();
-        double* v2_rho2_ab = vals["V_RHO_A_RHO_B"]->pointer();
-        double* v2_rho2_bb = vals["V_RHO_B_RHO_B"]->pointer();
+        double* rho_a = pworker->point_buffer()[XCValue::RHO_A];
+        double* rho_b = pworker->point_buffer()[XCValue::RHO_B];
+        double* v2_rho2_aa = vals[XCValue::V_RHO_A_RHO_A];
+        double* v2_rho2_ab = vals[XCValue::V_RHO_A_RHO_B];
+        double* v2_rho2_bb = vals[XCValue::V_RHO_B_RHO_B];
         size_t coll_funcs = pworker->basis_value("PHI")->ncol();
 
         double* rho_ak = R_rho_ak[rank]->pointer();
@@ -1819,18 +2236,18 @@ void UV::compute_Vx(std::vector<SharedMatrix> Dx, std::vector<SharedMatrix> ret)
             rho_ak_y = R_rho_ak_y[rank]->pointer();
             rho_ak_z = R_rho_ak_z[rank]->pointer();
             gamma_aak = R_gamma_ak[rank]->pointer();
-            rho_ax = pworker->point_value("RHO_AX")->pointer();
-            rho_ay = pworker->point_value("RHO_AY")->pointer();
-            rho_az = pworker->point_value("RHO_AZ")->pointer();
+            rho_ax = pworker->point_buffer()[XCValue::RHO_AX];
+            rho_ay = pworker->point_buffer()[XCValue::RHO_AY];
+            rho_az = pworker->point_buffer()[XCValue::RHO_AZ];
 
             // Beta
             rho_bk_x = R_rho_bk_x[rank]->pointer();
             rho_bk_y = R_rho_bk_y[rank]->pointer();
             rho_bk_z = R_rho_bk_z[rank]->pointer();
             gamma_bbk = R_gamma_bk[rank]->pointer();
-            rho_bx = pworker->point_value("RHO_AX")->pointer();
-            rho_by = pworker->point_value("RHO_AY")->pointer();
-            rho_bz = pworker->point_value("RHO_AZ")->pointer();
+            rho_bx = pworker->point_buffer()[XCValue::RHO_AX];
+            rho_by = pworker->point_buffer()[XCValue::RHO_AY];
+            rho_bz = pworker->point_buffer()[XCValue::RHO_AZ];
 
             gamma_abk = R_gamma_abk[rank]->pointer();
         }
@@ -1926,27 +2343,27 @@ void UV::compute_Vx(std::vector<SharedMatrix> Dx, std::vector<SharedMatrix> ret)
 
             // // => GGA contribution <= //
             if (ansatz >= 1) {
-                double* gamma_aa = pworker->point_value("GAMMA_AA")->pointer();
-                double* gamma_ab = pworker->point_value("GAMMA_AB")->pointer();
-                double* gamma_bb = pworker->point_value("GAMMA_BB")->pointer();
-
-                double* v_gamma_aa = vals["V_GAMMA_AA"]->pointer();
-                double* v_gamma_ab = vals["V_GAMMA_AB"]->pointer();
-                double* v_gamma_bb = vals["V_GAMMA_BB"]->pointer();
-
-                double* v2_gamma_aa_gamma_aa = vals["V_GAMMA_AA_GAMMA_AA"]->pointer();
-                double* v2_gamma_aa_gamma_ab = vals["V_GAMMA_AA_GAMMA_AB"]->pointer();
-                double* v2_gamma_aa_gamma_bb = vals["V_GAMMA_AA_GAMMA_BB"]->pointer();
-                double* v2_gamma_ab_gamma_ab = vals["V_GAMMA_AB_GAMMA_AB"]->pointer();
-                double* v2_gamma_ab_gamma_bb = vals["V_GAMMA_AB_GAMMA_BB"]->pointer();
-                double* v2_gamma_bb_gamma_bb = vals["V_GAMMA_BB_GAMMA_BB"]->pointer();
-
-                double* v2_rho_a_gamma_aa = vals["V_RHO_A_GAMMA_AA"]->pointer();
-                double* v2_rho_a_gamma_ab = vals["V_RHO_A_GAMMA_AB"]->pointer();
-                double* v2_rho_a_gamma_bb = vals["V_RHO_A_GAMMA_BB"]->pointer();
-                double* v2_rho_b_gamma_aa = vals["V_RHO_B_GAMMA_AA"]->pointer();
-                double* v2_rho_b_gamma_ab = vals["V_RHO_B_GAMMA_AB"]->pointer();
-                double* v2_rho_b_gamma_bb = vals["V_RHO_B_GAMMA_BB"]->pointer();
+                double* gamma_aa = pworker->point_buffer()[XCValue::GAMMA_AA];
+                double* gamma_ab = pworker->point_buffer()[XCValue::GAMMA_AB];
+                double* gamma_bb = pworker->point_buffer()[XCValue::GAMMA_BB];
+
+                double* v_gamma_aa = vals[XCValue::V_GAMMA_AA];
+                double* v_gamma_ab = vals[XCValue::V_GAMMA_AB];
+                double* v_gamma_bb = vals[XCValue::V_GAMMA_BB];
+
+                double* v2_gamma_aa_gamma_aa = vals[XCValue::V_GAMMA_AA_GAMMA_AA];
+                double* v2_gamma_aa_gamma_ab = vals[XCValue::V_GAMMA_AA_GAMMA_AB];
+                double* v2_gamma_aa_gamma_bb = vals[XCValue::V_GAMMA_AA_GAMMA_BB];
+                double* v2_gamma_ab_gamma_ab = vals[XCValue::V_GAMMA_AB_GAMMA_AB];
+                double* v2_gamma_ab_gamma_bb = vals[XCValue::V_GAMMA_AB_GAMMA_BB];
+                double* v2_gamma_bb_gamma_bb = vals[XCValue::V_GAMMA_BB_GAMMA_BB];
+
+                double* v2_rho_a_gamma_aa = vals[XCValue::V_RHO_A_GAMMA_AA];
+                double* v2_rho_a_gamma_ab = vals[XCValue::V_RHO_A_GAMMA_AB];
+                double* v2_rho_a_gamma_bb = vals[XCValue::V_RHO_A_GAMMA_BB];
+                double* v2_rho_b_gamma_aa = vals[XCValue::V_RHO_B_GAMMA_AA];
+                double* v2_rho_b_gamma_ab = vals[XCValue::V_RHO_B_GAMMA_AB];
+                double* v2_rho_b_gamma_bb = vals[XCValue::V_RHO_B_GAMMA_BB];
 
                 double tmp_val = 0.0, v2_val_aa = 0.0, v2_val_ab = 0.0, v2_val_bb = 0.0;
 
@@ -2214,7 +2631,7 @@ SharedMatrix UV::compute_gradient() {
         parallel_timer_off("Properties", rank);
 
         parallel_timer_on("Functional", rank);
-        std::map<std::string, SharedVector>& vals = fworker->compute_functional(pworker->point_values(), npoints);
+        const XCBuffer& vals = fworker->compute_functional(pworker->point_buffer(), npoints);
         parallel_timer_off("Functional", rank);
 
         // More pointers
@@ -2223,11 +2640,11 @@ SharedMatrix UV::compute_gradient() {
         double** phi_x = pworker->basis_value("PHI_X")->pointer();
         double** phi_y = pworker->basis_value("PHI_Y")->pointer();
         double** phi_z = pworker->basis_value("PHI_Z")->pointer();
-        double* rho_a = pworker->point_value("RHO_A")->pointer();
-        double* rho_b = pworker->point_value("RHO_B")->pointer();
-        double* zk = vals["V"]->pointer();
-        double* v_rho_a = vals["V_RHO_A"]->pointer();
-        double* v_rho_b = vals["V_RHO_B"]->pointer();
+        double* rho_a = pworker->point_buffer()[XCValue::RHO_A];
+        double* rho_b = pworker->point_buffer()[XCValue::RHO_B];
+        double* zk = vals[XCValue::V];
+        double* v_rho_a = vals[XCValue::V_RHO_A];
+        double* v_rho_b = vals[XCValue::V_RHO_B];
         size_t coll_funcs = pworker->basis_value("PHI")->ncol();
 
         // => Quadrature values <= //
@@ -2257,15 +2674,15 @@ SharedMatrix UV::compute_gradient() {
 
         // => GGA Contribution (Term 1) <= //
         if (fworker->is_gga()) {
-            double* rho_ax = pworker->point_value("RHO_AX")->pointer();
-            double* rho_ay = pworker->point_value("RHO_AY")->pointer();
-            double* rho_az = pworker->point_value("RHO_AZ")->pointer();
-            double* rho_bx = pworker->point_value("RHO_BX")->pointer();
-            double* rho_by = pworker->point_value("RHO_BY")->pointer();
-            double* rho_bz = pworker->point_value("RHO_BZ")->pointer();
-            double* v_gamma_aa = vals["V_GAMMA_AA"]->pointer();
-            double* v_gamma_ab = vals["V_GAMMA_AB"]->pointer();
-            double* v_gamma_bb = vals["V_GAMMA_BB"]->pointer();
+            double* rho_ax = pworker->point_buffer()[XCValue::RHO_AX];
+            double* rho_ay = pworker->point_buffer()[XCValue::RHO_AY];
+            double* rho_az = pworker->point_buffer()[XCValue::RHO_AZ];
+            double* rho_bx = pworker->point_buffer()[XCValue::RHO_BX];
+            double* rho_by = pworker->point_buffer()[XCValue::RHO_BY];
+            double* rho_bz = pworker->point_buffer()[XCValue::RHO_BZ];
+            double* v_gamma_aa = vals[XCValue::V_GAMMA_AA];
+            double* v_gamma_ab = vals[XCValue::V_GAMMA_AB];
+            double* v_gamma_bb = vals[XCValue::V_GAMMA_BB];
 
             for (int P = 0; P < npoints; P++) {
                 C_DAXPY(nlocal, -2.0 * w[P] * (2.0 * v_gamma_aa[P] * rho_ax[P] + v_gamma_ab[P] * rho_bx[P]), phi_x[P],
@@ -2307,15 +2724,15 @@ SharedMatrix UV::compute_gradient() {
             double** phi_yy = pworker->basis_value("PHI_YY")->pointer();
             double** phi_yz = pworker->basis_value("PHI_YZ")->pointer();
             double** phi_zz = pworker->basis_value("PHI_ZZ")->pointer();
-            double* rho_ax = pworker->point_value("RHO_AX")->pointer();
-            double* rho_ay = pworker->point_value("RHO_AY")->pointer();
-            double* rho_az = pworker->point_value("RHO_AZ")->pointer();
-            double* rho_bx = pworker->point_value("RHO_BX")->pointer();
-            double* rho_by = pworker->point_value("RHO_BY")->pointer();
-            double* rho_bz = pworker->point_value("RHO_BZ")->pointer();
-            double* v_gamma_aa = vals["V_GAMMA_AA"]->pointer();
-            double* v_gamma_ab = vals["V_GAMMA_AB"]->pointer();
-            double* v_gamma_bb = vals["V_GAMMA_BB"]->pointer();
+            double* rho_ax = pworker->point_buffer()[XCValue::RHO_AX];
+            double* rho_ay = pworker->point_buffer()[XCValue::RHO_AY];
+            double* rho_az = pworker->point_buffer()[XCValue::RHO_AZ];
+            double* rho_bx = pworker->point_buffer()[XCValue::RHO_BX];
+            double* rho_by = pworker->point_buffer()[XCValue::RHO_BY];
+            double* rho_bz = pworker->point_buffer()[XCValue::RHO_BZ];
+            double* v_gamma_aa = vals[XCValue::V_GAMMA_AA];
+            double* v_gamma_ab = vals[XCValue::V_GAMMA_AB];
+            double* v_gamma_bb = vals[XCValue::V_GAMMA_BB];
 
             C_DGEMM('N', 'N', npoints, nlocal, nlocal, 1.0, phi[0], coll_funcs, Dap[0], max_functions, 0.0, Uap[0],
                     max_functions);
@@ -2388,8 +2805,8 @@ SharedMatrix UV::compute_gradient() {
             double** phi_yy = pworker->basis_value("PHI_YY")->pointer();
             double** phi_yz = pworker->basis_value("PHI_YZ")->pointer();
             double** phi_zz = pworker->basis_value("PHI_ZZ")->pointer();
-            double* v_tau_a = vals["V_TAU_A"]->pointer();
-            double* v_tau_b = vals["V_TAU_B"]->pointer();
+            double* v_tau_a = vals[XCValue::V_TAU_A];
+            double* v_tau_b = vals[XCValue::V_TAU_B];
 
             double** phi_i[3];
             phi_i[0] = phi_x;
@@ -42,6 +42,7 @@ class DFTGrid;
 class PointFunctions;
 class SuperFunctional;
 class BlockOPoints;
+struct VV10Cell;
 
 // => BASE CLASS <= //
 
@@ -66,6 +67,8 @@ class PSI_API VBase {
     double v2_rho_cutoff_;
     /// VV10 interior kernel threshold
     double vv10_rho_cutoff_;
+    /// Opening criterion for VV10 far-field cells, 0 is exact
+    double vv10_theta_;
     /// Options object, used to build grid
     Options& options_;
     /// Basis set used in the integration
@@ -95,8 +98,7 @@ class PSI_API VBase {
     bool grac_initialized_;
 
     // VV10 dispersion, return vv10_nlc energy
-    void prepare_vv10_cache(DFTGrid& nlgrid, SharedMatrix D,
-                            std::vector<std::map<std::string, SharedVector>>& vv10_cache,
+    void prepare_vv10_cache(DFTGrid& nlgrid, SharedMatrix D, std::vector<VV10Cell>& vv10_tree,
                             std::vector<std::shared_ptr<PointFunctions>>& nl_point_workers, int ansatz = 1);
     double vv10_nlc(SharedMatrix D, SharedMatrix ret);
     SharedMatrix vv10_nlc_gradient(SharedMatrix D);
@@ -136,6 +138,8 @@ class PSI_API VBase {
     virtual void compute_Vx(std::vector<SharedMatrix> Dx, std::vector<SharedMatrix> ret);
     virtual SharedMatrix compute_gradient();
     virtual SharedMatrix compute_hessian();
+    /// Derivatives of V_xc with respect to the nuclear coordinates [first, first + count) at fixed D
+    virtual std::vector<SharedMatrix> compute_fock_derivatives(int first, int count);
 
     void set_print(int print) { print_ = print; }
     void set_debug(int debug) { debug_ = debug; }
@@ -161,6 +165,7 @@ class RV : public VBase {
     void compute_Vx(std::vector<SharedMatrix> Dx, std::vector<SharedMatrix> ret) override;
     SharedMatrix compute_gradient() override;
     SharedMatrix compute_hessian() override;
+    std::vector<SharedMatrix> compute_fock_derivatives(int first, int count) override;
 
     void print_header() const override;
 };
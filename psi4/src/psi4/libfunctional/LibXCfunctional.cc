@@ -367,8 +367,7 @@ std::vector<std::tuple<std::string, int, double>> LibXCFunctional::get_mix_data(
     }
     return ret;
 }
-void LibXCFunctional::compute_functional(const std::map<std::string, SharedVector>& in,
-                                         const std::map<std::string, SharedVector>& out, int npoints, int deriv) {
+void LibXCFunctional::compute_functional(const XCBuffer& in, const XCBuffer& out, int npoints, int deriv) {
     // => Input variables <= //
 
     if ((deriv >= 1) & (!vxc_)) {
@@ -396,25 +395,25 @@ void LibXCFunctional::compute_functional(const std::map<std::string, SharedVecto
     double* lapl_bp = nullptr;
 
     if (true) {
-        rho_ap = in.find("RHO_A")->second->pointer();
+        rho_ap = in[XCValue::RHO_A];
 
         if (!unpolarized_) {
-            rho_bp = in.find("RHO_B")->second->pointer();
+            rho_bp = in[XCValue::RHO_B];
         }
     }
     if (gga_) {
-        gamma_aap = in.find("GAMMA_AA")->second->pointer();
+        gamma_aap = in[XCValue::GAMMA_AA];
         if (!unpolarized_) {
-            gamma_abp = in.find("GAMMA_AB")->second->pointer();
-            gamma_bbp = in.find("GAMMA_BB")->second->pointer();
+            gamma_abp = in[XCValue::GAMMA_AB];
+            gamma_bbp = in[XCValue::GAMMA_BB];
         }
     }
     if (meta_) {
-        tau_ap = in.find("TAU_A")->second->pointer();
-        // lapl_ap = in.find("LAPL_RHO_A")->second->pointer();
+        tau_ap = in[XCValue::TAU_A];
+        // lapl_ap = in[XCValue::LAPL_RHO_A];
         if (!unpolarized_) {
-            tau_bp = in.find("TAU_B")->second->pointer();
-            // lapl_bp = in.find("LAPL_RHO_B")->second->pointer();
+            tau_bp = in[XCValue::TAU_B];
+            // lapl_bp = in[XCValue::LAPL_RHO_B];
         }
     }
 
@@ -464,88 +463,88 @@ void LibXCFunctional::compute_functional(const std::map<std::string, SharedVecto
     if (deriv >= 0) {
         // Energy doesnt make sense for all functionals
         if (exc_) {
-            v = out.find("V")->second->pointer();
+            v = out[XCValue::V];
         }
     }
     if (deriv >= 1) {
         if (true) {
-            v_rho_a = out.find("V_RHO_A")->second->pointer();
+            v_rho_a = out[XCValue::V_RHO_A];
             if (!unpolarized_) {
-                v_rho_b = out.find("V_RHO_B")->second->pointer();
+                v_rho_b = out[XCValue::V_RHO_B];
             }
         }
         if (gga_) {
-            v_gamma_aa = out.find("V_GAMMA_AA")->second->pointer();
+            v_gamma_aa = out[XCValue::V_GAMMA_AA];
             if (!unpolarized_) {
-                v_gamma_ab = out.find("V_GAMMA_AB")->second->pointer();
-                v_gamma_bb = out.find("V_GAMMA_BB")->second->pointer();
+                v_gamma_ab = out[XCValue::V_GAMMA_AB];
+                v_gamma_bb = out[XCValue::V_GAMMA_BB];
             }
         }
         if (meta_) {
-            v_tau_a = out.find("V_TAU_A")->second->pointer();
+            v_tau_a = out[XCValue::V_TAU_A];
             if (!unpolarized_) {
-                v_tau_b = out.find("V_TAU_B")->second->pointer();
+                v_tau_b = out[XCValue::V_TAU_B];
             }
-            // v_lapl_a = out.find("V_LAPL_A")->second->pointer();
-            // v_lapl_b = out.find("V_LAPL_B")->second->pointer();
+            // v_lapl_a = out[XCValue::V_LAPL_A];
+            // v_lapl_b = out[XCValue::V_LAPL_B];
         }
     }
     if (deriv >= 2) {
         if (true) {
-            v_rho_a_rho_a = out.find("V_RHO_A_RHO_A")->second->pointer();
+            v_rho_a_rho_a = out[XCValue::V_RHO_A_RHO_A];
 
             if (!unpolarized_) {
-                v_rho_a_rho_b = out.find("V_RHO_A_RHO_B")->second->pointer();
-                v_rho_b_rho_b = out.find("V_RHO_B_RHO_B")->second->pointer();
+                v_rho_a_rho_b = out[XCValue::V_RHO_A_RHO_B];
+                v_rho_b_rho_b = out[XCValue::V_RHO_B_RHO_B];
             }
         }
         if (gga_) {
-            v_gamma_aa_gamma_aa = out.find("V_GAMMA_AA_GAMMA_AA")->second->pointer();
+            v_gamma_aa_gamma_aa = out[XCValue::V_GAMMA_AA_GAMMA_AA];
 
             if (!unpolarized_) {
-                v_gamma_aa_gamma_ab = out.find("V_GAMMA_AA_GAMMA_AB")->second->pointer();
-                v_gamma_aa_gamma_bb = out.find("V_GAMMA_AA_GAMMA_BB")->second->pointer();
-                v_gamma_ab_gamma_ab = out.find("V_GAMMA_AB_GAMMA_AB")->second->pointer();
-                v_gamma_ab_gamma_bb = out.find("V_GAMMA_AB_GAMMA_BB")->second->pointer();
-                v_gamma_bb_gamma_bb = out.find("V_GAMMA_BB_GAMMA_BB")->second->pointer();
+                v_gamma_aa_gamma_ab = out[XCValue::V_GAMMA_AA_GAMMA_AB];
+                v_gamma_aa_gamma_bb = out[XCValue::V_GAMMA_AA_GAMMA_BB];
+                v_gamma_ab_gamma_ab = out[XCValue::V_GAMMA_AB_GAMMA_AB];
+                v_gamma_ab_gamma_bb = out[XCValue::V_GAMMA_AB_GAMMA_BB];
+                v_gamma_bb_gamma_bb = out[XCValue::V_GAMMA_BB_GAMMA_BB];
             }
         }
         if (meta_) {
-            v_tau_a_tau_a = out.find("V_TAU_A_TAU_A")->second->pointer();
+            v_tau_a_tau_a = out[XCValue::V_TAU_A_TAU_A];
 
             if (!unpolarized_) {
-                v_tau_a_tau_b = out.find("V_TAU_A_TAU_B")->second->pointer();
-                v_tau_b_tau_b = out.find("V_TAU_B_TAU_B")->second->pointer();
+                v_tau_a_tau_b = out[XCValue::V_TAU_A_TAU_B];
+                v_tau_b_tau_b = out[XCValue::V_TAU_B_TAU_B];
             }
         }
         if (gga_) {
-            v_rho_a_gamma_aa = out.find("V_RHO_A_GAMMA_AA")->second->pointer();
+            v_rho_a_gamma_aa = out[XCValue::V_RHO_A_GAMMA_AA];
 
             if (!unpolarized_) {
-                v_rho_a_gamma_ab = out.find("V_RHO_A_GAMMA_AB")->second->pointer();
-                v_rho_a_gamma_bb = out.find("V_RHO_A_GAMMA_BB")->second->pointer();
-                v_rho_b_gamma_aa = out.find("V_RHO_B_GAMMA_AA")->second->pointer();
-                v_rho_b_gamma_ab = out.find("V_RHO_B_GAMMA_AB")->second->pointer();
-                v_rho_b_gamma_bb = out.find("V_RHO_B_GAMMA_BB")->second->pointer();
+                v_rho_a_gamma_ab = out[XCValue::V_RHO_A_GAMMA_AB];
+                v_rho_a_gamma_bb = out[XCValue::V_RHO_A_GAMMA_BB];
+                v_rho_b_gamma_aa = out[XCValue::V_RHO_B_GAMMA_AA];
+                v_rho_b_gamma_ab = out[XCValue::V_RHO_B_GAMMA_AB];
+                v_rho_b_gamma_bb = out[XCValue::V_RHO_B_GAMMA_BB];
             }
         }
         if (meta_) {
-            v_rho_a_tau_a = out.find("V_RHO_A_TAU_A")->second->pointer();
+            v_rho_a_tau_a = out[XCValue::V_RHO_A_TAU_A];
 
             if (!unpolarized_) {
-                v_rho_a_tau_b = out.find("V_RHO_A_TAU_B")->second->pointer();
-                v_rho_b_tau_a = out.find("V_RHO_B_TAU_A")->second->pointer();
-                v_rho_b_tau_b = out.find("V_RHO_B_TAU_B")->second->pointer();
+                v_rho_a_tau_b = out[XCValue::V_RHO_A_TAU_B];
+                v_rho_b_tau_a = out[XCValue::V_RHO_B_TAU_A];
+                v_rho_b_tau_b = out[XCValue::V_RHO_B_TAU_B];
             }
         }
         if (gga_ && meta_) {
-            v_gamma_aa_tau_a = out.find("V_GAMMA_AA_TAU_A")->second->pointer();
+            v_gamma_aa_tau_a = out[XCValue::V_GAMMA_AA_TAU_A];
             if (!unpolarized_) {
-                v_gamma_aa_tau_b = out.find("V_GAMMA_AA_TAU_B")->second->pointer();
-                v_gamma_ab_tau_a = out.find("V_GAMMA_AB_TAU_A")->second->pointer();
-                v_gamma_ab_tau_b = out.find("V_GAMMA_AB_TAU_B")->second->pointer();
-                v_gamma_bb_tau_a = out.find("V_GAMMA_BB_TAU_A")->second->pointer();
-                v_gamma_bb_tau_b = out.find("V_GAMMA_BB_TAU_B")->second->pointer();
+                v_gamma_aa_tau_b = out[XCValue::V_GAMMA_AA_TAU_B];
+                v_gamma_ab_tau_a = out[XCValue::V_GAMMA_AB_TAU_A];
+                v_gamma_ab_tau_b = out[XCValue::V_GAMMA_AB_TAU_B];
+                v_gamma_bb_tau_a = out[XCValue::V_GAMMA_BB_TAU_A];
+                v_gamma_bb_tau_b = out[XCValue::V_GAMMA_BB_TAU_B];
             }
         }
     }
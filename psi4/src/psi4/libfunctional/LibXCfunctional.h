@@ -70,8 +70,8 @@ class LibXCFunctional : public Functional {
     LibXCFunctional(std::string xc_name, bool unpolarized);
     ~LibXCFunctional() override;
 
-    void compute_functional(const std::map<std::string, SharedVector>& in,
-                            const std::map<std::string, SharedVector>& out, int npoints, int deriv) override;
+    using Functional::compute_functional;
+    void compute_functional(const XCBuffer& in, const XCBuffer& out, int npoints, int deriv) override;
 
     // Clones a *worker* for the functional. This is not a complete functional
     std::shared_ptr<Functional> build_worker() override;
@@ -27,6 +27,7 @@
  */
 
 #include "functional.h"
+#include "psi4/libmints/vector.h"
 #include "psi4/psi4-dec.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
 #include "psi4/libpsi4util/exception.h"
@@ -80,6 +81,72 @@ void Functional::print(std::string out, int level) const {
 }
 void Functional::compute_functional(const std::map<std::string, SharedVector>& in,
                                     const std::map<std::string, SharedVector>& out, int npoints, int deriv) {
-    throw PSIEXCEPTION("Functional: pseudo-abstract class.");
+    compute_functional(XCBuffer::from_map(in), XCBuffer::from_map(out), npoints, deriv);
+}
+
+const std::string& xc_value_name(XCValue value) {
+    static const std::array<std::string, xc_nvalue> names = {{
+        "RHO_A",
+        "RHO_B",
+        "RHO_AX",
+        "RHO_AY",
+        "RHO_AZ",
+        "RHO_BX",
+        "RHO_BY",
+        "RHO_BZ",
+        "GAMMA_AA",
+        "GAMMA_AB",
+        "GAMMA_BB",
+        "TAU_A",
+        "TAU_B",
+        "Q_TMP",
+        "V",
+        "V_RHO_A",
+        "V_RHO_B",
+        "V_GAMMA_AA",
+        "V_GAMMA_AB",
+        "V_GAMMA_BB",
+        "V_TAU_A",
+        "V_TAU_B",
+        "V_RHO_A_RHO_A",
+        "V_RHO_A_RHO_B",
+        "V_RHO_B_RHO_B",
+        "V_GAMMA_AA_GAMMA_AA",
+        "V_GAMMA_AA_GAMMA_AB",
+        "V_GAMMA_AA_GAMMA_BB",
+        "V_GAMMA_AB_GAMMA_AB",
+        "V_GAMMA_AB_GAMMA_BB",
+        "V_GAMMA_BB_GAMMA_BB",
+        "V_TAU_A_TAU_A",
+        "V_TAU_A_TAU_B",
+        "V_TAU_B_TAU_B",
+        "V_RHO_A_GAMMA_AA",
+        "V_RHO_A_GAMMA_AB",
+        "V_RHO_A_GAMMA_BB",
+        "V_RHO_B_GAMMA_AA",
+        "V_RHO_B_GAMMA_AB",
+        "V_RHO_B_GAMMA_BB",
+        "V_RHO_A_TAU_A",
+        "V_RHO_A_TAU_B",
+        "V_RHO_B_TAU_A",
+        "V_RHO_B_TAU_B",
+        "V_GAMMA_AA_TAU_A",
+        "V_GAMMA_AA_TAU_B",
+        "V_GAMMA_AB_TAU_A",
+        "V_GAMMA_AB_TAU_B",
+        "V_GAMMA_BB_TAU_A",
+        "V_GAMMA_BB_TAU_B",
+    }};
+    return names[static_cast<int>(value)];
+}
+XCBuffer XCBuffer::from_map(const std::map<std::string, SharedVector>& values) {
+    XCBuffer buffer;
+    for (int i = 0; i < xc_nvalue; i++) {
+        auto it = values.find(xc_value_name(static_cast<XCValue>(i)));
+        if (it != values.end() && it->second) {
+            buffer.values_[i] = it->second->pointer();
+        }
+    }
+    return buffer;
 }
 }
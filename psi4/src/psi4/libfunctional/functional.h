@@ -30,12 +30,106 @@
 #define FUNCTIONAL_H
 
 #include "psi4/libmints/typedefs.h"
+#include <array>
 #include <map>
 #include <vector>
 #include <string>
 
 namespace psi {
 
+/**
+ * XCValue: index of every per-point quantity that travels through the XC pipeline.
+ * Density inputs (computed by PointFunctions) come first, functional outputs
+ * (computed by SuperFunctional) follow. The key of each entry in the string-keyed
+ * maps is the enumerator name, see xc_value_name.
+ **/
+enum class XCValue {
+    // => Density inputs <= //
+    RHO_A,
+    RHO_B,
+    RHO_AX,
+    RHO_AY,
+    RHO_AZ,
+    RHO_BX,
+    RHO_BY,
+    RHO_BZ,
+    GAMMA_AA,
+    GAMMA_AB,
+    GAMMA_BB,
+    TAU_A,
+    TAU_B,
+
+    // => Functional outputs <= //
+    Q_TMP,
+    V,
+    V_RHO_A,
+    V_RHO_B,
+    V_GAMMA_AA,
+    V_GAMMA_AB,
+    V_GAMMA_BB,
+    V_TAU_A,
+    V_TAU_B,
+    V_RHO_A_RHO_A,
+    V_RHO_A_RHO_B,
+    V_RHO_B_RHO_B,
+    V_GAMMA_AA_GAMMA_AA,
+    V_GAMMA_AA_GAMMA_AB,
+    V_GAMMA_AA_GAMMA_BB,
+    V_GAMMA_AB_GAMMA_AB,
+    V_GAMMA_AB_GAMMA_BB,
+    V_GAMMA_BB_GAMMA_BB,
+    V_TAU_A_TAU_A,
+    V_TAU_A_TAU_B,
+    V_TAU_B_TAU_B,
+    V_RHO_A_GAMMA_AA,
+    V_RHO_A_GAMMA_AB,
+    V_RHO_A_GAMMA_BB,
+    V_RHO_B_GAMMA_AA,
+    V_RHO_B_GAMMA_AB,
+    V_RHO_B_GAMMA_BB,
+    V_RHO_A_TAU_A,
+    V_RHO_A_TAU_B,
+    V_RHO_B_TAU_A,
+    V_RHO_B_TAU_B,
+    V_GAMMA_AA_TAU_A,
+    V_GAMMA_AA_TAU_B,
+    V_GAMMA_AB_TAU_A,
+    V_GAMMA_AB_TAU_B,
+    V_GAMMA_BB_TAU_A,
+    V_GAMMA_BB_TAU_B,
+
+    NVALUE
+};
+
+/// Number of XCValue slots
+constexpr int xc_nvalue = static_cast<int>(XCValue::NVALUE);
+
+/// Map key of an XCValue ("RHO_A" for XCValue::RHO_A)
+const std::string& xc_value_name(XCValue value);
+
+/**
+ * XCBuffer: fixed, XCValue-indexed table of the SoA point buffers of one worker.
+ *
+ * Slots the worker does not hold are nullptr. The buffers themselves are the
+ * worker's SharedVectors, allocated once per grid, so the string-keyed maps
+ * remain valid views of the same storage. Build the table once after allocation
+ * and index it in the per-block loops instead of doing map lookups.
+ **/
+class XCBuffer {
+   protected:
+    std::array<double*, xc_nvalue> values_;
+
+   public:
+    XCBuffer() { values_.fill(nullptr); }
+
+    /// Point every slot named in values at its storage, all others at nullptr
+    static XCBuffer from_map(const std::map<std::string, SharedVector>& values);
+
+    double* operator[](XCValue value) const { return values_[static_cast<int>(value)]; }
+    bool has(XCValue value) const { return values_[static_cast<int>(value)] != nullptr; }
+    void set(XCValue value, double* ptr) { values_[static_cast<int>(value)] = ptr; }
+};
+
 /**
  * Functional: Generic Semilocal Exchange or Correlation DFA functional
  *
@@ -96,8 +190,11 @@ class Functional {
 
     // => Computers <= //
 
-    virtual void compute_functional(const std::map<std::string, SharedVector>& in,
-                                    const std::map<std::string, SharedVector>& out, int npoints, int deriv) = 0;
+    // Keyed-map front end (Python, tests), builds the XCBuffer tables and forwards
+    void compute_functional(const std::map<std::string, SharedVector>& in,
+                            const std::map<std::string, SharedVector>& out, int npoints, int deriv);
+    // Accumulates the derivatives up to deriv of npoints points from in to out
+    virtual void compute_functional(const XCBuffer& in, const XCBuffer& out, int npoints, int deriv) = 0;
 
     // => Parameters <= //
 
@@ -37,6 +37,7 @@
 #include "functional.h"
 #include "LibXCfunctional.h"
 
+#include <algorithm>
 #include <cmath>
 #include <cstdlib>
 
@@ -580,45 +581,51 @@ void SuperFunctional::allocate() {
         vv_values_["GRID_WY"] = std::make_shared<Vector>("W_Y_GRID", max_points_);
         vv_values_["GRID_WZ"] = std::make_shared<Vector>("W_Z_GRID", max_points_);
     }
+    value_buffer_ = XCBuffer::from_map(values_);
+    ac_buffer_ = XCBuffer::from_map(ac_values_);
 }
 std::map<std::string, SharedVector>& SuperFunctional::compute_functional(
     const std::map<std::string, SharedVector>& vals, int npoints) {
     npoints = (npoints == -1 ? vals.find("RHO_A")->second->dimpi()[0] : npoints);
-
+    compute_functional(XCBuffer::from_map(vals), npoints);
+    return values_;
+}
+const XCBuffer& SuperFunctional::compute_functional(const XCBuffer& vals, int npoints) {
     // Zero out values
-    for (auto kv : values_) {
-        kv.second->zero();
+    for (int i = 0; i < xc_nvalue; i++) {
+        double* value = value_buffer_[static_cast<XCValue>(i)];
+        if (value) std::fill(value, value + max_points_, 0.0);
     }
 
     for (int i = 0; i < x_functionals_.size(); i++) {
-        x_functionals_[i]->compute_functional(vals, values_, npoints, deriv_);
+        x_functionals_[i]->compute_functional(vals, value_buffer_, npoints, deriv_);
     }
     for (int i = 0; i < c_functionals_.size(); i++) {
-        c_functionals_[i]->compute_functional(vals, values_, npoints, deriv_);
+        c_functionals_[i]->compute_functional(vals, value_buffer_, npoints, deriv_);
     }
 
     // Apply the grac shift, only valid for gradient computations
     if (needs_grac_ && (deriv_ == 1)) {
-        for (std::map<std::string, SharedVector>::const_iterator it = ac_values_.begin(); it != ac_values_.end();
-             ++it) {
-            ::memset((void*)((*it).second->pointer()), '\0', sizeof(double) * npoints);
+        for (int i = 0; i < xc_nvalue; i++) {
+            double* value = ac_buffer_[static_cast<XCValue>(i)];
+            if (value) std::fill(value, value + npoints, 0.0);
         }
         if (grac_x_functional_) {
-            grac_x_functional_->compute_functional(vals, ac_values_, npoints, 1);
+            grac_x_functional_->compute_functional(vals, ac_buffer_, npoints, 1);
         }
         if (grac_c_functional_) {
-            grac_c_functional_->compute_functional(vals, ac_values_, npoints, 1);
+            grac_c_functional_->compute_functional(vals, ac_buffer_, npoints, 1);
         }
 
         if (is_unpolarized()) {
-            double* rho = vals.find("RHO_A")->second->pointer();
-            double* sigma = vals.find("GAMMA_AA")->second->pointer();
+            double* rho = vals[XCValue::RHO_A];
+            double* sigma = vals[XCValue::GAMMA_AA];
 
-            double* v_rho = values_["V_RHO_A"]->pointer();
-            double* v_gamma = values_["V_GAMMA_AA"]->pointer();
+            double* v_rho = value_buffer_[XCValue::V_RHO_A];
+            double* v_gamma = value_buffer_[XCValue::V_GAMMA_AA];
 
-            double* grac_v_rho = ac_values_["V_RHO_A"]->pointer();
-            double* grac_v_gamma = ac_values_["V_GAMMA_AA"]->pointer();
+            double* grac_v_rho = ac_buffer_[XCValue::V_RHO_A];
+            double* grac_v_gamma = ac_buffer_[XCValue::V_GAMMA_AA];
 
             const double galpha = -1.0 * grac_alpha_;
             const double gbeta = grac_beta_;
@@ -691,12 +698,12 @@ std::map<std::string, SharedVector>& SuperFunctional::compute_functional(
         }
     }
 
-    return values_;
+    return value_buffer_;
 }
-std::map<std::string, SharedVector> SuperFunctional::compute_vv10_cache(const std::map<std::string, SharedVector>& vals,
+std::map<std::string, SharedVector> SuperFunctional::compute_vv10_cache(const XCBuffer& vals,
                                                                         std::shared_ptr<BlockOPoints> block,
                                                                         double rho_thresh, int npoints, bool internal) {
-    npoints = (npoints == -1 ? vals.find("RHO_A")->second->dimpi()[0] : npoints);
+    npoints = (npoints == -1 ? block->npoints() : npoints);
 
     // Precompute prefactors
     const double Wp_pref = (4.0 / 3.0) * M_PI;
@@ -713,8 +720,8 @@ std::map<std::string, SharedVector> SuperFunctional::compute_vv10_cache(const st
 
     double* w0p = vv_values_["W0"]->pointer();
     double* kappap = vv_values_["KAPPA"]->pointer();
-    double* rhop = vals.find("RHO_A")->second->pointer();
-    double* gammap = vals.find("GAMMA_AA")->second->pointer();
+    double* rhop = vals[XCValue::RHO_A];
+    double* gammap = vals[XCValue::GAMMA_AA];
 
 // Eh, worth a shot
 #pragma omp simd
@@ -744,6 +751,7 @@ std::map<std::string, SharedVector> SuperFunctional::compute_vv10_cache(const st
     auto rho_vec = std::make_shared<Vector>("RHO points", nact);
     auto w0_vec = std::make_shared<Vector>("W0 points", nact);
     auto kappa_vec = std::make_shared<Vector>("KAPPA points", nact);
+    auto w_rho_vec = std::make_shared<Vector>("W*RHO points", nact);
 
     double* w_vecp = w_vec->pointer();
     double* x_vecp = x_vec->pointer();
@@ -752,6 +760,7 @@ std::map<std::string, SharedVector> SuperFunctional::compute_vv10_cache(const st
     double* rho_vecp = rho_vec->pointer();
     double* w0_vecp = w0_vec->pointer();
     double* kappa_vecp = kappa_vec->pointer();
+    double* w_rho_vecp = w_rho_vec->pointer();
 
     size_t sieve_pos = 0;
     for (size_t i = 0; i < npoints; i++) {
@@ -765,6 +774,7 @@ std::map<std::string, SharedVector> SuperFunctional::compute_vv10_cache(const st
         rho_vecp[sieve_pos] = rhop[i];
         w0_vecp[sieve_pos] = w0p[i];
         kappa_vecp[sieve_pos] = kappap[i];
+        w_rho_vecp[sieve_pos] = block->w()[i] * rhop[i];
 
         sieve_pos++;
     }
@@ -778,13 +788,59 @@ std::map<std::string, SharedVector> SuperFunctional::compute_vv10_cache(const st
     ret["RHO"] = rho_vec;
     ret["W0"] = w0_vec;
     ret["KAPPA"] = kappa_vec;
+    ret["W_RHO"] = w_rho_vec;
 
     return ret;
 }
-double SuperFunctional::compute_vv10_kernel(const std::map<std::string, SharedVector>& vals,
-                                            const std::vector<std::map<std::string, SharedVector>>& vv10_cache,
-                                            std::shared_ptr<BlockOPoints> block, int npoints, bool do_grad) {
-    // Kernel between left (*this) and right (vv10_cache) grids
+namespace {
+// Pair sum of a left point against n right points (SoA). Right points may be
+// cached grid points or far-field cell pseudo-points, the kernel is the same.
+template <bool do_grad>
+void vv10_pair_sum(size_t n, double lx, double ly, double lz, double lW0, double lkappa, const double* r_x,
+                   const double* r_y, const double* r_z, const double* r_w_rho, const double* r_W0,
+                   const double* r_kappa, double& phi, double& U, double& W, double& xc, double& yc, double& zc) {
+    double phi_s = 0.0, U_s = 0.0, W_s = 0.0, xc_s = 0.0, yc_s = 0.0, zc_s = 0.0;
+#pragma omp simd reduction(+ : phi_s, U_s, W_s, xc_s, yc_s, zc_s)
+    for (size_t j = 0; j < n; j++) {
+        // Distance between grid points
+        const double d_x = lx - r_x[j];
+        const double d_y = ly - r_y[j];
+        const double d_z = lz - r_z[j];
+        const double R2 = d_x * d_x + d_y * d_y + d_z * d_z;
+
+        // g/gp values
+        const double g = lW0 * R2 + lkappa;
+        const double gp = r_W0[j] * R2 + r_kappa[j];
+        const double gs = g + gp;
+
+        // Sum the kernel
+        const double phi_kernel = (-1.5 * r_w_rho[j]) / (g * gp * gs);
+        phi_s += phi_kernel;
+        const double tmp_U = -1.0 * phi_kernel * ((1.0 / g) + (1.0 / gs));
+        U_s += tmp_U;
+        W_s += tmp_U * R2;
+
+        // Grid contribution
+        if (do_grad) {
+            const double Q = -2.0 * phi_kernel * (lW0 / g + r_W0[j] / gp + (lW0 + r_W0[j]) / gs);
+            xc_s += Q * d_x;
+            yc_s += Q * d_y;
+            zc_s += Q * d_z;
+        }
+    }
+    phi += phi_s;
+    U += U_s;
+    W += W_s;
+    xc += xc_s;
+    yc += yc_s;
+    zc += zc_s;
+}
+}  // namespace
+
+double SuperFunctional::compute_vv10_kernel(const XCBuffer& vals, const std::vector<VV10Cell>& vv10_tree,
+                                            std::shared_ptr<BlockOPoints> block, int npoints, bool do_grad,
+                                            double theta) {
+    // Kernel between left (*this) and right (vv10_tree) grids
 
     // Compute the vv10 cache in place
     const double l_thresh = 1.e-12;
@@ -793,8 +849,8 @@ double SuperFunctional::compute_vv10_kernel(const std::map<std::string, SharedVe
 
     // Grab values to update
     double vv10_e = 0.0;
-    double* v_rho = values_["V_RHO_A"]->pointer();
-    double* v_gamma = values_["V_GAMMA_AA"]->pointer();
+    double* v_rho = value_buffer_[XCValue::V_RHO_A];
+    double* v_gamma = value_buffer_[XCValue::V_GAMMA_AA];
     double* x_grid = vv_values_["GRID_WX"]->pointer();
     double* y_grid = vv_values_["GRID_WY"]->pointer();
     double* z_grid = vv_values_["GRID_WZ"]->pointer();
@@ -805,13 +861,47 @@ double SuperFunctional::compute_vv10_kernel(const std::map<std::string, SharedVe
     // Constants
     const double vv10_beta = vv10_beta_;
 
+    // => Walk the tree once for the whole block <= //
+    // Near leaves are summed point by point, far cells through their pseudo-point
+    std::vector<const VV10Cell*> near_cells;
+    std::vector<double> f_x, f_y, f_z, f_w_rho, f_W0, f_kappa;
+    if (vv10_tree.size()) {
+        const Vector3& bc = block->xc();
+        const double bR = block->R();
+        std::vector<int> stack(1, 0);
+        while (stack.size()) {
+            const VV10Cell& cell = vv10_tree[stack.back()];
+            stack.pop_back();
+
+            const double dx = cell.center[0] - bc[0];
+            const double dy = cell.center[1] - bc[1];
+            const double dz = cell.center[2] - bc[2];
+            const double dist = std::sqrt(dx * dx + dy * dy + dz * dz);
+
+            if (cell.radius + bR < theta * dist) {
+                f_x.push_back(cell.center[0]);
+                f_y.push_back(cell.center[1]);
+                f_z.push_back(cell.center[2]);
+                f_w_rho.push_back(cell.w_rho);
+                f_W0.push_back(cell.W0);
+                f_kappa.push_back(cell.kappa);
+            } else if (cell.children[0] == -1) {
+                near_cells.push_back(&cell);
+            } else {
+                stack.push_back(cell.children[0]);
+                stack.push_back(cell.children[1]);
+            }
+        }
+    }
+    const size_t nfar = f_x.size();
+
     // Get left points
     const double* l_x = block->x();
     const double* l_y = block->y();
     const double* l_z = block->z();
     const double* l_w = block->w();
-    const double* l_rho = vals.find("RHO_A")->second->pointer();
-    const double* l_gamma = vals.find("GAMMA_AA")->second->pointer();
+    const double* l_rho = vals[XCValue::RHO_A];
+    const double* l_gamma = vals[XCValue::GAMMA_AA];
     const double* l_W0 = vv_values_["W0"]->pointer();
     const double* l_kappa = vv_values_["KAPPA"]->pointer();
 
@@ -830,75 +920,35 @@ double SuperFunctional::compute_vv10_kernel(const std::map<std::string, SharedVe
         double xc = 0.0;
         double yc = 0.0;
         double zc = 0.0;
-        for (auto r_block : vv10_cache) {
+        for (const VV10Cell* cell : near_cells) {
             // Get right points
-            const double* r_x = r_block["X"]->pointer();
-            const double* r_y = r_block["Y"]->pointer();
-            const double* r_z = r_block["Z"]->pointer();
-            const double* r_w = r_block["W"]->pointer();
-            const double* r_rho = r_block["RHO"]->pointer();
-            const double* r_W0 = r_block["W0"]->pointer();
-            const double* r_kappa = r_block["KAPPA"]->pointer();
-
-            const size_t r_npoints = r_block["KAPPA"]->dimpi()[0];
+            const double* r_x = cell->p_x.data();
+            const double* r_y = cell->p_y.data();
+            const double* r_z = cell->p_z.data();
+            const double* r_w_rho = cell->p_w_rho.data();
+            const double* r_W0 = cell->p_W0.data();
+            const double* r_kappa = cell->p_kappa.data();
+            const size_t r_npoints = cell->npoints();
 
-            // Interior Kernel
             if (do_grad) {
-#pragma omp simd reduction(+ : phi, U, W, xc, yc, zc)
-                for (size_t j = 0; j < r_npoints; j++) {
-                    // Distance between grid points
-                    const double d_x = l_x[i] - r_x[j];
-                    const double d_y = l_y[i] - r_y[j];
-                    const double d_z = l_z[i] - r_z[j];
-                    const double R2 = d_x * d_x + d_y * d_y + d_z * d_z;
-
-                    // g/gp values
-                    const double g = l_W0[i] * R2 + l_kappa[i];
-                    const double gp = r_W0[j] * R2 + r_kappa[j];
-                    const double gs = g + gp;
-
-                    // Sum the kernel
-                    const double phi_kernel = (-1.5 * r_w[j] * r_rho[j]) / (g * gp * gs);
-
-                    // Dumb question, does FMA do subtraction?
-                    phi += phi_kernel;
-                    const double tmp_U = -1.0 * phi_kernel * ((1.0 / g) + (1.0 / gs));
-                    U += tmp_U;
-                    W += tmp_U * R2;
-
-                    // Grid contribution
-                    const double Q = -2.0 * phi_kernel * (l_W0[i] / g + r_W0[j] / gp + (l_W0[i] + r_W0[j]) / gs);
-                    xc += Q * d_x;
-                    yc += Q * d_y;
-                    zc += Q * d_z;
-                }
+                vv10_pair_sum<true>(r_npoints, l_x[i], l_y[i], l_z[i], l_W0[i], l_kappa[i], r_x, r_y, r_z, r_w_rho,
+                                    r_W0, r_kappa, phi, U, W, xc, yc, zc);
+            } else {
+                vv10_pair_sum<false>(r_npoints, l_x[i], l_y[i], l_z[i], l_W0[i], l_kappa[i], r_x, r_y, r_z, r_w_rho,
+                                     r_W0, r_kappa, phi, U, W, xc, yc, zc);
+            }
+        }  // End near cells
 
+        if (nfar) {
+            if (do_grad) {
+                vv10_pair_sum<true>(nfar, l_x[i], l_y[i], l_z[i], l_W0[i], l_kappa[i], f_x.data(), f_y.data(),
+                                    f_z.data(), f_w_rho.data(), f_W0.data(), f_kappa.data(), phi, U, W, xc, yc, zc);
             } else {
-#pragma omp simd reduction(+ : phi, U, W)
-                for (size_t j = 0; j < r_npoints; j++) {
-                    // Distance between grid points
-                    const double d_x = l_x[i] - r_x[j];
-                    const double d_y = l_y[i] - r_y[j];
-                    const double d_z = l_z[i] - r_z[j];
-                    const double R2 = d_x * d_x + d_y * d_y + d_z * d_z;
-
-                    // g/gp values
-                    const double g = l_W0[i] * R2 + l_kappa[i];
-                    const double gp = r_W0[j] * R2 + r_kappa[j];
-                    const double gs = g + gp;
-
-                    // Sum the kernel
-                    const double phi_kernel = (-1.5 * r_w[j] * r_rho[j]) / (g * gp * gs);
-
-                    // Dumb question, does FMA do subtraction?
-                    phi += phi_kernel;
-                    const double tmp_U = -1.0 * phi_kernel * ((1.0 / g) + (1.0 / gs));
-                    U += tmp_U;
-                    W += tmp_U * R2;
-                }
+                vv10_pair_sum<false>(nfar, l_x[i], l_y[i], l_z[i], l_W0[i], l_kappa[i], f_x.data(), f_y.data(),
+                                     f_z.data(), f_w_rho.data(), f_W0.data(), f_kappa.data(), phi, U, W, xc, yc, zc);
             }
+        }
 
-        }  // End r blocks
         // Mathematica for the win
         const double kappa_dn = l_kappa[i] / (6.0 * l_rho[i]);
         const double w0_dgamma = vv10_c_ * l_gamma[i] / (l_W0[i] * std::pow(l_rho[i], 4.0));
@@ -916,7 +966,6 @@ double SuperFunctional::compute_vv10_kernel(const std::map<std::string, SharedVe
         }
     }
 
-    // printf("Nact/Ntot Ext %zu / %zu\n", nact, l_npoints);
     return vv10_e;
 }
 void SuperFunctional::test_functional(SharedVector rho_a, SharedVector rho_b, SharedVector gamma_aa,
@@ -31,15 +31,36 @@
 
 #include "psi4/libmints/typedefs.h"
 #include "psi4/pragma.h"
+#include "functional.h"
 #include <map>
 #include <vector>
 #include <cstdlib>
 #include <string>
 namespace psi {
 
-class Functional;
 class BlockOPoints;
 
+/**
+ * VV10Cell: one node of the spatial tree over the VV10 nonlocal grid cache
+ *
+ * Leaves own a spatially compact set of cached points in SoA layout. Every
+ * node also carries a far-field pseudo-point: the w*rho weighted centroid,
+ * the summed w*rho, and w*rho weighted W0 and kappa. Radius bounds the
+ * distance from the centroid to any owned point.
+ **/
+struct VV10Cell {
+    double center[3] = {0.0, 0.0, 0.0};
+    double radius = 0.0;
+    double w_rho = 0.0;
+    double W0 = 0.0;
+    double kappa = 0.0;
+    /// Child node indices, -1 on leaves
+    int children[2] = {-1, -1};
+    /// Cached points (coordinates, w*rho, W0, kappa), leaves only
+    std::vector<double> p_x, p_y, p_z, p_w_rho, p_W0, p_kappa;
+    size_t npoints() const { return p_x.size(); }
+};
+
 /**
  * SuperFunctional: High-level semilocal DFA object
  *
@@ -101,6 +122,9 @@ class SuperFunctional {
     std::map<std::string, SharedVector> values_;
     std::map<std::string, SharedVector> ac_values_;
     std::map<std::string, SharedVector> vv_values_;
+    // XCValue-indexed views of values_ and ac_values_, rebuilt by allocate()
+    XCBuffer value_buffer_;
+    XCBuffer ac_buffer_;
 
     // Set up a null Superfunctional
     void common_init();
@@ -128,23 +152,27 @@ class SuperFunctional {
 
     std::map<std::string, SharedVector>& compute_functional(const std::map<std::string, SharedVector>& vals,
                                                             int npoints = -1);
+    // Per-block entry point, vals is the PointFunctions buffer table, returns value_buffer()
+    const XCBuffer& compute_functional(const XCBuffer& vals, int npoints);
     void test_functional(SharedVector rho_a, SharedVector rho_b, SharedVector gamma_aa, SharedVector gamma_ab,
                          SharedVector gamma_bb, SharedVector tau_a, SharedVector tau_b);
 
     // Compute the cache data for VV10 dispersion
-    std::map<std::string, SharedVector> compute_vv10_cache(const std::map<std::string, SharedVector>& vals,
-                                                           std::shared_ptr<BlockOPoints> block, double rho_thresh,
-                                                           int npoints = -1, bool internal = false);
+    std::map<std::string, SharedVector> compute_vv10_cache(const XCBuffer& vals, std::shared_ptr<BlockOPoints> block,
+                                                           double rho_thresh, int npoints = -1, bool internal = false);
 
-    // Copmutes the Cache data for VV10 dispersion
-    double compute_vv10_kernel(const std::map<std::string, SharedVector>& vals,
-                               const std::vector<std::map<std::string, SharedVector>>& vv10_cache,
-                               std::shared_ptr<BlockOPoints> block, int npoints = -1, bool do_grad = false);
+    // Computes the VV10 kernel of a block against the cache tree (root at 0). Cells whose
+    // bounding spheres satisfy (R_cell + R_block) < theta * distance are treated as a single
+    // pseudo-point, theta = 0 is the exact O(N^2) sum.
+    double compute_vv10_kernel(const XCBuffer& vals, const std::vector<VV10Cell>& vv10_tree,
+                               std::shared_ptr<BlockOPoints> block, int npoints = -1, bool do_grad = false,
+                               double theta = 0.0);
 
     // => Input/Output <= //
 
     std::map<std::string, SharedVector>& values() { return values_; }
     SharedVector value(const std::string& key) { return values_[key]; }
+    const XCBuffer& value_buffer() const { return value_buffer_; }
     SharedVector vv_value(const std::string& key) { return vv_values_[key]; }
 
     std::vector<std::shared_ptr<Functional>>& x_functionals() { return x_functionals_; }
@@ -76,6 +76,11 @@ ERDTwoElectronInt::ERDTwoElectronInt(const IntegralFactory *integral, int deriv,
 
     has_puream_ = bs1_->has_puream() || bs2_->has_puream() || bs3_->has_puream() || bs4_->has_puream();
 
+    if (use_shell_pairs) {
+        pairs12_ = integral->shell_pairs(bs1_, bs2_);
+        pairs34_ = integral->shell_pairs(bs3_, bs4_);
+    }
+
     spheric_ = 0;  // bs1_->has_puream() && bs2_->has_puream() &&
                    // bs3_->has_puream() && bs4_->has_puream();
 
@@ -586,13 +591,16 @@ size_t ERDTwoElectronInt::compute_shell(int shell_i, int shell_j, int shell_k, i
     outfile->Printf("\n");
 #endif
 
-    F_INT nbatch;
-    // Call ERD.  N.B. We reverse the shell ordering, because the first index is
-    // the fastest running index in the buffer, which should be l for us.
-    C_ERD__GENER_ERI_BATCH(i_buffer_size_, d_buffer_size_, npgto, npgto, ncgto, ncgto4, ncgto3, ncgto2, ncgto1, npgto4,
-                           npgto3, npgto2, npgto1, am4, am3, am2, am1, x4, y4, z4, x3, y3, z3, x2, y2, z2, x1, y1, z1,
-                           alpha_, cc_, ccbeg_, ccend_, spheric_, screen_, iscratch_, nbatch, buffer_offset_,
-                           dscratch_);
+    F_INT nbatch = 0;
+    // If every primitive pair of the bra or the ket is negligible the whole quartet vanishes; skip ERD.
+    if (!pairs12_ || (pairs12_->nprimitive(shell_i, shell_j) && pairs34_->nprimitive(shell_k, shell_l))) {
+        // Call ERD.  N.B. We reverse the shell ordering, because the first index is
+        // the fastest running index in the buffer, which should be l for us.
+        C_ERD__GENER_ERI_BATCH(i_buffer_size_, d_buffer_size_, npgto, npgto, ncgto, ncgto4, ncgto3, ncgto2, ncgto1,
+                               npgto4, npgto3, npgto2, npgto1, am4, am3, am2, am1, x4, y4, z4, x3, y3, z3, x2, y2, z2,
+                               x1, y1, z1, alpha_, cc_, ccbeg_, ccend_, spheric_, screen_, iscratch_, nbatch,
+                               buffer_offset_, dscratch_);
+    }
 
 #if DEBUG
     outfile->Printf("Buffer offset is %d\n", buffer_offset_ - 1);
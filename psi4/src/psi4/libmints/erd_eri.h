@@ -32,6 +32,7 @@
 #ifdef USING_erd
 
 #include "psi4/libmints/twobody.h"
+#include "psi4/libmints/shellpair.h"
 
 typedef int F_INT;
 typedef int F_BOOL;
@@ -118,6 +119,8 @@ class ERDTwoElectronInt : public TwoBodyAOInt {
     bool has_puream_;
     /// Not relating to the monotony of integral computations, but whether the basis sets are all the same
     bool same_bs_;
+    /// Shared primitive pair lists for the bra and ket, used to skip negligible quartets before calling ERD
+    std::shared_ptr<ShellPairList> pairs12_, pairs34_;
 
     void normalize_basis();
 
@@ -32,6 +32,7 @@
 #include <libint/libint.h>
 #include <libderiv/libderiv.h>
 #include "psi4/libmints/twobody.h"
+#include "psi4/libmints/shellpair.h"
 
 namespace psi {
 
@@ -42,31 +43,6 @@ class Fjt;
 class AOShellCombinationsIterator;
 class CorrelationFactor;
 
-/**
- * \ingroup MINTS
- * Structure to hold precomputed shell pair information
- */
-typedef struct ShellPair_typ {
-    //! Shells for this information.
-    int i, j;
-    //! Matrix over primitives with x, y, z coordinate of average Gaussian
-    double*** P;
-    //! Distance between shell i and shell j centers
-    double AB[3];
-    //! Distance between P and shell i center
-    double*** PA;
-    //! Distance between P and shell j center
-    double*** PB;
-    //! Array of alphas for both centers
-    double *ai, *aj;
-    //! Array of the gammas (ai + aj)
-    double** gamma;
-    //! Contraction coefficients
-    double *ci, *cj;
-    //! Overlap between primitives on i and j
-    double** overlap;
-} ShellPair;
-
 /*! \ingroup MINTS
  *  \class ERI
  *  \brief Capable of computing two-electron repulsion integrals.
@@ -93,25 +69,14 @@ class TwoElectronInt : public TwoBodyAOInt {
     //! Computes the ERI second derivative between four shells.
     size_t compute_quartet_deriv2(int, int, int, int);
 
-    //! Form shell pair information. Must be smart enough to handle arbitrary basis sets
-    void init_shell_pairs12();
-    void init_shell_pairs34();
-
-    //! Free shell pair information
-    void free_shell_pairs12();
-    void free_shell_pairs34();
-
     //! Should we use shell pair information?
     bool use_shell_pairs_;
 
-    //! Stack memory pointer, used in init_shell_pairs, freed in destructor
-    double *stack12_, *stack34_;
-
-    //! Shell pair information
-    ShellPair **pairs12_, **pairs34_;
+    //! Primitive pair lists shared through the factory, one per (bra, ket) basis ordering compute_quartet can see
+    std::vector<std::shared_ptr<ShellPairList> > pair_lists_;
 
-    //! Evaluates how much memory (in doubles) is needed to store shell pair data
-    size_t memory_to_store_shell_pairs(const std::shared_ptr<BasisSet>&, const std::shared_ptr<BasisSet>&);
+    //! Returns the primitive pair list for shells from bs_a and bs_b
+    const ShellPairList& pair_list(const std::shared_ptr<BasisSet>& bs_a, const std::shared_ptr<BasisSet>& bs_b) const;
 
     //! Original shell index requested
     int osh1_, osh2_, osh3_, osh4_;
@@ -37,6 +37,7 @@
 #include "psi4/libmints/wavefunction.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
 
+#include <algorithm>
 #include <stdexcept>
 #include <string>
 
@@ -1646,135 +1647,91 @@ static void handle_reordering12(PermutedOrder permutation, Libderiv_t &libderiv_
 }
 
 /**
- * @brief Fills the primitive data structure used by libint/libderiv with information from the ShellPairs
+ * @brief Fills the primitive data structure used by libint/libderiv from the precomputed primitive pairs
  * @param PrimQuartet The structure to hold the data.
  * @param fjt Object used to compute the fundamental integrals.
- * @param p12 ShellPair data structure for the left
- * @param p34 ShellPair data structure for the right
+ * @param pairs12 Primitive pair list for the left
+ * @param sh1 Shell on center 1
+ * @param sh2 Shell on center 2
+ * @param pairs34 Primitive pair list for the right
+ * @param sh3 Shell on center 3
+ * @param sh4 Shell on center 4
  * @param am Total angular momentum of this quartet
- * @param nprim1 Number of primitives on center 1
- * @param nprim2 Number of primitives on center 2
- * @param nprim3 Number of primitives on center 3
- * @param nprim4 Number of primitives on center 4
- * @param sh1eqsh2 Is the shell on center 1 identical to that on center 2?
- * @param sh3eqsh4 Is the shell on center 3 identical to that on center 4?
  * @param deriv_lvl Derivitive level of the integral
  * @return The total number of primitive combinations found. This is passed to libint/libderiv.
  */
-static size_t fill_primitive_data(prim_data *PrimQuartet, Fjt *fjt, const ShellPair *p12, const ShellPair *p34, int am,
-                                  int nprim1, int nprim2, int nprim3, int nprim4, bool sh1eqsh2, bool sh3eqsh4,
-                                  int deriv_lvl) {
+static size_t fill_primitive_data(prim_data *PrimQuartet, Fjt *fjt, const ShellPairList &pairs12, int sh1, int sh2,
+                                  const ShellPairList &pairs34, int sh3, int sh4, int am, int deriv_lvl) {
     double zeta, eta, ooze, rho, poz, coef1, PQx, PQy, PQz, PQ2, Wx, Wy, Wz, o12, o34, T, *F;
-    double a1, a2, a3, a4;
-    int p1, p2, p3, p4, i;
+    int i;
     size_t nprim = 0L;
-    double *pai = p12->ai;
-    double *pgamma12 = p12->gamma[0];
-    double *poverlap12 = p12->overlap[0];
-    for (p1 = 0; p1 < nprim1; ++p1) {
-        a1 = *pai;
-        ++pai;
-        double *paj = p12->aj;
-        for (p2 = 0; p2 < nprim2; ++p2) {
-            a2 = *paj;
-            zeta = *pgamma12;
-            o12 = *poverlap12;
-            ++paj;
-            ++pgamma12;
-            ++poverlap12;
-            double PAx = p12->PA[p1][p2][0];
-            double PAy = p12->PA[p1][p2][1];
-            double PAz = p12->PA[p1][p2][2];
-            double PBx = p12->PB[p1][p2][0];
-            double PBy = p12->PB[p1][p2][1];
-            double PBz = p12->PB[p1][p2][2];
-            double PABx = p12->P[p1][p2][0];
-            double PABy = p12->P[p1][p2][1];
-            double PABz = p12->P[p1][p2][2];
-
-            double *pak = p34->ai;
-            double *pgamma34 = p34->gamma[0];
-            double *poverlap34 = p34->overlap[0];
-            for (p3 = 0; p3 < nprim3; ++p3) {
-                a3 = *pak;
-                ++pak;
-                double *pal = p34->aj;
-                for (p4 = 0; p4 < nprim4; ++p4) {
-                    a4 = *pal;
-                    eta = *pgamma34;
-                    o34 = *poverlap34;
-                    ++pal;
-                    ++pgamma34;
-                    ++poverlap34;
-
-                    double PCx = p34->PA[p3][p4][0];
-                    double PCy = p34->PA[p3][p4][1];
-                    double PCz = p34->PA[p3][p4][2];
-                    double PDx = p34->PB[p3][p4][0];
-                    double PDy = p34->PB[p3][p4][1];
-                    double PDz = p34->PB[p3][p4][2];
-                    double PCDx = p34->P[p3][p4][0];
-                    double PCDy = p34->P[p3][p4][1];
-                    double PCDz = p34->P[p3][p4][2];
-
-                    ooze = 1.0 / (zeta + eta);
-                    poz = eta * ooze;
-                    rho = zeta * poz;
-                    coef1 = 2.0 * sqrt(rho * M_1_PI) * o12 * o34;
-
-                    PrimQuartet[nprim].poz = poz;
-                    PrimQuartet[nprim].oo2zn = 0.5 * ooze;
-                    PrimQuartet[nprim].pon = zeta * ooze;
-                    PrimQuartet[nprim].oo2z = 0.5 / zeta;
-                    PrimQuartet[nprim].oo2n = 0.5 / eta;
-                    PrimQuartet[nprim].twozeta_a = 2.0 * a1;
-                    PrimQuartet[nprim].twozeta_b = 2.0 * a2;
-                    PrimQuartet[nprim].twozeta_c = 2.0 * a3;
-                    PrimQuartet[nprim].twozeta_d = 2.0 * a4;
-
-                    PQx = PABx - PCDx;
-                    PQy = PABy - PCDy;
-                    PQz = PABz - PCDz;
-                    PQ2 = PQx * PQx + PQy * PQy + PQz * PQz;
-
-                    Wx = (PABx * zeta + PCDx * eta) * ooze;
-                    Wy = (PABy * zeta + PCDy * eta) * ooze;
-                    Wz = (PABz * zeta + PCDz * eta) * ooze;
-
-                    // PA
-                    PrimQuartet[nprim].U[0][0] = PAx;
-                    PrimQuartet[nprim].U[0][1] = PAy;
-                    PrimQuartet[nprim].U[0][2] = PAz;
-                    // PB
-                    PrimQuartet[nprim].U[1][0] = PBx;
-                    PrimQuartet[nprim].U[1][1] = PBy;
-                    PrimQuartet[nprim].U[1][2] = PBz;
-                    // QC
-                    PrimQuartet[nprim].U[2][0] = PCx;
-                    PrimQuartet[nprim].U[2][1] = PCy;
-                    PrimQuartet[nprim].U[2][2] = PCz;
-                    // QD
-                    PrimQuartet[nprim].U[3][0] = PDx;
-                    PrimQuartet[nprim].U[3][1] = PDy;
-                    PrimQuartet[nprim].U[3][2] = PDz;
-                    // WP
-                    PrimQuartet[nprim].U[4][0] = Wx - PABx;
-                    PrimQuartet[nprim].U[4][1] = Wy - PABy;
-                    PrimQuartet[nprim].U[4][2] = Wz - PABz;
-                    // WQ
-                    PrimQuartet[nprim].U[5][0] = Wx - PCDx;
-                    PrimQuartet[nprim].U[5][1] = Wy - PCDy;
-                    PrimQuartet[nprim].U[5][2] = Wz - PCDz;
-
-                    T = rho * PQ2;
-                    fjt->set_rho(rho);
-                    F = fjt->values(am + deriv_lvl, T);
-
-                    for (i = 0; i <= am + deriv_lvl; ++i) PrimQuartet[nprim].F[i] = F[i] * coef1;
-
-                    nprim++;
-                }
+    const int n12 = pairs12.nprimitive(sh1, sh2);
+    const int n34 = pairs34.nprimitive(sh3, sh4);
+    const PrimitivePair *p12 = pairs12.primitives(sh1, sh2);
+    for (int i12 = 0; i12 < n12; ++i12, ++p12) {
+        zeta = p12->gamma;
+        o12 = p12->overlap;
+        double PABx = p12->P[0];
+        double PABy = p12->P[1];
+        double PABz = p12->P[2];
+
+        const PrimitivePair *p34 = pairs34.primitives(sh3, sh4);
+        for (int i34 = 0; i34 < n34; ++i34, ++p34) {
+            eta = p34->gamma;
+            o34 = p34->overlap;
+            double PCDx = p34->P[0];
+            double PCDy = p34->P[1];
+            double PCDz = p34->P[2];
+
+            ooze = 1.0 / (zeta + eta);
+            poz = eta * ooze;
+            rho = zeta * poz;
+            coef1 = 2.0 * sqrt(rho * M_1_PI) * o12 * o34;
+
+            prim_data &prim = PrimQuartet[nprim];
+            prim.poz = poz;
+            prim.oo2zn = 0.5 * ooze;
+            prim.pon = zeta * ooze;
+            prim.oo2z = p12->oo2gamma;
+            prim.oo2n = p34->oo2gamma;
+            prim.oo2p = 0.5 / rho;
+            prim.twozeta_a = 2.0 * p12->a1;
+            prim.twozeta_b = 2.0 * p12->a2;
+            prim.twozeta_c = 2.0 * p34->a1;
+            prim.twozeta_d = 2.0 * p34->a2;
+
+            PQx = PABx - PCDx;
+            PQy = PABy - PCDy;
+            PQz = PABz - PCDz;
+            PQ2 = PQx * PQx + PQy * PQy + PQz * PQz;
+
+            Wx = (PABx * zeta + PCDx * eta) * ooze;
+            Wy = (PABy * zeta + PCDy * eta) * ooze;
+            Wz = (PABz * zeta + PCDz * eta) * ooze;
+
+            for (i = 0; i < 3; ++i) {
+                // PA, PB, QC, QD
+                prim.U[0][i] = p12->PA[i];
+                prim.U[1][i] = p12->PB[i];
+                prim.U[2][i] = p34->PA[i];
+                prim.U[3][i] = p34->PB[i];
             }
+            // WP
+            prim.U[4][0] = Wx - PABx;
+            prim.U[4][1] = Wy - PABy;
+            prim.U[4][2] = Wz - PABz;
+            // WQ
+            prim.U[5][0] = Wx - PCDx;
+            prim.U[5][1] = Wy - PCDy;
+            prim.U[5][2] = Wz - PCDz;
+
+            T = rho * PQ2;
+            fjt->set_rho(rho);
+            F = fjt->values(am + deriv_lvl, T);
+
+            for (i = 0; i <= am + deriv_lvl; ++i) prim.F[i] = F[i] * coef1;
+
+            nprim++;
         }
     }
     return nprim;
@@ -1876,16 +1833,19 @@ TwoElectronInt::TwoElectronInt(const IntegralFactory *integral, int deriv, bool
     }
     memset(source_, 0, sizeof(double) * size);
 
-    if (basis1() != basis2() || basis1() != basis3() || basis2() != basis4()) {
-        use_shell_pairs_ = false;
-    }
-
     if (use_shell_pairs_) {
-        // Precompute a bunch of information
-        init_shell_pairs12();
-        // If basis3 and basis4 equals basis1 and basis2, then the following function will do nothing,
-        // except assign pairs34_ to pairs12_
-        init_shell_pairs34();
+        // compute_quartet may swap the centers within and between the pairs, so fetch every ordering it can
+        // ask for. The factory builds each list once and hands the same copy to all of its integral objects;
+        // for (PQ|RS) these all collapse to a single list, for three-index (Q0|mn) to two small ones.
+        std::shared_ptr<BasisSet> bra_ket[4][2] = {{basis1(), basis2()},
+                                                   {basis2(), basis1()},
+                                                   {basis3(), basis4()},
+                                                   {basis4(), basis3()}};
+        for (auto &bk : bra_ket) {
+            std::shared_ptr<ShellPairList> list = integral->shell_pairs(bk[0], bk[1]);
+            if (std::find(pair_lists_.begin(), pair_lists_.end(), list) == pair_lists_.end())
+                pair_lists_.push_back(list);
+        }
     }
 
     // form the blocking. We use the default
@@ -1898,305 +1858,14 @@ TwoElectronInt::~TwoElectronInt() {
     delete[] source_full_;
     free_libint(&libint_);
     if (deriv_) free_libderiv(&libderiv_);
-    free_shell_pairs12();
-    free_shell_pairs34();  // This shouldn't do anything, but this might change in the future
-}
-
-void TwoElectronInt::init_shell_pairs12() {
-    ShellPair *sp;
-    Vector3 P, PA, PB, AB, A, B;
-    int i, j, si, sj, np_i, np_j;
-    size_t memd;
-    double a1, a2, ab2, gam, c1, c2;
-    double *curr_stack_ptr;
-
-    // Estimate memory needed by allocated space for the dynamically allocated parts of ShellPair structure
-    memd = TwoElectronInt::memory_to_store_shell_pairs(basis1(), basis2());
-
-    // Allocate a stack of memory
-    stack12_ = new double[memd];
-    curr_stack_ptr = stack12_;
-
-    // Allocate shell pair memory
-    pairs12_ = new ShellPair *[basis1()->nshell()];
-    for (i = 0; i < basis1()->nshell(); ++i) pairs12_[i] = new ShellPair[basis2()->nshell()];
-
-    // Loop over all shell pairs (si, sj) and create primitive pairs pairs
-    for (si = 0; si < basis1()->nshell(); ++si) {
-        A = basis1()->shell(si).center();
-
-        for (sj = 0; sj < basis2()->nshell(); ++sj) {
-            B = basis2()->shell(sj).center();
-
-            AB = A - B;
-            ab2 = AB.dot(AB);
-
-            // Get the pointer for convenience
-            sp = &(pairs12_[si][sj]);
-
-            // Save some information
-            sp->i = si;
-            sp->j = sj;
-            sp->AB[0] = AB[0];
-            sp->AB[1] = AB[1];
-            sp->AB[2] = AB[2];
-
-            np_i = basis1()->shell(si).nprimitive();
-            np_j = basis2()->shell(sj).nprimitive();
-
-            // Reserve some memory for the primitives
-            sp->ai = curr_stack_ptr;
-            curr_stack_ptr += np_i;
-            sp->aj = curr_stack_ptr;
-            curr_stack_ptr += np_j;
-
-            // Allocate and reserve memory for gammas
-            sp->gamma = new double *[np_i];
-            for (i = 0; i < np_i; ++i) {
-                sp->gamma[i] = curr_stack_ptr;
-                curr_stack_ptr += np_j;
-            }
-
-            // Reserve space for contraction coefficients
-            sp->ci = curr_stack_ptr;
-            curr_stack_ptr += np_i;
-            sp->cj = curr_stack_ptr;
-            curr_stack_ptr += np_j;
-
-            // Allocate and reserve space for overlaps
-            sp->overlap = new double *[np_i];
-            for (i = 0; i < np_i; ++i) {
-                sp->overlap[i] = curr_stack_ptr;
-                curr_stack_ptr += np_j;
-            }
-
-            // Allocate and reserve space for P, PA, and PB.
-            sp->P = new double **[np_i];
-            sp->PA = new double **[np_i];
-            sp->PB = new double **[np_i];
-            for (i = 0; i < np_i; ++i) {
-                sp->P[i] = new double *[np_j];
-                sp->PA[i] = new double *[np_j];
-                sp->PB[i] = new double *[np_j];
-
-                for (j = 0; j < np_j; ++j) {
-                    sp->P[i][j] = curr_stack_ptr;
-                    curr_stack_ptr += 3;
-                    sp->PA[i][j] = curr_stack_ptr;
-                    curr_stack_ptr += 3;
-                    sp->PB[i][j] = curr_stack_ptr;
-                    curr_stack_ptr += 3;
-                }
-            }
-
-            // All memory has been reserved/allocated for this shell primitive pair pair.
-            // Pre-compute all data that we can:
-            for (i = 0; i < np_i; ++i) {
-                a1 = basis1()->shell(si).exp(i);
-                c1 = basis1()->shell(si).coef(i);
-
-                // Save some information
-                sp->ai[i] = a1;
-                sp->ci[i] = c1;
-
-                for (j = 0; j < np_j; ++j) {
-                    a2 = basis2()->shell(sj).exp(j);
-                    c2 = basis2()->shell(sj).coef(j);
-
-                    gam = a1 + a2;
-
-                    // Compute Gaussian product and component distances
-                    P = (A * a1 + B * a2) / gam;
-                    PA = P - A;
-                    PB = P - B;
-
-                    // Copy data into pairs array
-                    sp->aj[j] = a2;
-                    sp->cj[j] = c2;
-                    sp->gamma[i][j] = gam;
-                    sp->P[i][j][0] = P[0];
-                    sp->P[i][j][1] = P[1];
-                    sp->P[i][j][2] = P[2];
-                    sp->PA[i][j][0] = PA[0];
-                    sp->PA[i][j][1] = PA[1];
-                    sp->PA[i][j][2] = PA[2];
-                    sp->PB[i][j][0] = PB[0];
-                    sp->PB[i][j][1] = PB[1];
-                    sp->PB[i][j][2] = PB[2];
-                    sp->overlap[i][j] = pow(M_PI / gam, 3.0 / 2.0) * exp(-a1 * a2 * ab2 / gam) * c1 * c2;
-                }
-            }
-        }
-    }
-}
-
-void TwoElectronInt::init_shell_pairs34() {
-    // If basis1 == basis3 && basis2 == basis4, then we don't need to do anything except use the pointer
-    // of pairs12_.
-    if (use_shell_pairs_ == true) {
-        // This assumes init_shell_pairs12 was called and precomputed the values.
-        pairs34_ = pairs12_;
-        stack34_ = nullptr;
-        return;
-    }
-#if 0
-                                                                                                                            outfile->Printf( "  Pre-computing additional values for two-electron integrals. [ |34) does not equal (12| ]\n");
-
-    // Estimate memory needed by allocated space for the dynamically allocated parts of ShellPair structure
-    memd = ERIBase::memory_to_store_shell_pairs(basis3(), basis4());
-
-    // Allocate a stack of memory
-    stack34_ = new double[memd];
-    curr_stack_ptr = stack34_;
-
-    // Allocate shell pair memory
-    pairs34_ = new ShellPair*[basis3()->nprimitive()];
-    for (i=0; i<basis3()->nprimitive(); ++i)
-        pairs34_[i] = new ShellPair[basis4()->nprimitive()];
-
-    // Loop over all shell pairs (si, sj) and create primitive pairs pairs
-    for (si=0; si<basis3()->nprimitive(); ++si) {
-        A = basis3()->shell(si).center();
-
-        for (sj=0; sj<basis4()->nprimitive(); ++sj) {
-            B = basis4()->shell(sj).center();
-
-            AB = A - B;
-            ab2 = AB.dot(AB);
-
-            // Get the pointer for convenience
-            sp = &(pairs34_[si][sj]);
-
-            // Save some information
-            sp->i = si;
-            sp->j = sj;
-            sp->AB[0] = AB[0]; sp->AB[1] = AB[1]; sp->AB[2] = AB[2];
-
-            np_i = basis3()->shell(si).nprimitive();
-            np_j = basis4()->shell(sj).nprimitive();
-
-            // Reserve some memory for the primitives
-            sp->ai = curr_stack_ptr; curr_stack_ptr += np_i;
-            sp->aj = curr_stack_ptr; curr_stack_ptr += np_j;
-
-            // Allocate and reserve memory for gammas
-            sp->gamma = new double*[np_i];
-            for (i=0; i<np_i; ++i) {
-                sp->gamma[i] = curr_stack_ptr; curr_stack_ptr += np_j;
-            }
-
-            // Reserve space for contraction coefficients
-            sp->ci = curr_stack_ptr; curr_stack_ptr += np_i;
-            sp->cj = curr_stack_ptr; curr_stack_ptr += np_j;
-
-            // Allocate and reserve space for overlaps
-            sp->overlap = new double*[np_i];
-            for (i=0; i<np_i; ++i) {
-                sp->overlap[i] = curr_stack_ptr; curr_stack_ptr += np_j;
-            }
-
-            // Allocate and reserve space for P, PA, and PB.
-            sp->P  = new double**[np_i];
-            sp->PA = new double**[np_i];
-            sp->PB = new double**[np_i];
-            for (i=0; i<np_i; ++i) {
-                sp->P[i]  = new double*[np_j];
-                sp->PA[i] = new double*[np_j];
-                sp->PB[i] = new double*[np_j];
-
-                for (j=0; j<np_j; ++j) {
-                    sp->P[i][j]  = curr_stack_ptr; curr_stack_ptr += 3;
-                    sp->PA[i][j] = curr_stack_ptr; curr_stack_ptr += 3;
-                    sp->PB[i][j] = curr_stack_ptr; curr_stack_ptr += 3;
-                }
-            }
-
-            // All memory has been reserved/allocated for this shell primitive pair pair.
-            // Pre-compute all data that we can:
-            for (i=0; i<np_i; ++i) {
-                a1 = basis3()->shell(si)->exp(i);
-                c1 = basis3()->shell(si)->coef(i);
-
-                // Save some information
-                sp->ai[i] = a1;
-                sp->ci[i] = c1;
-
-                for (j=0; j<np_j; ++j) {
-                    a2 = basis4()->shell(sj)->exp(j);
-                    c2 = basis4()->shell(sj)->coef(j);
-
-                    gam = a1 + a2;
-
-                    // Compute some distances
-                    P = ( A * a1 + B * a2 ) / gam;
-                    PA = P - A;
-                    PB = P - B;
-
-                    // Copy data into pairs array
-                    sp->aj[j] = a2;
-                    sp->cj[j] = c2;
-                    sp->gamma[i][j] = gam;
-                    sp->P[i][j][0]  = P[0];  sp->P[i][j][1]  = P[1];  sp->P[i][j][2]  = P[2];
-                    sp->PA[i][j][0] = PA[0]; sp->PA[i][j][1] = PA[1]; sp->PA[i][j][2] = PA[2];
-                    sp->PB[i][j][0] = PB[0]; sp->PB[i][j][1] = PB[1]; sp->PB[i][j][2] = PB[2];
-                    sp->overlap[i][j] = pow(M_PI/gam, 3.0/2.0) * exp(-a1*a2*ab2/gam) * c1 * c2;
-                }
-            }
-        }
-    }
-#endif
 }
 
-void TwoElectronInt::free_shell_pairs12() {
-    int i, si, sj;
-    ShellPair *sp;
-    int np_i;
-
-    if (!use_shell_pairs_) return;
-
-    delete[] stack12_;
-    for (si = 0; si < basis1()->nshell(); ++si) {
-        for (sj = 0; sj < basis2()->nshell(); ++sj) {
-            np_i = basis1()->shell(si).nprimitive();
-            sp = &(pairs12_[si][sj]);
-
-            delete[] sp->gamma;
-            delete[] sp->overlap;
-
-            if (sp->P != nullptr) {
-                for (i = 0; i < np_i; ++i) delete[] sp->P[i];
-                delete[] sp->P;
-            }
-            if (sp->PA != nullptr) {
-                for (i = 0; i < np_i; ++i) delete[] sp->PA[i];
-                delete[] sp->PA;
-            }
-            if (sp->PB != nullptr) {
-                for (i = 0; i < np_i; ++i) delete[] sp->PB[i];
-                delete[] sp->PB;
-            }
-        }
-    }
-
-    for (si = 0; si < basis1()->nshell(); ++si) delete[] pairs12_[si];
-    delete[] pairs12_;
-}
-
-void TwoElectronInt::free_shell_pairs34() {}
-
-size_t TwoElectronInt::memory_to_store_shell_pairs(const std::shared_ptr<BasisSet> &bs1,
-                                                   const std::shared_ptr<BasisSet> &bs2) {
-    int i, j, np_i, np_j;
-    size_t mem = 0;
-
-    for (i = 0; i < bs1->nshell(); ++i) {
-        np_i = bs1->shell(i).nprimitive();
-        for (j = 0; j < bs2->nshell(); ++j) {
-            np_j = bs2->shell(j).nprimitive();
-            mem += (2 * (np_i + np_j) + 11 * np_i * np_j);
-        }
+const ShellPairList &TwoElectronInt::pair_list(const std::shared_ptr<BasisSet> &bs_a,
+                                               const std::shared_ptr<BasisSet> &bs_b) const {
+    for (const auto &list : pair_lists_) {
+        if (list->basis1() == bs_a && list->basis2() == bs_b) return *list;
     }
-    return mem;
+    throw PSIEXCEPTION("TwoElectronInt: no primitive pair list for the requested basis sets.");
 }
 
 size_t TwoElectronInt::compute_shell(const AOShellCombinationsIterator &shellIter) {
@@ -2421,15 +2090,10 @@ size_t TwoElectronInt::compute_quartet(int sh1, int sh2, int sh3, int sh4) {
     nprim3 = s3.nprimitive();
     nprim4 = s4.nprimitive();
 
-    // If we can, use the precomputed values found in ShellPair.
+    // If we can, use the precomputed values found in the shared ShellPairList.
     if (use_shell_pairs_) {
-        ShellPair *p12, *p34;
-        // 1234 -> 1234 no change
-        p12 = &(pairs12_[sh1][sh2]);
-        p34 = &(pairs34_[sh3][sh4]);
-
-        nprim = fill_primitive_data(libint_.PrimQuartet, fjt_, p12, p34, am, nprim1, nprim2, nprim3, nprim4, sh1 == sh2,
-                                    sh3 == sh4, 0);
+        nprim = fill_primitive_data(libint_.PrimQuartet, fjt_, pair_list(bs1_, bs2_), sh1, sh2, pair_list(bs3_, bs4_),
+                                    sh3, sh4, am, 0);
     } else {
         const double *a1s = s1.exps();
         const double *a2s = s2.exps();
@@ -2560,7 +2224,10 @@ size_t TwoElectronInt::compute_quartet(int sh1, int sh2, int sh3, int sh4) {
 #endif
 
     // Compute the integral
-    if (am) {
+    if (nprim == 0) {
+        // Every primitive pair on one side was screened out
+        memset(source_, 0, sizeof(double) * size);
+    } else if (am) {
         double *target_ints;
 
         target_ints = build_eri[am1][am2][am3][am4](&libint_, nprim);
@@ -2787,12 +2454,8 @@ size_t TwoElectronInt::compute_quartet_deriv1(int sh1, int sh2, int sh3, int sh4
     nprim = 0;
 
     if (use_shell_pairs_) {
-        ShellPair *p12, *p34;
-        p12 = &(pairs12_[sh1][sh2]);
-        p34 = &(pairs34_[sh3][sh4]);
-
-        nprim = fill_primitive_data(libderiv_.PrimQuartet, fjt_, p12, p34, am, nprim1, nprim2, nprim3, nprim4,
-                                    sh1 == sh2, sh3 == sh4, 1);
+        nprim = fill_primitive_data(libderiv_.PrimQuartet, fjt_, pair_list(bs1_, bs2_), sh1, sh2,
+                                    pair_list(bs3_, bs4_), sh3, sh4, am, 1);
     } else {
         for (int p1 = 0; p1 < nprim1; ++p1) {
             double a1 = s1.exp(p1);
@@ -2911,12 +2574,12 @@ size_t TwoElectronInt::compute_quartet_deriv1(int sh1, int sh2, int sh3, int sh4
     // How many are there?
     size_t size = INT_NCART(am1) * INT_NCART(am2) * INT_NCART(am3) * INT_NCART(am4);
 
-    // Compute the integral
-    build_deriv1_eri[am1][am2][am3][am4](&libderiv_, nprim);
-
     // Zero out memory
     memset(source_, 0, sizeof(double) * size * ERI_1DER_NTYPE);
 
+    // Compute the integral, unless every primitive pair on one side was screened out
+    if (nprim) build_deriv1_eri[am1][am2][am3][am4](&libderiv_, nprim);
+
     // Copy results from libderiv into source_ (note libderiv only gives 3 of the centers).
     // The libmints array returns the following integral derivatives:
     //   0 -> A_x
@@ -2933,7 +2596,7 @@ size_t TwoElectronInt::compute_quartet_deriv1(int sh1, int sh2, int sh3, int sh4
     //   B_y = -(A_y + C_y + D_y)
     //   B_z = -(A_z + C_z + D_z)
 
-    handle_reordering1(permuted_order_, libderiv_, source_, size);
+    if (nprim) handle_reordering1(permuted_order_, libderiv_, source_, size);
 
     // Transform the integrals to the spherical basis
     if (!force_cartesian_) pure_transform(sh1, sh2, sh3, sh4, ERI_1DER_NTYPE);
@@ -3128,12 +2791,8 @@ size_t TwoElectronInt::compute_quartet_deriv2(int sh1, int sh2, int sh3, int sh4
 
     // prepare all the data needed for libderiv
     if (use_shell_pairs_) {
-        ShellPair *p12, *p34;
-        p12 = &(pairs12_[sh1][sh2]);
-        p34 = &(pairs34_[sh3][sh4]);
-
-        nprim = fill_primitive_data(libderiv_.PrimQuartet, fjt_, p12, p34, am, nprim1, nprim2, nprim3, nprim4,
-                                    sh1 == sh2, sh3 == sh4, 2);
+        nprim = fill_primitive_data(libderiv_.PrimQuartet, fjt_, pair_list(bs1_, bs2_), sh1, sh2,
+                                    pair_list(bs3_, bs4_), sh3, sh4, am, 2);
     } else {
         for (int p1 = 0; p1 < nprim1; ++p1) {
             double a1 = s1.exp(p1);
@@ -3242,13 +2901,15 @@ size_t TwoElectronInt::compute_quartet_deriv2(int sh1, int sh2, int sh3, int sh4
     }
 
     size_t size = INT_NCART(am1) * INT_NCART(am2) * INT_NCART(am3) * INT_NCART(am4);
-    build_deriv12_eri[am1][am2][am3][am4](&libderiv_, nprim);
 
     // zero out the memory
     memset(source_, 0, sizeof(double) * size * ERI_2DER_NTYPE);
 
     // Copy results from libderiv into source_ (note libderiv only gives 3 of the centers)
-    handle_reordering12(permuted_order_, libderiv_, source_, size);
+    if (nprim) {
+        build_deriv12_eri[am1][am2][am3][am4](&libderiv_, nprim);
+        handle_reordering12(permuted_order_, libderiv_, source_, size);
+    }
 
     // Transform the integrals to the spherical basis
     if (!force_cartesian_) pure_transform(sh1, sh2, sh3, sh4, ERI_2DER_NTYPE);
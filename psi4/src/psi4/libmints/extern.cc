@@ -38,13 +38,214 @@
 #include "psi4/libpsi4util/PsiOutStream.h"
 #include "psi4/libpsi4util/process.h"
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
 #ifdef _OPENMP
 #include <omp.h>
 #endif
 
 namespace psi {
 
-ExternalPotential::ExternalPotential() : debug_(0), print_(1) {}
+namespace {
+
+// Primitive value below which a shell is considered to have ended, for far-field targets
+const double shell_extent_cutoff = 1.0E-8;
+// Charges per leaf of the far-field charge tree
+const size_t charge_tree_leaf = 32;
+// Fields below this size are cheaper to treat exactly
+const size_t far_field_min_charges = 1000;
+
+/// Radius beyond which the most diffuse primitive of the shell is negligible
+double shell_extent(const GaussianShell &shell) {
+    double amin = shell.exp(0);
+    for (int K = 1; K < shell.nprimitive(); K++) amin = std::min(amin, shell.exp(K));
+    return std::sqrt(-std::log(shell_extent_cutoff) / amin);
+}
+
+/// Octree over a field of point charges (rows Z,x,y,z, in bohr). Each cell stores seven
+/// pseudo-charges, on its center and at +/- half its width along the principal axes of
+/// its second moment, which reproduce the cell's charge, dipole and second moment.
+class ChargeTree {
+    struct Cell {
+        double center[3];
+        double half;
+        size_t begin, end;
+        int children[8];
+        int nchild;
+        double pseudo[7][4];
+    };
+
+    std::vector<std::array<double, 4>> charges_;
+    std::vector<Cell> cells_;
+
+    int build(size_t begin, size_t end, const double *center, double half, int depth) {
+        int index = cells_.size();
+        cells_.push_back(Cell());
+        Cell &cell = cells_.back();
+        std::copy(center, center + 3, cell.center);
+        cell.half = half;
+        cell.begin = begin;
+        cell.end = end;
+        cell.nchild = 0;
+        form_pseudo_charges(index);
+
+        if (end - begin <= charge_tree_leaf || depth >= 20) return index;
+
+        // Bucket the charges by octant
+        auto octant = [center](const std::array<double, 4> &c) {
+            return (c[1] > center[0] ? 1 : 0) + (c[2] > center[1] ? 2 : 0) + (c[3] > center[2] ? 4 : 0);
+        };
+        size_t counts[9] = {0};
+        for (size_t i = begin; i < end; i++) counts[octant(charges_[i]) + 1]++;
+        for (int o = 0; o < 8; o++) counts[o + 1] += counts[o];
+        std::vector<std::array<double, 4>> sorted(end - begin);
+        size_t fill[8];
+        std::copy(counts, counts + 8, fill);
+        for (size_t i = begin; i < end; i++) sorted[fill[octant(charges_[i])]++] = charges_[i];
+        std::copy(sorted.begin(), sorted.end(), charges_.begin() + begin);
+
+        int children[8];
+        int nchild = 0;
+        for (int o = 0; o < 8; o++) {
+            if (counts[o + 1] == counts[o]) continue;
+            double child_center[3];
+            child_center[0] = center[0] + (o & 1 ? 0.5 : -0.5) * half;
+            child_center[1] = center[1] + (o & 2 ? 0.5 : -0.5) * half;
+            child_center[2] = center[2] + (o & 4 ? 0.5 : -0.5) * half;
+            children[nchild++] =
+                build(begin + counts[o], begin + counts[o + 1], child_center, 0.5 * half, depth + 1);
+        }
+        // cells_ may have been reallocated by the recursion
+        std::copy(children, children + nchild, cells_[index].children);
+        cells_[index].nchild = nchild;
+        return index;
+    }
+
+    void form_pseudo_charges(int index) {
+        Cell &cell = cells_[index];
+        double q = 0.0;
+        double mu[3] = {0.0, 0.0, 0.0};
+        double Q[9] = {0.0};
+        for (size_t i = cell.begin; i < cell.end; i++) {
+            const std::array<double, 4> &c = charges_[i];
+            double d[3] = {c[1] - cell.center[0], c[2] - cell.center[1], c[3] - cell.center[2]};
+            q += c[0];
+            for (int a = 0; a < 3; a++) {
+                mu[a] += c[0] * d[a];
+                for (int b = 0; b < 3; b++) Q[3 * a + b] += c[0] * d[a] * d[b];
+            }
+        }
+
+        // Principal axes of the second moment; eigenvector k is Q[3k..3k+2]
+        double lambda[3];
+        double work[16];
+        C_DSYEV('V', 'U', 3, Q, 3, lambda, work, 16);
+
+        double s = (cell.half > 0.0 ? cell.half : 1.0);
+        double q0 = q;
+        for (int k = 0; k < 3; k++) {
+            const double *e = &Q[3 * k];
+            double m = mu[0] * e[0] + mu[1] * e[1] + mu[2] * e[2];
+            double qp = 0.5 * (lambda[k] / (s * s) + m / s);
+            double qm = 0.5 * (lambda[k] / (s * s) - m / s);
+            q0 -= qp + qm;
+            cell.pseudo[2 * k + 1][0] = qp;
+            cell.pseudo[2 * k + 2][0] = qm;
+            for (int a = 0; a < 3; a++) {
+                cell.pseudo[2 * k + 1][a + 1] = cell.center[a] + s * e[a];
+                cell.pseudo[2 * k + 2][a + 1] = cell.center[a] - s * e[a];
+            }
+        }
+        cell.pseudo[0][0] = q0;
+        std::copy(cell.center, cell.center + 3, &cell.pseudo[0][1]);
+    }
+
+   public:
+    explicit ChargeTree(SharedMatrix Zxyz) {
+        double **Zxyzp = Zxyz->pointer();
+        size_t ncharge = Zxyz->rowspi()[0];
+        charges_.resize(ncharge);
+        double lo[3] = {0.0, 0.0, 0.0};
+        double hi[3] = {0.0, 0.0, 0.0};
+        for (size_t i = 0; i < ncharge; i++) {
+            std::copy(Zxyzp[i], Zxyzp[i] + 4, charges_[i].begin());
+            for (int a = 0; a < 3; a++) {
+                lo[a] = (i == 0 ? Zxyzp[i][a + 1] : std::min(lo[a], Zxyzp[i][a + 1]));
+                hi[a] = (i == 0 ? Zxyzp[i][a + 1] : std::max(hi[a], Zxyzp[i][a + 1]));
+            }
+        }
+        double center[3];
+        double half = 0.0;
+        for (int a = 0; a < 3; a++) {
+            center[a] = 0.5 * (lo[a] + hi[a]);
+            half = std::max(half, 0.5 * (hi[a] - lo[a]));
+        }
+        build(0, ncharge, center, 1.0001 * half, 0);
+    }
+
+    /// The charge field seen by a target sphere (center, radius): exact charges near it,
+    /// pseudo-charges for every cell that is well separated from it
+    SharedMatrix field(const double *center, double radius, double theta) const {
+        std::vector<std::array<double, 4>> field;
+        std::vector<int> stack(1, 0);
+        while (!stack.empty()) {
+            const Cell &cell = cells_[stack.back()];
+            stack.pop_back();
+            double dx = cell.center[0] - center[0];
+            double dy = cell.center[1] - center[1];
+            double dz = cell.center[2] - center[2];
+            double R = std::sqrt(dx * dx + dy * dy + dz * dz);
+            double rho = std::sqrt(3.0) * cell.half;
+            if (cell.end - cell.begin > 7 && rho + radius < theta * R) {
+                for (int k = 0; k < 7; k++) {
+                    field.push_back({{cell.pseudo[k][0], cell.pseudo[k][1], cell.pseudo[k][2], cell.pseudo[k][3]}});
+                }
+            } else if (cell.nchild == 0) {
+                field.insert(field.end(), charges_.begin() + cell.begin, charges_.begin() + cell.end);
+            } else {
+                stack.insert(stack.end(), cell.children, cell.children + cell.nchild);
+            }
+        }
+
+        auto Zxyz = std::make_shared<Matrix>("Charges (Z,x,y,z)", field.size(), 4);
+        if (field.size()) ::memcpy(Zxyz->pointer()[0], field.data(), sizeof(double) * 4 * field.size());
+        return Zxyz;
+    }
+};
+
+/// The point charges in bohr, as rows of (Z,x,y,z)
+SharedMatrix charge_field(const std::vector<std::tuple<double, double, double, double> > &charges, double convfac) {
+    auto Zxyz = std::make_shared<Matrix>("Charges (Z,x,y,z)", charges.size(), 4);
+    double **Zxyzp = Zxyz->pointer();
+    for (size_t i = 0; i < charges.size(); i++) {
+        Zxyzp[i][0] = std::get<0>(charges[i]);
+        Zxyzp[i][1] = convfac * std::get<1>(charges[i]);
+        Zxyzp[i][2] = convfac * std::get<2>(charges[i]);
+        Zxyzp[i][3] = convfac * std::get<3>(charges[i]);
+    }
+    return Zxyz;
+}
+
+/// Lower-triangle shell pairs, each assigned to its more compact shell
+std::vector<std::vector<std::pair<int, int> > > far_field_targets(std::shared_ptr<BasisSet> basis,
+                                                                   std::vector<double> &extents) {
+    int nshell = basis->nshell();
+    extents.resize(nshell);
+    for (int P = 0; P < nshell; P++) extents[P] = shell_extent(basis->shell(P));
+    std::vector<std::vector<std::pair<int, int> > > targets(nshell);
+    for (int P = 0; P < nshell; P++) {
+        for (int Q = 0; Q <= P; Q++) {
+            targets[extents[Q] < extents[P] ? Q : P].push_back(std::make_pair(P, Q));
+        }
+    }
+    return targets;
+}
+
+}  // namespace
+
+ExternalPotential::ExternalPotential() : debug_(0), print_(1), far_field_theta_(0.0) {}
 
 ExternalPotential::~ExternalPotential() {}
 
@@ -65,6 +266,10 @@ void ExternalPotential::print(std::string out) const {
     std::shared_ptr<psi::PsiOutStream> printer = (out == "outfile" ? outfile : std::make_shared<PsiOutStream>(out));
     printer->Printf("   => External Potential Field: %s <= \n\n", name_.c_str());
 
+    if (far_field_theta_ > 0.0 && charges_.size() >= far_field_min_charges) {
+        printer->Printf("    Far-field charge tree with opening angle %.3f\n\n", far_field_theta_);
+    }
+
     // Charges
     if (charges_.size()) {
         printer->Printf("    > Charges [a.u.] < \n\n");
@@ -100,56 +305,105 @@ SharedMatrix ExternalPotential::computePotentialMatrix(std::shared_ptr<BasisSet>
     double convfac = 1.0;
     if (basis->molecule()->units() == Molecule::Angstrom) convfac /= pc_bohr2angstroms;
 
+    int threads = 1;
+#ifdef _OPENMP
+    threads = Process::environment.get_n_threads();
+#endif
+
     // Monopoles
     auto V_charge = std::make_shared<Matrix>("External Potential (Charges)", n, n);
 
-    auto Zxyz = std::make_shared<Matrix>("Charges (Z,x,y,z)", charges_.size(), 4);
-    double **Zxyzp = Zxyz->pointer();
-    for (size_t i = 0; i < charges_.size(); i++) {
-        Zxyzp[i][0] = std::get<0>(charges_[i]);
-        Zxyzp[i][1] = convfac * std::get<1>(charges_[i]);
-        Zxyzp[i][2] = convfac * std::get<2>(charges_[i]);
-        Zxyzp[i][3] = convfac * std::get<3>(charges_[i]);
-    }
+    SharedMatrix Zxyz = charge_field(charges_, convfac);
+
+    if (far_field_theta_ > 0.0 && charges_.size() >= far_field_min_charges) {
+        // Near charges exactly, distant cells as pseudo-charges, one field per target shell
+        ChargeTree tree(Zxyz);
+        std::vector<double> extents;
+        std::vector<std::vector<std::pair<int, int> > > targets = far_field_targets(basis, extents);
 
-    std::shared_ptr<PotentialInt> pot(static_cast<PotentialInt *>(fact->ao_potential()));
-    pot->set_charge_field(Zxyz);
-    pot->compute(V_charge);
+        std::vector<std::shared_ptr<PotentialInt> > Vint;
+        for (int t = 0; t < threads; t++) {
+            Vint.push_back(std::shared_ptr<PotentialInt>(static_cast<PotentialInt *>(fact->ao_potential())));
+        }
+        double **Vp = V_charge->pointer();
+
+#pragma omp parallel for schedule(dynamic) num_threads(threads)
+        for (int T = 0; T < basis->nshell(); T++) {
+            if (targets[T].empty()) continue;
+
+            int thread = 0;
+#ifdef _OPENMP
+            thread = omp_get_thread_num();
+#endif
+
+            SharedMatrix field = tree.field(basis->shell(T).center(), extents[T], far_field_theta_);
+            if (field->rowspi()[0] == 0) continue;
+            Vint[thread]->set_charge_field(field);
+            const double *buffer = Vint[thread]->buffer();
+
+            // Each pair belongs to exactly one target, so its blocks are written by one thread
+            for (const auto &PQ : targets[T]) {
+                int P = PQ.first;
+                int Q = PQ.second;
+                Vint[thread]->compute_shell(P, Q);
+                int nP = basis->shell(P).nfunction();
+                int oP = basis->shell(P).function_index();
+                int nQ = basis->shell(Q).nfunction();
+                int oQ = basis->shell(Q).function_index();
+                for (int p = 0, index = 0; p < nP; p++) {
+                    for (int q = 0; q < nQ; q++, index++) {
+                        Vp[p + oP][q + oQ] = buffer[index];
+                        Vp[q + oQ][p + oP] = buffer[index];
+                    }
+                }
+            }
+        }
+    } else {
+        std::shared_ptr<PotentialInt> pot(static_cast<PotentialInt *>(fact->ao_potential()));
+        pot->set_charge_field(Zxyz);
+        pot->compute(V_charge);
+    }
 
     V->add(V_charge);
     V_charge.reset();
-    pot.reset();
 
     // Diffuse Bases
     for (size_t ind = 0; ind < bases_.size(); ind++) {
         std::shared_ptr<BasisSet> aux = bases_[ind].first;
         SharedVector d = bases_[ind].second;
 
-        // TODO thread this
         auto fact2 = std::make_shared<IntegralFactory>(aux, BasisSet::zero_ao_basis_set(), basis, basis);
-        std::shared_ptr<TwoBodyAOInt> eri(fact2->eri());
-
-        const double *buffer = eri->buffer();
+        std::vector<std::shared_ptr<TwoBodyAOInt> > eri;
+        for (int t = 0; t < threads; t++) eri.push_back(std::shared_ptr<TwoBodyAOInt>(fact2->eri()));
 
         double **Vp = V->pointer();
         double *dp = d->pointer();
 
-        for (int Q = 0; Q < aux->nshell(); Q++) {
-            for (int M = 0; M < basis->nshell(); M++) {
-                for (int N = 0; N < basis->nshell(); N++) {
+        // Each thread owns shell M; the (N|M) mirror blocks have N < M, so they do not collide
+#pragma omp parallel for schedule(dynamic) num_threads(threads)
+        for (int M = 0; M < basis->nshell(); M++) {
+            int thread = 0;
+#ifdef _OPENMP
+            thread = omp_get_thread_num();
+#endif
+            const double *buffer = eri[thread]->buffer();
+            int numM = basis->shell(M).nfunction();
+            int Mstart = basis->shell(M).function_index();
+            for (int N = 0; N <= M; N++) {
+                int numN = basis->shell(N).nfunction();
+                int Nstart = basis->shell(N).function_index();
+                for (int Q = 0; Q < aux->nshell(); Q++) {
                     int numQ = aux->shell(Q).nfunction();
-                    int numM = basis->shell(M).nfunction();
-                    int numN = basis->shell(N).nfunction();
                     int Qstart = aux->shell(Q).function_index();
-                    int Mstart = basis->shell(M).function_index();
-                    int Nstart = basis->shell(N).function_index();
 
-                    eri->compute_shell(Q, 0, M, N);
+                    if (eri[thread]->compute_shell(Q, 0, M, N) == 0) continue;
 
                     for (int oq = 0, index = 0; oq < numQ; oq++) {
                         for (int om = 0; om < numM; om++) {
                             for (int on = 0; on < numN; on++, index++) {
-                                Vp[om + Mstart][on + Nstart] += dp[oq + Qstart] * buffer[index];
+                                double val = dp[oq + Qstart] * buffer[index];
+                                Vp[om + Mstart][on + Nstart] += val;
+                                if (N != M) Vp[on + Nstart][om + Mstart] += val;
                             }
                         }
                     }
@@ -171,18 +425,14 @@ SharedMatrix ExternalPotential::computePotentialGradients(std::shared_ptr<BasisS
     auto grad = std::make_shared<Matrix>("External Potential Gradient", natom, 3);
     double **Gp = grad->pointer();
 
-    auto Zxyz = std::make_shared<Matrix>("Charges (Z,x,y,z)", charges_.size(), 4);
-    double **Zxyzp = Zxyz->pointer();
-
     double convfac = 1.0;
     if (mol->units() == Molecule::Angstrom) convfac /= pc_bohr2angstroms;
 
-    for (size_t i = 0; i < charges_.size(); i++) {
-        Zxyzp[i][0] = std::get<0>(charges_[i]);
-        Zxyzp[i][1] = convfac * std::get<1>(charges_[i]);
-        Zxyzp[i][2] = convfac * std::get<2>(charges_[i]);
-        Zxyzp[i][3] = convfac * std::get<3>(charges_[i]);
-    }
+    SharedMatrix Zxyz = charge_field(charges_, convfac);
+
+    bool far_field = (far_field_theta_ > 0.0 && charges_.size() >= far_field_min_charges);
+    std::shared_ptr<ChargeTree> tree;
+    if (far_field) tree = std::make_shared<ChargeTree>(Zxyz);
 
     // Start with the nuclear contribution
     grad->zero();
@@ -191,6 +441,13 @@ SharedMatrix ExternalPotential::computePotentialGradients(std::shared_ptr<BasisS
         double yc = mol->y(cen);
         double zc = mol->z(cen);
         double cencharge = mol->Z(cen);
+        SharedMatrix field = Zxyz;
+        if (far_field) {
+            double center[3] = {xc, yc, zc};
+            field = tree->field(center, 0.0, far_field_theta_);
+        }
+        double **Zxyzp = field->pointer();
+        nextc = field->rowspi()[0];
         for (int ext = 0; ext < nextc; ++ext) {
             double charge = cencharge * Zxyzp[ext][0];
             double x = Zxyzp[ext][1] - xc;
@@ -249,48 +506,64 @@ SharedMatrix ExternalPotential::computePotentialGradients(std::shared_ptr<BasisS
         Vtemps[t]->zero();
     }
 
-    // Lower Triangle
-    std::vector<std::pair<int, int> > PQ_pairs;
-    for (int P = 0; P < basis->nshell(); P++) {
-        for (int Q = 0; Q <= P; Q++) {
-            PQ_pairs.push_back(std::pair<int, int>(P, Q));
+    // Lower Triangle, one group per shell P or, with the tree, per far-field target shell
+    std::vector<std::vector<std::pair<int, int> > > PQ_groups;
+    std::vector<double> extents;
+    if (far_field) {
+        PQ_groups = far_field_targets(basis, extents);
+    } else {
+        PQ_groups.resize(basis->nshell());
+        for (int P = 0; P < basis->nshell(); P++) {
+            for (int Q = 0; Q <= P; Q++) {
+                PQ_groups[P].push_back(std::pair<int, int>(P, Q));
+            }
         }
     }
 
 #pragma omp parallel for schedule(dynamic) num_threads(threads)
-    for (long int PQ = 0L; PQ < PQ_pairs.size(); PQ++) {
-        int P = PQ_pairs[PQ].first;
-        int Q = PQ_pairs[PQ].second;
+    for (int T = 0; T < basis->nshell(); T++) {
+        if (PQ_groups[T].empty()) continue;
 
         int thread = 0;
 #ifdef _OPENMP
         thread = omp_get_thread_num();
 #endif
 
-        Vint[thread]->compute_shell_deriv1_no_charge_term(P, Q);
-        const double *buffer = Vint[thread]->buffer();
+        if (far_field) {
+            SharedMatrix field = tree->field(basis->shell(T).center(), extents[T], far_field_theta_);
+            if (field->rowspi()[0] == 0) continue;
+            Vint[thread]->set_charge_field(field);
+        }
+
+        for (const auto &PQ : PQ_groups[T]) {
+            int P = PQ.first;
+            int Q = PQ.second;
 
-        int nP = basis->shell(P).nfunction();
-        int oP = basis->shell(P).function_index();
+            Vint[thread]->compute_shell_deriv1_no_charge_term(P, Q);
+            const double *buffer = Vint[thread]->buffer();
 
-        int nQ = basis->shell(Q).nfunction();
-        int oQ = basis->shell(Q).function_index();
+            int nP = basis->shell(P).nfunction();
+            int oP = basis->shell(P).function_index();
 
-        double perm = (P == Q ? 1.0 : 2.0);
+            int nQ = basis->shell(Q).nfunction();
+            int oQ = basis->shell(Q).function_index();
 
-        double **Vp = Vtemps[thread]->pointer();
-        double **Dp = Dt->pointer();
+            double perm = (P == Q ? 1.0 : 2.0);
 
-        for (int A = 0; A < basis->molecule()->natom(); A++) {
-            const double *ref0 = &buffer[3 * A * nP * nQ + 0 * nP * nQ];
-            const double *ref1 = &buffer[3 * A * nP * nQ + 1 * nP * nQ];
-            const double *ref2 = &buffer[3 * A * nP * nQ + 2 * nP * nQ];
-            for (int p = 0; p < nP; p++) {
-                for (int q = 0; q < nQ; q++) {
-                    double Vval = perm * Dp[p + oP][q + oQ];
-                    Vp[A][0] += Vval * (*ref0++);
-                    Vp[A][1] += Vval * (*ref1++);
-                    Vp[A][2] += Vval * (*ref2++);
+            double **Vp = Vtemps[thread]->pointer();
+            double **Dp = Dt->pointer();
+
+            for (int A = 0; A < basis->molecule()->natom(); A++) {
+                const double *ref0 = &buffer[3 * A * nP * nQ + 0 * nP * nQ];
+                const double *ref1 = &buffer[3 * A * nP * nQ + 1 * nP * nQ];
+                const double *ref2 = &buffer[3 * A * nP * nQ + 2 * nP * nQ];
+                for (int p = 0; p < nP; p++) {
+                    for (int q = 0; q < nQ; q++) {
+                        double Vval = perm * Dp[p + oP][q + oQ];
+                        Vp[A][0] += Vval * (*ref0++);
+                        Vp[A][1] += Vval * (*ref1++);
+                        Vp[A][2] += Vval * (*ref2++);
+                    }
                 }
             }
         }
@@ -309,6 +582,12 @@ double ExternalPotential::computeNuclearEnergy(std::shared_ptr<Molecule> mol) {
 
     if (mol->units() == Molecule::Angstrom) convfac /= pc_bohr2angstroms;
 
+    SharedMatrix Zxyz_ext = charge_field(charges_, convfac);
+
+    bool far_field = (far_field_theta_ > 0.0 && charges_.size() >= far_field_min_charges);
+    std::shared_ptr<ChargeTree> tree;
+    if (far_field) tree = std::make_shared<ChargeTree>(Zxyz_ext);
+
     // Nucleus-charge interaction
     for (int A = 0; A < mol->natom(); A++) {
         double xA = mol->x(A);
@@ -316,11 +595,18 @@ double ExternalPotential::computeNuclearEnergy(std::shared_ptr<Molecule> mol) {
         double zA = mol->z(A);
         double ZA = mol->Z(A);
 
-        for (size_t B = 0; B < charges_.size(); B++) {
-            double ZB = std::get<0>(charges_[B]);
-            double xB = convfac * std::get<1>(charges_[B]);
-            double yB = convfac * std::get<2>(charges_[B]);
-            double zB = convfac * std::get<3>(charges_[B]);
+        SharedMatrix field = Zxyz_ext;
+        if (far_field) {
+            double center[3] = {xA, yA, zA};
+            field = tree->field(center, 0.0, far_field_theta_);
+        }
+        double **fieldp = field->pointer();
+
+        for (int B = 0; B < field->rowspi()[0]; B++) {
+            double ZB = fieldp[B][0];
+            double xB = fieldp[B][1];
+            double yB = fieldp[B][2];
+            double zB = fieldp[B][3];
 
             double dx = xA - xB;
             double dy = yA - yB;
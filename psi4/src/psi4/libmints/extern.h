@@ -61,6 +61,8 @@ class PSI_API ExternalPotential {
     std::vector<std::tuple<double, double, double, double> > charges_;
     /// Auxiliary basis sets (with accompanying molecules and coefs) of diffuse charges
     std::vector<std::pair<std::shared_ptr<BasisSet>, SharedVector> > bases_;
+    /// Opening angle of the far-field charge tree, 0.0 treats every charge exactly
+    double far_field_theta_;
 
    public:
     /// Constructur, does nothing
@@ -79,6 +81,16 @@ class PSI_API ExternalPotential {
     /// Reset the field to zero (eliminates all entries)
     void clear();
 
+    /**
+     * Treat distant point charges through a multipole tree. Charges are sorted into an
+     * octree; a cell whose bounding sphere and the target (shell or nucleus) are well
+     * separated, (cell radius + target radius) < theta * distance, is replaced by seven
+     * pseudo-charges that reproduce its charge, dipole and second moment. Nearer cells
+     * are treated exactly. Smaller theta is more accurate, 0.0 disables the far field.
+     */
+    void setFarFieldTheta(double theta) { far_field_theta_ = theta; }
+    double farFieldTheta() const { return far_field_theta_; }
+
     /// Compute the external potential matrix in the given basis set
     SharedMatrix computePotentialMatrix(std::shared_ptr<BasisSet> basis);
     /// Compute the gradients due to the external potential
@@ -50,6 +50,7 @@
 #include "psi4/libmints/ecpint.h"
 #include "psi4/libmints/basisset.h"
 #include "psi4/libmints/erd_eri.h"
+#include "psi4/libmints/shellpair.h"
 
 #ifdef USING_simint
 #include "psi4/libmints/siminteri.h"
@@ -83,10 +84,23 @@ void IntegralFactory::set_basis(std::shared_ptr<BasisSet> bs1, std::shared_ptr<B
     bs3_ = bs3;
     bs4_ = bs4;
 
+    shell_pair_lists_.clear();
+
     // Use the max am from libint
     init_spherical_harmonics(LIBINT_MAX_AM + 1);
 }
 
+std::shared_ptr<ShellPairList> IntegralFactory::shell_pairs(std::shared_ptr<BasisSet> bs1,
+                                                            std::shared_ptr<BasisSet> bs2) const {
+    std::unique_lock<std::mutex> lock(shell_pair_lock_);
+    for (const auto& list : shell_pair_lists_) {
+        if (list->basis1() == bs1 && list->basis2() == bs2) return list;
+    }
+    auto list = std::make_shared<ShellPairList>(bs1, bs2);
+    shell_pair_lists_.push_back(list);
+    return list;
+}
+
 OneBodyAOInt* IntegralFactory::ao_overlap(int deriv) {
     return new OverlapInt(spherical_transforms_, bs1_, bs2_, deriv);
 }
@@ -35,6 +35,7 @@ PRAGMA_WARNING_IGNORE_DEPRECATED_DECLARATIONS
 #include <memory>
 PRAGMA_WARNING_POP
 #include <vector>
+#include <mutex>
 
 #include "onebody.h"
 #include "twobody.h"
@@ -79,6 +80,7 @@ class ShellRotation;
 class SymmetryOperation;
 class SOBasisSet;
 class CorrelationFactor;
+class ShellPairList;
 
 /*! \ingroup MINTS */
 class PSI_API SphericalTransformComponent {
@@ -387,6 +389,10 @@ class PSI_API IntegralFactory {
     /// Provides ability to transform from sphericals (d=0, f=1, g=2)
     std::vector<ISphericalTransform> ispherical_transforms_;
 
+    /// Primitive pair data handed out by shell_pairs(), shared by every integral object of this factory
+    mutable std::vector<std::shared_ptr<ShellPairList> > shell_pair_lists_;
+    mutable std::mutex shell_pair_lock_;
+
    public:
     /** Initialize IntegralFactory object given a BasisSet for each center. */
     IntegralFactory(std::shared_ptr<BasisSet> bs1, std::shared_ptr<BasisSet> bs2, std::shared_ptr<BasisSet> bs3,
@@ -409,6 +415,9 @@ class PSI_API IntegralFactory {
     virtual void set_basis(std::shared_ptr<BasisSet> bs1, std::shared_ptr<BasisSet> bs2, std::shared_ptr<BasisSet> bs3,
                            std::shared_ptr<BasisSet> bs4);
 
+    /// Returns the (shared, lazily built) primitive pair list for the shell pairs of bs1 and bs2
+    std::shared_ptr<ShellPairList> shell_pairs(std::shared_ptr<BasisSet> bs1, std::shared_ptr<BasisSet> bs2) const;
+
     /// Returns an OneBodyInt that computes the overlap integral.
     virtual OneBodyAOInt* ao_overlap(int deriv = 0);
 
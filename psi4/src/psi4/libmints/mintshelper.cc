@@ -847,9 +847,9 @@ SharedMatrix MintsHelper::ao_eri(std::shared_ptr<IntegralFactory> input_factory)
 }
 
 SharedMatrix MintsHelper::ao_eri(std::shared_ptr<BasisSet> bs1, std::shared_ptr<BasisSet> bs2,
-                                 std::shared_ptr<BasisSet> bs3, std::shared_ptr<BasisSet> bs4) {
+                                 std::shared_ptr<BasisSet> bs3, std::shared_ptr<BasisSet> bs4, bool use_shell_pairs) {
     IntegralFactory intf(bs1, bs2, bs3, bs4);
-    std::shared_ptr<TwoBodyAOInt> ints(intf.eri());
+    std::shared_ptr<TwoBodyAOInt> ints(intf.eri(0, use_shell_pairs));
     return ao_helper("AO ERI Tensor", ints);
 }
 
@@ -2657,6 +2657,242 @@ std::vector<SharedMatrix> MintsHelper::ao_tei_deriv1(int atom, double omega,
     return grad;
 }
 
+std::vector<SharedMatrix> MintsHelper::ao_tei_deriv1_all(double omega, std::shared_ptr<IntegralFactory> input_factory) {
+    std::vector<std::string> cartcomp;
+    cartcomp.push_back("X");
+    cartcomp.push_back("Y");
+    cartcomp.push_back("Z");
+
+    std::shared_ptr<IntegralFactory> factory = input_factory ? input_factory : integral_;
+
+    std::vector<std::shared_ptr<TwoBodyAOInt>> ints;
+    for (size_t thread = 0; thread < nthread_; thread++) {
+        if (omega == 0.0) {
+            ints.push_back(std::shared_ptr<TwoBodyAOInt>(factory->eri(1)));
+        } else {
+            ints.push_back(std::shared_ptr<TwoBodyAOInt>(factory->erf_eri(omega, 1)));
+        }
+    }
+
+    std::shared_ptr<BasisSet> bs1 = ints[0]->basis1();
+    std::shared_ptr<BasisSet> bs2 = ints[0]->basis2();
+    std::shared_ptr<BasisSet> bs3 = ints[0]->basis3();
+    std::shared_ptr<BasisSet> bs4 = ints[0]->basis4();
+
+    int nbf1 = bs1->nbf();
+    int nbf2 = bs2->nbf();
+    int nbf3 = bs3->nbf();
+    int nbf4 = bs4->nbf();
+
+    int natom = basisset_->molecule()->natom();
+
+    std::vector<SharedMatrix> grad;
+    std::vector<double **> gradp;
+    for (int A = 0; A < natom; A++) {
+        for (int p = 0; p < 3; p++) {
+            std::stringstream sstream;
+            sstream << "ao_tei_deriv1_" << A << cartcomp[p];
+            grad.push_back(std::make_shared<Matrix>(sstream.str(), nbf1 * nbf2, nbf3 * nbf4));
+            gradp.push_back(grad.back()->pointer());
+        }
+    }
+
+// Every (P..|..) row block belongs to one task, so the scatter below needs no synchronization
+#pragma omp parallel for schedule(dynamic) num_threads(nthread_)
+    for (int P = 0; P < bs1->nshell(); P++) {
+        size_t rank = 0;
+#ifdef _OPENMP
+        rank = omp_get_thread_num();
+#endif
+        const double *buffer = ints[rank]->buffer();
+
+        int Psize = bs1->shell(P).nfunction();
+        int Pncart = bs1->shell(P).ncartesian();
+        int Poff = bs1->shell(P).function_index();
+        int Pcenter = bs1->shell(P).ncenter();
+
+        for (int Q = 0; Q < bs2->nshell(); Q++) {
+            int Qsize = bs2->shell(Q).nfunction();
+            int Qncart = bs2->shell(Q).ncartesian();
+            int Qoff = bs2->shell(Q).function_index();
+            int Qcenter = bs2->shell(Q).ncenter();
+
+            for (int R = 0; R < bs3->nshell(); R++) {
+                int Rsize = bs3->shell(R).nfunction();
+                int Rncart = bs3->shell(R).ncartesian();
+                int Roff = bs3->shell(R).function_index();
+                int Rcenter = bs3->shell(R).ncenter();
+
+                for (int S = 0; S < bs4->nshell(); S++) {
+                    int Ssize = bs4->shell(S).nfunction();
+                    int Sncart = bs4->shell(S).ncartesian();
+                    int Soff = bs4->shell(S).function_index();
+                    int Scenter = bs4->shell(S).ncenter();
+
+                    // One-center quartets are translationally invariant
+                    if (Pcenter == Qcenter && Pcenter == Rcenter && Pcenter == Scenter) continue;
+
+                    ints[rank]->compute_shell_deriv1(P, Q, R, S);
+
+                    int centers[4] = {Pcenter, Qcenter, Rcenter, Scenter};
+                    size_t stride = Pncart * Qncart * Rncart * Sncart;
+                    size_t delta = 0L;
+
+                    for (int p = 0; p < Psize; p++) {
+                        for (int q = 0; q < Qsize; q++) {
+                            size_t i = (Poff + p) * (size_t)nbf2 + Qoff + q;
+                            for (int r = 0; r < Rsize; r++) {
+                                for (int s = 0; s < Ssize; s++, delta++) {
+                                    size_t j = (Roff + r) * (size_t)nbf4 + Soff + s;
+
+                                    // libderiv provides A, C and D; B follows from translational invariance
+                                    double d[4][3];
+                                    for (int k = 0; k < 3; k++) {
+                                        d[0][k] = buffer[(0 + k) * stride + delta];
+                                        d[2][k] = buffer[(3 + k) * stride + delta];
+                                        d[3][k] = buffer[(6 + k) * stride + delta];
+                                        d[1][k] = -(d[0][k] + d[2][k] + d[3][k]);
+                                    }
+                                    for (int c = 0; c < 4; c++) {
+                                        for (int k = 0; k < 3; k++) gradp[3 * centers[c] + k][i][j] += d[c][k];
+                                    }
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // Build numpy and final matrix shape
+    std::vector<int> nshape{nbf1, nbf2, nbf3, nbf4};
+    for (size_t p = 0; p < grad.size(); p++) grad[p]->set_numpy_shape(nshape);
+
+    return grad;
+}
+
+std::pair<std::vector<SharedMatrix>, std::vector<SharedMatrix>> MintsHelper::ao_jk_deriv1(SharedMatrix D,
+                                                                                        double omega) {
+    std::vector<std::string> cartcomp;
+    cartcomp.push_back("X");
+    cartcomp.push_back("Y");
+    cartcomp.push_back("Z");
+
+    if (D->nirrep() > 1) {
+        throw PSIEXCEPTION("MintsHelper::ao_jk_deriv1: Density must be of C1 symmetry");
+    }
+
+    int nbf = basisset_->nbf();
+    if (D->rowdim() != nbf || D->coldim() != nbf) {
+        throw PSIEXCEPTION("MintsHelper::ao_jk_deriv1: Density does not match the basis set");
+    }
+
+    std::vector<std::shared_ptr<TwoBodyAOInt>> ints;
+    for (size_t thread = 0; thread < nthread_; thread++) {
+        if (omega == 0.0) {
+            ints.push_back(std::shared_ptr<TwoBodyAOInt>(integral_->eri(1)));
+        } else {
+            ints.push_back(std::shared_ptr<TwoBodyAOInt>(integral_->erf_eri(omega, 1)));
+        }
+    }
+
+    int natom = basisset_->molecule()->natom();
+    int nshell = basisset_->nshell();
+
+    std::vector<SharedMatrix> J, K;
+    std::vector<double **> Jp, Kp;
+    for (int A = 0; A < natom; A++) {
+        for (int p = 0; p < 3; p++) {
+            std::stringstream jstream, kstream;
+            jstream << "ao_J_deriv1_" << A << cartcomp[p];
+            kstream << "ao_K_deriv1_" << A << cartcomp[p];
+            J.push_back(std::make_shared<Matrix>(jstream.str(), nbf, nbf));
+            K.push_back(std::make_shared<Matrix>(kstream.str(), nbf, nbf));
+            Jp.push_back(J.back()->pointer());
+            Kp.push_back(K.back()->pointer());
+        }
+    }
+
+    double **Dp = D->pointer();
+
+// J^x_pq = (pq|rs)^x D_rs and K^x_pr = (pq|rs)^x D_qs only ever touch rows of P, so tasks over P need no
+// reduction. The (rs) <-> (sr) symmetry is folded in by only visiting S <= R.
+#pragma omp parallel for schedule(dynamic) num_threads(nthread_)
+    for (int P = 0; P < nshell; P++) {
+        size_t rank = 0;
+#ifdef _OPENMP
+        rank = omp_get_thread_num();
+#endif
+        const double *buffer = ints[rank]->buffer();
+
+        int Psize = basisset_->shell(P).nfunction();
+        int Pncart = basisset_->shell(P).ncartesian();
+        int Poff = basisset_->shell(P).function_index();
+        int Pcenter = basisset_->shell(P).ncenter();
+
+        for (int Q = 0; Q < nshell; Q++) {
+            int Qsize = basisset_->shell(Q).nfunction();
+            int Qncart = basisset_->shell(Q).ncartesian();
+            int Qoff = basisset_->shell(Q).function_index();
+            int Qcenter = basisset_->shell(Q).ncenter();
+
+            for (int R = 0; R < nshell; R++) {
+                int Rsize = basisset_->shell(R).nfunction();
+                int Rncart = basisset_->shell(R).ncartesian();
+                int Roff = basisset_->shell(R).function_index();
+                int Rcenter = basisset_->shell(R).ncenter();
+
+                for (int S = 0; S <= R; S++) {
+                    int Ssize = basisset_->shell(S).nfunction();
+                    int Sncart = basisset_->shell(S).ncartesian();
+                    int Soff = basisset_->shell(S).function_index();
+                    int Scenter = basisset_->shell(S).ncenter();
+
+                    if (Pcenter == Qcenter && Pcenter == Rcenter && Pcenter == Scenter) continue;
+
+                    ints[rank]->compute_shell_deriv1(P, Q, R, S);
+
+                    int centers[4] = {Pcenter, Qcenter, Rcenter, Scenter};
+                    size_t stride = Pncart * Qncart * Rncart * Sncart;
+                    size_t delta = 0L;
+
+                    for (int p = Poff; p < Poff + Psize; p++) {
+                        for (int q = Qoff; q < Qoff + Qsize; q++) {
+                            for (int r = Roff; r < Roff + Rsize; r++) {
+                                for (int s = Soff; s < Soff + Ssize; s++, delta++) {
+                                    double d[4][3];
+                                    for (int k = 0; k < 3; k++) {
+                                        d[0][k] = buffer[(0 + k) * stride + delta];
+                                        d[2][k] = buffer[(3 + k) * stride + delta];
+                                        d[3][k] = buffer[(6 + k) * stride + delta];
+                                        d[1][k] = -(d[0][k] + d[2][k] + d[3][k]);
+                                    }
+
+                                    double Drs = (R == S ? Dp[r][s] : Dp[r][s] + Dp[s][r]);
+                                    double Dqs = Dp[q][s];
+                                    double Dqr = Dp[q][r];
+                                    for (int c = 0; c < 4; c++) {
+                                        for (int k = 0; k < 3; k++) {
+                                            int Ak = 3 * centers[c] + k;
+                                            double val = d[c][k];
+                                            Jp[Ak][p][q] += val * Drs;
+                                            Kp[Ak][p][r] += val * Dqs;
+                                            if (R != S) Kp[Ak][p][s] += val * Dqr;
+                                        }
+                                    }
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    return std::make_pair(J, K);
+}
+
 std::vector<SharedMatrix> MintsHelper::ao_tei_deriv2(int atom1, int atom2) {
     std::vector<std::string> cartcomp;
     cartcomp.push_back("x");
@@ -2961,6 +3197,87 @@ std::vector<SharedMatrix> MintsHelper::ao_oei_deriv1(const std::string &oei_type
     return ao_grad;
 }
 
+std::vector<SharedMatrix> MintsHelper::ao_oei_deriv1_all(const std::string &oei_type) {
+    std::vector<std::string> cartcomp;
+    cartcomp.push_back("X");
+    cartcomp.push_back("Y");
+    cartcomp.push_back("Z");
+
+    std::vector<std::shared_ptr<OneBodyAOInt>> ints;
+    std::string label;
+    for (size_t thread = 0; thread < nthread_; thread++) {
+        if (oei_type == "OVERLAP") {
+            ints.push_back(std::shared_ptr<OneBodyAOInt>(integral_->ao_overlap(1)));
+            label = "ao_OVERLAP_deriv1_";
+        } else if (oei_type == "KINETIC") {
+            ints.push_back(std::shared_ptr<OneBodyAOInt>(integral_->ao_kinetic(1)));
+            label = "ao_KINETIC_deriv1_";
+        } else if (oei_type == "POTENTIAL") {
+            ints.push_back(std::shared_ptr<OneBodyAOInt>(integral_->ao_potential(1)));
+            label = "ao_potential_deriv1_";
+        } else {
+            throw PSIEXCEPTION("Not a valid choice of OEI");
+        }
+    }
+    bool potential = (oei_type == "POTENTIAL");
+
+    std::shared_ptr<BasisSet> bs1 = ints[0]->basis1();
+    std::shared_ptr<BasisSet> bs2 = ints[0]->basis2();
+
+    int natom = basisset_->molecule()->natom();
+
+    std::vector<SharedMatrix> grad;
+    std::vector<double **> gradp;
+    for (int A = 0; A < natom; A++) {
+        for (int p = 0; p < 3; p++) {
+            std::stringstream sstream;
+            sstream << label << A << cartcomp[p];
+            grad.push_back(std::make_shared<Matrix>(sstream.str(), bs1->nbf(), bs2->nbf()));
+            gradp.push_back(grad.back()->pointer());
+        }
+    }
+
+// Each task owns the rows of shell P in every matrix
+#pragma omp parallel for schedule(dynamic) num_threads(nthread_)
+    for (int P = 0; P < bs1->nshell(); P++) {
+        size_t rank = 0;
+#ifdef _OPENMP
+        rank = omp_get_thread_num();
+#endif
+        const double *buffer = ints[rank]->buffer();
+
+        int nP = bs1->shell(P).nfunction();
+        int oP = bs1->shell(P).function_index();
+        int aP = bs1->shell(P).ncenter();
+
+        for (int Q = 0; Q < bs2->nshell(); Q++) {
+            int nQ = bs2->shell(Q).nfunction();
+            int oQ = bs2->shell(Q).function_index();
+            int aQ = bs2->shell(Q).ncenter();
+
+            ints[rank]->compute_shell_deriv1(P, Q);
+
+            // Potential derivatives come for every atom (basis centers and charges), overlap and kinetic
+            // derivatives for the two basis function centers only
+            int ncenter = potential ? natom : 2;
+            for (int c = 0; c < ncenter; c++) {
+                int A = potential ? c : (c == 0 ? aP : aQ);
+                for (int k = 0; k < 3; k++) {
+                    const double *ref = &buffer[(3 * c + k) * nP * nQ];
+                    double **gp = gradp[3 * A + k];
+                    for (int p = 0; p < nP; p++) {
+                        for (int q = 0; q < nQ; q++) {
+                            gp[p + oP][q + oQ] += (*ref++);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    return grad;
+}
+
 std::vector<SharedMatrix> MintsHelper::ao_oei_deriv2(const std::string &oei_type, int atom1, int atom2) {
     std::vector<SharedMatrix> ao_grad_12;
     std::vector<SharedMatrix> ao_grad_21;
@@ -33,6 +33,7 @@
 #include "psi4/libmints/multipolesymmetry.h"
 #include "psi4/libpsi4util/process.h"
 
+#include <utility>
 #include <vector>
 
 namespace psi {
@@ -138,8 +139,9 @@ class PSI_API MintsHelper {
 
     /// AO ERI Integrals (Full matrix, not recommended for large systems)
     SharedMatrix ao_eri(std::shared_ptr<IntegralFactory> = nullptr);
+    /// Mixed-basis AO ERIs; use_shell_pairs=false skips the screened primitive pair lists
     SharedMatrix ao_eri(std::shared_ptr<BasisSet> bs1, std::shared_ptr<BasisSet> bs2, std::shared_ptr<BasisSet> bs3,
-                        std::shared_ptr<BasisSet> bs4);
+                        std::shared_ptr<BasisSet> bs4, bool use_shell_pairs = true);
     /// AO ERI Shell
     SharedMatrix ao_eri_shell(int M, int N, int P, int Q);
 
@@ -153,9 +155,16 @@ class PSI_API MintsHelper {
     std::vector<SharedMatrix> mo_oei_deriv1(const std::string& oei_type, int atom, SharedMatrix C1, SharedMatrix C2);
     std::vector<SharedMatrix> mo_oei_deriv2(const std::string& oei_type, int atom1, int atom2, SharedMatrix C1,
                                             SharedMatrix C2);
+    /// All atoms' OEI first derivatives in one threaded pass: 3 * natom matrices, indexed [3 * atom + xyz]
+    std::vector<SharedMatrix> ao_oei_deriv1_all(const std::string& oei_type);
     // Derivatives of TEI in AO and MO basis
     std::vector<SharedMatrix> ao_tei_deriv1(int atom, double omega = 0.0, std::shared_ptr<IntegralFactory> = nullptr);
     std::vector<SharedMatrix> ao_tei_deriv2(int atom1, int atom2);
+    /// All atoms' TEI first derivatives in one threaded pass: 3 * natom matrices, indexed [3 * atom + xyz]
+    std::vector<SharedMatrix> ao_tei_deriv1_all(double omega = 0.0, std::shared_ptr<IntegralFactory> = nullptr);
+    /// TEI first derivatives contracted with a C1 density, J^x_pq = (pq|rs)^x D_rs and K^x_pr = (pq|rs)^x D_qs,
+    /// for all atoms in one threaded pass; both lists are indexed [3 * atom + xyz]
+    std::pair<std::vector<SharedMatrix>, std::vector<SharedMatrix>> ao_jk_deriv1(SharedMatrix D, double omega = 0.0);
     std::vector<SharedMatrix> mo_tei_deriv1(int atom, SharedMatrix C1, SharedMatrix C2, SharedMatrix C3,
                                             SharedMatrix C4);
     std::vector<SharedMatrix> mo_tei_deriv2(int atom1, int atom2, SharedMatrix C1, SharedMatrix C2, SharedMatrix C3,
@@ -0,0 +1,120 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2019 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#include "psi4/libmints/shellpair.h"
+#include "psi4/libmints/basisset.h"
+#include "psi4/libmints/gshell.h"
+#include "psi4/libpsi4util/process.h"
+
+#include <cmath>
+#include <cstdint>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace psi {
+
+namespace {
+
+// Fills (or, with out == nullptr, just counts) the significant primitive pairs of shells s1 and s2
+int build_primitive_pairs(const GaussianShell& s1, const GaussianShell& s2, double threshold, PrimitivePair* out) {
+    const double* A = s1.center();
+    const double* B = s2.center();
+    double AB2 = (A[0] - B[0]) * (A[0] - B[0]) + (A[1] - B[1]) * (A[1] - B[1]) + (A[2] - B[2]) * (A[2] - B[2]);
+
+    int count = 0;
+    for (int p1 = 0; p1 < s1.nprimitive(); ++p1) {
+        double a1 = s1.exp(p1);
+        double c1 = s1.coef(p1);
+        for (int p2 = 0; p2 < s2.nprimitive(); ++p2) {
+            double a2 = s2.exp(p2);
+            double c2 = s2.coef(p2);
+            double gamma = a1 + a2;
+            double oog = 1.0 / gamma;
+            double overlap = pow(M_PI * oog, 3.0 / 2.0) * exp(-a1 * a2 * oog * AB2) * c1 * c2;
+            if (std::fabs(overlap) < threshold) continue;
+
+            if (out != nullptr) {
+                PrimitivePair& pp = out[count];
+                for (int x = 0; x < 3; ++x) {
+                    pp.P[x] = (a1 * A[x] + a2 * B[x]) * oog;
+                    pp.PA[x] = pp.P[x] - A[x];
+                    pp.PB[x] = pp.P[x] - B[x];
+                }
+                pp.a1 = a1;
+                pp.a2 = a2;
+                pp.gamma = gamma;
+                pp.oo2gamma = 0.5 * oog;
+                pp.overlap = overlap;
+                pp.pad_[0] = pp.pad_[1] = 0.0;
+            }
+            count++;
+        }
+    }
+    return count;
+}
+
+}  // namespace
+
+ShellPairList::ShellPairList(std::shared_ptr<BasisSet> bs1, std::shared_ptr<BasisSet> bs2, double threshold)
+    : bs1_(bs1), bs2_(bs2), threshold_(threshold), pairs_(nullptr) {
+    static_assert(sizeof(PrimitivePair) == 128, "PrimitivePair should span exactly two cache lines");
+
+    int nshell1 = bs1_->nshell();
+    nshell2_ = bs2_->nshell();
+    size_t npairs = (size_t)nshell1 * nshell2_;
+    offsets_.assign(npairs + 1, 0L);
+
+    int nthread = Process::environment.get_n_threads();
+
+// Count the survivors first so that everything lands in a single block
+#pragma omp parallel for schedule(dynamic) num_threads(nthread)
+    for (int M = 0; M < nshell1; ++M) {
+        const GaussianShell& sM = bs1_->shell(M);
+        for (int N = 0; N < nshell2_; ++N) {
+            offsets_[(size_t)M * nshell2_ + N + 1] = build_primitive_pairs(sM, bs2_->shell(N), threshold_, nullptr);
+        }
+    }
+    for (size_t MN = 0; MN < npairs; ++MN) offsets_[MN + 1] += offsets_[MN];
+
+    const size_t align = 64;
+    size_t nbytes = offsets_.back() * sizeof(PrimitivePair) + align;
+    storage_.reset(new char[nbytes]);
+    char* raw = storage_.get();
+    pairs_ = reinterpret_cast<PrimitivePair*>(raw + (align - reinterpret_cast<std::uintptr_t>(raw) % align) % align);
+
+#pragma omp parallel for schedule(dynamic) num_threads(nthread)
+    for (int M = 0; M < nshell1; ++M) {
+        const GaussianShell& sM = bs1_->shell(M);
+        for (int N = 0; N < nshell2_; ++N) {
+            build_primitive_pairs(sM, bs2_->shell(N), threshold_, pairs_ + offsets_[(size_t)M * nshell2_ + N]);
+        }
+    }
+}
+
+}  // namespace psi
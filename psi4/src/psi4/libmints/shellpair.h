@@ -0,0 +1,118 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2019 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#ifndef _psi_src_lib_libmints_shellpair_h
+#define _psi_src_lib_libmints_shellpair_h
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "psi4/pragma.h"
+
+namespace psi {
+
+class BasisSet;
+
+/**
+ * \ingroup MINTS
+ * Precomputed data for a single primitive pair (a|b) of a shell pair.
+ *
+ * The layout is padded to exactly two 64-byte cache lines.
+ */
+struct PrimitivePair {
+    //! Gaussian product center
+    double P[3];
+    //! P - A
+    double PA[3];
+    //! P - B
+    double PB[3];
+    //! Exponents on center A and B
+    double a1, a2;
+    //! a1 + a2
+    double gamma;
+    //! 1 / (2 gamma)
+    double oo2gamma;
+    //! (pi / gamma)^(3/2) exp(-a1 a2 |AB|^2 / gamma) c1 c2
+    double overlap;
+    double pad_[2];
+};
+
+/*! \ingroup MINTS
+ *  \class ShellPairList
+ *  \brief Screened primitive pair data for every shell pair (M|N) of two basis sets.
+ *
+ *  The list is built once and is read-only afterwards, so a single instance is
+ *  shared by all the integral objects (and threads) that work on the same pair
+ *  of basis sets; IntegralFactory::shell_pairs() hands out the shared copies.
+ *  Only primitive pairs whose overlap prefactor exceeds the threshold are kept,
+ *  stored contiguously per shell pair in one cache-aligned block.
+ *
+ *      const ShellPairList& pairs = *factory->shell_pairs(bs1, bs2);
+ *      const PrimitivePair* prim = pairs.primitives(M, N);
+ *      for (int i = 0; i < pairs.nprimitive(M, N); ++i, ++prim) ...
+ */
+class PSI_API ShellPairList {
+   protected:
+    std::shared_ptr<BasisSet> bs1_;
+    std::shared_ptr<BasisSet> bs2_;
+
+    //! Primitive pairs whose |overlap| falls below this are dropped
+    double threshold_;
+
+    //! Number of shells in bs2_ (row stride of offsets_)
+    int nshell2_;
+    //! Start of shell pair MN in pairs_, nshell1 * nshell2 + 1 entries
+    std::vector<size_t> offsets_;
+
+    //! Raw storage and its 64-byte aligned view
+    std::unique_ptr<char[]> storage_;
+    PrimitivePair* pairs_;
+
+   public:
+    ShellPairList(std::shared_ptr<BasisSet> bs1, std::shared_ptr<BasisSet> bs2, double threshold = 1.0E-20);
+
+    std::shared_ptr<BasisSet> basis1() const { return bs1_; }
+    std::shared_ptr<BasisSet> basis2() const { return bs2_; }
+    double threshold() const { return threshold_; }
+
+    /// Number of significant primitive pairs in shell pair (M|N)
+    int nprimitive(int M, int N) const {
+        size_t MN = (size_t)M * nshell2_ + N;
+        return (int)(offsets_[MN + 1] - offsets_[MN]);
+    }
+    /// First significant primitive pair of shell pair (M|N)
+    const PrimitivePair* primitives(int M, int N) const { return pairs_ + offsets_[(size_t)M * nshell2_ + N]; }
+
+    /// Total number of significant primitive pairs
+    size_t size() const { return offsets_.back(); }
+};
+
+}  // namespace psi
+
+#endif
@@ -90,6 +90,8 @@ void PSIO::close(size_t unit, int keep) {
     this_unit->numvols = 0;
     this_unit->toclen = 0;
     this_unit->toc = nullptr;
+    this_unit->toctail = nullptr;
+    toc_index_[unit].clear();
 }
 
 int psio_close(size_t unit, int keep) {
@@ -87,6 +87,8 @@ struct psio_ud {
     psio_vol vol[PSIO_MAXVOL];
     size_t toclen;
     psio_tocentry *toc;
+    /*! Last entry of the TOC list, so that appends need no walk */
+    psio_tocentry *toctail;
 };
 
 /** A convenient address initialization struct */
@@ -80,7 +80,9 @@ PSIO::PSIO() {
         }
         psio_unit[i].toclen = 0;
         psio_unit[i].toc = nullptr;
+        psio_unit[i].toctail = nullptr;
     }
+    toc_index_.resize(PSIO_MAXUNIT);
 
     /* Open user's general .psirc file, if exists */
     //  char *userhome = getenv("HOME");
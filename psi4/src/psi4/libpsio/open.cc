@@ -135,6 +135,8 @@ void PSIO::open(size_t unit, int status) {
         /* Init the TOC stats and write them to disk */
         this_unit->toclen = 0;
         this_unit->toc = nullptr;
+        this_unit->toctail = nullptr;
+        toc_index_[unit].clear();
         wt_toclen(unit, 0);
     } else
         psio_error(unit, PSIO_ERROR_OSTAT);
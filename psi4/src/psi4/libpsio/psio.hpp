@@ -29,11 +29,14 @@
 #ifndef _psi_src_lib_libpsio_psio_hpp_
 #define _psi_src_lib_libpsio_psio_hpp_
 
+#include <cstring>
 #include <string>
 #include <map>
 #include <set>
 #include <queue>
 #include <memory>
+#include <unordered_map>
+#include <vector>
 
 #include "psi4/libpsio/config.h"
 
@@ -359,8 +362,26 @@ private:
     size_t get_numvols(size_t unit);
     /// grab the path to volume of unit and strdup into path.
     void get_volpath(size_t unit, size_t volume, char **path);
+    /// FNV-1a hash of a TOC key
+    struct TOCKeyHash {
+        size_t operator()(const char *key) const {
+            size_t hash = 14695981039346656037ULL;
+            for (; *key != '\0'; ++key) hash = (hash ^ (unsigned char)*key) * 1099511628211ULL;
+            return hash;
+        }
+    };
+    struct TOCKeyEqual {
+        bool operator()(const char *a, const char *b) const { return !::strcmp(a, b); }
+    };
+    /// Hash index over the in-core TOC, keyed on each entry's own key buffer
+    typedef std::unordered_map<const char *, psio_tocentry *, TOCKeyHash, TOCKeyEqual> TOCIndex;
+    /// TOC index of each unit, kept in step with the psio_unit[unit].toc list while the unit is open
+    std::vector<TOCIndex> toc_index_;
+
     /// return the last TOC entry
     psio_tocentry* toclast(size_t unit);
+    /// link a new entry onto the end of the in-core TOC and index it (does not touch toclen)
+    void tocappend(size_t unit, psio_tocentry *entry);
     /// Compute the length of the TOC for a given unit using the in-core TOC list.
     size_t toclen(size_t unit);
     /** Write the length of the TOC for a given unit directly to the file.
@@ -65,10 +65,16 @@ void PSIO::tocclean(size_t unit, const char *key) {
     while ((last_entry != this_entry) && (last_entry != nullptr)) {
         /* Now free all the remaining members */
         prev_entry = last_entry->last;
+        toc_index_[unit].erase(last_entry->key);
         free(last_entry);
         last_entry = prev_entry;
         this_unit->toclen--;
     }
+    this_unit->toctail = last_entry;
+    if (last_entry != nullptr)
+        last_entry->next = nullptr;
+    else
+        this_unit->toc = nullptr;
 
     /* Update on disk */
     wt_toclen(unit, this_unit->toclen);
@@ -50,18 +50,21 @@ bool PSIO::tocdel(size_t unit, const char *key) {
 
     if (this_entry == nullptr) return false;
 
+    psio_ud *this_unit = &(psio_unit[unit]);
     psio_tocentry *last_entry = this_entry->last;
     psio_tocentry *next_entry = this_entry->next;
 
-    if (next_entry == nullptr)
-        last_entry->next = nullptr;
-    else {
+    if (last_entry == nullptr)
+        this_unit->toc = next_entry;
+    else
         last_entry->next = next_entry;
+    if (next_entry == nullptr)
+        this_unit->toctail = last_entry;
+    else
         next_entry->last = last_entry;
-    }
 
+    toc_index_[unit].erase(this_entry->key);
     free(this_entry);
-    psio_ud *this_unit = &(psio_unit[unit]);
     this_unit->toclen--;
 
     return true;
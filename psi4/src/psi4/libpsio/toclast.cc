@@ -36,12 +36,21 @@
 
 namespace psi {
 
-psio_tocentry *PSIO::toclast(size_t unit) {
-    psio_tocentry *this_entry = psio_unit[unit].toc;
+psio_tocentry *PSIO::toclast(size_t unit) { return psio_unit[unit].toctail; }
 
-    while (this_entry->next != nullptr) this_entry = this_entry->next;
+void PSIO::tocappend(size_t unit, psio_tocentry *entry) {
+    psio_ud *this_unit = &(psio_unit[unit]);
 
-    return (this_entry);
+    entry->next = nullptr;
+    entry->last = this_unit->toctail;
+    if (this_unit->toctail == nullptr)
+        this_unit->toc = entry;
+    else
+        this_unit->toctail->next = entry;
+    this_unit->toctail = entry;
+
+    /* Keys are unique, but keep the first entry if a file says otherwise, as the old list scan did */
+    toc_index_[unit].emplace(entry->key, entry);
 }
 
 }  // namespace psi
@@ -41,7 +41,7 @@ void PSIO::tocread(size_t unit) {
     size_t i;
     int entry_size;
     psio_ud *this_unit;
-    psio_tocentry *last_entry, *this_entry;
+    psio_tocentry *this_entry;
     psio_address address;
 
     this_unit = &(psio_unit[unit]);
@@ -54,30 +54,18 @@ void PSIO::tocread(size_t unit) {
     /* grab the number of records */
     this_unit->toclen = rd_toclen(unit);
 
-    /* Malloc room for the TOC */
-    if (this_unit->toclen) {
-        this_unit->toc = (psio_tocentry *)malloc(sizeof(psio_tocentry));
-        this_entry = this_unit->toc;
-        this_entry->last = nullptr;
-        for (i = 1; i < this_unit->toclen; i++) {
-            last_entry = this_entry;
-            this_entry = (psio_tocentry *)malloc(sizeof(psio_tocentry));
-            last_entry->next = this_entry;
-            this_entry->last = last_entry;
-        }
-        this_entry->next = nullptr;
-    } else {
-        this_unit->toclen = 0;
-        this_unit->toc = nullptr;
-    }
+    this_unit->toc = nullptr;
+    this_unit->toctail = nullptr;
+    toc_index_[unit].clear();
+    toc_index_[unit].reserve(this_unit->toclen);
 
-    /* Read the TOC entry-by-entry */
-    this_entry = this_unit->toc;
+    /* Read the TOC entry-by-entry, linking and indexing as we go */
     address = psio_get_address(PSIO_ZERO, sizeof(size_t)); /* start one size_t after the top of the file */
     for (i = 0; i < this_unit->toclen; i++) {
+        this_entry = (psio_tocentry *)malloc(sizeof(psio_tocentry));
         rw(unit, (char *)this_entry, address, entry_size, 0);
+        tocappend(unit, this_entry);
         address = this_entry->eadd;
-        this_entry = this_entry->next;
     }
 }
 
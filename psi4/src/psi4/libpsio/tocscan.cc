@@ -52,23 +52,17 @@ psio_tocentry *PSIO::tocscan(size_t unit, const char *key) {
     bool already_open = open_check(unit);
     if (!already_open) open(unit, PSIO_OPEN_OLD);
 
-    this_entry = psio_unit[unit].toc;
-
-    while (this_entry != nullptr) {
-        if (!strcmp(this_entry->key, key)) {
-            if (!already_open) close(unit, 1);  // keep
-            return (this_entry);
-        }
-        this_entry = this_entry->next;
-    }
+    const TOCIndex &index = toc_index_[unit];
+    auto found = index.find(key);
+    this_entry = (found == index.end() ? nullptr : found->second);
 
     if (!already_open) close(unit, 1);  // keep
-    return (nullptr);
+    return (this_entry);
 }
 
 /*!
- ** PSIO_TOCSCAN(): Scans the TOC for a particular keyword and returns either
- ** a pointer to the entry or nullptr to the caller.
+ ** PSIO_TOCSCAN(): Looks up a particular keyword in the TOC hash index and
+ ** returns either a pointer to the entry or nullptr to the caller.
  **
  ** \ingroup PSIO
  */
@@ -76,8 +70,6 @@ psio_tocentry *PSIO::tocscan(size_t unit, const char *key) {
 psio_tocentry *psio_tocscan(size_t unit, const char *key) { return _default_psio_lib_->tocscan(unit, key); }
 
 bool PSIO::tocentry_exists(size_t unit, const char *key) {
-    psio_tocentry *this_entry;
-
     if (key == nullptr) return (true);
 
     if ((strlen(key) + 1) > PSIO_KEYLEN) psio_error(unit, PSIO_ERROR_KEYLEN);
@@ -85,18 +77,10 @@ bool PSIO::tocentry_exists(size_t unit, const char *key) {
     bool already_open = open_check(unit);
     if (!already_open) open(unit, PSIO_OPEN_OLD);
 
-    this_entry = psio_unit[unit].toc;
-
-    while (this_entry != nullptr) {
-        if (!strcmp(this_entry->key, key)) {
-            if (!already_open) close(unit, 1);  // keep
-            return (true);
-        }
-        this_entry = this_entry->next;
-    }
+    bool exists = toc_index_[unit].count(key) != 0;
 
     if (!already_open) close(unit, 1);  // keep
-    return (false);
+    return (exists);
 }
 
 /*!
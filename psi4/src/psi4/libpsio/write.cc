@@ -65,20 +65,16 @@ void PSIO::write(size_t unit, const char *key, char *buffer, size_t size, psio_a
         this_entry = (psio_tocentry *)malloc(sizeof(psio_tocentry));
         ::strncpy(this_entry->key, key, PSIO_KEYLEN);
         this_entry->key[PSIO_KEYLEN - 1] = '\0';
-        this_entry->next = nullptr;
-        this_entry->last = nullptr;
 
         /* Compute the global address of the new entry */
         if (!(this_unit->toclen)) { /* First TOC entry */
             this_entry->sadd.page = 0;
             this_entry->sadd.offset = sizeof(size_t); /* offset for the toclen value stored first */
-            this_unit->toc = this_entry;
         } else { /* Use ending address from last TOC entry */
             last_entry = toclast(unit);
             this_entry->sadd = last_entry->eadd;
-            last_entry->next = this_entry;
-            this_entry->last = last_entry;
         }
+        tocappend(unit, this_entry);
 
         /* compute important global addresses for the entry */
         start_toc = this_entry->sadd;
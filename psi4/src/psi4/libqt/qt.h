@@ -89,6 +89,14 @@ void parallel_timer_on(const std::string& key, int thread_rank);
 void parallel_timer_off(const std::string& key, int thread_rank);
 void start_skip_timers();
 void stop_skip_timers();
+void trace_timers_enable(bool enable, size_t capacity = 1L << 18);
+bool trace_timers_enabled();
+void trace_timers_clear();
+int trace_timer_register(const std::string& key);
+void trace_timer_on(int id);
+void trace_timer_off(int id);
+void trace_timers_write_chrome(const std::string& filename);
+void trace_timers_write_json(const std::string& filename);
 
 void print_block(double*, int, int, FILE*);
 
@@ -72,6 +72,14 @@
 ** Implemented timer for OpenMP parallism.
 **
 ** Tianyuan Zhang, June 2017
+**
+** Added trace timers for hot OpenMP loops: keys are registered once to
+** integer ids, every thread records begin/end events into its own ring
+** buffer without any shared lock, and the timeline can be exported in the
+** Chrome trace-event format (chrome://tracing, ui.perfetto.dev) together
+** with an aggregate JSON summary. Tracing is off unless enabled through
+** trace_timers_enable() or the PSI_TRACE_TIMERS environment variable;
+** while it is on, the serial and parallel timers are recorded as well.
 */
 
 #include <cstdio>
@@ -87,9 +95,13 @@
 #endif
 
 #include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <fstream>
 #include <list>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <utility>
 #include <vector>
@@ -928,6 +940,268 @@ bool Timer_thread::merge_move(Timer_Structure *another) {
     return false;
 }
 
+namespace {
+
+struct Trace_event {
+    clock::rep time;
+    int id;
+    int begin;
+};
+
+// Everything one thread records; only that thread writes to it while tracing is on
+struct Trace_thread {
+    int tid;
+    int omp_rank;
+    std::vector<Trace_event> ring;
+    size_t nevent;
+    std::vector<clock::rep> start;
+    std::vector<size_t> n_calls;
+    std::vector<clock::rep> wtime;
+
+    Trace_thread(int tid_in, int omp_rank_in, size_t capacity)
+        : tid(tid_in), omp_rank(omp_rank_in), ring(capacity), nevent(0) {}
+
+    void record(int id, int begin, clock::rep time) {
+        if (id >= (int)start.size()) {
+            start.resize(id + 1, 0);
+            n_calls.resize(id + 1, 0);
+            wtime.resize(id + 1, 0);
+        }
+        if (begin) {
+            start[id] = time;
+        } else {
+            ++n_calls[id];
+            wtime[id] += time - start[id];
+        }
+        if (!ring.empty()) {
+            Trace_event &event = ring[nevent % ring.size()];
+            event.time = time;
+            event.id = id;
+            event.begin = begin;
+        }
+        ++nevent;
+    }
+};
+
+std::mutex trace_lock;
+std::atomic<bool> trace_enabled(false);
+size_t trace_capacity = 1L << 18;
+size_t trace_generation = 0;
+clock::time_point trace_epoch = clock::now();
+std::vector<std::string> trace_keys;
+std::map<std::string, int> trace_ids;
+std::vector<std::unique_ptr<Trace_thread>> trace_threads;
+
+struct Trace_local {
+    Trace_thread *thread = nullptr;
+    size_t generation = 0;
+};
+thread_local Trace_local trace_local;
+
+// The calling thread's buffer; takes the lock only the first time a thread records
+Trace_thread *trace_thread() {
+    if (trace_local.thread == nullptr || trace_local.generation != trace_generation) {
+        std::lock_guard<std::mutex> lock(trace_lock);
+        int omp_rank = 0;
+#ifdef _OPENMP
+        omp_rank = omp_get_thread_num();
+#endif
+        trace_threads.emplace_back(new Trace_thread((int)trace_threads.size(), omp_rank, trace_capacity));
+        trace_local.thread = trace_threads.back().get();
+        trace_local.generation = trace_generation;
+    }
+    return trace_local.thread;
+}
+
+std::string json_escape(const std::string &str) {
+    std::string escaped;
+    for (char c : str) {
+        switch (c) {
+            case '"':
+                escaped += "\\\"";
+                break;
+            case '\\':
+                escaped += "\\\\";
+                break;
+            case '\n':
+                escaped += "\\n";
+                break;
+            case '\t':
+                escaped += "\\t";
+                break;
+            default:
+                if ((unsigned char)c < 0x20) {
+                    char buf[8];
+                    snprintf(buf, sizeof(buf), "\\u%04x", c);
+                    escaped += buf;
+                } else {
+                    escaped += c;
+                }
+        }
+    }
+    return escaped;
+}
+
+double trace_seconds(clock::rep ticks) {
+    return std::chrono::duration_cast<std::chrono::duration<double>>(clock::duration(ticks)).count();
+}
+
+}  // namespace
+
+/*!
+** trace_timers_enable(): Switch event recording on or off. Must be called
+** outside of OpenMP parallel sections. Threads that have not recorded yet
+** get ring buffers holding the last capacity events.
+**
+** \ingroup QT
+*/
+void trace_timers_enable(bool enable, size_t capacity) {
+    std::lock_guard<std::mutex> lock(trace_lock);
+    if (capacity != 0) trace_capacity = capacity;
+    trace_enabled = enable;
+}
+
+bool trace_timers_enabled() { return trace_enabled; }
+
+/*!
+** trace_timers_clear(): Drop all recorded events and aggregates, keeping the
+** registered ids. Must be called outside of OpenMP parallel sections.
+**
+** \ingroup QT
+*/
+void trace_timers_clear() {
+    std::lock_guard<std::mutex> lock(trace_lock);
+    trace_threads.clear();
+    ++trace_generation;
+    trace_epoch = clock::now();
+}
+
+/*!
+** trace_timer_register(): Return the integer id of the trace timer key,
+** creating it if needed. Takes a lock, so do this outside the hot loop.
+**
+** \ingroup QT
+*/
+int trace_timer_register(const std::string &key) {
+    std::lock_guard<std::mutex> lock(trace_lock);
+    auto iter = trace_ids.find(key);
+    if (iter != trace_ids.end()) return iter->second;
+    int id = trace_keys.size();
+    trace_keys.push_back(key);
+    trace_ids[key] = id;
+    return id;
+}
+
+/*!
+** trace_timer_on()/trace_timer_off(): Record the start/end of the trace timer
+** id on the calling thread. Safe and lock-free inside OpenMP parallel sections;
+** a no-op while tracing is disabled. An id may not be nested within itself on
+** the same thread.
+**
+** \ingroup QT
+*/
+void trace_timer_on(int id) {
+    if (!trace_enabled.load(std::memory_order_relaxed)) return;
+    Trace_thread *thread = trace_thread();
+    thread->record(id, 1, (clock::now() - trace_epoch).count());
+}
+
+void trace_timer_off(int id) {
+    if (!trace_enabled.load(std::memory_order_relaxed)) return;
+    Trace_thread *thread = trace_thread();
+    thread->record(id, 0, (clock::now() - trace_epoch).count());
+}
+
+/*!
+** trace_timers_write_chrome(): Write the recorded timeline in the Chrome
+** trace-event JSON format. Each matched begin/end pair becomes one complete
+** ("X") event; pairs whose begin fell out of a ring buffer are skipped.
+**
+** \ingroup QT
+*/
+void trace_timers_write_chrome(const std::string &filename) {
+    std::lock_guard<std::mutex> lock(trace_lock);
+    std::ofstream out(filename);
+    if (!out) throw PSIEXCEPTION("Unable to open trace file " + filename);
+#ifdef _MSC_VER
+    int pid = 0;
+#else
+    int pid = getpid();
+#endif
+    out << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+    bool first = true;
+    for (const auto &thread : trace_threads) {
+        if (!first) out << ",\n";
+        first = false;
+        out << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": " << pid << ", \"tid\": " << thread->tid
+            << ", \"args\": {\"name\": \"thread " << thread->tid << " (omp " << thread->omp_rank << ")\"}}";
+
+        size_t capacity = thread->ring.size();
+        size_t nevent = thread->nevent;
+        size_t first_event = (nevent > capacity ? nevent - capacity : 0);
+        std::vector<clock::rep> open(trace_keys.size(), -1);
+        for (size_t n = first_event; n < nevent; ++n) {
+            const Trace_event &event = thread->ring[n % capacity];
+            if (event.begin) {
+                open[event.id] = event.time;
+            } else if (open[event.id] >= 0) {
+                char buf[64];
+                snprintf(buf, sizeof(buf), "%.3f, \"dur\": %.3f", 1.0E6 * trace_seconds(open[event.id]),
+                         1.0E6 * trace_seconds(event.time - open[event.id]));
+                out << ",\n{\"name\": \"" << json_escape(trace_keys[event.id]) << "\", \"cat\": \"psi4\", \"ph\": \"X\", "
+                    << "\"pid\": " << pid << ", \"tid\": " << thread->tid << ", \"ts\": " << buf << "}";
+                open[event.id] = -1;
+            }
+        }
+    }
+    out << "\n]}\n";
+}
+
+/*!
+** trace_timers_write_json(): Write the per-key aggregates (calls and wall
+** time, in total and per thread) as JSON. Aggregates are kept outside the ring
+** buffers, so they cover every recorded call.
+**
+** \ingroup QT
+*/
+void trace_timers_write_json(const std::string &filename) {
+    std::lock_guard<std::mutex> lock(trace_lock);
+    std::ofstream out(filename);
+    if (!out) throw PSIEXCEPTION("Unable to open trace summary file " + filename);
+    size_t dropped = 0;
+    for (const auto &thread : trace_threads) {
+        if (thread->nevent > thread->ring.size()) dropped += thread->nevent - thread->ring.size();
+    }
+    out << "{\"dropped_events\": " << dropped << ", \"timers\": [";
+    bool first_key = true;
+    for (int id = 0; id < (int)trace_keys.size(); ++id) {
+        size_t n_calls = 0;
+        clock::rep wtime = 0;
+        for (const auto &thread : trace_threads) {
+            if (id >= (int)thread->n_calls.size()) continue;
+            n_calls += thread->n_calls[id];
+            wtime += thread->wtime[id];
+        }
+        if (n_calls == 0) continue;
+        char buf[64];
+        out << (first_key ? "\n" : ",\n");
+        first_key = false;
+        snprintf(buf, sizeof(buf), "%.9f", trace_seconds(wtime));
+        out << "  {\"name\": \"" << json_escape(trace_keys[id]) << "\", \"calls\": " << n_calls
+            << ", \"wall\": " << buf << ", \"threads\": [";
+        bool first_thread = true;
+        for (const auto &thread : trace_threads) {
+            if (id >= (int)thread->n_calls.size() || thread->n_calls[id] == 0) continue;
+            snprintf(buf, sizeof(buf), "%.9f", trace_seconds(thread->wtime[id]));
+            out << (first_thread ? "" : ", ") << "{\"tid\": " << thread->tid << ", \"calls\": " << thread->n_calls[id]
+                << ", \"wall\": " << buf << "}";
+            first_thread = false;
+        }
+        out << "]}";
+    }
+    out << "\n]}\n";
+}
+
 Timer_Structure root_timer(nullptr, ""), parallel_timer(nullptr, "");
 std::list<Timer_Structure *> ser_on_timers;
 std::vector<std::list<Timer_Structure *>> par_on_timers;
@@ -993,6 +1267,10 @@ void timer_init() {
     extern bool skip_timers;
     skip_timers = false;
     omp_unset_lock(&lock_timer);
+    const char *trace_env = std::getenv("PSI_TRACE_TIMERS");
+    if (trace_env != nullptr && std::strlen(trace_env) > 0 && std::strcmp(trace_env, "0") != 0) {
+        trace_timers_enable(true, 0);
+    }
 }
 
 /*!
@@ -1038,6 +1316,11 @@ void timer_done() {
 
     omp_unset_lock(&lock_timer);
     omp_destroy_lock(&lock_timer);
+
+    if (trace_timers_enabled()) {
+        trace_timers_write_chrome("timer.trace.json");
+        trace_timers_write_json("timer.summary.json");
+    }
 }
 
 void start_skip_timers() {
@@ -1064,6 +1347,7 @@ void stop_skip_timers() {
 ** \ingroup QT
 */
 PSI_API void timer_on(const std::string &key) {
+    if (trace_enabled.load(std::memory_order_relaxed) && !skip_timers) trace_timer_on(trace_timer_register(key));
     omp_set_lock(&lock_timer);
     extern bool skip_timers;
     if (skip_timers) {
@@ -1100,6 +1384,7 @@ PSI_API void timer_on(const std::string &key) {
 ** \ingroup QT
 */
 PSI_API void timer_off(const std::string &key) {
+    if (trace_enabled.load(std::memory_order_relaxed) && !skip_timers) trace_timer_off(trace_timer_register(key));
     omp_set_lock(&lock_timer);
     extern bool skip_timers;
     if (skip_timers) {
@@ -1171,6 +1456,7 @@ PSI_API void timer_off(const std::string &key) {
 ** \ingroup QT
 */
 void parallel_timer_on(const std::string &key, int thread_rank) {
+    if (trace_enabled.load(std::memory_order_relaxed) && !skip_timers) trace_timer_on(trace_timer_register(key));
     omp_set_lock(&lock_timer);
     extern bool skip_timers;
     if (skip_timers) {
@@ -1214,6 +1500,7 @@ void parallel_timer_on(const std::string &key, int thread_rank) {
 ** \ingroup QT
 */
 void parallel_timer_off(const std::string &key, int thread_rank) {
+    if (trace_enabled.load(std::memory_order_relaxed) && !skip_timers) trace_timer_off(trace_timer_register(key));
     omp_set_lock(&lock_timer);
     extern bool skip_timers;
     if (skip_timers) {
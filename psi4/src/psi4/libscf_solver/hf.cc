@@ -651,6 +651,9 @@ void HF::form_H() {
         if (options_.get_bool("EXTERNAL_POTENTIAL_SYMMETRY") == false && H_->nirrep() != 1)
             throw PSIEXCEPTION("SCF: External Fields are not consistent with symmetry. Set symmetry c1.");
 
+        if (options_["EXTERNAL_POTENTIAL_FAR_FIELD_THETA"].has_changed())
+            external_pot_->setFarFieldTheta(options_.get_double("EXTERNAL_POTENTIAL_FAR_FIELD_THETA"));
+
         SharedMatrix Vprime = external_pot_->computePotentialMatrix(basisset_);
 
         if (options_.get_bool("EXTERNAL_POTENTIAL_SYMMETRY")) {
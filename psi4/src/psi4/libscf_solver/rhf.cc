@@ -626,6 +626,12 @@ std::vector<SharedMatrix> RHF::cphf_solve(std::vector<SharedMatrix> x_vec, doubl
         outfile->Printf("   -----------------------------------------------------\n");
     }
 
+    if (options_.get_str("SOLVER_CPHF_TYPE") == "BLOCK") {
+        std::vector<SharedMatrix> ret_vec =
+            cphf_block_solve(x_vec, c1_input_, Precon_ao, Precon_so, conv_tol, max_iter, print_lvl, start);
+        return ret_vec;
+    }
+
     // => Initial state <= //
 
     // What vectors do we need?
@@ -796,6 +802,206 @@ std::vector<SharedMatrix> RHF::cphf_solve(std::vector<SharedMatrix> x_vec, doubl
     return ret_vec;
 }
 
+std::vector<SharedMatrix> RHF::cphf_block_solve(const std::vector<SharedMatrix>& x_vec,
+                                                const std::vector<bool>& c1_input, SharedMatrix Precon_ao,
+                                                SharedMatrix Precon_so, double conv_tol, int max_iter, int print_lvl,
+                                                std::time_t start) {
+    // Right-hand sides of the same shape and symmetry share one subspace; the products for
+    // every group's new directions are formed together in one cphf_Hx (one JK) call per iteration
+    struct Block {
+        std::vector<size_t> rhs;
+        std::vector<SharedMatrix> V;
+        std::vector<SharedMatrix> AV;
+        // Subspace coefficients of each right-hand side's current solution, rhs x V
+        std::vector<std::vector<double>> y;
+    };
+
+    size_t nvecs = x_vec.size();
+    std::vector<Block> blocks;
+    for (size_t i = 0; i < nvecs; i++) {
+        size_t b = 0;
+        for (; b < blocks.size(); b++) {
+            size_t j = blocks[b].rhs[0];
+            if (c1_input[i] == c1_input[j] && x_vec[i]->symmetry() == x_vec[j]->symmetry()) break;
+        }
+        if (b == blocks.size()) blocks.push_back(Block());
+        blocks[b].rhs.push_back(i);
+    }
+
+    auto precondition = [&](SharedMatrix v, size_t i) {
+        v->apply_denominator(c1_input[i] ? Precon_ao : Precon_so);
+    };
+
+    // Gram-Schmidt against the subspace (twice, for stability); false if nothing new is left
+    auto orthonormalize = [](SharedMatrix v, SharedMatrix Av, const std::vector<SharedMatrix>& V,
+                             const std::vector<SharedMatrix>& AV) {
+        double norm0 = std::sqrt(v->sum_of_squares());
+        if (norm0 == 0.0) return false;
+        for (int pass = 0; pass < 2; pass++) {
+            for (size_t k = 0; k < V.size(); k++) {
+                double overlap = V[k]->vector_dot(v);
+                v->axpy(-overlap, V[k]);
+                if (Av) Av->axpy(-overlap, AV[k]);
+            }
+        }
+        double norm = std::sqrt(v->sum_of_squares());
+        if (norm < 1.0E-8 * norm0) return false;
+        v->scale(1.0 / norm);
+        if (Av) Av->scale(1.0 / norm);
+        return true;
+    };
+
+    std::vector<double> b_norm2(nvecs), rms(nvecs, 1.0);
+    std::vector<bool> active(nvecs, true);
+    std::vector<SharedMatrix> ret_vec(nvecs), r_vec(nvecs);
+    int nremain = 0;
+    for (size_t i = 0; i < nvecs; i++) {
+        double norm2 = x_vec[i]->sum_of_squares();
+        b_norm2[i] = std::max(norm2, 1.e-14);  // Prevent rel denom from being too small
+        r_vec[i] = x_vec[i]->clone();
+        // A vanishing right-hand side (e.g., a symmetry-forbidden perturbation) is solved by zero
+        if (norm2 == 0.0) {
+            active[i] = false;
+            rms[i] = 0.0;
+        } else {
+            nremain++;
+        }
+    }
+    for (int iter = 0; iter < max_iter; iter++) {
+        // => Expand each subspace with the preconditioned residuals of its active vectors <= //
+        std::vector<SharedMatrix> new_vecs;
+        std::vector<size_t> new_block;
+        for (size_t b = 0; b < blocks.size(); b++) {
+            Block& block = blocks[b];
+            std::vector<SharedMatrix> added;
+            for (size_t i : block.rhs) {
+                if (!active[i]) continue;
+                SharedMatrix d = r_vec[i]->clone();
+                precondition(d, i);
+                std::vector<SharedMatrix> basis(block.V);
+                basis.insert(basis.end(), added.begin(), added.end());
+                if (orthonormalize(d, SharedMatrix(), basis, std::vector<SharedMatrix>())) added.push_back(d);
+            }
+            for (SharedMatrix d : added) {
+                new_vecs.push_back(d);
+                new_block.push_back(b);
+            }
+        }
+        if (new_vecs.empty()) break;
+
+        std::vector<SharedMatrix> Anew = cphf_Hx(new_vecs);
+        cphf_nfock_builds_ += new_vecs.size();
+        for (size_t k = 0; k < new_vecs.size(); k++) {
+            blocks[new_block[k]].V.push_back(new_vecs[k]);
+            blocks[new_block[k]].AV.push_back(Anew[k]);
+        }
+
+        // => Solve every right-hand side in its subspace, form the residuals <= //
+        double max_rms = 0.0;
+        double mean_rms = 0.0;
+        nremain = 0;
+        for (Block& block : blocks) {
+            int m = block.V.size();
+            int nrhs = block.rhs.size();
+
+            // Nothing in this subspace yet (every right-hand side vanished): the solutions stay zero
+            if (m == 0) {
+                block.y.assign(nrhs, std::vector<double>());
+                for (size_t i : block.rhs) mean_rms += rms[i];
+                continue;
+            }
+
+            auto G = std::make_shared<Matrix>("Subspace Hessian", m, m);
+            auto Y = std::make_shared<Matrix>("Subspace Solutions", nrhs, m);
+            double** Gp = G->pointer();
+            double** Yp = Y->pointer();
+            for (int k = 0; k < m; k++) {
+                for (int l = 0; l <= k; l++) {
+                    Gp[k][l] = Gp[l][k] = 0.5 * (block.V[k]->vector_dot(block.AV[l]) +
+                                                 block.V[l]->vector_dot(block.AV[k]));
+                }
+                for (int j = 0; j < nrhs; j++) Yp[j][k] = block.V[k]->vector_dot(x_vec[block.rhs[j]]);
+            }
+            std::vector<int> ipiv(m);
+            int info = C_DGESV(m, nrhs, Gp[0], m, ipiv.data(), Yp[0], m);
+            if (info != 0) throw PSIEXCEPTION("RHF::cphf_solve: singular subspace Hessian in the block solver.");
+
+            block.y.assign(nrhs, std::vector<double>(m));
+            for (int j = 0; j < nrhs; j++) {
+                size_t i = block.rhs[j];
+                std::copy(Yp[j], Yp[j] + m, block.y[j].begin());
+                r_vec[i]->copy(x_vec[i]);
+                for (int k = 0; k < m; k++) r_vec[i]->axpy(-Yp[j][k], block.AV[k]);
+                rms[i] = std::sqrt(r_vec[i]->sum_of_squares() / b_norm2[i]);
+                active[i] = (rms[i] >= conv_tol);
+                if (active[i]) nremain++;
+                max_rms = std::max(max_rms, rms[i]);
+                mean_rms += rms[i];
+            }
+        }
+        mean_rms /= (double)nvecs;
+
+        std::time_t stop = std::time(nullptr);
+        if (print_lvl) {
+            outfile->Printf("    %5d %14.3e %12.3e %7d %9ld\n", iter + 1, mean_rms, max_rms, nremain, stop - start);
+        }
+        if (!nremain) break;
+
+        // => Collapse oversized subspaces onto the current solutions (no new products needed) <= //
+        for (Block& block : blocks) {
+            size_t nrhs = block.rhs.size();
+            if (block.V.size() + nrhs <= std::max<size_t>(8 * nrhs, 16)) continue;
+            std::vector<SharedMatrix> X, V, AV;
+            for (size_t j = 0; j < nrhs; j++) {
+                SharedMatrix v = block.V[0]->clone();
+                SharedMatrix Av = block.AV[0]->clone();
+                v->zero();
+                Av->zero();
+                for (size_t k = 0; k < block.V.size(); k++) {
+                    v->axpy(block.y[j][k], block.V[k]);
+                    Av->axpy(block.y[j][k], block.AV[k]);
+                }
+                X.push_back(v->clone());
+                if (orthonormalize(v, Av, V, AV)) {
+                    V.push_back(v);
+                    AV.push_back(Av);
+                }
+            }
+            // Re-express the current solutions in the collapsed basis
+            for (size_t j = 0; j < nrhs; j++) {
+                block.y[j].resize(V.size());
+                for (size_t k = 0; k < V.size(); k++) block.y[j][k] = V[k]->vector_dot(X[j]);
+            }
+            block.V = V;
+            block.AV = AV;
+        }
+    }
+
+    // => Assemble the solutions <= //
+    for (Block& block : blocks) {
+        for (size_t j = 0; j < block.rhs.size(); j++) {
+            size_t i = block.rhs[j];
+            ret_vec[i] = x_vec[i]->clone();
+            ret_vec[i]->zero();
+            if (block.y.empty()) continue;
+            for (size_t k = 0; k < block.y[j].size(); k++) ret_vec[i]->axpy(block.y[j][k], block.V[k]);
+        }
+    }
+    cphf_converged_ = (nremain == 0);
+
+    if (print_lvl > 1) {
+        outfile->Printf("   -----------------------------------------------------\n");
+        outfile->Printf("\n");
+        if (nremain) {
+            outfile->Printf("    Warning! %d equations did not converge!\n\n", nremain);
+        } else {
+            outfile->Printf("    Solver has converged.\n\n");
+        }
+    }
+
+    return ret_vec;
+}
+
 int RHF::soscf_update(double soscf_conv, int soscf_min_iter, int soscf_max_iter, int soscf_print) {
     int fock_builds;
     std::time_t start, stop;
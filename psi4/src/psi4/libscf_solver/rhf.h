@@ -29,6 +29,8 @@
 #ifndef RHF_H
 #define RHF_H
 
+#include <ctime>
+
 #include "psi4/libpsio/psio.hpp"
 #include "hf.h"
 
@@ -50,6 +52,12 @@ class RHF : public HF {
 
     void common_init();
 
+    /// Block subspace solver behind cphf_solve, used for SOLVER_CPHF_TYPE BLOCK
+    std::vector<SharedMatrix> cphf_block_solve(const std::vector<SharedMatrix>& x_vec,
+                                               const std::vector<bool>& c1_input, SharedMatrix Precon_ao,
+                                               SharedMatrix Precon_so, double conv_tol, int max_iter, int print_lvl,
+                                               std::time_t start);
+
    public:
     RHF(SharedWavefunction ref_wfn, std::shared_ptr<SuperFunctional> functional);
     RHF(SharedWavefunction ref_wfn, std::shared_ptr<SuperFunctional> functional, Options& options,
@@ -53,6 +53,7 @@ IntegralTransform::IntegralTransform(std::shared_ptr<Wavefunction> wfn, SpaceVec
       outputType_(outputType),
       frozenOrbitals_(frozenOrbitals),
       alreadyPresorted_(false),
+      directTei_(false),
       dpdIntFile_(PSIF_LIBTRANS_DPD),
       aHtIntFile_(PSIF_LIBTRANS_A_HT),
       bHtIntFile_(PSIF_LIBTRANS_B_HT),
@@ -121,6 +122,7 @@ IntegralTransform::IntegralTransform(SharedMatrix H, SharedMatrix c, SharedMatri
       outputType_(outputType),
       frozenOrbitals_(frozenOrbitals),
       alreadyPresorted_(false),
+      directTei_(false),
       dpdIntFile_(PSIF_LIBTRANS_DPD),
       aHtIntFile_(PSIF_LIBTRANS_A_HT),
       bHtIntFile_(PSIF_LIBTRANS_B_HT),
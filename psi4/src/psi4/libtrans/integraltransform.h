@@ -30,6 +30,7 @@
 #define _PSI_SRC_LIB_LIBTRANS_INTEGRALTRANSFORM_H_
 
 #include <array>
+#include <functional>
 #include <map>
 #include <vector>
 #include <string>
@@ -48,6 +49,8 @@ class Matrix;
 class Dimension;
 class Wavefunction;
 class PSIO;
+class SOBasisSet;
+class TwoBodySOInt;
 
 typedef std::vector<std::shared_ptr<MOSpace> > SpaceVec;
 
@@ -204,6 +207,10 @@ class PSI_API IntegralTransform {
     void set_keep_iwl_so_ints(bool val) { keepIwlSoInts_ = val; }
     /// Whether the library will keep or delete the SO integrals in IWL form after processing
     bool get_keep_iwl_so_ints() const { return keepIwlSoInts_; }
+    /// Set the library to compute the SO integrals on the fly, in batches of rows, instead of presorting the IWL file
+    void set_direct_tei(bool val) { directTei_ = val; }
+    /// Whether the library computes the SO integrals on the fly instead of presorting the IWL file
+    bool get_direct_tei() const { return directTei_; }
     /// Whether TPDM has already presorted
     void set_tpdm_already_presorted(bool val) { tpdmAlreadyPresorted_ = val; }
 
@@ -264,6 +271,15 @@ class PSI_API IntegralTransform {
                                     const std::vector<double> &soInts, std::string A_label, std::string B_label);
     void trans_one(int m, int n, double *input, double *output, double **C, int soOffset, int *order,
                    bool backtransform = false, double scale = 0.0);
+    void transform_tei_ket(dpdbuf4 *J, dpdbuf4 *K, SharedMatrix cP, SharedMatrix cQ, int *orbsPIP, int *orbsPIQ,
+                           const std::function<void(int, size_t, int)> &rowHook = nullptr,
+                           const std::function<void(int, size_t, int)> &rowSource = nullptr);
+    void presort_so_tei_iwl(const double *aD, const double *bD, const double *aFzcD, const double *bFzcD,
+                            double *aFock, double *bFock, double *aFzcOp, double *bFzcOp);
+    void setup_direct_tei();
+    void build_fock_direct(const double *aD, const double *bD, const double *aFzcD, const double *bFzcD,
+                           double *aFock, double *bFock, double *aFzcOp, double *bFzcOp);
+    void compute_so_tei_rows(dpdbuf4 *J, int h, size_t start, int nrows);
 
     // Has this instance been initialized yet?
     bool initialized_;
@@ -308,6 +324,14 @@ class PSI_API IntegralTransform {
     std::map<std::string, int> dpdLookup_;
     // Whether the SO integrals have already been presorted
     bool alreadyPresorted_;
+    // Whether the SO integrals are computed on the fly, rather than presorted from the IWL file
+    bool directTei_;
+    // The SO basis used to compute the integrals on the fly
+    std::shared_ptr<SOBasisSet> soBasis_;
+    // The SO integral object used to compute the integrals on the fly
+    std::shared_ptr<TwoBodySOInt> soEri_;
+    // The SO shell containing each (Pitzer ordered) SO
+    std::vector<int> soShell_;
     // Whether to also write DPD formatted SO TPDMs after density transformations
     bool write_dpd_so_tpdm_;
     // The file to which DPD formatted integrals are written
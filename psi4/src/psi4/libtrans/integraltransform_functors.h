@@ -37,6 +37,12 @@
 #include "psi4/libpsi4util/PsiOutStream.h"
 #include "psi4/libpsi4util/exception.h"
 
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace psi {
 
 class FrozenCoreAndFockRestrictedFunctor {
@@ -509,6 +515,7 @@ class DPDFillerFunctor {
             int offset = bucket_offset_[this_bucket_][pq_sym];
             if ((pq - offset >= params_->rowtot[pq_sym]) || (rs >= params_->coltot[rs_sym]))
                 error("MP Params_make: pq, rs", p, q, r, s, pq, rs, pq_sym, rs_sym);
+#pragma omp atomic
             file_->matrix[pq_sym][pq - offset][rs] += value;
         }
 
@@ -524,6 +531,7 @@ class DPDFillerFunctor {
             int offset = bucket_offset_[this_bucket_][rs_sym];
             if ((rs - offset >= params_->rowtot[rs_sym]) || (pq >= params_->coltot[pq_sym]))
                 error("MP Params_make: rs, pq", p, q, r, s, rs, pq, rs_sym, pq_sym);
+#pragma omp atomic
             file_->matrix[rs_sym][rs - offset][pq] += value;
         }
     }
@@ -538,6 +546,64 @@ class DPDFillerFunctor {
     }
 };
 
+/**
+ * Scatters unique SO integrals, as provided by TwoBodySOInt, into a block of rows of an in-core buffer
+ * with a packed (p >= q) bra and an unpacked ket.  Each integral is stored in every permutation that
+ * falls in the block, so each unique integral must be provided exactly once.  Distinct integrals never
+ * share an element, so the functor can be used by several threads at once.
+ */
+class DirectSOFillerFunctor {
+   private:
+    dpdbuf4 *buf_;
+    dpdparams4 *params_;
+    int irrep_;
+    int first_row_;
+    int num_rows_;
+
+    void place(int p, int q, int r, int s, double value) {
+        int P = p > q ? p : q;
+        int Q = p > q ? q : p;
+        if ((params_->psym[P] ^ params_->qsym[Q]) != irrep_) return;
+        int row = params_->rowidx[P][Q] - first_row_;
+        if (row < 0 || row >= num_rows_) return;
+        double *prow = buf_->matrix[irrep_][row];
+        prow[params_->colidx[r][s]] = value;
+        prow[params_->colidx[s][r]] = value;
+    }
+
+   public:
+    DirectSOFillerFunctor(dpdbuf4 *buf, int irrep, int first_row, int num_rows)
+        : buf_(buf), params_(buf->params), irrep_(irrep), first_row_(first_row), num_rows_(num_rows) {}
+
+    void operator()(int pabs, int qabs, int rabs, int sabs, int psym, int prel, int qsym, int qrel, int rsym, int rrel,
+                    int ssym, int srel, double value) {
+        place(pabs, qabs, rabs, sabs, value);
+        // The bra-ket transposed integral, unless it is the same pair
+        if (!((pabs == rabs && qabs == sabs) || (pabs == sabs && qabs == rabs))) place(rabs, sabs, pabs, qabs, value);
+    }
+};
+
+/**
+ * Hands each integral to the Fock functor belonging to the calling thread
+ */
+template <class FockFunctor>
+class ThreadedFockFunctor {
+   private:
+    std::vector<FockFunctor> &focks_;
+
+   public:
+    ThreadedFockFunctor(std::vector<FockFunctor> &focks) : focks_(focks) {}
+
+    void operator()(int pabs, int qabs, int rabs, int sabs, int psym, int prel, int qsym, int qrel, int rsym, int rrel,
+                    int ssym, int srel, double value) {
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+        focks_[thread](pabs, qabs, rabs, sabs, psym, prel, qsym, qrel, rsym, rrel, ssym, srel, value);
+    }
+};
+
 class NullFunctor {
    public:
     /*
@@ -572,5 +638,50 @@ void iwl_integrals(IWL *iwl, DPDFunctor &dpd, FockFunctor &fock) {
     iwl->set_keep_flag(true);
 }
 
+/**
+ * A threaded version of iwl_integrals.  The integrals from up to nbuffers IWL buffers are gathered
+ * into a chunk, which is then distributed over focks.size() threads.  The DPD functor is shared (its
+ * updates are atomic), while each thread accumulates into its own Fock functor; the caller is
+ * responsible for reducing the quantities held by the functors afterwards.
+ */
+template <class DPDFunctor, class FockFunctor>
+void iwl_integrals(IWL *iwl, DPDFunctor &dpd, std::vector<FockFunctor> &focks, int nbuffers = 64) {
+    int nthreads = focks.size();
+    std::vector<int> labels;
+    std::vector<double> values;
+    bool lastBuffer;
+    do {
+        labels.clear();
+        values.clear();
+        for (int buf = 0; buf < nbuffers; ++buf) {
+            Label *lblptr = iwl->labels();
+            Value *valptr = iwl->values();
+            lastBuffer = iwl->last_buffer();
+            for (int index = 0; index < iwl->buffer_count(); ++index) {
+                int labelIndex = 4 * index;
+                labels.push_back(std::abs((int)lblptr[labelIndex++]));
+                labels.push_back((int)lblptr[labelIndex++]);
+                labels.push_back((int)lblptr[labelIndex++]);
+                labels.push_back((int)lblptr[labelIndex++]);
+                values.push_back((double)valptr[index]);
+            } /* end loop through current buffer */
+            if (lastBuffer) break;
+            iwl->fetch();
+        }
+        long int nints = values.size();
+#pragma omp parallel for schedule(static) num_threads(nthreads)
+        for (long int index = 0; index < nints; ++index) {
+            int thread = 0;
+#ifdef _OPENMP
+            thread = omp_get_thread_num();
+#endif
+            const int *pqrs = &labels[4 * index];
+            dpd(pqrs[0], pqrs[1], pqrs[2], pqrs[3], values[index]);
+            focks[thread](pqrs[0], pqrs[1], pqrs[2], pqrs[3], 0, 0, 0, 0, 0, 0, 0, 0, values[index]);
+        }
+    } while (!lastBuffer);
+    iwl->set_keep_flag(true);
+}
+
 }  // namespace psi
 #endif  // INTEGRALTRANSFORM_FUNCTORS_H
@@ -37,8 +37,11 @@
 #include "psi4/libmints/matrix.h"
 #include "psi4/psifiles.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/process.h"
 
+#include <array>
 #include <cmath>
+#include <vector>
 
 using namespace psi;
 
@@ -55,6 +58,9 @@ using namespace psi;
  */
 std::vector<SharedMatrix> IntegralTransform::compute_fock_like_matrices(SharedMatrix Hcore,
                                                                         std::vector<SharedMatrix> Cmats) {
+    if (directTei_)
+        throw PSIEXCEPTION("LibTrans::compute_fock_like_matrices() needs the presorted SO integrals; "
+                           "it cannot be used when the SO integrals are computed directly.");
     // This function is supposed to only be called after an initial presort, but we'll check to make sure.
     if (!alreadyPresorted_) presort_so_tei();
 
@@ -252,134 +258,11 @@ void IntegralTransform::presort_so_tei() {
     int currentActiveDPD = psi::dpd_default;
     dpd_set_default(myDPDNum_);
 
-    if (print_) {
-        outfile->Printf("\tPresorting SO-basis two-electron integrals.\n");
-    }
-
-    dpdfile4 I;
-    psio_->open(PSIF_SO_PRESORT, PSIO_OPEN_NEW);
-    global_dpd_->file4_init(&I, PSIF_SO_PRESORT, 0, DPD_ID("[n>=n]+"), DPD_ID("[n>=n]+"), "SO Ints (nn|nn)");
-
-    size_t memoryd = memory_ / sizeof(double);
-
-    int nump = 0, numq = 0;
-    for (int h = 0; h < nirreps_; ++h) {
-        nump += I.params->ppi[h];
-        numq += I.params->qpi[h];
-    }
-    int **bucketMap = init_int_matrix(nump, numq);
-
-    /* Room for one bucket to begin with */
-    int **bucketOffset = (int **)malloc(sizeof(int *));
-    bucketOffset[0] = init_int_array(nirreps_);
-    int **bucketRowDim = (int **)malloc(sizeof(int *));
-    bucketRowDim[0] = init_int_array(nirreps_);
-    long int **bucketSize = (long int **)malloc(sizeof(long int *));
-    bucketSize[0] = init_long_int_array(nirreps_);
-
-    /* Figure out how many passes we need and where each p,q goes */
-    int nBuckets = 1;
-    size_t coreLeft = memoryd;
-    psio_address next;
-    for (int h = 0; h < nirreps_; ++h) {
-        size_t rowLength = (size_t)I.params->coltot[h ^ (I.my_irrep)];
-        for (int row = 0; row < I.params->rowtot[h]; ++row) {
-            if (coreLeft >= rowLength) {
-                coreLeft -= rowLength;
-                bucketRowDim[nBuckets - 1][h]++;
-                bucketSize[nBuckets - 1][h] += rowLength;
-            } else {
-                nBuckets++;
-                coreLeft = memoryd - rowLength;
-                /* Make room for another bucket */
-                int **p;
-
-                p = static_cast<int **>(realloc(static_cast<void *>(bucketOffset), nBuckets * sizeof(int *)));
-                if (p == nullptr) {
-                    throw PsiException("file_build: allocation error", __FILE__, __LINE__);
-                } else {
-                    bucketOffset = p;
-                }
-                bucketOffset[nBuckets - 1] = init_int_array(nirreps_);
-                bucketOffset[nBuckets - 1][h] = row;
-
-                p = static_cast<int **>(realloc(static_cast<void *>(bucketRowDim), nBuckets * sizeof(int *)));
-                if (p == nullptr) {
-                    throw PsiException("file_build: allocation error", __FILE__, __LINE__);
-                } else {
-                    bucketRowDim = p;
-                }
-                bucketRowDim[nBuckets - 1] = init_int_array(nirreps_);
-                bucketRowDim[nBuckets - 1][h] = 1;
-
-                long int **pp;
-                pp = static_cast<long int **>(realloc(static_cast<void *>(bucketSize), nBuckets * sizeof(long int *)));
-                if (pp == nullptr) {
-                    throw PsiException("file_build: allocation error", __FILE__, __LINE__);
-                } else {
-                    bucketSize = pp;
-                }
-                bucketSize[nBuckets - 1] = init_long_int_array(nirreps_);
-                bucketSize[nBuckets - 1][h] = rowLength;
-            }
-            int p = I.params->roworb[h][row][0];
-            int q = I.params->roworb[h][row][1];
-            bucketMap[p][q] = nBuckets - 1;
-        }
-    }
-
-    if (print_) {
-        outfile->Printf("\tSorting File: %s nbuckets = %d\n", I.label, nBuckets);
-    }
-
-    next = PSIO_ZERO;
-    for (int n = 0; n < nBuckets; ++n) { /* nbuckets = number of passes */
-        /* Prepare target matrix */
-        for (int h = 0; h < nirreps_; h++) {
-            I.matrix[h] = block_matrix(bucketRowDim[n][h], I.params->coltot[h]);
-        }
-
-        DPDFillerFunctor dpdfiller(&I, n, bucketMap, bucketOffset, false, true);
-        NullFunctor null;
-        IWL *iwl = new IWL(psio_.get(), soIntTEIFile_, tolerance_, 1, 1);
-        // In the functors below, we only want to build the Fock matrix on the first pass
-        if (transformationType_ == TransformationType::Restricted) {
-            FrozenCoreAndFockRestrictedFunctor fock(aD, aFzcD, aFock, aFzcOp);
-            if (n)
-                iwl_integrals(iwl, dpdfiller, null);
-            else
-                iwl_integrals(iwl, dpdfiller, fock);
-        } else {
-            FrozenCoreAndFockUnrestrictedFunctor fock(aD, bD, aFzcD, bFzcD, aFock, bFock, aFzcOp, bFzcOp);
-            if (n)
-                iwl_integrals(iwl, dpdfiller, null);
-            else
-                iwl_integrals(iwl, dpdfiller, fock);
-        }
-        delete iwl;
-
-        for (int h = 0; h < nirreps_; ++h) {
-            if (bucketSize[n][h])
-                psio_->write(I.filenum, I.label, (char *)I.matrix[h][0], bucketSize[n][h] * ((long int)sizeof(double)),
-                             next, &next);
-            free_block(I.matrix[h]);
-        }
-    } /* end loop over buckets/passes */
-
-    /* Get rid of the input integral file */
-    psio_->open(soIntTEIFile_, PSIO_OPEN_OLD);
-    psio_->close(soIntTEIFile_, keepIwlSoInts_);
-
-    free_int_matrix(bucketMap);
-
-    for (int n = 0; n < nBuckets; ++n) {
-        free(bucketOffset[n]);
-        free(bucketRowDim[n]);
-        free(bucketSize[n]);
-    }
-    free(bucketOffset);
-    free(bucketRowDim);
-    free(bucketSize);
+    // Build the Fock-like operators, and the DPD SO integral file if the integrals are not computed on the fly
+    if (directTei_)
+        build_fock_direct(aD, bD, aFzcD, bFzcD, aFock, bFock, aFzcOp, bFzcOp);
+    else
+        presort_so_tei_iwl(aD, bD, aFzcD, bFzcD, aFock, bFock, aFzcOp, bFzcOp);
 
     double *moInts = init_array(nTriMo_);
     int *order = init_int_array(nmo_);
@@ -534,6 +417,180 @@ void IntegralTransform::presort_so_tei() {
     dpd_set_default(currentActiveDPD);
 
     alreadyPresorted_ = true;
+}
+
+/**
+ * Sorts the IWL SO integrals into the DPD file used by the first half-transformation, adding their
+ * contribution to the Fock and frozen core operators (in lower triangular storage) on the first pass.
+ */
+void IntegralTransform::presort_so_tei_iwl(const double *aD, const double *bD, const double *aFzcD,
+                                           const double *bFzcD, double *aFock, double *bFock, double *aFzcOp,
+                                           double *bFzcOp) {
+    if (print_) {
+        outfile->Printf("\tPresorting SO-basis two-electron integrals.\n");
+    }
+
+    dpdfile4 I;
+    psio_->open(PSIF_SO_PRESORT, PSIO_OPEN_NEW);
+    global_dpd_->file4_init(&I, PSIF_SO_PRESORT, 0, DPD_ID("[n>=n]+"), DPD_ID("[n>=n]+"), "SO Ints (nn|nn)");
+
+    size_t memoryd = memory_ / sizeof(double);
+
+    int nump = 0, numq = 0;
+    for (int h = 0; h < nirreps_; ++h) {
+        nump += I.params->ppi[h];
+        numq += I.params->qpi[h];
+    }
+    int **bucketMap = init_int_matrix(nump, numq);
+
+    /* Room for one bucket to begin with */
+    int **bucketOffset = (int **)malloc(sizeof(int *));
+    bucketOffset[0] = init_int_array(nirreps_);
+    int **bucketRowDim = (int **)malloc(sizeof(int *));
+    bucketRowDim[0] = init_int_array(nirreps_);
+    long int **bucketSize = (long int **)malloc(sizeof(long int *));
+    bucketSize[0] = init_long_int_array(nirreps_);
+
+    /* Figure out how many passes we need and where each p,q goes */
+    int nBuckets = 1;
+    size_t coreLeft = memoryd;
+    psio_address next;
+    for (int h = 0; h < nirreps_; ++h) {
+        size_t rowLength = (size_t)I.params->coltot[h ^ (I.my_irrep)];
+        for (int row = 0; row < I.params->rowtot[h]; ++row) {
+            if (coreLeft >= rowLength) {
+                coreLeft -= rowLength;
+                bucketRowDim[nBuckets - 1][h]++;
+                bucketSize[nBuckets - 1][h] += rowLength;
+            } else {
+                nBuckets++;
+                coreLeft = memoryd - rowLength;
+                /* Make room for another bucket */
+                int **p;
+
+                p = static_cast<int **>(realloc(static_cast<void *>(bucketOffset), nBuckets * sizeof(int *)));
+                if (p == nullptr) {
+                    throw PsiException("file_build: allocation error", __FILE__, __LINE__);
+                } else {
+                    bucketOffset = p;
+                }
+                bucketOffset[nBuckets - 1] = init_int_array(nirreps_);
+                bucketOffset[nBuckets - 1][h] = row;
+
+                p = static_cast<int **>(realloc(static_cast<void *>(bucketRowDim), nBuckets * sizeof(int *)));
+                if (p == nullptr) {
+                    throw PsiException("file_build: allocation error", __FILE__, __LINE__);
+                } else {
+                    bucketRowDim = p;
+                }
+                bucketRowDim[nBuckets - 1] = init_int_array(nirreps_);
+                bucketRowDim[nBuckets - 1][h] = 1;
+
+                long int **pp;
+                pp = static_cast<long int **>(realloc(static_cast<void *>(bucketSize), nBuckets * sizeof(long int *)));
+                if (pp == nullptr) {
+                    throw PsiException("file_build: allocation error", __FILE__, __LINE__);
+                } else {
+                    bucketSize = pp;
+                }
+                bucketSize[nBuckets - 1] = init_long_int_array(nirreps_);
+                bucketSize[nBuckets - 1][h] = rowLength;
+            }
+            int p = I.params->roworb[h][row][0];
+            int q = I.params->roworb[h][row][1];
+            bucketMap[p][q] = nBuckets - 1;
+        }
+    }
+
+    if (print_) {
+        outfile->Printf("\tSorting File: %s nbuckets = %d\n", I.label, nBuckets);
+    }
+
+    // Scratch Fock-like matrices for all but the first thread, which are reduced after the sort
+    int nthreads = Process::environment.get_n_threads();
+    std::vector<std::array<double *, 2>> threadFock(nthreads, {{nullptr, nullptr}});
+    std::vector<std::array<double *, 2>> threadFzcOp(nthreads, {{nullptr, nullptr}});
+    for (int thread = 1; thread < nthreads; ++thread) {
+        threadFock[thread][0] = init_array(nTriSo_);
+        threadFzcOp[thread][0] = init_array(nTriSo_);
+        if (transformationType_ != TransformationType::Restricted) {
+            threadFock[thread][1] = init_array(nTriSo_);
+            threadFzcOp[thread][1] = init_array(nTriSo_);
+        }
+    }
+
+    next = PSIO_ZERO;
+    for (int n = 0; n < nBuckets; ++n) { /* nbuckets = number of passes */
+        /* Prepare target matrix */
+        for (int h = 0; h < nirreps_; h++) {
+            I.matrix[h] = block_matrix(bucketRowDim[n][h], I.params->coltot[h]);
+        }
+
+        DPDFillerFunctor dpdfiller(&I, n, bucketMap, bucketOffset, false, true);
+        std::vector<NullFunctor> null(nthreads);
+        IWL *iwl = new IWL(psio_.get(), soIntTEIFile_, tolerance_, 1, 1);
+        // In the functors below, we only want to build the Fock matrix on the first pass.  Thread 0
+        // accumulates straight into the Fock-like matrices, the others into the scratch copies.
+        if (transformationType_ == TransformationType::Restricted) {
+            std::vector<FrozenCoreAndFockRestrictedFunctor> fock;
+            fock.emplace_back(aD, aFzcD, aFock, aFzcOp);
+            for (int thread = 1; thread < nthreads; ++thread)
+                fock.emplace_back(aD, aFzcD, threadFock[thread][0], threadFzcOp[thread][0]);
+            if (n)
+                iwl_integrals(iwl, dpdfiller, null);
+            else
+                iwl_integrals(iwl, dpdfiller, fock);
+        } else {
+            std::vector<FrozenCoreAndFockUnrestrictedFunctor> fock;
+            fock.emplace_back(aD, bD, aFzcD, bFzcD, aFock, bFock, aFzcOp, bFzcOp);
+            for (int thread = 1; thread < nthreads; ++thread)
+                fock.emplace_back(aD, bD, aFzcD, bFzcD, threadFock[thread][0], threadFock[thread][1],
+                                  threadFzcOp[thread][0], threadFzcOp[thread][1]);
+            if (n)
+                iwl_integrals(iwl, dpdfiller, null);
+            else
+                iwl_integrals(iwl, dpdfiller, fock);
+        }
+        delete iwl;
+
+        for (int h = 0; h < nirreps_; ++h) {
+            if (bucketSize[n][h])
+                psio_->write(I.filenum, I.label, (char *)I.matrix[h][0], bucketSize[n][h] * ((long int)sizeof(double)),
+                             next, &next);
+            free_block(I.matrix[h]);
+        }
+    } /* end loop over buckets/passes */
+
+    // Reduce the per-thread contributions to the Fock-like matrices
+    for (int thread = 1; thread < nthreads; ++thread) {
+        for (int pq = 0; pq < nTriSo_; ++pq) {
+            aFock[pq] += threadFock[thread][0][pq];
+            aFzcOp[pq] += threadFzcOp[thread][0][pq];
+            if (transformationType_ != TransformationType::Restricted) {
+                bFock[pq] += threadFock[thread][1][pq];
+                bFzcOp[pq] += threadFzcOp[thread][1][pq];
+            }
+        }
+        for (int spin = 0; spin < 2; ++spin) {
+            if (threadFock[thread][spin]) free(threadFock[thread][spin]);
+            if (threadFzcOp[thread][spin]) free(threadFzcOp[thread][spin]);
+        }
+    }
+
+    /* Get rid of the input integral file */
+    psio_->open(soIntTEIFile_, PSIO_OPEN_OLD);
+    psio_->close(soIntTEIFile_, keepIwlSoInts_);
+
+    free_int_matrix(bucketMap);
+
+    for (int n = 0; n < nBuckets; ++n) {
+        free(bucketOffset[n]);
+        free(bucketRowDim[n]);
+        free(bucketSize[n]);
+    }
+    free(bucketOffset);
+    free(bucketRowDim);
+    free(bucketSize);
 
     global_dpd_->file4_close(&I);
     psio_->close(PSIF_SO_PRESORT, 1);
@@ -27,9 +27,15 @@
  */
 
 #include "integraltransform.h"
+#include "psi4/libpsio/psio.h"
 #include "psi4/libpsio/psio.hpp"
+#include "psi4/libpsio/aiohandler.h"
 #include "psi4/libciomr/libciomr.h"
+#include "psi4/libdpd/dpd.h"
 #include "psi4/libiwl/iwl.hpp"
+#include "psi4/libmints/matrix.h"
+#include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/process.h"
 #include "psi4/libqt/qt.h"
 #include <cmath>
 #include <cctype>
@@ -37,8 +43,27 @@
 #include "psi4/psifiles.h"
 #include "mospace.h"
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 using namespace psi;
 
+namespace {
+/// The PSIO address of row "row" of irrep "irrep" in a DPD file (as in DPD::file4_mat_irrep_wrt_block)
+psio_address dpd_row_address(dpdfile4 *File, int irrep, size_t row) {
+    psio_address irrep_ptr = File->lfiles[irrep];
+    size_t coltot = File->params->coltot[irrep ^ File->my_irrep];
+    if (coltot) {
+        size_t seek_block = DPD_BIGNUM / (coltot * sizeof(double));
+        for (; row > seek_block; row -= seek_block)
+            irrep_ptr = psio_get_address(irrep_ptr, seek_block * coltot * sizeof(double));
+        irrep_ptr = psio_get_address(irrep_ptr, row * coltot * sizeof(double));
+    }
+    return irrep_ptr;
+}
+}  // namespace
+
 /**
  * Transform the two-electron integrals from the SO to the MO basis in the spaces specified
  *
@@ -61,3 +86,158 @@ void IntegralTransform::transform_tei(const std::shared_ptr<MOSpace> s1, const s
     }
     transform_tei_second_half(s1, s2, s3, s4);
 }
+
+/**
+ * Transform the ket indices of the integrals in J, ( x x | n n ) -> ( x x | P Q ), and write them to K.
+ * The rows of each memory-sized bucket are distributed over threads.  When K is not held in core,
+ * each transformed bucket is packed into the on-disk layout and written asynchronously, alternating
+ * between two buffers so that the write of one bucket overlaps the read and transformation of the next.
+ *
+ * @param J - the input buffer, with the SO ket unpacked in core
+ * @param K - the output buffer, with the MO ket unpacked in core
+ * @param cP - the transformation coefficients for the first ket index
+ * @param cQ - the transformation coefficients for the second ket index
+ * @param orbsPIP - the number of orbitals per irrep in the first ket index
+ * @param orbsPIQ - the number of orbitals per irrep in the second ket index
+ * @param rowHook - if set, called serially for every transformed bucket with the irrep, the
+ *                  first row, and the number of rows, while the bucket is still in K.matrix
+ * @param rowSource - if set, called with the same arguments to fill each bucket of J.matrix,
+ *                    instead of reading it from J's file
+ */
+void IntegralTransform::transform_tei_ket(dpdbuf4 *J, dpdbuf4 *K, SharedMatrix cP, SharedMatrix cQ, int *orbsPIP,
+                                          int *orbsPIQ, const std::function<void(int, size_t, int)> &rowHook,
+                                          const std::function<void(int, size_t, int)> &rowSource) {
+    int nthreads = Process::environment.get_n_threads();
+
+    std::vector<double **> TMP(nthreads);
+    for (int thread = 0; thread < nthreads; thread++) TMP[thread] = block_matrix(nso_, nso_);
+
+    auto aio = std::make_shared<AIOHandler>(psio_);
+    // Only buffers that keep the file's bra packing can be written in row blocks
+    bool async = !K->file.incore && !K->anti && K->params->perm_pq == K->file.params->perm_pq &&
+                 K->params->peq == K->file.params->peq;
+
+    for (int h = 0; h < nirreps_; h++) {
+        int nBuckets;
+        size_t rowsPerBucket;
+        size_t rowsLeft;
+        size_t memFree = 0;
+        bool asyncBuckets = async;
+        if (J->params->coltot[h] && J->params->rowtot[h]) {
+            memFree = static_cast<size_t>(dpd_memfree() - J->params->coltot[h] - K->params->coltot[h]);
+            // Room for J and K, plus the two packed write buffers if there is enough memory
+            rowsPerBucket = memFree / (4 * J->params->coltot[h]);
+            if (rowsPerBucket == 0) {
+                asyncBuckets = false;
+                rowsPerBucket = memFree / (2 * J->params->coltot[h]);
+            }
+            if (rowsPerBucket > J->params->rowtot[h]) rowsPerBucket = static_cast<size_t>(J->params->rowtot[h]);
+            nBuckets =
+                static_cast<int>(ceil(static_cast<double>(J->params->rowtot[h]) / static_cast<double>(rowsPerBucket)));
+            rowsLeft = static_cast<size_t>(J->params->rowtot[h] % rowsPerBucket);
+        } else {
+            nBuckets = 0;
+            rowsPerBucket = 0;
+            rowsLeft = 0;
+        }
+
+        if (print_ > 1) {
+            outfile->Printf("\th = %d; memfree         = %lu\n", h, memFree);
+            outfile->Printf("\th = %d; rows_per_bucket = %lu\n", h, rowsPerBucket);
+            outfile->Printf("\th = %d; rows_left       = %lu\n", h, rowsLeft);
+            outfile->Printf("\th = %d; nbuckets        = %d\n", h, nBuckets);
+        }
+
+        global_dpd_->buf4_mat_irrep_init_block(J, h, rowsPerBucket);
+        global_dpd_->buf4_mat_irrep_init_block(K, h, rowsPerBucket);
+
+        // Map each on-disk ket column onto the in-core (unpacked) column
+        int Gket = h ^ K->file.my_irrep;
+        int fileColtot = K->file.params->coltot[Gket];
+        std::vector<int> colMap(fileColtot);
+        for (int rs = 0; rs < fileColtot; rs++) {
+            int r = K->file.params->colorb[Gket][rs][0];
+            int s = K->file.params->colorb[Gket][rs][1];
+            colMap[rs] = K->params->colidx[r][s];
+        }
+
+        double **writeBuffer[2] = {nullptr, nullptr};
+        size_t writeJob[2] = {0, 0};
+        psio_address writeEnd[2];
+        if (asyncBuckets && nBuckets) {
+            writeBuffer[0] = block_matrix(rowsPerBucket, fileColtot);
+            if (nBuckets > 1) writeBuffer[1] = block_matrix(rowsPerBucket, fileColtot);
+        }
+
+        for (int n = 0; n < nBuckets; n++) {
+            int thisBucketRows;
+            if (nBuckets == 1)
+                thisBucketRows = rowsPerBucket;
+            else
+                thisBucketRows = (n < nBuckets - 1) ? rowsPerBucket : rowsLeft;
+            if (rowSource)
+                rowSource(h, n * rowsPerBucket, thisBucketRows);
+            else
+                global_dpd_->buf4_mat_irrep_rd_block(J, h, n * rowsPerBucket, thisBucketRows);
+
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+            for (int pq = 0; pq < thisBucketRows; pq++) {
+                int thread = 0;
+#ifdef _OPENMP
+                thread = omp_get_thread_num();
+#endif
+                double **pTMP = TMP[thread];
+                for (int Gr = 0; Gr < nirreps_; Gr++) {
+                    // Transform ( x x | n n ) -> ( x x | n Q )
+                    int Gs = h ^ Gr;
+                    int nrows = sopi_[Gr];
+                    int ncols = orbsPIQ[Gs];
+                    int nlinks = sopi_[Gs];
+                    int rs = J->col_offset[h][Gr];
+                    double **pcQ = cQ->pointer(Gs);
+                    if (nrows && ncols && nlinks)
+                        C_DGEMM('n', 'n', nrows, ncols, nlinks, 1.0, &J->matrix[h][pq][rs], nlinks, pcQ[0], ncols, 0.0,
+                                pTMP[0], nso_);
+
+                    // Transform ( x x | n Q ) -> ( x x | P Q )
+                    nrows = orbsPIP[Gr];
+                    ncols = orbsPIQ[Gs];
+                    nlinks = sopi_[Gr];
+                    rs = K->col_offset[h][Gr];
+                    double **pcP = cP->pointer(Gr);
+                    if (nrows && ncols && nlinks)
+                        C_DGEMM('t', 'n', nrows, ncols, nlinks, 1.0, pcP[0], nrows, pTMP[0], nso_, 0.0,
+                                &K->matrix[h][pq][rs], ncols);
+                } /* Gr */
+            }     /* pq */
+
+            if (rowHook) rowHook(h, n * rowsPerBucket, thisBucketRows);
+
+            if (asyncBuckets) {
+                int buf = n % 2;
+                if (writeJob[buf]) aio->wait_for_job(writeJob[buf]);
+                double **pW = writeBuffer[buf];
+#pragma omp parallel for schedule(static) num_threads(nthreads)
+                for (int pq = 0; pq < thisBucketRows; pq++) {
+                    for (int rs = 0; rs < fileColtot; rs++) pW[pq][rs] = K->matrix[h][pq][colMap[rs]];
+                }
+                if (thisBucketRows && fileColtot) {
+                    psio_address start = dpd_row_address(&K->file, h, n * rowsPerBucket);
+                    writeJob[buf] = aio->write(K->file.filenum, K->file.label, (char *)pW[0],
+                                               sizeof(double) * thisBucketRows * (size_t)fileColtot, start,
+                                               &writeEnd[buf]);
+                }
+            } else {
+                global_dpd_->buf4_mat_irrep_wrt_block(K, h, n * rowsPerBucket, thisBucketRows);
+            }
+        }
+        aio->synchronize();
+        if (writeBuffer[0]) free_block(writeBuffer[0]);
+        if (writeBuffer[1]) free_block(writeBuffer[1]);
+
+        global_dpd_->buf4_mat_irrep_close_block(J, h, rowsPerBucket);
+        global_dpd_->buf4_mat_irrep_close_block(K, h, rowsPerBucket);
+    }
+
+    for (int thread = 0; thread < nthreads; thread++) free_block(TMP[thread]);
+}
@@ -0,0 +1,197 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2019 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#include "integraltransform_functors.h"
+#include "integraltransform.h"
+
+#include "psi4/libciomr/libciomr.h"
+#include "psi4/libdpd/dpd.h"
+#include "psi4/libmints/basisset.h"
+#include "psi4/libmints/integral.h"
+#include "psi4/libmints/sobasis.h"
+#include "psi4/libmints/sointegral_twobody.h"
+#include "psi4/libmints/twobody.h"
+#include "psi4/libmints/wavefunction.h"
+#include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/exception.h"
+#include "psi4/libpsi4util/process.h"
+
+#include <array>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using namespace psi;
+
+namespace {
+/**
+ * Computes the unique SO shell quartets with at least one shell pair flagged in needPair (all quartets
+ * if needPair is empty), distributing the outer shell pairs over threads.
+ */
+template <class Functor>
+void compute_so_quartets(TwoBodySOInt &eri, std::shared_ptr<SOBasisSet> sobasis, const std::vector<char> &needPair,
+                         Functor &body) {
+    int nshell = sobasis->nshell();
+    std::vector<std::pair<int, int>> pairs;
+    SO_PQ_Iterator pqIter(sobasis);
+    for (pqIter.first(); !pqIter.is_done(); pqIter.next()) pairs.push_back(std::make_pair(pqIter.p(), pqIter.q()));
+
+    int nthreads = Process::environment.get_n_threads();
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+    for (size_t pq = 0; pq < pairs.size(); ++pq) {
+        SO_RS_Iterator rsIter(pairs[pq].first, pairs[pq].second, sobasis, sobasis, sobasis, sobasis);
+        for (rsIter.first(); !rsIter.is_done(); rsIter.next()) {
+            int P = rsIter.p();
+            int Q = rsIter.q();
+            int R = rsIter.r();
+            int S = rsIter.s();
+            if (!needPair.empty() && !needPair[P * nshell + Q] && !needPair[R * nshell + S]) continue;
+            eri.compute_shell(P, Q, R, S, body);
+        }
+    }
+}
+}  // namespace
+
+/**
+ * Sets up the SO integral object, and the map from each (Pitzer ordered) SO to its SO shell, used
+ * to compute the SO integrals on the fly.
+ */
+void IntegralTransform::setup_direct_tei() {
+    if (soEri_) return;
+    if (!wfn_) throw PSIEXCEPTION("IntegralTransform: the direct SO integral algorithm requires a wavefunction.");
+
+    std::shared_ptr<BasisSet> basis = wfn_->basisset();
+    auto factory = std::make_shared<IntegralFactory>(basis, basis, basis, basis);
+    int nthreads = Process::environment.get_n_threads();
+    std::vector<std::shared_ptr<TwoBodyAOInt>> tb;
+    for (int thread = 0; thread < nthreads; ++thread) tb.push_back(std::shared_ptr<TwoBodyAOInt>(factory->eri()));
+    soEri_ = std::make_shared<TwoBodySOInt>(tb, factory);
+    soBasis_ = std::make_shared<SOBasisSet>(basis, factory);
+
+    std::vector<int> irrepOffset(nirreps_, 0);
+    for (int h = 1; h < nirreps_; ++h) irrepOffset[h] = irrepOffset[h - 1] + sopi_[h - 1];
+    soShell_.assign(nso_, 0);
+    for (int ish = 0; ish < soBasis_->nshell(); ++ish) {
+        for (int i = 0; i < soBasis_->nfunction(ish); ++i) {
+            int func = soBasis_->function(ish) + i;
+            soShell_[irrepOffset[soBasis_->irrep(func)] + soBasis_->function_within_irrep(func)] = ish;
+        }
+    }
+}
+
+/**
+ * Adds the two-electron contributions to the Fock and frozen core operators (in lower triangular
+ * storage) from a single pass over the SO integrals computed on the fly, in place of the IWL presort.
+ */
+void IntegralTransform::build_fock_direct(const double *aD, const double *bD, const double *aFzcD,
+                                          const double *bFzcD, double *aFock, double *bFock, double *aFzcOp,
+                                          double *bFzcOp) {
+    setup_direct_tei();
+
+    if (print_) {
+        outfile->Printf("\tComputing SO-basis two-electron integrals directly; no presort is needed.\n");
+    }
+
+    // Scratch Fock-like matrices for all but the first thread, which are reduced afterwards
+    int nthreads = Process::environment.get_n_threads();
+    std::vector<std::array<double *, 2>> threadFock(nthreads, {{nullptr, nullptr}});
+    std::vector<std::array<double *, 2>> threadFzcOp(nthreads, {{nullptr, nullptr}});
+    for (int thread = 1; thread < nthreads; ++thread) {
+        threadFock[thread][0] = init_array(nTriSo_);
+        threadFzcOp[thread][0] = init_array(nTriSo_);
+        if (transformationType_ != TransformationType::Restricted) {
+            threadFock[thread][1] = init_array(nTriSo_);
+            threadFzcOp[thread][1] = init_array(nTriSo_);
+        }
+    }
+
+    std::vector<char> allPairs;
+    if (transformationType_ == TransformationType::Restricted) {
+        std::vector<FrozenCoreAndFockRestrictedFunctor> fock;
+        fock.emplace_back(aD, aFzcD, aFock, aFzcOp);
+        for (int thread = 1; thread < nthreads; ++thread)
+            fock.emplace_back(aD, aFzcD, threadFock[thread][0], threadFzcOp[thread][0]);
+        ThreadedFockFunctor<FrozenCoreAndFockRestrictedFunctor> body(fock);
+        compute_so_quartets(*soEri_, soBasis_, allPairs, body);
+    } else {
+        std::vector<FrozenCoreAndFockUnrestrictedFunctor> fock;
+        fock.emplace_back(aD, bD, aFzcD, bFzcD, aFock, bFock, aFzcOp, bFzcOp);
+        for (int thread = 1; thread < nthreads; ++thread)
+            fock.emplace_back(aD, bD, aFzcD, bFzcD, threadFock[thread][0], threadFock[thread][1],
+                              threadFzcOp[thread][0], threadFzcOp[thread][1]);
+        ThreadedFockFunctor<FrozenCoreAndFockUnrestrictedFunctor> body(fock);
+        compute_so_quartets(*soEri_, soBasis_, allPairs, body);
+    }
+
+    for (int thread = 1; thread < nthreads; ++thread) {
+        for (int pq = 0; pq < nTriSo_; ++pq) {
+            aFock[pq] += threadFock[thread][0][pq];
+            aFzcOp[pq] += threadFzcOp[thread][0][pq];
+            if (transformationType_ != TransformationType::Restricted) {
+                bFock[pq] += threadFock[thread][1][pq];
+                bFzcOp[pq] += threadFzcOp[thread][1][pq];
+            }
+        }
+        for (int spin = 0; spin < 2; ++spin) {
+            if (threadFock[thread][spin]) free(threadFock[thread][spin]);
+            if (threadFzcOp[thread][spin]) free(threadFzcOp[thread][spin]);
+        }
+    }
+}
+
+/**
+ * Computes rows [start, start + nrows) of irrep h of the SO integrals ( n>=n | n,n ) into J.matrix,
+ * evaluating only the shell quartets whose bra or ket shell pair contributes to those rows.
+ *
+ * @param J - the buffer, with the packed SO bra and unpacked SO ket, whose block is filled
+ * @param h - the irrep of the bra
+ * @param start - the first row of the block
+ * @param nrows - the number of rows in the block
+ */
+void IntegralTransform::compute_so_tei_rows(dpdbuf4 *J, int h, size_t start, int nrows) {
+    setup_direct_tei();
+
+    size_t coltot = J->params->coltot[h];
+    if (nrows == 0 || coltot == 0) return;
+    ::memset(J->matrix[h][0], 0, sizeof(double) * nrows * coltot);
+
+    int nshell = soBasis_->nshell();
+    std::vector<char> needPair(static_cast<size_t>(nshell) * nshell, 0);
+    for (int pq = 0; pq < nrows; ++pq) {
+        int M = soShell_[J->params->roworb[h][pq + start][0]];
+        int N = soShell_[J->params->roworb[h][pq + start][1]];
+        needPair[M * nshell + N] = needPair[N * nshell + M] = 1;
+    }
+
+    DirectSOFillerFunctor filler(J, h, start, nrows);
+    compute_so_quartets(*soEri_, soBasis_, needPair, filler);
+}
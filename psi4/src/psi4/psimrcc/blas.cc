@@ -331,9 +331,10 @@ int CCBLAS::compute_storage_strategy() {
             outfile->Printf("\n    PSIMRCC will store some integrals out-of-core");
             strategy = 1;
         } else {
+            // The matrices that do not fit are allocated when an operation needs them and
+            // make_space() writes to disk those that no queued operation refers to
             outfile->Printf("\n    PSIMRCC will store all integrals and some other matrices out-of-core");
             strategy = 2;
-            throw PSIEXCEPTION("CCBLAS::compute_storage_strategy(): Strategy #2 is not implemented yet");
         }
     }
     sort(integrals.begin(), integrals.end());
@@ -66,6 +66,8 @@ class CCBLAS {
     typedef std::vector<int> intvec;
     typedef std::vector<std::pair<int, int> > intpairvec;
     typedef std::deque<CCOperation> OpDeque;
+    typedef std::pair<size_t, size_t> OpRange;  // [first,last) operations of a fused task
+    typedef std::vector<std::vector<OpRange> > OpSchedule;
 
     CCBLAS(Options& options);
     ~CCBLAS();
@@ -159,6 +161,10 @@ class CCBLAS {
     void solve_ref(std::string& str);
     int parse(std::string& str);
     void process_operations();
+    OpSchedule schedule_operations();
+    bool is_schedule_level_in_core(const std::vector<OpRange>& level);
+    void compute_task(const OpRange& task, int thread);
+    void release_task(const OpRange& task);
     void process_reduce_spaces(CCMatrix* out_Matrix, CCMatrix* in_Matrix);
     void process_expand_spaces(CCMatrix* out_Matrix, CCMatrix* in_Matrix);
     bool get_factor(const std::string& str, double& factor);
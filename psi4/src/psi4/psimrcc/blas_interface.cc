@@ -26,6 +26,7 @@
  * @END LICENSE
  */
 
+#include <algorithm>
 #include <cstdlib>
 
 #include "psi4/libmoinfo/libmoinfo.h"
@@ -238,13 +239,37 @@ void CCBLAS::load_irrep(CCMatrix* Matrix, int h) {
     }
 }
 
+/**
+ * Write to disk the blocks that none of the queued operations will use until
+ * memory_required bytes are available.  The largest blocks are released first.
+ * Outside of compute() the deque is empty and it is not known which matrices
+ * are still referenced, so nothing is released.
+ */
 void CCBLAS::make_space(size_t memory_required) {
-    if (memory_required < memory_manager->get_FreeMemory())
+    if (memory_required < memory_manager->get_FreeMemory()) return;
+    if (operations.empty()) {
+        outfile->Printf("\nCCBLAS::make_space() cannot release memory outside of compute()");
         return;
-    else {
-        outfile->Printf("\nCCBLAS::make_space() not implemented yet!!!");
-        // Attempt #1
     }
+    std::vector<std::pair<size_t, std::pair<CCMatrix*, int> > > unused_blocks;
+    for (MatrixMap::iterator it = matrices.begin(); it != matrices.end(); ++it) {
+        CCMatrix* Matrix = it->second;
+        MatCnt::iterator count = matrices_in_deque.find(Matrix);
+        if (Matrix->is_fock() || ((count != matrices_in_deque.end()) && (count->second > 0))) continue;
+        for (int h = 0; h < moinfo->get_nirreps(); ++h) {
+            if (Matrix->is_block_allocated(h) && (Matrix->get_memorypi2(h) > 0))
+                unused_blocks.push_back(std::make_pair(Matrix->get_memorypi2(h), std::make_pair(Matrix, h)));
+        }
+    }
+    std::sort(unused_blocks.rbegin(), unused_blocks.rend());
+    for (size_t n = 0; n < unused_blocks.size(); ++n) {
+        if (memory_required < memory_manager->get_FreeMemory()) break;
+        DEBUGGING(2, outfile->Printf("\nCCBLAS::make_space(): writing %s irrep %d to disk",
+                                     unused_blocks[n].second.first->get_label().c_str(), unused_blocks[n].second.second);)
+        unused_blocks[n].second.first->dump_block_to_disk(unused_blocks[n].second.second);
+    }
+    if (memory_required >= memory_manager->get_FreeMemory())
+        outfile->Printf("\nCCBLAS::make_space() could not release %lu bytes", (size_t)memory_required);
 }
 
 }  // namespace psimrcc
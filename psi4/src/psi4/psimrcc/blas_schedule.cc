@@ -0,0 +1,149 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2019 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#include <algorithm>
+
+#include "psi4/libmoinfo/libmoinfo.h"
+
+#include "blas.h"
+#include "debugging.h"
+#include "matrix.h"
+
+namespace psi {
+namespace psimrcc {
+
+/**
+ * Build the dependency graph of the queued operations.
+ *
+ * Consecutive operations that accumulate into the same target (the terms of a
+ * single expression) are fused into one task, so that the target is zeroed and
+ * updated by a single thread while it is in cache.  Each task is then assigned
+ * to the first level that comes after every task writing a matrix it uses and
+ * every task reading its target.  The tasks within a level are independent
+ * (e.g. the same term evaluated for different reference determinants) and may
+ * be computed concurrently.
+ * @return the tasks grouped by level, in the order in which the levels must run
+ */
+CCBLAS::OpSchedule CCBLAS::schedule_operations() {
+    OpSchedule schedule;
+    MatCnt last_write;  // Last level that writes a matrix
+    MatCnt last_read;   // Last level that reads a matrix
+
+    size_t first = 0;
+    while (first < operations.size()) {
+        CCMatrix* A_Matrix = operations[first].get_A_Matrix();
+        size_t last = first + 1;
+        while ((last < operations.size()) && (operations[last].get_A_Matrix() == A_Matrix)) ++last;
+
+        std::vector<CCMatrix*> sources;
+        for (size_t n = first; n < last; ++n) {
+            CCMatrix* B_Matrix = operations[n].get_B_Matrix();
+            CCMatrix* C_Matrix = operations[n].get_C_Matrix();
+            if ((B_Matrix != nullptr) && (B_Matrix != A_Matrix)) sources.push_back(B_Matrix);
+            if ((C_Matrix != nullptr) && (C_Matrix != A_Matrix)) sources.push_back(C_Matrix);
+        }
+
+        int level = 0;
+        MatCnt::iterator it = last_write.find(A_Matrix);
+        if (it != last_write.end()) level = std::max(level, it->second + 1);
+        it = last_read.find(A_Matrix);
+        if (it != last_read.end()) level = std::max(level, it->second + 1);
+        for (size_t n = 0; n < sources.size(); ++n) {
+            it = last_write.find(sources[n]);
+            if (it != last_write.end()) level = std::max(level, it->second + 1);
+        }
+
+        last_write[A_Matrix] = level;
+        for (size_t n = 0; n < sources.size(); ++n) {
+            it = last_read.find(sources[n]);
+            if (it == last_read.end())
+                last_read[sources[n]] = level;
+            else
+                it->second = std::max(it->second, level);
+        }
+
+        if (static_cast<int>(schedule.size()) <= level) schedule.resize(level + 1);
+        schedule[level].push_back(std::make_pair(first, last));
+        first = last;
+    }
+    DEBUGGING(3, outfile->Printf("\nCCBLAS::schedule_operations(): %d operations in %d levels",
+                                 static_cast<int>(operations.size()), static_cast<int>(schedule.size()));)
+    return schedule;
+}
+
+/**
+ * Check that all the matrices used by a level are in core, so that its tasks
+ * can run concurrently without loading (or releasing) any block
+ */
+bool CCBLAS::is_schedule_level_in_core(const std::vector<OpRange>& level) {
+    if (!full_in_core) return false;
+    for (size_t t = 0; t < level.size(); ++t) {
+        for (size_t n = level[t].first; n < level[t].second; ++n) {
+            CCOperation& op = operations[n];
+            if ((op.get_A_Matrix() != nullptr) && !op.get_A_Matrix()->is_allocated()) return false;
+            if ((op.get_B_Matrix() != nullptr) && !op.get_B_Matrix()->is_allocated()) return false;
+            if ((op.get_C_Matrix() != nullptr) && !op.get_C_Matrix()->is_allocated()) return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Compute a fused task using the work and buffer arrays of a thread
+ */
+void CCBLAS::compute_task(const OpRange& task, int thread) {
+    for (size_t n = task.first; n < task.second; ++n) {
+        CCOperation& op = operations[n];
+        op.set_scratch(work[thread], buffer[thread]);
+        op.compute();
+    }
+}
+
+/**
+ * Decrease the counters of the matrices used by a task that has been computed
+ */
+void CCBLAS::release_task(const OpRange& task) {
+    for (size_t n = task.first; n < task.second; ++n) {
+        CCOperation& op = operations[n];
+        if (op.get_A_Matrix() != nullptr) {
+            matrices_in_deque[op.get_A_Matrix()]--;
+            matrices_in_deque_target[op.get_A_Matrix()]--;
+        }
+        if (op.get_B_Matrix() != nullptr) {
+            matrices_in_deque[op.get_B_Matrix()]--;
+            matrices_in_deque_source[op.get_B_Matrix()]--;
+        }
+        if (op.get_C_Matrix() != nullptr) {
+            matrices_in_deque[op.get_C_Matrix()]--;
+            matrices_in_deque_source[op.get_C_Matrix()]--;
+        }
+    }
+}
+
+}  // namespace psimrcc
+}  // namespace psi
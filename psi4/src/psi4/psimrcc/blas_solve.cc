@@ -26,7 +26,11 @@
  * @END LICENSE
  */
 
+#include <algorithm>
 #include <cstdio>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 #include "psi4/libmoinfo/libmoinfo.h"
 
 #include "blas.h"
@@ -97,88 +101,14 @@ void CCBLAS::append(std::string str) {
 
 /**
  * Flush the operation deque in a memory smart way!
+ * The operations are fused and ordered by the dependency graph built by
+ * schedule_operations(). When all the matrices are in core the independent
+ * tasks of each level are computed concurrently, otherwise the tasks are
+ * computed one at a time and make_space() uses the counters of the remaining
+ * operations to decide which blocks may be written to disk.
  */
 void CCBLAS::compute() {
-    //   outfile->Printf("\n\nsmart_compute::size of current deque = %d",operations.size());
-    //
-    //   outfile->Printf("\nsmart_compute::content of the deque:");
-    //   for(OpDeque::iterator it = operations.begin();it!=operations.end();++it){
-    //     outfile->Printf("\n");
-    //     it->print();
-    //   }
-
-    //   // Create a map with all the target matrices and how many times they appear
-    //   map<string,int> target_count;
-    //   for(OpDeque::iterator it = operations.begin();it!=operations.end();++it){
-    //     if(it->get_A_Matrix()!=nullptr)
-    //       target_count[it->get_A_Matrix()->get_label()]++;
-    //   }
-    //   // Create a map with all the source matrices and how many times they appear
-    //   map<string,int> source_count;
-    //   for(OpDeque::iterator it = operations.begin();it!=operations.end();++it){
-    //     if(it->get_B_Matrix()!=nullptr)
-    //       source_count[it->get_B_Matrix()->get_label()]++;
-    //     if(it->get_C_Matrix()!=nullptr)
-    //       source_count[it->get_C_Matrix()->get_label()]++;
-    //   }
-    //
-    //   // Create a map with all the intermediates defined as matrices that appear a source and target
-    //     map<string,int> intermediates_count;
-    //   for(map<string,int>::iterator it=matrix_count.begin();it!=matrix_count.end();++it){
-    //     map<string,int>::iterator target_it = target_count.find(it->first);
-    //     map<string,int>::iterator source_it = source_count.find(it->first);
-    //     if( (target_it!=target_count.end()) && (source_it!=source_count.end()))
-    //       intermediates_count[source_it->first]=source_it->second;
-    //   }
-    //
-    //   // Print the map for debugging purposes
-    //   outfile->Printf("\n\nsmart_compute::printing the matrix_count map");
-    //   for(map<string,int>::iterator it=matrix_count.begin();it!=matrix_count.end();++it){
-    //     outfile->Printf("\n %s(%d)",it->first.c_str(),it->second);
-    //   }
-    //
-    //   // Print the map for debugging purposes
-    //   outfile->Printf("\n\nsmart_compute::printing the target_count map");
-    //   for(map<string,int>::iterator it=target_count.begin();it!=target_count.end();++it){
-    //     outfile->Printf("\n %s(%d)",it->first.c_str(),it->second);
-    //   }
-    //
-    //   // Print the map for debugging purposes
-    //   outfile->Printf("\n\nsmart_compute::printing the source_count map");
-    //   for(map<string,int>::iterator it=source_count.begin();it!=source_count.end();++it){
-    //     outfile->Printf("\n %s(%d)",it->first.c_str(),it->second);
-    //   }
-    //
-    //   // Print the map for debugging purposes
-    //   outfile->Printf("\n\nsmart_compute::printing the intermediates_count map");
-    //   for(map<string,int>::iterator it=intermediates_count.begin();it!=intermediates_count.end();++it){
-    //     outfile->Printf("\n %s(%d)",it->first.c_str(),it->second);
-    //   }
-
-    //   map<string,bool> matrix_on_disk;
-    //   map<string,bool> matrix_in_core;
-    //   for(map<string,int>::iterator it=matrix_count.begin();it!=matrix_count.end();++it){
-    //     if(it->first[0]=='<'
-    //     matrix_on_disk[it->first]=false;
-    //     matrix_on_disk[it->first]=false;
-    //   }
-
-    //   for(OpDeque::iterator it = operations.begin();it!=operations.end();++it){
-    //
-    //   }
-    //   static int memory_for_solve = 0;
-    //
-    //   for(OpDeque::iterator it = operations.begin();it!=operations.end();++it){
-    //     int nop = distance(it-operations.begin());
-    //     outfile->Printf("\nI will process operation #%3d",nop);
-    //     int memA=0;
-    //     if(it->get_A_Matrix()!=nullptr){
-    //       memA=it->get_A_Matrix()->get_memory();
-    //     }
-    //   }
-
     // Create a map with all the required matrices and how many times they appear
-
     for (OpDeque::iterator it = operations.begin(); it != operations.end(); ++it) {
         if (it->get_A_Matrix() != nullptr) {
             matrices_in_deque[it->get_A_Matrix()]++;
@@ -193,28 +123,30 @@ void CCBLAS::compute() {
             matrices_in_deque_source[it->get_C_Matrix()]++;
         }
     }
-    while (!operations.empty()) {
-        // Read the element
-        CCOperation& op = operations.front();
-        // Compute the operation
-        op.compute();
 
-        // Decrease the counters for the matrices to be processed
-        if (op.get_A_Matrix() != nullptr) {
-            matrices_in_deque[op.get_A_Matrix()]--;
-            matrices_in_deque_target[op.get_A_Matrix()]--;
-        }
-        if (op.get_B_Matrix() != nullptr) {
-            matrices_in_deque[op.get_B_Matrix()]--;
-            matrices_in_deque_source[op.get_B_Matrix()]--;
-        }
-        if (op.get_C_Matrix() != nullptr) {
-            matrices_in_deque[op.get_C_Matrix()]--;
-            matrices_in_deque_source[op.get_C_Matrix()]--;
+    OpSchedule schedule = schedule_operations();
+    int nthreads = static_cast<int>(work.size());
+    for (size_t l = 0; l < schedule.size(); ++l) {
+        std::vector<OpRange>& level = schedule[l];
+        int ntasks = static_cast<int>(level.size());
+        if ((nthreads > 1) && (ntasks > 1) && is_schedule_level_in_core(level)) {
+#pragma omp parallel for schedule(dynamic) num_threads(std::min(nthreads, ntasks))
+            for (int t = 0; t < ntasks; ++t) {
+                int thread = 0;
+#ifdef _OPENMP
+                thread = omp_get_thread_num();
+#endif
+                compute_task(level[t], thread);
+            }
+            for (int t = 0; t < ntasks; ++t) release_task(level[t]);
+        } else {
+            for (int t = 0; t < ntasks; ++t) {
+                compute_task(level[t], 0);
+                release_task(level[t]);
+            }
         }
-        // Eliminate the element
-        operations.pop_front();
     }
+    operations.clear();
 }
 
 /**
@@ -90,6 +90,7 @@ class CCMatrix {
     size_t get_block_sizepi(int h) const { return (block_sizepi[h]); }
     double** operator[](int h) const { return (matrix[h]); }
     double*** get_matrix() {
+#pragma omp atomic
         naccess++;
         return (matrix);
     }
@@ -83,6 +83,7 @@ void CCOperation::setup_contractions() {
         if (T_matrix_offset > 0) zero_arr(&(local_work[0]), T_matrix_offset);
     }
 
+#pragma omp atomic
     PartA_timing += PartA.get();
     Timer PartB;
 
@@ -131,6 +132,7 @@ void CCOperation::setup_contractions() {
             contract_in_core(A_matrix, B_matrix, C_matrix, B_on_disk, C_on_disk, rows_A, rows_B, rows_C, cols_A, cols_B,
                              cols_C, offset);
             // Store the timing in moinfo
+#pragma omp critical(psimrcc_dgemm_timing)
             moinfo->add_dgemm_timing(timer.get());
         }
 
@@ -168,6 +170,7 @@ void CCOperation::setup_contractions() {
                     contract_in_core(A_matrix, B_matrix, C_matrix, B_on_disk, C_on_disk, rows_A, rows_B, rows_C, cols_A,
                                      cols_B, cols_C, offset);
                     // Store the timing in moinfo
+#pragma omp critical(psimrcc_dgemm_timing)
                     moinfo->add_dgemm_timing(timer.get());
                     offset += strip_length;
                 }
@@ -209,6 +212,7 @@ void CCOperation::setup_contractions() {
                     contract_in_core(A_matrix, B_matrix, C_matrix, B_on_disk, C_on_disk, rows_A, rows_B, rows_C, cols_A,
                                      cols_B, cols_C, offset);
                     // Store the timing in moinfo
+#pragma omp critical(psimrcc_dgemm_timing)
                     moinfo->add_dgemm_timing(timer.get());
                     offset += strip_length;
                 }
@@ -218,6 +222,7 @@ void CCOperation::setup_contractions() {
         }
     }  // end of for loop over irreps
 
+#pragma omp atomic
     PartB_timing += PartB.get();
     Timer PartC;
     if (need_sort) {
@@ -227,6 +232,7 @@ void CCOperation::setup_contractions() {
             delete[] T_matrix[h];
         delete[] T_matrix;
     }
+#pragma omp atomic
     PartC_timing += PartC.get();
 }
 
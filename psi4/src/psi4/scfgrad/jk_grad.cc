@@ -28,11 +28,15 @@
 
 #include "jk_grad.h"
 
+#include <algorithm>
+#include <cmath>
+
 #include "psi4/libmints/sieve.h"
 #include "psi4/libqt/qt.h"
 #include "psi4/lib3index/3index.h"
 #include "psi4/libpsio/psio.hpp"
 #include "psi4/libpsio/psio.h"
+#include "psi4/libpsio/aiohandler.h"
 #include "psi4/psifiles.h"
 #include "psi4/libmints/matrix.h"
 #include "psi4/libmints/molecule.h"
@@ -99,6 +103,8 @@ std::shared_ptr<JKGrad> JKGrad::build_JKGrad(int deriv, std::shared_ptr<BasisSet
 
         return std::shared_ptr<JKGrad>(jk);
 
+    } else if (options.get_str("SCF_TYPE") == "COSX") {
+        throw PSIEXCEPTION("JKGrad::build_JKGrad: COSX gradients are not implemented, use SCF_TYPE DF or DIRECT");
     } else {
         throw PSIEXCEPTION("JKGrad::build_JKGrad: Unknown SCF Type");
     }
@@ -743,7 +749,7 @@ void DFJKGrad::build_UV_terms()
 
     int max_rows;
     size_t effective_memory = memory_ - 1L * naux * naux;
-    size_t row_cost = 2L * na * (size_t) na;
+    size_t row_cost = 3L * na * (size_t) na;
     size_t rows = memory_ / row_cost;
     rows = (rows > naux ? naux : rows);
     rows = (rows < 1L ? 1L : rows);
@@ -751,88 +757,80 @@ void DFJKGrad::build_UV_terms()
 
     // => Temporary Buffers <= //
 
+    // Bij is double buffered, one stripe is contracted while the next is read
     auto Aij = std::make_shared<Matrix>("Aij", max_rows, na*(size_t)na);
     auto Bij = std::make_shared<Matrix>("Bij", max_rows, na*(size_t)na);
+    auto Bij2 = std::make_shared<Matrix>("Bij", max_rows, na*(size_t)na);
     double** Aijp = Aij->pointer();
-    double** Bijp = Bij->pointer();
+    double* Bijp[2] = {Bij->pointer()[0], Bij2->pointer()[0]};
+
+    auto aio = std::make_shared<AIOHandler>(psio_);
 
     // => V < = //
 
-    // > Alpha < //
-    if (true) {
-        psio_address next_Aij = PSIO_ZERO;
-        for (int P = 0; P < naux; P += max_rows) {
-            psio_address next_Bij = PSIO_ZERO;
-            int nP = (P + max_rows >= naux ? naux - P : max_rows);
-            psio_->read(unit_a_,"(A|ij)",(char*) Aijp[0], sizeof(double)*nP*na*na, next_Aij, &next_Aij);
-            for (int Q = 0; Q < naux; Q += max_rows) {
-                int nQ = (Q + max_rows >= naux ? naux - Q : max_rows);
-                psio_->read(unit_a_,"(A|ij)",(char*) Bijp[0], sizeof(double)*nQ*na*na, next_Bij, &next_Bij);
-
-                C_DGEMM('N','T',nP,nQ,na*(size_t)na,1.0,Aijp[0],na*(size_t)na,Bijp[0],na*(size_t)na,0.0,&Vp[P][Q],naux);
-            }
-        }
-    }
-    // > Beta < //
+    // V is symmetric, only the Q <= P stripes are formed
+    stream_UV_stripes(aio, unit_a_, "(A|ij)", "(A|ij)", na, max_rows, Aijp[0], Bijp, Vp, 0.0, true);
     if (!restricted) {
-        psio_address next_Aij = PSIO_ZERO;
-        for (int P = 0; P < naux; P += max_rows) {
-            psio_address next_Bij = PSIO_ZERO;
-            int nP = (P + max_rows >= naux ? naux - P : max_rows);
-            psio_->read(unit_b_,"(A|ij)",(char*) Aijp[0], sizeof(double)*nP*nb*nb, next_Aij, &next_Aij);
-            for (int Q = 0; Q < naux; Q += max_rows) {
-                int nQ = (Q + max_rows >= naux ? naux - Q : max_rows);
-                psio_->read(unit_b_,"(A|ij)",(char*) Bijp[0], sizeof(double)*nQ*nb*nb, next_Bij, &next_Bij);
-
-                C_DGEMM('N','T',nP,nQ,nb*(size_t)nb,1.0,Aijp[0],nb*(size_t)nb,Bijp[0],nb*(size_t)nb,1.0,&Vp[P][Q],naux);
-            }
-        }
+        stream_UV_stripes(aio, unit_b_, "(A|ij)", "(A|ij)", nb, max_rows, Aijp[0], Bijp, Vp, 1.0, true);
     } else {
         V->scale(2.0);
     }
+    for (int P = 0; P < naux; P++) {
+        for (int Q = (P / max_rows + 1) * max_rows; Q < naux; Q++) {
+            Vp[P][Q] = Vp[Q][P];
+        }
+    }
     psio_->write_entry(unit_c_,"V",(char*) Vp[0], sizeof(double) * naux * naux);
 
     if (!do_wK_)
         return;
 
     // => W < = //
-    V->zero();
 
-    // > Alpha < //
-    if (true) {
-        psio_address next_Aij = PSIO_ZERO;
-        for (int P = 0; P < naux; P += max_rows) {
-            psio_address next_Bij = PSIO_ZERO;
-            int nP = (P + max_rows >= naux ? naux - P : max_rows);
-            psio_->read(unit_a_,"(A|ij)",(char*) Aijp[0], sizeof(double)*nP*na*na, next_Aij, &next_Aij);
-            for (int Q = 0; Q < naux; Q += max_rows) {
-                int nQ = (Q + max_rows >= naux ? naux - Q : max_rows);
-                psio_->read(unit_a_,"(A|w|ij)",(char*) Bijp[0], sizeof(double)*nQ*na*na, next_Bij, &next_Bij);
-
-                C_DGEMM('N','T',nP,nQ,na*(size_t)na,1.0,Aijp[0],na*(size_t)na,Bijp[0],na*(size_t)na,0.0,&Vp[P][Q],naux);
-            }
-        }
-    }
-    // > Beta < //
+    stream_UV_stripes(aio, unit_a_, "(A|ij)", "(A|w|ij)", na, max_rows, Aijp[0], Bijp, Vp, 0.0, false);
     if (!restricted) {
-        psio_address next_Aij = PSIO_ZERO;
-        for (int P = 0; P < naux; P += max_rows) {
-            psio_address next_Bij = PSIO_ZERO;
-            int nP = (P + max_rows >= naux ? naux - P : max_rows);
-            psio_->read(unit_b_,"(A|ij)",(char*) Aijp[0], sizeof(double)*nP*nb*nb, next_Aij, &next_Aij);
-            for (int Q = 0; Q < naux; Q += max_rows) {
-                int nQ = (Q + max_rows >= naux ? naux - Q : max_rows);
-                psio_->read(unit_b_,"(A|w|ij)",(char*) Bijp[0], sizeof(double)*nQ*nb*nb, next_Bij, &next_Bij);
-
-                C_DGEMM('N','T',nP,nQ,nb*(size_t)nb,1.0,Aijp[0],nb*(size_t)nb,Bijp[0],nb*(size_t)nb,1.0,&Vp[P][Q],naux);
-            }
-        }
+        stream_UV_stripes(aio, unit_b_, "(A|ij)", "(A|w|ij)", nb, max_rows, Aijp[0], Bijp, Vp, 1.0, false);
     } else {
         V->scale(2.0);
     }
     V->hermitivitize();
     psio_->write_entry(unit_c_,"W",(char*) Vp[0], sizeof(double) * naux * naux);
 }
+void DFJKGrad::stream_UV_stripes(std::shared_ptr<AIOHandler> aio, size_t unit, const char* Akey, const char* Bkey,
+                                 int nmo, int max_rows, double* Aij, double* Bij[2], double** Vp, double beta,
+                                 bool lower)
+{
+    int naux = auxiliary_->nbf();
+    size_t nmo2 = nmo * (size_t) nmo;
+    psio_address dummy;
+
+    for (int P = 0; P < naux; P += max_rows) {
+        int nP = (P + max_rows >= naux ? naux - P : max_rows);
+        int Qstop = (lower ? P + nP : naux);
+        psio_->read(unit, Akey, (char*) Aij, sizeof(double) * nP * nmo2,
+                    psio_get_address(PSIO_ZERO, sizeof(double) * P * nmo2), &dummy);
+
+        size_t job = aio->read(unit, Bkey, (char*) Bij[0], sizeof(double) * std::min(max_rows, Qstop) * nmo2,
+                               PSIO_ZERO, &dummy);
+        int buf = 0;
+        for (int Q = 0; Q < Qstop; Q += max_rows) {
+            int nQ = (Q + max_rows >= Qstop ? Qstop - Q : max_rows);
+            aio->wait_for_job(job);
+
+            // > Prefetch the next stripe while this one is contracted < //
+            int Qnext = Q + max_rows;
+            if (Qnext < Qstop) {
+                int nQnext = (Qnext + max_rows >= Qstop ? Qstop - Qnext : max_rows);
+                job = aio->read(unit, Bkey, (char*) Bij[1 - buf], sizeof(double) * nQnext * nmo2,
+                                psio_get_address(PSIO_ZERO, sizeof(double) * Qnext * nmo2), &dummy);
+            }
+
+            C_DGEMM('N','T',nP,nQ,nmo2,1.0,Aij,nmo2,Bij[buf],nmo2,beta,&Vp[P][Q],naux);
+            buf = 1 - buf;
+        }
+    }
+    aio->synchronize();
+}
 void DFJKGrad::build_AB_x_terms()
 {
 
@@ -1044,7 +1042,7 @@ void DFJKGrad::build_Amn_x_terms()
             row_cost += nso * (size_t) nso;
         }
         row_cost += nso * (size_t) na;
-        row_cost += na * (size_t) na;
+        row_cost += 2L * na * (size_t) na;
         size_t rows = memory_ / row_cost;
         rows = (rows > naux ? naux : rows);
         rows = (rows < maxP ? maxP : rows);
@@ -1083,19 +1081,22 @@ void DFJKGrad::build_Amn_x_terms()
     SharedMatrix wKmn;
     SharedMatrix Ami;
     SharedMatrix Aij;
+    SharedMatrix Aij2;
 
     double** Kmnp;
     double** wKmnp;
     double** Amip;
-    double** Aijp;
+    double* Aijp[2];
 
     if (do_K_ || do_wK_) {
         Kmn = std::make_shared<Matrix>("Kmn", max_rows, nso * (size_t) nso);
         Ami = std::make_shared<Matrix>("Ami", max_rows, nso * (size_t) na);
         Aij = std::make_shared<Matrix>("Aij", max_rows, na * (size_t) na);
+        Aij2 = std::make_shared<Matrix>("Aij", max_rows, na * (size_t) na);
         Kmnp = Kmn->pointer();
         Amip = Ami->pointer();
-        Aijp = Aij->pointer();
+        Aijp[0] = Aij->pointer()[0];
+        Aijp[1] = Aij2->pointer()[0];
     }
     if (do_wK_) {
         wKmn = std::make_shared<Matrix>("wKmn", max_rows, nso * (size_t) nso);
@@ -1106,11 +1107,6 @@ void DFJKGrad::build_Amn_x_terms()
     double** Cap = Ca_->pointer();
     double** Cbp = Cb_->pointer();
 
-    psio_address next_Aija = PSIO_ZERO;
-    psio_address next_Aijb = PSIO_ZERO;
-    psio_address next_Awija = PSIO_ZERO;
-    psio_address next_Awijb = PSIO_ZERO;
-
     // => Integrals <= //
 
     auto rifactory = std::make_shared<IntegralFactory>(auxiliary_, BasisSet::zero_ao_basis_set(), primary_, primary_);
@@ -1147,21 +1143,45 @@ void DFJKGrad::build_Amn_x_terms()
 
     // => Figure out required transforms <= //
 
-    // unit, disk buffer name, nmo_size, psio_address, output_buffer
-    std::vector<std::tuple<size_t, std::string, double**, size_t, psio_address*, double**>> transforms;
+    // unit, disk buffer name, nmo_size, output_buffer
+    std::vector<std::tuple<size_t, std::string, double**, size_t, double**>> transforms;
     if (do_K_ || do_wK_) {
-        transforms.push_back(std::make_tuple(unit_a_, "(A|ij)", Cap, na, &next_Aija, Kmnp));
+        transforms.push_back(std::make_tuple(unit_a_, "(A|ij)", Cap, na, Kmnp));
         if (!restricted) {
-            transforms.push_back(std::make_tuple(unit_b_, "(A|ij)", Cbp, nb, &next_Aijb, Kmnp));
+            transforms.push_back(std::make_tuple(unit_b_, "(A|ij)", Cbp, nb, Kmnp));
         }
     }
     if (do_wK_) {
-        transforms.push_back(std::make_tuple(unit_a_, "(A|w|ij)", Cap, na, &next_Awija, wKmnp));
+        transforms.push_back(std::make_tuple(unit_a_, "(A|w|ij)", Cap, na, wKmnp));
         if (!restricted) {
-            transforms.push_back(std::make_tuple(unit_b_, "(A|w|ij)", Cbp, nb, &next_Awijb, wKmnp));
+            transforms.push_back(std::make_tuple(unit_b_, "(A|w|ij)", Cbp, nb, wKmnp));
         }
     }
 
+    // => Stripe Prefetch <= //
+
+    // The (A|ij) stripes are consumed in (block, transform) order. Each one is read
+    // asynchronously into the idle buffer while its predecessor is back-transformed,
+    // so the last stripe of a block streams in under the derivative integrals.
+    auto aio = std::make_shared<AIOHandler>(psio_);
+    psio_address dummy;
+    size_t nstripes = transforms.size() * (Pstarts.size() - 1);
+    auto read_stripe = [&](size_t stripe, double* target) {
+        const auto& trans = transforms[stripe % transforms.size()];
+        int Pstart = Pstarts[stripe / transforms.size()];
+        int Pstop = Pstarts[stripe / transforms.size() + 1];
+        size_t pstart = auxiliary_->shell(Pstart).function_index();
+        size_t pstop = (Pstop == auxiliary_->nshell() ? naux : auxiliary_->shell(Pstop).function_index());
+        size_t nmo2 = std::get<3>(trans) * std::get<3>(trans);
+        return aio->read(std::get<0>(trans), std::get<1>(trans).c_str(), (char*)target,
+                         sizeof(double) * (pstop - pstart) * nmo2,
+                         psio_get_address(PSIO_ZERO, sizeof(double) * pstart * nmo2), &dummy);
+    };
+    size_t stripe = 0L;
+    int buf = 0;
+    size_t stripe_job = 0L;
+    if (nstripes) stripe_job = read_stripe(0L, Aijp[0]);
+
     // => Master Loop <= //
 
     for (int block = 0; block < Pstarts.size() - 1; block++) {
@@ -1183,25 +1203,25 @@ void DFJKGrad::build_Amn_x_terms()
         for (const auto& trans : transforms) {
 
             // > Unpack transform < //
-            size_t unit = std::get<0>(trans);
-            std::string buffer = std::get<1>(trans);
             double** Cp = std::get<2>(trans);
             size_t nmo = std::get<3>(trans);
-            psio_address* address = std::get<4>(trans);
-            double** retp = std::get<5>(trans);
-            // printf("%4.2lf : %zu  %s %zu | %zu %zu\n", factor, unit, buffer.c_str(), nmo, address->page, address->offset);
+            double** retp = std::get<4>(trans);
 
             size_t nmo2 = nmo * nmo;
 
             // > Stripe < //
-            psio_->read(unit, buffer.c_str(), (char*)Aijp[0], sizeof(double) * np * nmo2, *address, address);
-            // printf("%4.2lf : %zu  %s %zu | %zu %zu\n", factor, unit, buffer.c_str(), nmo, address->page, address->offset);
-            // printf("\n");
+            aio->wait_for_job(stripe_job);
+            double* Aijs = Aijp[buf];
+            if (stripe + 1 < nstripes) {
+                stripe_job = read_stripe(stripe + 1, Aijp[1 - buf]);
+            }
+            stripe++;
+            buf = 1 - buf;
 
             // > (A|ij) C_mi -> (A|mj) < //
 #pragma omp parallel for
             for (int P = 0; P < np; P++) {
-                C_DGEMM('N', 'N', nso, nmo, nmo, 1.0, Cp[0], nmo, &Aijp[0][P * nmo2], nmo, 0.0, Amip[P], na);
+                C_DGEMM('N', 'N', nso, nmo, nmo, 1.0, Cp[0], nmo, &Aijs[P * nmo2], nmo, 0.0, Amip[P], na);
             }
 
             // > (A|mj) C_nj -> (A|mn) < //
@@ -1378,6 +1398,7 @@ void DFJKGrad::build_Amn_x_terms()
             }
         }
     }
+    aio->synchronize();
 
     // => Temporary Gradient Reduction <= //
 
@@ -2209,7 +2230,7 @@ void DirectJKGrad::compute_gradient()
         for (int thread = 0; thread < ints_num_threads_; thread++) {
             ints.push_back(std::shared_ptr<TwoBodyAOInt>(factory->eri(1)));
         }
-        std::map<std::string, std::shared_ptr<Matrix> > vals = compute1(ints);
+        std::map<std::string, std::shared_ptr<Matrix> > vals = compute1(ints, do_J_, do_K_);
         if (do_J_) {
             gradients_["Coulomb"]->copy(vals["J"]);
             // gradients_["Coulomb"]->print();
@@ -2224,12 +2245,13 @@ void DirectJKGrad::compute_gradient()
         for (int thread = 0; thread < ints_num_threads_; thread++) {
             ints.push_back(std::shared_ptr<TwoBodyAOInt>(factory->erf_eri(omega_,1)));
         }
-        std::map<std::string, std::shared_ptr<Matrix> > vals = compute1(ints);
+        std::map<std::string, std::shared_ptr<Matrix> > vals = compute1(ints, false, true);
         gradients_["Exchange,LR"]->copy(vals["K"]);
         // gradients_["Exchange,LR"]->print();
     }
 }
-std::map<std::string, std::shared_ptr<Matrix> > DirectJKGrad::compute1(std::vector<std::shared_ptr<TwoBodyAOInt> >& ints)
+std::map<std::string, std::shared_ptr<Matrix> > DirectJKGrad::compute1(std::vector<std::shared_ptr<TwoBodyAOInt> >& ints,
+                                                                       bool do_J, bool do_K)
 {
     int nthreads = ints.size();
 
@@ -2244,177 +2266,251 @@ std::map<std::string, std::shared_ptr<Matrix> > DirectJKGrad::compute1(std::vect
 
     const std::vector<std::pair<int, int> >& shell_pairs = sieve_->shell_pairs();
     size_t npairs = shell_pairs.size();
-    size_t npairs2 = npairs * npairs;
 
     double** Dtp = Dt_->pointer();
     double** Dap = Da_->pointer();
     double** Dbp = Db_->pointer();
 
-#pragma omp parallel for num_threads(nthreads) schedule(dynamic)
-    for (size_t index = 0L; index < npairs2; index++) {
-
-        size_t PQ = index / npairs;
-        size_t RS = index % npairs;
+    // => Density Bounds <= //
 
-        if (RS > PQ) continue;
+    // Every quartet contribution is an integral derivative times D_pq D_rs (J) or
+    // D_pr D_qs, D_ps D_qr (K), so the Schwarz ceiling of (PQ|RS) is weighted by
+    // the largest density elements of the shell blocks involved
+    int nshell = primary_->nshell();
+    std::vector<double> DJ(nshell * (size_t)nshell, 0.0);
+    std::vector<double> DK(nshell * (size_t)nshell, 0.0);
+    for (int P = 0; P < nshell; P++) {
+        int Psize = primary_->shell(P).nfunction();
+        int Poff = primary_->shell(P).function_index();
+        for (int Q = 0; Q < nshell; Q++) {
+            int Qsize = primary_->shell(Q).nfunction();
+            int Qoff = primary_->shell(Q).function_index();
+            double Jmax = 0.0;
+            double Kmax = 0.0;
+            for (int p = Poff; p < Poff + Psize; p++) {
+                for (int q = Qoff; q < Qoff + Qsize; q++) {
+                    Jmax = std::max(Jmax, std::fabs(Dtp[p][q]));
+                    Kmax = std::max(Kmax, std::max(std::fabs(Dap[p][q]), std::fabs(Dbp[p][q])));
+                }
+            }
+            DJ[P * (size_t)nshell + Q] = Jmax;
+            DK[P * (size_t)nshell + Q] = Kmax;
+        }
+    }
 
-        int P = shell_pairs[PQ].first;
-        int Q = shell_pairs[PQ].second;
-        int R = shell_pairs[RS].first;
-        int S = shell_pairs[RS].second;
+    // => Shell Pair Blocking <= //
+
+    // Significant shell pairs are grouped by atom pair, so every quartet of a (PQ|RS) block task
+    // sits on the same four centers. Each task is screened as a whole, and its gradient
+    // contributions are summed locally and written once per task.
+    std::map<std::pair<int, int>, size_t> block_index;
+    std::vector<std::vector<size_t> > pair_blocks;
+    std::vector<std::pair<int, int> > block_atoms;
+    for (size_t PQ = 0; PQ < npairs; PQ++) {
+        int A = primary_->shell(shell_pairs[PQ].first).ncenter();
+        int B = primary_->shell(shell_pairs[PQ].second).ncenter();
+        auto it = block_index.find(std::make_pair(A, B));
+        if (it == block_index.end()) {
+            it = block_index.insert(std::make_pair(std::make_pair(A, B), pair_blocks.size())).first;
+            pair_blocks.push_back(std::vector<size_t>());
+            block_atoms.push_back(std::make_pair(A, B));
+        }
+        pair_blocks[it->second].push_back(PQ);
+    }
+    size_t nblock = pair_blocks.size();
+
+    const std::vector<double> pair_values = sieve_->shell_pair_values();
+    double cutoff2 = cutoff_ * cutoff_;
+
+    // Block bounds: largest pair value and Coulomb density; exchange density per atom pair
+    std::vector<double> block_value(nblock, 0.0);
+    std::vector<double> block_DJ(nblock, 0.0);
+    for (size_t b = 0; b < nblock; b++) {
+        for (size_t PQ : pair_blocks[b]) {
+            int P = shell_pairs[PQ].first;
+            int Q = shell_pairs[PQ].second;
+            block_value[b] = std::max(block_value[b], pair_values[P * (size_t)nshell + Q]);
+            block_DJ[b] = std::max(block_DJ[b], DJ[P * (size_t)nshell + Q]);
+        }
+    }
+    std::vector<double> atom_DK(natom * (size_t)natom, 0.0);
+    for (int P = 0; P < nshell; P++) {
+        int A = primary_->shell(P).ncenter();
+        for (int Q = 0; Q < nshell; Q++) {
+            int B = primary_->shell(Q).ncenter();
+            double& DKAB = atom_DK[A * (size_t)natom + B];
+            DKAB = std::max(DKAB, DK[P * (size_t)nshell + Q]);
+        }
+    }
 
-        if (!sieve_->shell_significant(P,Q,R,S)) continue;
+    // => Quartet Loop <= //
 
-        //outfile->Printf("(%d,%d,%d,%d)\n", P,Q,R,S);
+    // One task per (PQ| block, paired with all |RS) blocks up to it. The longest rows go
+    // first so that the dynamic schedule finishes with the cheap ones.
+#pragma omp parallel for num_threads(nthreads) schedule(dynamic)
+    for (long int row = 0L; row < (long int)nblock; row++) {
+        size_t PQblock = nblock - 1 - row;
 
         int thread = 0;
 #ifdef _OPENMP
         thread = omp_get_thread_num();
 #endif
 
-        ints[thread]->compute_shell_deriv1(P,Q,R,S);
-
-        const double* buffer = ints[thread]->buffer();
-
         double** Jp = Jgrad[thread]->pointer();
         double** Kp = Kgrad[thread]->pointer();
 
-        int Psize = primary_->shell(P).nfunction();
-        int Qsize = primary_->shell(Q).nfunction();
-        int Rsize = primary_->shell(R).nfunction();
-        int Ssize = primary_->shell(S).nfunction();
-
-        int Pncart = primary_->shell(P).ncartesian();
-        int Qncart = primary_->shell(Q).ncartesian();
-        int Rncart = primary_->shell(R).ncartesian();
-        int Sncart = primary_->shell(S).ncartesian();
-
-        int Poff = primary_->shell(P).function_index();
-        int Qoff = primary_->shell(Q).function_index();
-        int Roff = primary_->shell(R).function_index();
-        int Soff = primary_->shell(S).function_index();
-
-        int Pcenter = primary_->shell(P).ncenter();
-        int Qcenter = primary_->shell(Q).ncenter();
-        int Rcenter = primary_->shell(R).ncenter();
-        int Scenter = primary_->shell(S).ncenter();
-
-        double prefactor = 1.0;
-        if (P != Q)   prefactor *= 2.0;
-        if (R != S)   prefactor *= 2.0;
-        if (PQ != RS) prefactor *= 2.0;
-
-        size_t stride = static_cast<size_t> (Pncart) * Qncart * Rncart * Sncart;
-
-        double val;
-        double Dpq, Drs;
-        size_t delta;
-        double Ax, Ay, Az;
-        double Bx, By, Bz;
-        double Cx, Cy, Cz;
-        double Dx, Dy, Dz;
-
-        // => Coulomb Term <= //
+        int Pcenter = block_atoms[PQblock].first;
+        int Qcenter = block_atoms[PQblock].second;
+
+        for (size_t RSblock = 0L; RSblock <= PQblock; RSblock++) {
+            int Rcenter = block_atoms[RSblock].first;
+            int Scenter = block_atoms[RSblock].second;
+
+            // Bound for every quartet in the task
+            double task_value = block_value[PQblock] * block_value[RSblock];
+            double task_DJ = block_DJ[PQblock] * block_DJ[RSblock];
+            double task_DK = std::max(atom_DK[Pcenter * (size_t)natom + Rcenter] *
+                                          atom_DK[Qcenter * (size_t)natom + Scenter],
+                                      atom_DK[Pcenter * (size_t)natom + Scenter] *
+                                          atom_DK[Qcenter * (size_t)natom + Rcenter]);
+            bool J_task = do_J && task_value * task_DJ * task_DJ >= cutoff2;
+            bool K_task = do_K && task_value * task_DK * task_DK >= cutoff2;
+            if (!J_task && !K_task) continue;
+
+            // Gradient contributions of the task on centers P, Q, R, S (x, y, z each)
+            double Jtask[12] = {0.0};
+            double Ktask[12] = {0.0};
+
+            for (size_t PQ : pair_blocks[PQblock]) {
+                int P = shell_pairs[PQ].first;
+                int Q = shell_pairs[PQ].second;
+
+                int Psize = primary_->shell(P).nfunction();
+                int Qsize = primary_->shell(Q).nfunction();
+                int Pncart = primary_->shell(P).ncartesian();
+                int Qncart = primary_->shell(Q).ncartesian();
+                int Poff = primary_->shell(P).function_index();
+                int Qoff = primary_->shell(Q).function_index();
+
+                for (size_t RS : pair_blocks[RSblock]) {
+                    // Within a diagonal task, each quartet only once
+                    if (RSblock == PQblock && RS > PQ) break;
+
+                    int R = shell_pairs[RS].first;
+                    int S = shell_pairs[RS].second;
+
+                    double ceiling2 = sieve_->shell_ceiling2(P, Q, R, S);
+                    double DJ_quartet = DJ[P * (size_t)nshell + Q] * DJ[R * (size_t)nshell + S];
+                    double DK_quartet = std::max(DK[P * (size_t)nshell + R] * DK[Q * (size_t)nshell + S],
+                                                 DK[P * (size_t)nshell + S] * DK[Q * (size_t)nshell + R]);
+                    bool J_significant = J_task && ceiling2 * DJ_quartet * DJ_quartet >= cutoff2;
+                    bool K_significant = K_task && ceiling2 * DK_quartet * DK_quartet >= cutoff2;
+                    if (!J_significant && !K_significant) continue;
+
+                    ints[thread]->compute_shell_deriv1(P, Q, R, S);
+
+                    const double* buffer = ints[thread]->buffer();
+
+                    int Rsize = primary_->shell(R).nfunction();
+                    int Ssize = primary_->shell(S).nfunction();
+
+                    int Rncart = primary_->shell(R).ncartesian();
+                    int Sncart = primary_->shell(S).ncartesian();
+
+                    int Roff = primary_->shell(R).function_index();
+                    int Soff = primary_->shell(S).function_index();
+
+                    double prefactor = 1.0;
+                    if (P != Q) prefactor *= 2.0;
+                    if (R != S) prefactor *= 2.0;
+                    if (PQ != RS) prefactor *= 2.0;
+
+                    size_t stride = static_cast<size_t>(Pncart) * Qncart * Rncart * Sncart;
+
+                    double val;
+                    double Dpq, Drs;
+                    size_t delta;
+
+                    // => Coulomb Term <= //
+
+                    if (J_significant) {
+                        delta = 0L;
+                        for (int p = 0; p < Psize; p++) {
+                            for (int q = 0; q < Qsize; q++) {
+                                Dpq = prefactor * Dtp[p + Poff][q + Qoff];
+                                for (int r = 0; r < Rsize; r++) {
+                                    for (int s = 0; s < Ssize; s++) {
+                                        Drs = Dtp[r + Roff][s + Soff];
+                                        val = Dpq * Drs;
+                                        Jtask[0] += val * buffer[0 * stride + delta];
+                                        Jtask[1] += val * buffer[1 * stride + delta];
+                                        Jtask[2] += val * buffer[2 * stride + delta];
+                                        Jtask[6] += val * buffer[3 * stride + delta];
+                                        Jtask[7] += val * buffer[4 * stride + delta];
+                                        Jtask[8] += val * buffer[5 * stride + delta];
+                                        Jtask[9] += val * buffer[6 * stride + delta];
+                                        Jtask[10] += val * buffer[7 * stride + delta];
+                                        Jtask[11] += val * buffer[8 * stride + delta];
+                                        delta++;
+                                    }
+                                }
+                            }
+                        }
+                    }
 
-        Ax = 0.0; Ay = 0.0; Az = 0.0;
-        Bx = 0.0; By = 0.0; Bz = 0.0;
-        Cx = 0.0; Cy = 0.0; Cz = 0.0;
-        Dx = 0.0; Dy = 0.0; Dz = 0.0;
-        delta = 0L;
-        for (int p = 0; p < Psize; p++) {
-            for (int q = 0; q < Qsize; q++) {
-                for (int r = 0; r < Rsize; r++) {
-                    for (int s = 0; s < Ssize; s++) {
-                        Dpq = Dtp[p + Poff][q + Qoff];
-                        Drs = Dtp[r + Roff][s + Soff];
-                        val = prefactor * Dpq * Drs;
-                        Ax += val * buffer[0 * stride + delta];
-                        Ay += val * buffer[1 * stride + delta];
-                        Az += val * buffer[2 * stride + delta];
-                        Cx += val * buffer[3 * stride + delta];
-                        Cy += val * buffer[4 * stride + delta];
-                        Cz += val * buffer[5 * stride + delta];
-                        Dx += val * buffer[6 * stride + delta];
-                        Dy += val * buffer[7 * stride + delta];
-                        Dz += val * buffer[8 * stride + delta];
-                        delta++;
+                    // => Exchange Term <= //
+
+                    if (K_significant) {
+                        delta = 0L;
+                        for (int p = 0; p < Psize; p++) {
+                            for (int q = 0; q < Qsize; q++) {
+                                for (int r = 0; r < Rsize; r++) {
+                                    for (int s = 0; s < Ssize; s++) {
+                                        val = 0.0;
+                                        Dpq = Dap[p + Poff][r + Roff];
+                                        Drs = Dap[q + Qoff][s + Soff];
+                                        val += Dpq * Drs;
+                                        Dpq = Dap[p + Poff][s + Soff];
+                                        Drs = Dap[q + Qoff][r + Roff];
+                                        val += Dpq * Drs;
+                                        Dpq = Dbp[p + Poff][r + Roff];
+                                        Drs = Dbp[q + Qoff][s + Soff];
+                                        val += Dpq * Drs;
+                                        Dpq = Dbp[p + Poff][s + Soff];
+                                        Drs = Dbp[q + Qoff][r + Roff];
+                                        val += Dpq * Drs;
+                                        val *= 0.5 * prefactor;
+                                        Ktask[0] += val * buffer[0 * stride + delta];
+                                        Ktask[1] += val * buffer[1 * stride + delta];
+                                        Ktask[2] += val * buffer[2 * stride + delta];
+                                        Ktask[6] += val * buffer[3 * stride + delta];
+                                        Ktask[7] += val * buffer[4 * stride + delta];
+                                        Ktask[8] += val * buffer[5 * stride + delta];
+                                        Ktask[9] += val * buffer[6 * stride + delta];
+                                        Ktask[10] += val * buffer[7 * stride + delta];
+                                        Ktask[11] += val * buffer[8 * stride + delta];
+                                        delta++;
+                                    }
+                                }
+                            }
+                        }
                     }
                 }
             }
-        }
-        Bx = -(Ax + Cx + Dx);
-        By = -(Ay + Cy + Dy);
-        Bz = -(Az + Cz + Dz);
-
-        Jp[Pcenter][0] += Ax;
-        Jp[Pcenter][1] += Ay;
-        Jp[Pcenter][2] += Az;
-        Jp[Qcenter][0] += Bx;
-        Jp[Qcenter][1] += By;
-        Jp[Qcenter][2] += Bz;
-        Jp[Rcenter][0] += Cx;
-        Jp[Rcenter][1] += Cy;
-        Jp[Rcenter][2] += Cz;
-        Jp[Scenter][0] += Dx;
-        Jp[Scenter][1] += Dy;
-        Jp[Scenter][2] += Dz;
-
-        // => Exchange Term <= //
 
-        Ax = 0.0; Ay = 0.0; Az = 0.0;
-        Bx = 0.0; By = 0.0; Bz = 0.0;
-        Cx = 0.0; Cy = 0.0; Cz = 0.0;
-        Dx = 0.0; Dy = 0.0; Dz = 0.0;
-        delta = 0L;
-        for (int p = 0; p < Psize; p++) {
-            for (int q = 0; q < Qsize; q++) {
-                for (int r = 0; r < Rsize; r++) {
-                    for (int s = 0; s < Ssize; s++) {
-                        val = 0.0;
-                        Dpq = Dap[p + Poff][r + Roff];
-                        Drs = Dap[q + Qoff][s + Soff];
-                        val += prefactor * Dpq * Drs;
-                        Dpq = Dap[p + Poff][s + Soff];
-                        Drs = Dap[q + Qoff][r + Roff];
-                        val += prefactor * Dpq * Drs;
-                        Dpq = Dbp[p + Poff][r + Roff];
-                        Drs = Dbp[q + Qoff][s + Soff];
-                        val += prefactor * Dpq * Drs;
-                        Dpq = Dbp[p + Poff][s + Soff];
-                        Drs = Dbp[q + Qoff][r + Roff];
-                        val += prefactor * Dpq * Drs;
-                        val *= 0.5;
-                        Ax += val * buffer[0 * stride + delta];
-                        Ay += val * buffer[1 * stride + delta];
-                        Az += val * buffer[2 * stride + delta];
-                        Cx += val * buffer[3 * stride + delta];
-                        Cy += val * buffer[4 * stride + delta];
-                        Cz += val * buffer[5 * stride + delta];
-                        Dx += val * buffer[6 * stride + delta];
-                        Dy += val * buffer[7 * stride + delta];
-                        Dz += val * buffer[8 * stride + delta];
-                        delta++;
-                    }
+            // Translational invariance gives the Q center, once per task
+            int centers[4] = {Pcenter, Qcenter, Rcenter, Scenter};
+            for (int k = 0; k < 3; k++) {
+                Jtask[3 + k] = -(Jtask[k] + Jtask[6 + k] + Jtask[9 + k]);
+                Ktask[3 + k] = -(Ktask[k] + Ktask[6 + k] + Ktask[9 + k]);
+            }
+            for (int c = 0; c < 4; c++) {
+                for (int k = 0; k < 3; k++) {
+                    Jp[centers[c]][k] += Jtask[3 * c + k];
+                    Kp[centers[c]][k] += Ktask[3 * c + k];
                 }
             }
         }
-        Bx = -(Ax + Cx + Dx);
-        By = -(Ay + Cy + Dy);
-        Bz = -(Az + Cz + Dz);
-
-        Kp[Pcenter][0] += Ax;
-        Kp[Pcenter][1] += Ay;
-        Kp[Pcenter][2] += Az;
-        Kp[Qcenter][0] += Bx;
-        Kp[Qcenter][1] += By;
-        Kp[Qcenter][2] += Bz;
-        Kp[Rcenter][0] += Cx;
-        Kp[Rcenter][1] += Cy;
-        Kp[Rcenter][2] += Cz;
-        Kp[Scenter][0] += Dx;
-        Kp[Scenter][1] += Dy;
-        Kp[Scenter][2] += Dz;
-
     }
 
     for (int thread = 1; thread < nthreads; thread++) {
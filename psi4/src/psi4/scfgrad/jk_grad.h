@@ -38,6 +38,7 @@ namespace psi {
 class ERISieve;
 class BasisSet;
 class PSIO;
+class AIOHandler;
 class TwoBodyAOInt;
 
 namespace scfgrad {
@@ -183,6 +184,10 @@ protected:
     void build_Amn_lr_terms();
     void build_AB_inv_terms();
     void build_UV_terms();
+    /// V_PQ = sum_ij (P|ij)_Akey (Q|ij)_Bkey + beta V_PQ, with the Bkey stripes
+    /// prefetched through aio; lower forms only the stripes with Q <= P
+    void stream_UV_stripes(std::shared_ptr<AIOHandler> aio, size_t unit, const char* Akey, const char* Bkey, int nmo,
+                           int max_rows, double* Aij, double* Bij[2], double** Vp, double beta, bool lower);
     void build_AB_x_terms();
     void build_Amn_x_terms();
 
@@ -241,7 +246,9 @@ protected:
 
     void common_init();
 
-    std::map<std::string, std::shared_ptr<Matrix> > compute1(std::vector<std::shared_ptr<TwoBodyAOInt> >& ints);
+    // Density-screened J and/or K gradient contributions of the given integral objects (one per thread)
+    std::map<std::string, std::shared_ptr<Matrix> > compute1(std::vector<std::shared_ptr<TwoBodyAOInt> >& ints, bool do_J,
+                                                             bool do_K);
     std::map<std::string, std::shared_ptr<Matrix> > compute2(std::vector<std::shared_ptr<TwoBodyAOInt> >& ints);
 public:
     DirectJKGrad(int deriv, std::shared_ptr<BasisSet> primary);
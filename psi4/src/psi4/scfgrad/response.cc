@@ -420,11 +420,17 @@ std::shared_ptr<Matrix> RSCFDeriv::hessian_response()
             psio_->write(PSIF_HESS,"Vpi^A",(char*)Vpip[0], static_cast<size_t> (nmo) * nocc * sizeof(double),next_Vpi,&next_Vpi);
         }
     }
+    // => Exchange-correlation <= //
+    // Only the alpha fraction of exact exchange enters the response; the XC kernel rides along with J
+    // V_xc derivatives are formed per batch of perturbations below, next to the J/K ones
+    double Kscale = functional_->is_x_hybrid() ? functional_->x_alpha() : 0.0;
+    bool do_xc = functional_->needs_xc();
+
     // => Jpi/Kpi <= //
     {
 
         size_t memory = 0.9 * memory_ / 8L;
-        size_t max_a = memory / (3L * nso * nso);
+        size_t max_a = memory / ((do_xc ? 4L : 3L) * nso * nso);
         max_a = (max_a > 3 * natom ? 3 * natom : max_a);
 
         int natom = basisset_->molecule()->natom();
@@ -586,18 +592,20 @@ std::shared_ptr<Matrix> RSCFDeriv::hessian_response()
                             C_DGEMV('t', nP, nso*nso, -1.0, Bmnp[oP], nso*nso, pTempP[0], 1, 1.0, pdG[Pz][0], 1);
 
                             // K terms
-                            // Px
-                            C_DGEMM('n', 'n', nP, nso*nso, nQ, 1.0, ptr+0*stride, nQ, pTmn[oQ], nso*nso, 0.0, pTmpPmn[0], nso*nso);
-                            for(int p = 0; p < nP; ++p)
-                                C_DGEMM('N', 'N', nso, nso, nso, 1.0, Bmnp[p+oP], nso, pTmpPmn[p], nso, 1.0, pdG[Px][0], nso);
-                            // Py
-                            C_DGEMM('n', 'n', nP, nso*nso, nQ, 1.0, ptr+1*stride, nQ, pTmn[oQ], nso*nso, 0.0, pTmpPmn[0], nso*nso);
-                            for(int p = 0; p < nP; ++p)
-                                C_DGEMM('N', 'N', nso, nso, nso, 1.0, Bmnp[p+oP], nso, pTmpPmn[p], nso, 1.0, pdG[Py][0], nso);
-                            // Pz
-                            C_DGEMM('n', 'n', nP, nso*nso, nQ, 1.0, ptr+2*stride, nQ, pTmn[oQ], nso*nso, 0.0, pTmpPmn[0], nso*nso);
-                            for(int p = 0; p < nP; ++p)
-                                C_DGEMM('N', 'N', nso, nso, nso, 1.0, Bmnp[p+oP], nso, pTmpPmn[p], nso, 1.0, pdG[Pz][0], nso);
+                            if (Kscale != 0.0) {
+                                // Px
+                                C_DGEMM('n', 'n', nP, nso*nso, nQ, 1.0, ptr+0*stride, nQ, pTmn[oQ], nso*nso, 0.0, pTmpPmn[0], nso*nso);
+                                for(int p = 0; p < nP; ++p)
+                                    C_DGEMM('N', 'N', nso, nso, nso, Kscale, Bmnp[p+oP], nso, pTmpPmn[p], nso, 1.0, pdG[Px][0], nso);
+                                // Py
+                                C_DGEMM('n', 'n', nP, nso*nso, nQ, 1.0, ptr+1*stride, nQ, pTmn[oQ], nso*nso, 0.0, pTmpPmn[0], nso*nso);
+                                for(int p = 0; p < nP; ++p)
+                                    C_DGEMM('N', 'N', nso, nso, nso, Kscale, Bmnp[p+oP], nso, pTmpPmn[p], nso, 1.0, pdG[Py][0], nso);
+                                // Pz
+                                C_DGEMM('n', 'n', nP, nso*nso, nQ, 1.0, ptr+2*stride, nQ, pTmn[oQ], nso*nso, 0.0, pTmpPmn[0], nso*nso);
+                                for(int p = 0; p < nP; ++p)
+                                    C_DGEMM('N', 'N', nso, nso, nso, Kscale, Bmnp[p+oP], nso, pTmpPmn[p], nso, 1.0, pdG[Pz][0], nso);
+                            }
 
                         }
                         if(pert_incore[Qcenter]){
@@ -613,18 +621,20 @@ std::shared_ptr<Matrix> RSCFDeriv::hessian_response()
                             C_DGEMV('t', nP, nso*nso, -1.0, Bmnp[oP], nso*nso, pTempP[0], 1, 1.0, pdG[Qz][0], 1);
 
                             // K terms
-                            // Qx
-                            C_DGEMM('n', 'n', nP, nso*nso, nQ, 1.0, ptr+3*stride, nQ, pTmn[oQ], nso*nso, 0.0, pTmpPmn[0], nso*nso);
-                            for(int p = 0; p < nP; ++p)
-                                C_DGEMM('N', 'N', nso, nso, nso, 1.0, Bmnp[p+oP], nso, pTmpPmn[p], nso, 1.0, pdG[Qx][0], nso);
-                            // Qy
-                            C_DGEMM('n', 'n', nP, nso*nso, nQ, 1.0, ptr+4*stride, nQ, pTmn[oQ], nso*nso, 0.0, pTmpPmn[0], nso*nso);
-                            for(int p = 0; p < nP; ++p)
-                                C_DGEMM('N', 'N', nso, nso, nso, 1.0, Bmnp[p+oP], nso, pTmpPmn[p], nso, 1.0, pdG[Qy][0], nso);
-                            // Qz
-                            C_DGEMM('n', 'n', nP, nso*nso, nQ, 1.0, ptr+5*stride, nQ, pTmn[oQ], nso*nso, 0.0, pTmpPmn[0], nso*nso);
-                            for(int p = 0; p < nP; ++p)
-                                C_DGEMM('N', 'N', nso, nso, nso, 1.0, Bmnp[p+oP], nso, pTmpPmn[p], nso, 1.0, pdG[Qz][0], nso);
+                            if (Kscale != 0.0) {
+                                // Qx
+                                C_DGEMM('n', 'n', nP, nso*nso, nQ, 1.0, ptr+3*stride, nQ, pTmn[oQ], nso*nso, 0.0, pTmpPmn[0], nso*nso);
+                                for(int p = 0; p < nP; ++p)
+                                    C_DGEMM('N', 'N', nso, nso, nso, Kscale, Bmnp[p+oP], nso, pTmpPmn[p], nso, 1.0, pdG[Qx][0], nso);
+                                // Qy
+                                C_DGEMM('n', 'n', nP, nso*nso, nQ, 1.0, ptr+4*stride, nQ, pTmn[oQ], nso*nso, 0.0, pTmpPmn[0], nso*nso);
+                                for(int p = 0; p < nP; ++p)
+                                    C_DGEMM('N', 'N', nso, nso, nso, Kscale, Bmnp[p+oP], nso, pTmpPmn[p], nso, 1.0, pdG[Qy][0], nso);
+                                // Qz
+                                C_DGEMM('n', 'n', nP, nso*nso, nQ, 1.0, ptr+5*stride, nQ, pTmn[oQ], nso*nso, 0.0, pTmpPmn[0], nso*nso);
+                                for(int p = 0; p < nP; ++p)
+                                    C_DGEMM('N', 'N', nso, nso, nso, Kscale, Bmnp[p+oP], nso, pTmpPmn[p], nso, 1.0, pdG[Qz][0], nso);
+                            }
                         }
 
                     }
@@ -709,12 +719,14 @@ std::shared_ptr<Matrix> RSCFDeriv::hessian_response()
                                 C_DGEMV('t', nP, nso*nso, 2.0, Bmnp[oP], nso*nso, pTempP[1], 1, 1.0, pdG[Py][0], 1);
                                 C_DGEMV('t', nP, nso*nso, 2.0, Bmnp[oP], nso*nso, pTempP[2], 1, 1.0, pdG[Pz][0], 1);
                                 // K Terms
-                                for(int p = 0; p < nP; ++p)
-                                    C_DGEMM('T', 'N', nN, nso, nM, -2.0, ptr+0*stride+p*nM*nN, nN, &pTmn[oP+p][oM*nso], nso, 1.0, pdG[Px][oN], nso);
-                                for(int p = 0; p < nP; ++p)
-                                    C_DGEMM('T', 'N', nN, nso, nM, -2.0, ptr+1*stride+p*nM*nN, nN, &pTmn[oP+p][oM*nso], nso, 1.0, pdG[Py][oN], nso);
-                                for(int p = 0; p < nP; ++p)
-                                    C_DGEMM('T', 'N', nN, nso, nM, -2.0, ptr+2*stride+p*nM*nN, nN, &pTmn[oP+p][oM*nso], nso, 1.0, pdG[Pz][oN], nso);
+                                if (Kscale != 0.0) {
+                                    for(int p = 0; p < nP; ++p)
+                                        C_DGEMM('T', 'N', nN, nso, nM, -2.0 * Kscale, ptr+0*stride+p*nM*nN, nN, &pTmn[oP+p][oM*nso], nso, 1.0, pdG[Px][oN], nso);
+                                    for(int p = 0; p < nP; ++p)
+                                        C_DGEMM('T', 'N', nN, nso, nM, -2.0 * Kscale, ptr+1*stride+p*nM*nN, nN, &pTmn[oP+p][oM*nso], nso, 1.0, pdG[Py][oN], nso);
+                                    for(int p = 0; p < nP; ++p)
+                                        C_DGEMM('T', 'N', nN, nso, nM, -2.0 * Kscale, ptr+2*stride+p*nM*nN, nN, &pTmn[oP+p][oM*nso], nso, 1.0, pdG[Pz][oN], nso);
+                                }
                             }
                             if(pert_incore[Mcenter]){
                                 // J Terms
@@ -733,12 +745,14 @@ std::shared_ptr<Matrix> RSCFDeriv::hessian_response()
                                 C_DGEMV('t', nP, nso*nso, 2.0, Bmnp[oP], nso*nso, pTempP[4], 1, 1.0, pdG[my][0], 1);
                                 C_DGEMV('t', nP, nso*nso, 2.0, Bmnp[oP], nso*nso, pTempP[5], 1, 1.0, pdG[mz][0], 1);
                                 // K Terms
-                                for(int p = 0; p < nP; ++p)
-                                    C_DGEMM('T', 'N', nN, nso, nM, -2.0, ptr+3*stride+p*nM*nN, nN, &pTmn[oP+p][oM*nso], nso, 1.0, pdG[mx][oN], nso);
-                                for(int p = 0; p < nP; ++p)
-                                    C_DGEMM('T', 'N', nN, nso, nM, -2.0, ptr+4*stride+p*nM*nN, nN, &pTmn[oP+p][oM*nso], nso, 1.0, pdG[my][oN], nso);
-                                for(int p = 0; p < nP; ++p)
-                                    C_DGEMM('T', 'N', nN, nso, nM, -2.0, ptr+5*stride+p*nM*nN, nN, &pTmn[oP+p][oM*nso], nso, 1.0, pdG[mz][oN], nso);
+                                if (Kscale != 0.0) {
+                                    for(int p = 0; p < nP; ++p)
+                                        C_DGEMM('T', 'N', nN, nso, nM, -2.0 * Kscale, ptr+3*stride+p*nM*nN, nN, &pTmn[oP+p][oM*nso], nso, 1.0, pdG[mx][oN], nso);
+                                    for(int p = 0; p < nP; ++p)
+                                        C_DGEMM('T', 'N', nN, nso, nM, -2.0 * Kscale, ptr+4*stride+p*nM*nN, nN, &pTmn[oP+p][oM*nso], nso, 1.0, pdG[my][oN], nso);
+                                    for(int p = 0; p < nP; ++p)
+                                        C_DGEMM('T', 'N', nN, nso, nM, -2.0 * Kscale, ptr+5*stride+p*nM*nN, nN, &pTmn[oP+p][oM*nso], nso, 1.0, pdG[mz][oN], nso);
+                                }
                             }
                             if(pert_incore[Ncenter]){
                                 // J Terms
@@ -757,21 +771,26 @@ std::shared_ptr<Matrix> RSCFDeriv::hessian_response()
                                 C_DGEMV('t', nP, nso*nso, 2.0, Bmnp[oP], nso*nso, pTempP[7], 1, 1.0, pdG[ny][0], 1);
                                 C_DGEMV('t', nP, nso*nso, 2.0, Bmnp[oP], nso*nso, pTempP[8], 1, 1.0, pdG[nz][0], 1);
                                 // K Terms
-                                for(int p = 0; p < nP; ++p)
-                                    C_DGEMM('T', 'N', nN, nso, nM, -2.0, ptr+6*stride+p*nM*nN, nN, &pTmn[oP+p][oM*nso], nso, 1.0, pdG[nx][oN], nso);
-                                for(int p = 0; p < nP; ++p)
-                                    C_DGEMM('T', 'N', nN, nso, nM, -2.0, ptr+7*stride+p*nM*nN, nN, &pTmn[oP+p][oM*nso], nso, 1.0, pdG[ny][oN], nso);
-                                for(int p = 0; p < nP; ++p)
-                                    C_DGEMM('T', 'N', nN, nso, nM, -2.0, ptr+8*stride+p*nM*nN, nN, &pTmn[oP+p][oM*nso], nso, 1.0, pdG[nz][oN], nso);
+                                if (Kscale != 0.0) {
+                                    for(int p = 0; p < nP; ++p)
+                                        C_DGEMM('T', 'N', nN, nso, nM, -2.0 * Kscale, ptr+6*stride+p*nM*nN, nN, &pTmn[oP+p][oM*nso], nso, 1.0, pdG[nx][oN], nso);
+                                    for(int p = 0; p < nP; ++p)
+                                        C_DGEMM('T', 'N', nN, nso, nM, -2.0 * Kscale, ptr+7*stride+p*nM*nN, nN, &pTmn[oP+p][oM*nso], nso, 1.0, pdG[ny][oN], nso);
+                                    for(int p = 0; p < nP; ++p)
+                                        C_DGEMM('T', 'N', nN, nso, nM, -2.0 * Kscale, ptr+8*stride+p*nM*nN, nN, &pTmn[oP+p][oM*nso], nso, 1.0, pdG[nz][oN], nso);
+                                }
                             }
 
                         }
                     }
                 }
 
+                std::vector<SharedMatrix> Vxc_derivs;
+                if (do_xc) Vxc_derivs = potential_->compute_fock_derivatives(A, nA);
                 for(int a = 0; a < nA; ++a){
                     // Symmetrize the derivative Fock contributions
                     SharedMatrix G = dGmats[a];
+                    if (do_xc) G->add(Vxc_derivs[a]);
                     G->add(G->transpose());
                     Gpi->transform(C, G, Cocc);
                     Gpi->scale(0.5);
@@ -951,13 +970,14 @@ std::shared_ptr<Matrix> RSCFDeriv::hessian_response()
                     }
 
                     // => Exchange Term <= //
+                    if (Kscale == 0.0) continue;
 
                     Ax = 0.0; Ay = 0.0; Az = 0.0;
                     Bx = 0.0; By = 0.0; Bz = 0.0;
                     Cx = 0.0; Cy = 0.0; Cz = 0.0;
                     Dx = 0.0; Dy = 0.0; Dz = 0.0;
                     delta = 0L;
-                    prefactor *= -0.25;
+                    prefactor *= -0.25 * Kscale;
                     for (int p = Poff; p < Poff+Psize; p++) {
                         for (int q = Qoff; q < Qoff+Qsize; q++) {
                             for (int r = Roff; r < Roff+Rsize; r++) {
@@ -1042,9 +1062,12 @@ std::shared_ptr<Matrix> RSCFDeriv::hessian_response()
                     }
                 } // End shell loops
 
+                std::vector<SharedMatrix> Vxc_derivs;
+                if (do_xc) Vxc_derivs = potential_->compute_fock_derivatives(A, nA);
                 for(int a = 0; a < nA; ++a){
                     // Symmetrize the derivative Fock contributions
                     SharedMatrix G = dGmats[a];
+                    if (do_xc) G->add(Vxc_derivs[a]);
                     G->add(G->transpose());
                     Gpi->transform(C, G, Cocc);
                     Gpi->scale(0.5);
@@ -1066,6 +1089,20 @@ std::shared_ptr<Matrix> RSCFDeriv::hessian_response()
     jk->set_memory(mem);
     jk->initialize();
 
+    // V_xc[C_left C_right^T] for the same perturbations as the JK object, empty for HF
+    std::vector<SharedMatrix> Vx;
+    auto compute_Vx = [&](const std::vector<SharedMatrix>& Cl, const std::vector<SharedMatrix>& Cr,
+                          std::vector<SharedMatrix>& ret) {
+        ret.clear();
+        if (!functional_->needs_xc()) return;
+        std::vector<SharedMatrix> Dx;
+        for (size_t a = 0; a < Cl.size(); a++) {
+            Dx.push_back(linalg::doublet(Cl[a], Cr[a], false, true));
+            ret.push_back(std::make_shared<Matrix>("Vx Temp", nso, nso));
+        }
+        potential_->compute_Vx(Dx, ret);
+    };
+
     // => J2pi/K2pi <= //
     {
         std::vector<std::shared_ptr<Matrix> >& L = jk->C_left();
@@ -1109,15 +1146,19 @@ std::shared_ptr<Matrix> RSCFDeriv::hessian_response()
             }
 
             jk->compute();
+            compute_Vx(L, R, Vx);
 
             for (int a = 0; a < nA; a++) {
-                // Add the 2J contribution to G
+                // Add the 2J (and 2 V_xc) contribution to G
+                if (!Vx.empty()) J[a]->add(Vx[a]);
                 C_DGEMM('N','N',nso,nocc,nso,1.0,J[a]->pointer()[0],nso,Cop[0],nocc,0.0,Tp[0],nocc);
                 C_DGEMM('T','N',nmo,nocc,nso,-2.0,Cp[0],nmo,Tp[0],nocc,0.0,Up[0],nocc);
 
                 // Subtract the K term from G
-                C_DGEMM('N','N',nso,nocc,nso,1.0,K[a]->pointer()[0],nso,Cop[0],nocc,0.0,Tp[0],nocc);
-                C_DGEMM('T','N',nmo,nocc,nso,1.0,Cp[0],nmo,Tp[0],nocc,1.0,Up[0],nocc);
+                if (Kscale != 0.0) {
+                    C_DGEMM('N','N',nso,nocc,nso,1.0,K[a]->pointer()[0],nso,Cop[0],nocc,0.0,Tp[0],nocc);
+                    C_DGEMM('T','N',nmo,nocc,nso,Kscale,Cp[0],nmo,Tp[0],nocc,1.0,Up[0],nocc);
+                }
 
                 psio_address next_Gpi = psio_get_address(PSIO_ZERO,(A + a) * (size_t) nmo * nocc * sizeof(double));
                 psio_->write(PSIF_HESS,"G2pi^A",(char*)Up[0], static_cast<size_t> (nmo)*nocc*sizeof(double),next_Gpi,&next_Gpi);
@@ -1297,10 +1338,14 @@ std::shared_ptr<Matrix> RSCFDeriv::hessian_response()
             }
 
             jk->compute();
+            compute_Vx(L, R, Vx);
             for (int a = 0; a < nA; a++) {
+                if (!Vx.empty()) J[a]->add(Vx[a]);
                 C_DGEMM('N','N',nso,nocc,nso, 4.0,J[a]->pointer()[0],nso,Cop[0],nocc,0.0,Tp[0],nocc);
-                C_DGEMM('N','N',nso,nocc,nso,-1.0,K[a]->pointer()[0],nso,Cop[0],nocc,1.0,Tp[0],nocc);
-                C_DGEMM('T','N',nso,nocc,nso,-1.0,K[a]->pointer()[0],nso,Cop[0],nocc,1.0,Tp[0],nocc);
+                if (Kscale != 0.0) {
+                    C_DGEMM('N','N',nso,nocc,nso,-Kscale,K[a]->pointer()[0],nso,Cop[0],nocc,1.0,Tp[0],nocc);
+                    C_DGEMM('T','N',nso,nocc,nso,-Kscale,K[a]->pointer()[0],nso,Cop[0],nocc,1.0,Tp[0],nocc);
+                }
                 C_DGEMM('T','N',nmo,nocc,nso,1.0,Cp[0],nmo,Tp[0],nocc,0.0,Up[0],nocc);
                 psio_address next_Qpi = psio_get_address(PSIO_ZERO,(A + a) * (size_t) nmo * nocc * sizeof(double));
                 psio_->write(PSIF_HESS,"Qpi^A",(char*)Up[0], static_cast<size_t> (nmo)*nocc*sizeof(double),next_Qpi,&next_Qpi);
@@ -358,12 +358,21 @@ SharedMatrix SCFDeriv::compute_hessian()
     std::shared_ptr<VBase> potential;
 
     if (functional_->needs_xc()) {
-        throw PSIEXCEPTION("Missing XC derivatives for Hessians");
-        // if (options_.get_str("REFERENCE") == "RKS") {
-        //     potential_->set_D({Da_});
-        // } else {
-        //     potential_->set_D({Da_, Db_});
-        // }
+        if (options_.get_str("REFERENCE") != "RKS") {
+            throw PSIEXCEPTION("SCFHessian: XC Hessians are only implemented for RKS references");
+        }
+        if (functional_->is_meta()) {
+            throw PSIEXCEPTION("SCFHessian: XC Hessians are not implemented for meta-GGA functionals");
+        }
+        if (functional_->needs_vv10()) {
+            throw PSIEXCEPTION("SCFHessian: XC Hessians are not implemented for VV10 functionals");
+        }
+        if (functional_->is_x_lrc()) {
+            throw PSIEXCEPTION("SCFHessian: Hessians are not implemented for range-separated functionals");
+        }
+        functional = functional_;
+        potential = potential_;
+        potential_->set_D({Da_});
     }
 
     // => Sizings <= //
@@ -1035,13 +1044,12 @@ SharedMatrix SCFDeriv::compute_hessian()
     timer_on("Hess: XC");
     if (functional) {
         potential->print_header();
-        throw PSIEXCEPTION("KS Hessians not implemented");
-        //hessians_["XC"] = potential->compute_hessian();
+        hessians_["XC"] = potential->compute_hessian();
     }
     timer_off("Hess: XC");
 
     // => Response Terms (Brace Yourself) <= //
-    if (options_.get_str("REFERENCE") == "RHF") {
+    if (options_.get_str("REFERENCE") == "RHF" || options_.get_str("REFERENCE") == "RKS") {
         hessians_["Response"] = hessian_response();
     } else {
         throw PSIEXCEPTION("SCFHessian: Response not implemented for this reference");
@@ -163,6 +163,11 @@ int read_options(const std::string &name, Options &options, bool suppress_printi
     /*- Assume external fields are arranged so that they have symmetry. It is up to the user to know what to do here.
        The code does NOT help you out in any way! !expert -*/
     options.add_bool("EXTERNAL_POTENTIAL_SYMMETRY", false);
+    /*- Opening angle of the multipole tree used for distant external point charges. A cell of charges is
+       replaced by its multipole expansion (as seven pseudo-charges) when its size plus that of the basis
+       function shell is below this fraction of their distance. Only used for fields of 1000 or more charges;
+       0.0 treats every charge exactly. !expert -*/
+    options.add_double("EXTERNAL_POTENTIAL_FAR_FIELD_THETA", 0.0);
     /*- Text to be passed directly into CFOUR input files. May contain
     molecule, options, percent blocks, etc. Access through ``cfour {...}``
     block. -*/
@@ -174,7 +179,7 @@ int read_options(const std::string &name, Options &options, bool suppress_printi
     /*- What algorithm to use for the SCF computation. See Table :ref:`SCF
     Convergence & Algorithm <table:conv_scf>` for default algorithm for
     different calculation types. -*/
-    options.add_str("SCF_TYPE", "PK", "DIRECT DF MEM_DF DISK_DF PK OUT_OF_CORE CD GTFOCK");
+    options.add_str("SCF_TYPE", "PK", "DIRECT DF MEM_DF DISK_DF PK OUT_OF_CORE CD GTFOCK COSX");
     /*- Algorithm to use for MP2 computation.
     See :ref:`Cross-module Redundancies <table:managedmethods>` for details. -*/
     options.add_str("MP2_TYPE", "DF", "DF CONV CD");
@@ -244,6 +249,12 @@ int read_options(const std::string &name, Options &options, bool suppress_printi
     options.add("CUBIC_GRID_OVERAGE", new ArrayType());
     /*- CubicScalarGrid grid spacing in bohr [D_X, D_Y, D_Z]. Defaults to 0.2 bohr each. -*/
     options.add("CUBIC_GRID_SPACING", new ArrayType());
+    /*- CubicScalarGrid ESP algorithm. FITTED contracts the density fitted in DF_BASIS_SCF; DIRECT evaluates the
+    screened shell pair potentials without an auxiliary basis (multipoles in the far field). -*/
+    options.add_str("CUBIC_ESP_ALGORITHM", "FITTED", "FITTED DIRECT");
+    /*- CubicScalarGrid ESP multipole cutoff. Shell pair densities farther than this multiple of their extent from a
+    grid point enter through their multipoles; 0.0 evaluates every pair exactly. !expert -*/
+    options.add_double("CUBIC_ESP_MULTIPOLE_RATIO", 2.0);
     /*- How many NOONS to print -- used in libscf_solver/uhf.cc and libmints/oeprop.cc -*/
     options.add_str("PRINT_NOONS", "3");
 
@@ -1020,6 +1031,12 @@ int read_options(const std::string &name, Options &options, bool suppress_printi
         options.add_double("CUBIC_BASIS_TOLERANCE", 1.0E-12);
         /*- CubicScalarGrid maximum number of grid points per evaluation block. !expert -*/
         options.add_int("CUBIC_BLOCK_MAX_POINTS", 1000);
+        /*- CubicScalarGrid ESP algorithm. FITTED contracts the density fitted in DF_BASIS_SCF; DIRECT evaluates the
+        screened shell pair potentials without an auxiliary basis (multipoles in the far field). -*/
+        options.add_str("CUBIC_ESP_ALGORITHM", "FITTED", "FITTED DIRECT");
+        /*- CubicScalarGrid ESP multipole cutoff. Shell pair densities farther than this multiple of their extent from
+        a grid point enter through their multipoles; 0.0 evaluates every pair exactly. !expert -*/
+        options.add_double("CUBIC_ESP_MULTIPOLE_RATIO", 2.0);
 
         // => Scalar Field Plotting Options <= //
 
@@ -1089,6 +1106,10 @@ int read_options(const std::string &name, Options &options, bool suppress_printi
         options.add_int("DIIS_MAX_VECS", 6);
         /*- Minimum number of error vectors stored for DIIS extrapolation !expert-*/
         options.add_int("DIIS_MIN_VECS", 3);
+        /*- How the UHF density cumulant DIIS history is stored. BLOCKED keeps it on disk and streams
+        it one irrep block at a time, so that no complete cumulant vector is held in memory by the
+        DIIS manager; BLOCKED_FLOAT additionally stores it in single precision to halve the I/O. !expert -*/
+        options.add_str("DCFT_DIIS_STORAGE", "DEFAULT", "DEFAULT BLOCKED BLOCKED_FLOAT");
         /*- Controls whether to avoid the AO->MO transformation of the
         two-electron integrals for the four-virtual case ($\langle VV||
         VV \rangle$) by computing the corresponding terms in the AO
@@ -1422,6 +1443,13 @@ int read_options(const std::string &name, Options &options, bool suppress_printi
         options.add_str("DF_INTS_IO", "NONE", "NONE SAVE LOAD");
         /*- Fitting Condition, i.e. eigenvalue threshold for RI basis. Analogous to S_TOLERANCE !expert -*/
         options.add_double("DF_FITTING_CONDITION", 1.0E-10);
+        /*- Do build MemDFJK exchange from Cholesky-localized occupied orbitals, each restricted
+        to its own AO domain? Cost grows linearly with system size once orbitals are local.
+        Only applies to symmetric (SCF) densities. -*/
+        options.add_bool("DF_LOCAL_K", false);
+        /*- Coefficient magnitude below which a localized orbital is dropped from an AO function
+        in the |globals__df_local_k| build. !expert -*/
+        options.add_double("DF_LOCAL_K_TOLERANCE", 1.0E-5);
         /*- FastDF Fitting Metric -*/
         options.add_str("DF_METRIC", "COULOMB", "COULOMB EWALD OVERLAP");
         /*- FastDF SR Ewald metric range separation parameter -*/
@@ -1433,6 +1461,17 @@ int read_options(const std::string &name, Options &options, bool suppress_printi
         /*- Bump function max radius -*/
         options.add_double("DF_BUMP_R1", 0.0);
 
+        /*- SUBSECTION COSX Algorithm -*/
+
+        /*- Number of radial points for the seminumerical exchange grid of |scf__scf_type| ``COSX``. -*/
+        options.add_int("COSX_RADIAL_POINTS", 35);
+        /*- Number of spherical points (A :ref:`Lebedev Points <table:lebedevorder>` number) for the
+        seminumerical exchange grid of |scf__scf_type| ``COSX``. -*/
+        options.add_int("COSX_SPHERICAL_POINTS", 110);
+        /*- Shells whose density-contracted values (phi D) stay below this on a grid block are
+        skipped in the COSX potential integrals. !expert -*/
+        options.add_double("COSX_DENSITY_TOLERANCE", 1.0E-10);
+
         /*- SUBSECTION SAD Guess Algorithm -*/
 
         /*- The amount of SAD information to print to the output !expert -*/
@@ -1494,9 +1533,13 @@ int read_options(const std::string &name, Options &options, bool suppress_printi
         options.add_str("DFT_GRID_NAME", "", "SG0 SG1");
         /*- Pruning Scheme. !expert -*/
         options.add_str("DFT_PRUNING_SCHEME", "FLAT",
-                        "FLAT P_GAUSSIAN D_GAUSSIAN P_SLATER D_SLATER LOG_GAUSSIAN LOG_SLATER");
+                        "FLAT P_GAUSSIAN D_GAUSSIAN P_SLATER D_SLATER LOG_GAUSSIAN LOG_SLATER ADAPTIVE");
         /*- Spread alpha for logarithmic pruning. !expert -*/
         options.add_double("DFT_PRUNING_ALPHA", 1.0);
+        /*- Target angular quadrature error per radial shell for ADAPTIVE pruning. Each shell gets the smallest
+        Lebedev order (never above DFT_SPHERICAL_POINTS) that resolves the basis functions reaching it to this
+        tolerance. The radial grid is not error-controlled: H and He simply use 80% of DFT_RADIAL_POINTS. !expert -*/
+        options.add_double("DFT_PRUNING_TOLERANCE", 1.0E-7);
         /*- The maximum number of grid points per evaluation block. !expert -*/
         options.add_int("DFT_BLOCK_MAX_POINTS", 256);
         /*- The minimum number of grid points per evaluation block. !expert -*/
@@ -1505,6 +1548,11 @@ int read_options(const std::string &name, Options &options, bool suppress_printi
         options.add_double("DFT_BLOCK_MAX_RADIUS", 3.0);
         /*- The blocking scheme for DFT. !expert -*/
         options.add_str("DFT_BLOCK_SCHEME", "OCTREE", "NAIVE OCTREE");
+        /*- The number of finished DFT grids kept for reuse within the process. A grid with the same options,
+        basis and geometry as a kept one (e.g., a repeated SCF or a returning fragment) skips the nuclear
+        partitioning and blocking, at the cost of holding each kept grid in memory. 0 (the default) disables
+        this reuse; the per-element atomic grids are always reused. !expert -*/
+        options.add_int("DFT_GRID_CACHE_SIZE", 0);
         /*- Parameters defining the dispersion correction. See Table
         :ref:`-D Functionals <table:dft_disp>` for default values and Table
         :ref:`Dispersion Corrections <table:dashd>` for the order in which
@@ -1520,6 +1568,11 @@ int read_options(const std::string &name, Options &options, bool suppress_printi
         options.add_int("DFT_VV10_RADIAL_POINTS", 50);
         /*- Rho cutoff for VV10 NL integration. !expert -*/
         options.add_double("DFT_VV10_RHO_CUTOFF", 1.e-8);
+        /*- Opening criterion for the VV10 NL kernel. A cell of the nonlocal grid is replaced by a single
+        far-field pseudo-point when the sum of its and the local block's radii is below this fraction of
+        their separation. 0.0 recovers the exact pairwise sum; values around 0.2 make the kernel close
+        to linear scaling for large molecules. !expert -*/
+        options.add_double("DFT_VV10_THETA", 0.0);
         /*- Define VV10 parameter b -*/
         options.add_double("DFT_VV10_B", 0.0);
         /*- Define VV10 parameter C -*/
@@ -1609,6 +1662,12 @@ int read_options(const std::string &name, Options &options, bool suppress_printi
         /*- Solver exact diagonal or eigenvalue difference?
         -*/
         options.add_bool("SOLVER_EXACT_DIAGONAL", false);
+        /*- Algorithm for the RHF coupled-perturbed equations of response properties and Hessians.
+        CG runs an independent conjugate gradient per perturbation; BLOCK grows one subspace
+        shared by all perturbations of the same symmetry, which usually needs fewer iterations
+        when the right-hand sides are related. Both pack every active vector into one JK call.
+        -*/
+        options.add_str("SOLVER_CPHF_TYPE", "CG", "CG BLOCK");
     }
     if (name == "CCTRANSORT" || options.read_globals()) {
         /*- MODULEDESCRIPTION Transforms and sorts integrals for CC codes. Called before (non-density-fitted) MP2 and
@@ -1621,6 +1680,10 @@ int read_options(const std::string &name, Options &options, bool suppress_printi
         options.add_str("AO_BASIS", "NONE", "NONE DISK DIRECT");
         /*- Delete the SO two-electron integrals after the transformation? -*/
         options.add_bool("DELETE_TEI", true);
+        /*- Compute the SO two-electron integrals on the fly during the transformation, rather than
+            writing and presorting the SO integral file? This needs much less scratch disk space, at the
+            cost of recomputing integrals. Ignored when |cctransort__ao_basis| is DISK. -*/
+        options.add_bool("DIRECT_TEI", false);
         /*- Caching level for libdpd -*/
         options.add_int("CACHELEVEL", 2);
         /*- Force conversion of ROHF MOs to semicanonical MOs to run UHF-based energies -*/